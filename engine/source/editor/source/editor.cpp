@@ -14,7 +14,7 @@ namespace Piccolo
 {
     void registerEdtorTickComponent(std::string component_type_name)
     {
-        g_editor_tick_component_types.insert(component_type_name);
+        g_editor_tick_component_mask |= Reflection::getComponentTypeMask(component_type_name);
     }
 
     PiccoloEditor::PiccoloEditor()
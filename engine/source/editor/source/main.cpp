@@ -5,6 +5,8 @@
 #include <unordered_map>
 
 #include "runtime/engine.h"
+#include "runtime/function/global/global_context.h"
+#include "runtime/function/render/window_system.h"
 
 #include "editor/include/editor.h"
 
@@ -22,12 +24,20 @@ int main(int argc, char** argv)
     engine->startEngine(config_file_path.generic_string());
     engine->initialize();
 
-    Piccolo::PiccoloEditor* editor = new Piccolo::PiccoloEditor();
-    editor->initialize(engine);
+    // the editor ui needs the vulkan backend, a headless run only ticks the runtime
+    if (Piccolo::g_runtime_global_context.m_window_system->isHeadless())
+    {
+        engine->run();
+    }
+    else
+    {
+        Piccolo::PiccoloEditor* editor = new Piccolo::PiccoloEditor();
+        editor->initialize(engine);
 
-    editor->run();
+        editor->run();
 
-    editor->clear();
+        editor->clear();
+    }
 
     engine->clear();
     engine->shutdownEngine();
@@ -21,6 +21,7 @@ namespace Generator
         GeneratorInterface::prepareStatus(path);
         TemplateManager::getInstance()->loadTemplates(m_root_path, "commonReflectionFile");
         TemplateManager::getInstance()->loadTemplates(m_root_path, "allReflectionFile");
+        TemplateManager::getInstance()->loadTemplates(m_root_path, "allTypeIdFile");
         return;
     }
 
@@ -53,6 +54,17 @@ namespace Generator
             class_names.insert_or_assign(class_temp->getClassName(), false);
             class_names[class_temp->getClassName()] = true;
 
+            if (class_temp->m_is_struct)
+            {
+                m_struct_names.insert(class_temp->getClassName());
+            }
+
+            std::vector<std::string>& base_names = m_class_base_names[class_temp->getClassName()];
+            for (auto& base_class : class_temp->m_base_classes)
+            {
+                base_names.emplace_back(base_class->name);
+            }
+
             std::vector<std::string>                                   field_names;
             std::map<std::string, std::pair<std::string, std::string>> vector_map;
 
@@ -135,6 +147,67 @@ namespace Generator
         std::string render_string =
             TemplateManager::getInstance()->renderByTemplate("allReflectionFile", mustache_data);
         Utils::saveFile(render_string, m_out_path + "/all_reflection.h");
+
+        genTypeIdFile();
+    }
+
+    void ReflectionGenerator::genTypeIdFile()
+    {
+        static const std::string component_base_name = "Component";
+
+        // a class is a component if it derives from Component, directly or through another reflected class
+        std::set<std::string> component_names;
+        bool                  is_changed = true;
+        while (is_changed)
+        {
+            is_changed = false;
+            for (auto& class_item : m_class_base_names)
+            {
+                if (component_names.count(class_item.first) > 0)
+                    continue;
+                for (auto& base_name : class_item.second)
+                {
+                    if (base_name == component_base_name || component_names.count(base_name) > 0)
+                    {
+                        component_names.insert(class_item.first);
+                        is_changed = true;
+                        break;
+                    }
+                }
+            }
+        }
+
+        // ids are dense and assigned in name order, so they only change when the set of reflected classes changes
+        Mustache::data mustache_data;
+        Mustache::data type_defines           = Mustache::data::type::list;
+        Mustache::data component_type_defines = Mustache::data::type::list;
+
+        int type_id = 0;
+        for (auto& class_item : m_class_base_names)
+        {
+            Mustache::data type_define;
+            type_define.set("class_name", class_item.first);
+            type_define.set("class_key", m_struct_names.count(class_item.first) > 0 ? "struct" : "class");
+            type_define.set("type_id", std::to_string(type_id++));
+            type_defines.push_back(type_define);
+        }
+
+        int component_type_index = 0;
+        for (auto& component_name : component_names)
+        {
+            Mustache::data component_type_define;
+            component_type_define.set("class_name", component_name);
+            component_type_define.set("component_type_index", std::to_string(component_type_index++));
+            component_type_defines.push_back(component_type_define);
+        }
+
+        mustache_data.set("type_defines", type_defines);
+        mustache_data.set("component_type_defines", component_type_defines);
+        mustache_data.set("type_count", std::to_string(type_id));
+        mustache_data.set("component_type_count", std::to_string(component_type_index));
+
+        std::string render_string = TemplateManager::getInstance()->renderByTemplate("allTypeIdFile", mustache_data);
+        Utils::saveFile(render_string, m_out_path + "/all_type_id.h");
     }
 
     ReflectionGenerator::~ReflectionGenerator() {}
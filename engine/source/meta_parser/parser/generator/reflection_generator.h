@@ -16,7 +16,13 @@ namespace Generator
         virtual std::string processFileName(std::string path) override;
 
     private:
+        void genTypeIdFile();
+
         std::vector<std::string> m_head_file_list;
         std::vector<std::string> m_sourcefile_list;
+        // reflected class name -> names of its direct base classes
+        std::map<std::string, std::vector<std::string>> m_class_base_names;
+        // reflected classes declared with the struct key
+        std::set<std::string> m_struct_names;
     };
 } // namespace Generator
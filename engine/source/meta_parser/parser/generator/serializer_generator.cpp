@@ -17,6 +17,8 @@ namespace Generator
         TemplateManager::getInstance()->loadTemplates(m_root_path, "allSerializer.h");
         TemplateManager::getInstance()->loadTemplates(m_root_path, "allSerializer.ipp");
         TemplateManager::getInstance()->loadTemplates(m_root_path, "commonSerializerGenFile");
+        TemplateManager::getInstance()->loadTemplates(m_root_path, "allStreamSerializer.ipp");
+        TemplateManager::getInstance()->loadTemplates(m_root_path, "commonStreamSerializerGenFile");
         return;
     }
 
@@ -25,16 +27,26 @@ namespace Generator
         auto relativeDir = fs::path(path).filename().replace_extension("serializer.gen.h").string();
         return m_out_path + "/" + relativeDir;
     }
+
+    std::string SerializerGenerator::processStreamFileName(std::string path)
+    {
+        auto relativeDir = fs::path(path).filename().replace_extension("stream_serializer.gen.h").string();
+        return m_out_path + "/" + relativeDir;
+    }
+
     int SerializerGenerator::generate(std::string path, SchemaMoudle schema)
     {
         std::string file_path = processFileName(path);
 
         Mustache::data muatache_data;
         Mustache::data include_headfiles(Mustache::data::type::list);
+        Mustache::data stream_include_headfiles(Mustache::data::type::list);
         Mustache::data class_defines(Mustache::data::type::list);
 
         include_headfiles.push_back(
             Mustache::data("headfile_name", Utils::makeRelativePath(m_root_path, path).string()));
+        stream_include_headfiles.push_back(
+            Mustache::data("headfile_name", Utils::makeRelativePath(m_root_path, path).string()));
         for (auto class_temp : schema.classes)
         {
             if (!class_temp->shouldCompileFields())
@@ -87,8 +99,17 @@ namespace Generator
             TemplateManager::getInstance()->renderByTemplate("commonSerializerGenFile", muatache_data);
         Utils::saveFile(render_string, file_path);
 
+        // readMember declarations for StreamSerializer, the definitions go to all_stream_serializer.ipp
+        std::string stream_file_path = processStreamFileName(path);
+        muatache_data.set("include_headfiles", stream_include_headfiles);
+        render_string =
+            TemplateManager::getInstance()->renderByTemplate("commonStreamSerializerGenFile", muatache_data);
+        Utils::saveFile(render_string, stream_file_path);
+
         m_include_headfiles.push_back(
             Mustache::data("headfile_name", Utils::makeRelativePath(m_root_path, file_path).string()));
+        m_include_headfiles.push_back(
+            Mustache::data("headfile_name", Utils::makeRelativePath(m_root_path, stream_file_path).string()));
         return 0;
     }
 
@@ -102,6 +123,8 @@ namespace Generator
         Utils::saveFile(render_string, m_out_path + "/all_serializer.h");
         render_string = TemplateManager::getInstance()->renderByTemplate("allSerializer.ipp", mustache_data);
         Utils::saveFile(render_string, m_out_path + "/all_serializer.ipp");
+        render_string = TemplateManager::getInstance()->renderByTemplate("allStreamSerializer.ipp", mustache_data);
+        Utils::saveFile(render_string, m_out_path + "/all_stream_serializer.ipp");
     }
 
     SerializerGenerator::~SerializerGenerator() {}
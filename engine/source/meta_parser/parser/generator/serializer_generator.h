@@ -19,6 +19,8 @@ namespace Generator
 
         virtual std::string processFileName(std::string path) override;
 
+        std::string processStreamFileName(std::string path);
+
     private:
         Mustache::data m_class_defines {Mustache::data::type::list};
         Mustache::data m_include_headfiles {Mustache::data::type::list};
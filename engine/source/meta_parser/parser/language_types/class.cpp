@@ -7,7 +7,7 @@ BaseClass::BaseClass(const Cursor& cursor) : name(Utils::getTypeNameWithoutNames
 Class::Class(const Cursor& cursor, const Namespace& current_namespace) :
     TypeInfo(cursor, current_namespace), m_name(cursor.getDisplayName()),
     m_qualified_name(Utils::getTypeNameWithoutNamespace(cursor.getType())),
-    m_display_name(Utils::getNameWithoutFirstM(m_qualified_name))
+    m_display_name(Utils::getNameWithoutFirstM(m_qualified_name)), m_is_struct(cursor.getKind() == CXCursor_StructDecl)
 {
     Utils::replaceAll(m_name, " ", "");
     Utils::replaceAll(m_name, "Piccolo::", "");
@@ -44,5 +44,8 @@ public:
 
     std::string m_display_name;
 
+    // declared with the struct key, forward declarations have to use the same one
+    bool m_is_struct;
+
     bool isAccessible(void) const;
 };
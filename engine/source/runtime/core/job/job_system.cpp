@@ -0,0 +1,225 @@
+#include "runtime/core/job/job_system.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace Piccolo
+{
+    namespace
+    {
+        constexpr uint32_t k_invalid_worker_index = 0xffffffff;
+
+        // the worker index of the current thread, invalid for threads not owned by a job system
+        thread_local uint32_t          t_worker_index {k_invalid_worker_index};
+        thread_local const JobSystem* t_worker_owner {nullptr};
+    } // namespace
+
+    JobSystem::~JobSystem() { clear(); }
+
+    void JobSystem::initialize(uint32_t worker_count)
+    {
+        assert(!m_is_running);
+
+        m_queues.clear();
+        for (uint32_t queue_index = 0; queue_index <= worker_count; ++queue_index)
+        {
+            m_queues.push_back(std::make_unique<JobQueue>());
+        }
+
+        m_is_running = true;
+
+        m_workers.reserve(worker_count);
+        for (uint32_t worker_index = 0; worker_index < worker_count; ++worker_index)
+        {
+            m_workers.emplace_back(&JobSystem::workerLoop, this, worker_index);
+        }
+    }
+
+    void JobSystem::clear()
+    {
+        if (!m_is_running)
+            return;
+
+        // let the external thread finish what has been queued before shutting down
+        while (tryExecuteJob())
+        {
+        }
+
+        {
+            std::lock_guard<std::mutex> lock_guard(m_wake_mutex);
+            m_is_running = false;
+        }
+        m_wake_condition.notify_all();
+
+        for (std::thread& worker : m_workers)
+        {
+            worker.join();
+        }
+        m_workers.clear();
+        m_queues.clear();
+        m_queued_job_count = 0;
+    }
+
+    uint32_t JobSystem::getDefaultWorkerCount()
+    {
+        // keep one hardware thread for the thread submitting the work
+        const uint32_t hardware_thread_count = std::thread::hardware_concurrency();
+        return hardware_thread_count > 1 ? hardware_thread_count - 1 : 0;
+    }
+
+    void JobSystem::run(JobFunction job, JobCounter& counter)
+    {
+        counter.m_pending_job_count.fetch_add(1, std::memory_order_relaxed);
+
+        if (m_workers.empty())
+        {
+            Job inline_job {std::move(job), &counter};
+            execute(inline_job);
+            return;
+        }
+
+        JobQueue& queue = *m_queues[getCurrentQueueIndex()];
+        {
+            std::lock_guard<std::mutex> lock_guard(queue.m_mutex);
+            queue.m_jobs.push_back({std::move(job), &counter});
+        }
+        m_queued_job_count.fetch_add(1, std::memory_order_release);
+
+        // taking the wake mutex orders this push against a worker that is about to sleep
+        {
+            std::lock_guard<std::mutex> lock_guard(m_wake_mutex);
+        }
+        m_wake_condition.notify_one();
+    }
+
+    void JobSystem::parallelFor(uint32_t count, uint32_t min_chunk_size, const JobRangeFunction& range_function)
+    {
+        if (count == 0)
+            return;
+
+        // a few chunks per thread so that stealing can balance uneven chunks
+        const uint32_t thread_count = getWorkerCount() + 1;
+        const uint32_t chunk_size =
+            std::max(std::max(min_chunk_size, 1u), (count + thread_count * 4 - 1) / (thread_count * 4));
+
+        if (m_workers.empty() || chunk_size >= count)
+        {
+            range_function(0, count);
+            return;
+        }
+
+        JobCounter counter;
+        uint32_t   begin = 0;
+        for (; begin + chunk_size < count; begin += chunk_size)
+        {
+            const uint32_t end = begin + chunk_size;
+            run([&range_function, begin, end]() { range_function(begin, end); }, counter);
+        }
+
+        // the submitting thread takes the last chunk itself
+        range_function(begin, count);
+
+        wait(counter);
+    }
+
+    void JobSystem::wait(JobCounter& counter)
+    {
+        waitUntil([&counter]() { return counter.isDone(); });
+    }
+
+    void JobSystem::waitUntil(const std::function<bool()>& is_done)
+    {
+        while (!is_done())
+        {
+            if (!tryExecuteJob())
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void JobSystem::workerLoop(uint32_t worker_index)
+    {
+        t_worker_index = worker_index;
+        t_worker_owner = this;
+
+        while (true)
+        {
+            if (tryExecuteJob())
+                continue;
+
+            std::unique_lock<std::mutex> lock(m_wake_mutex);
+            m_wake_condition.wait(lock, [this]() {
+                return !m_is_running || m_queued_job_count.load(std::memory_order_acquire) > 0;
+            });
+
+            if (!m_is_running)
+                break;
+        }
+
+        t_worker_index = k_invalid_worker_index;
+        t_worker_owner = nullptr;
+    }
+
+    bool JobSystem::popJob(uint32_t queue_index, Job& out_job)
+    {
+        JobQueue&                   queue = *m_queues[queue_index];
+        std::lock_guard<std::mutex> lock_guard(queue.m_mutex);
+        if (queue.m_jobs.empty())
+            return false;
+
+        // LIFO for the owner, the most recently pushed job is the most likely to be hot in cache
+        out_job = std::move(queue.m_jobs.back());
+        queue.m_jobs.pop_back();
+        return true;
+    }
+
+    bool JobSystem::stealJob(uint32_t thief_queue_index, Job& out_job)
+    {
+        const uint32_t queue_count = static_cast<uint32_t>(m_queues.size());
+        for (uint32_t offset = 1; offset < queue_count; ++offset)
+        {
+            JobQueue&                   victim = *m_queues[(thief_queue_index + offset) % queue_count];
+            std::lock_guard<std::mutex> lock_guard(victim.m_mutex);
+            if (victim.m_jobs.empty())
+                continue;
+
+            // FIFO for thieves, the oldest job tends to be the largest remaining piece of work
+            out_job = std::move(victim.m_jobs.front());
+            victim.m_jobs.pop_front();
+            return true;
+        }
+        return false;
+    }
+
+    bool JobSystem::tryExecuteJob()
+    {
+        if (m_queues.empty())
+            return false;
+
+        const uint32_t queue_index = getCurrentQueueIndex();
+
+        Job job;
+        if (!popJob(queue_index, job) && !stealJob(queue_index, job))
+            return false;
+
+        m_queued_job_count.fetch_sub(1, std::memory_order_acq_rel);
+        execute(job);
+        return true;
+    }
+
+    void JobSystem::execute(Job& job)
+    {
+        job.m_function();
+        job.m_counter->m_pending_job_count.fetch_sub(1, std::memory_order_acq_rel);
+    }
+
+    uint32_t JobSystem::getCurrentQueueIndex() const
+    {
+        if (t_worker_owner == this && t_worker_index != k_invalid_worker_index)
+        {
+            return t_worker_index;
+        }
+        return static_cast<uint32_t>(m_queues.size()) - 1;
+    }
+} // namespace Piccolo
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Piccolo
+{
+    using JobFunction      = std::function<void()>;
+    using JobRangeFunction = std::function<void(uint32_t begin, uint32_t end)>;
+
+    /// Tracks the jobs of one submission, wait on it with JobSystem::wait
+    class JobCounter
+    {
+        friend class JobSystem;
+
+    public:
+        bool isDone() const { return m_pending_job_count.load(std::memory_order_acquire) == 0; }
+
+    private:
+        std::atomic<uint32_t> m_pending_job_count {0};
+    };
+
+    /// Work-stealing job scheduler.
+    /// Every worker owns a queue: it pushes and pops jobs at the back of its own queue and steals from the
+    /// front of the other queues when its queue runs dry. Threads that are not workers (the main thread)
+    /// submit into a shared external queue, and help executing jobs while they wait on a counter.
+    class JobSystem
+    {
+        struct Job
+        {
+            JobFunction m_function;
+            JobCounter* m_counter {nullptr};
+        };
+
+        struct JobQueue
+        {
+            std::mutex      m_mutex;
+            std::deque<Job> m_jobs;
+        };
+
+    public:
+        ~JobSystem();
+
+        /// @worker_count: number of worker threads, 0 runs every job inline on the submitting thread
+        void initialize(uint32_t worker_count);
+        void clear();
+
+        uint32_t getWorkerCount() const { return static_cast<uint32_t>(m_workers.size()); }
+
+        static uint32_t getDefaultWorkerCount();
+
+        void run(JobFunction job, JobCounter& counter);
+
+        /// split [0, count) into chunks of at least min_chunk_size and execute them in parallel,
+        /// returns after all chunks are done
+        void parallelFor(uint32_t count, uint32_t min_chunk_size, const JobRangeFunction& range_function);
+
+        /// block until all jobs of the counter are done, the calling thread executes jobs meanwhile
+        void wait(JobCounter& counter);
+
+        /// block until is_done returns true, for work tracked outside of a JobCounter
+        void waitUntil(const std::function<bool()>& is_done);
+
+    private:
+        void workerLoop(uint32_t worker_index);
+
+        bool popJob(uint32_t queue_index, Job& out_job);
+        bool stealJob(uint32_t thief_queue_index, Job& out_job);
+        bool tryExecuteJob();
+        void execute(Job& job);
+
+        uint32_t getCurrentQueueIndex() const;
+
+        std::vector<std::thread>               m_workers;
+        std::vector<std::unique_ptr<JobQueue>> m_queues; // one per worker, the last one is the external queue
+
+        std::mutex              m_wake_mutex;
+        std::condition_variable m_wake_condition;
+        std::atomic<uint32_t>   m_queued_job_count {0};
+        std::atomic<bool>       m_is_running {false};
+    };
+} // namespace Piccolo
@@ -0,0 +1,9 @@
+#pragma once
+
+// SSE2 is part of every x64 target, code using it keeps a scalar path for the other targets
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PICCOLO_SIMD_SSE2 1
+#include <emmintrin.h>
+#else
+#define PICCOLO_SIMD_SSE2 0
+#endif
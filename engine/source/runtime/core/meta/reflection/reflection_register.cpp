@@ -4,9 +4,11 @@
 #include "runtime/core/meta/reflection/reflection.h"
 #include "runtime/core/meta/reflection/reflection_register.h"
 #include "runtime/core/meta/serializer/serializer.h"
+#include "runtime/core/meta/serializer/stream_serializer.h"
 
 #include "_generated/reflection/all_reflection.h"
 #include "_generated/serializer/all_serializer.ipp"
+#include "_generated/serializer/all_stream_serializer.ipp"
 
 namespace Piccolo
 {
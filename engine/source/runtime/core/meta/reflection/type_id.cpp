@@ -0,0 +1,25 @@
+#include "runtime/core/meta/reflection/type_id.h"
+
+#include "_generated/reflection/all_type_id.h"
+
+namespace Piccolo
+{
+    namespace Reflection
+    {
+        ComponentTypeIndex getComponentTypeIndex(const std::string& component_type_name)
+        {
+            for (ComponentTypeIndex type_index = 0; type_index < k_component_type_count; ++type_index)
+            {
+                if (component_type_name == k_component_type_names[type_index])
+                    return type_index;
+            }
+            return k_invalid_component_type_index;
+        }
+
+        ComponentTypeMask getComponentTypeMask(const std::string& component_type_name)
+        {
+            const ComponentTypeIndex type_index = getComponentTypeIndex(component_type_name);
+            return type_index == k_invalid_component_type_index ? 0 : ComponentTypeMask(1) << type_index;
+        }
+    } // namespace Reflection
+} // namespace Piccolo
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <type_traits>
+
+namespace Piccolo
+{
+    namespace Reflection
+    {
+        /// dense id of a reflected class, assigned by the meta parser in _generated/reflection/all_type_id.h
+        using TypeId = uint32_t;
+        /// dense index of a reflected class deriving from Component, used as a bit of ComponentTypeMask
+        using ComponentTypeIndex = uint32_t;
+        using ComponentTypeMask  = uint64_t;
+
+        constexpr TypeId             k_invalid_type_id              = std::numeric_limits<TypeId>::max();
+        constexpr ComponentTypeIndex k_invalid_component_type_index = std::numeric_limits<ComponentTypeIndex>::max();
+        constexpr ComponentTypeIndex k_max_component_type_count     = 64;
+
+        // specialized for every reflected class by the generated all_type_id.h
+        template<typename T>
+        struct TypeIdOf;
+        // specialized for every reflected component class by the generated all_type_id.h
+        template<typename T>
+        struct ComponentTypeIndexOf;
+
+        template<typename T>
+        constexpr TypeId getTypeId()
+        {
+            return TypeIdOf<std::remove_cv_t<T>>::value;
+        }
+
+        template<typename TComponent>
+        constexpr ComponentTypeIndex getComponentTypeIndex()
+        {
+            return ComponentTypeIndexOf<std::remove_cv_t<TComponent>>::value;
+        }
+
+        template<typename TComponent>
+        constexpr ComponentTypeMask getComponentTypeMask()
+        {
+            return ComponentTypeMask(1) << getComponentTypeIndex<TComponent>();
+        }
+
+        /// runtime lookup for type names read from assets, returns k_invalid_component_type_index if the name is not
+        /// a reflected component
+        ComponentTypeIndex getComponentTypeIndex(const std::string& component_type_name);
+        ComponentTypeMask  getComponentTypeMask(const std::string& component_type_name);
+    } // namespace Reflection
+} // namespace Piccolo
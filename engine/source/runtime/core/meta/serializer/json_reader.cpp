@@ -0,0 +1,468 @@
+#include "runtime/core/meta/serializer/json_reader.h"
+
+#include <cstdlib>
+#include <cstring>
+
+namespace Piccolo
+{
+    namespace
+    {
+        // longest number token that is converted through strtod
+        constexpr size_t k_max_number_length = 64;
+        // integers with up to this many digits are exact in a double
+        constexpr size_t k_max_exact_integer_digits = 15;
+
+        bool isWhitespace(char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; }
+
+        bool isNumberCharacter(char c)
+        {
+            return (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E';
+        }
+
+        int getHexDigit(char c)
+        {
+            if (c >= '0' && c <= '9')
+                return c - '0';
+            if (c >= 'a' && c <= 'f')
+                return c - 'a' + 10;
+            if (c >= 'A' && c <= 'F')
+                return c - 'A' + 10;
+            return -1;
+        }
+
+        void appendUtf8(uint32_t code_point, std::string& out)
+        {
+            if (code_point < 0x80)
+            {
+                out.push_back(static_cast<char>(code_point));
+            }
+            else if (code_point < 0x800)
+            {
+                out.push_back(static_cast<char>(0xc0 | (code_point >> 6)));
+                out.push_back(static_cast<char>(0x80 | (code_point & 0x3f)));
+            }
+            else if (code_point < 0x10000)
+            {
+                out.push_back(static_cast<char>(0xe0 | (code_point >> 12)));
+                out.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3f)));
+                out.push_back(static_cast<char>(0x80 | (code_point & 0x3f)));
+            }
+            else
+            {
+                out.push_back(static_cast<char>(0xf0 | (code_point >> 18)));
+                out.push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3f)));
+                out.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3f)));
+                out.push_back(static_cast<char>(0x80 | (code_point & 0x3f)));
+            }
+        }
+    } // namespace
+
+    // same nesting limit as json11
+    const uint32_t JsonReader::s_max_depth = 200;
+
+    JsonReader::JsonReader(const char* text, size_t size) : m_text(text), m_size(text ? size : 0) {}
+
+    JsonReader::ValueType JsonReader::peekType()
+    {
+        skipWhitespace();
+        if (hasError() || m_offset >= m_size)
+            return ValueType::Invalid;
+
+        switch (m_text[m_offset])
+        {
+            case 'n':
+                return ValueType::Null;
+            case 't':
+            case 'f':
+                return ValueType::Bool;
+            case '"':
+                return ValueType::String;
+            case '[':
+                return ValueType::Array;
+            case '{':
+                return ValueType::Object;
+            default:
+                return (m_text[m_offset] == '-' || (m_text[m_offset] >= '0' && m_text[m_offset] <= '9')) ?
+                           ValueType::Number :
+                           ValueType::Invalid;
+        }
+    }
+
+    bool JsonReader::beginObject() { return beginContainer('{', "expected an object"); }
+
+    bool JsonReader::nextMember(std::string_view& member_name)
+    {
+        if (!nextContainerItem('}', "expected ',' or '}'"))
+            return false;
+
+        skipWhitespace();
+        return parseMemberName(member_name) && consume(':', "expected ':'");
+    }
+
+    bool JsonReader::beginArray() { return beginContainer('[', "expected an array"); }
+
+    bool JsonReader::nextElement() { return nextContainerItem(']', "expected ',' or ']'"); }
+
+    bool JsonReader::readNull()
+    {
+        skipWhitespace();
+        return consumeLiteral("null") || fail("expected null");
+    }
+
+    bool JsonReader::readBool(bool& value)
+    {
+        skipWhitespace();
+        if (consumeLiteral("true"))
+        {
+            value = true;
+            return true;
+        }
+        if (consumeLiteral("false"))
+        {
+            value = false;
+            return true;
+        }
+        return fail("expected a bool");
+    }
+
+    bool JsonReader::readNumber(double& value)
+    {
+        skipWhitespace();
+        std::string_view token;
+        if (!scanNumber(token))
+            return false;
+
+        // plain integers are by far the most common numbers outside of the vertex data, convert them directly
+        const bool   is_negative = token[0] == '-';
+        const size_t digit_count = token.size() - (is_negative ? 1 : 0);
+        if (digit_count > 0 && digit_count <= k_max_exact_integer_digits &&
+            token.find_first_not_of("0123456789", is_negative ? 1 : 0) == std::string_view::npos)
+        {
+            int64_t integer = 0;
+            for (size_t index = is_negative ? 1 : 0; index < token.size(); ++index)
+            {
+                integer = integer * 10 + (token[index] - '0');
+            }
+            value = static_cast<double>(is_negative ? -integer : integer);
+            return true;
+        }
+
+        // the text is not null terminated, strtod gets a terminated copy of the token
+        if (token.size() >= k_max_number_length)
+            return fail("number is too long");
+
+        char number_text[k_max_number_length];
+        std::memcpy(number_text, token.data(), token.size());
+        number_text[token.size()] = '\0';
+
+        char* number_end = nullptr;
+        value            = std::strtod(number_text, &number_end);
+        if (number_end != number_text + token.size())
+            return fail("invalid number");
+        return true;
+    }
+
+    bool JsonReader::readString(std::string& value)
+    {
+        skipWhitespace();
+        value.clear();
+        return parseString(&value);
+    }
+
+    bool JsonReader::skipValue()
+    {
+        switch (peekType())
+        {
+            case ValueType::Null:
+                return readNull();
+            case ValueType::Bool:
+            {
+                bool value;
+                return readBool(value);
+            }
+            case ValueType::Number:
+            {
+                std::string_view token;
+                return scanNumber(token);
+            }
+            case ValueType::String:
+                return parseString(nullptr);
+            case ValueType::Array:
+            {
+                if (!beginArray())
+                    return false;
+                while (nextElement())
+                {
+                    if (!skipValue())
+                        return false;
+                }
+                return !hasError();
+            }
+            case ValueType::Object:
+            {
+                if (!beginObject())
+                    return false;
+                std::string_view member_name;
+                while (nextMember(member_name))
+                {
+                    if (!skipValue())
+                        return false;
+                }
+                return !hasError();
+            }
+            default:
+                return fail("expected a value");
+        }
+    }
+
+    bool JsonReader::readRawValue(std::string_view& text)
+    {
+        skipWhitespace();
+        const size_t begin = m_offset;
+        if (!skipValue())
+            return false;
+
+        text = std::string_view(m_text + begin, m_offset - begin);
+        return true;
+    }
+
+    bool JsonReader::finish()
+    {
+        skipWhitespace();
+        if (hasError())
+            return false;
+        return m_offset == m_size || fail("unexpected text after the value");
+    }
+
+    bool JsonReader::fail(const char* error)
+    {
+        if (!m_error)
+        {
+            m_error        = error;
+            m_error_offset = m_offset;
+        }
+        return false;
+    }
+
+    void JsonReader::skipWhitespace()
+    {
+        while (m_offset < m_size && isWhitespace(m_text[m_offset]))
+        {
+            ++m_offset;
+        }
+    }
+
+    bool JsonReader::consume(char expected, const char* error)
+    {
+        skipWhitespace();
+        if (hasError() || m_offset >= m_size || m_text[m_offset] != expected)
+            return fail(error);
+
+        ++m_offset;
+        return true;
+    }
+
+    bool JsonReader::consumeLiteral(std::string_view literal)
+    {
+        if (hasError() || m_size - m_offset < literal.size() ||
+            std::memcmp(m_text + m_offset, literal.data(), literal.size()) != 0)
+            return false;
+
+        m_offset += literal.size();
+        return true;
+    }
+
+    bool JsonReader::parseString(std::string* value)
+    {
+        if (hasError() || m_offset >= m_size || m_text[m_offset] != '"')
+            return fail("expected a string");
+        ++m_offset;
+
+        while (true)
+        {
+            // copy the run up to the next quote or escape at once
+            size_t run_end = m_offset;
+            while (run_end < m_size && m_text[run_end] != '"' && m_text[run_end] != '\\')
+            {
+                if (static_cast<unsigned char>(m_text[run_end]) < 0x20)
+                {
+                    m_offset = run_end;
+                    return fail("control character in string");
+                }
+                ++run_end;
+            }
+            if (value)
+            {
+                value->append(m_text + m_offset, run_end - m_offset);
+            }
+            m_offset = run_end;
+
+            if (m_offset >= m_size)
+                return fail("unterminated string");
+
+            if (m_text[m_offset] == '"')
+            {
+                ++m_offset;
+                return true;
+            }
+
+            // escape sequence
+            if (m_offset + 1 >= m_size)
+                return fail("unterminated string");
+
+            const char escape = m_text[m_offset + 1];
+            m_offset += 2;
+
+            char escaped_character = 0;
+            switch (escape)
+            {
+                case '"':
+                case '\\':
+                case '/':
+                    escaped_character = escape;
+                    break;
+                case 'b':
+                    escaped_character = '\b';
+                    break;
+                case 'f':
+                    escaped_character = '\f';
+                    break;
+                case 'n':
+                    escaped_character = '\n';
+                    break;
+                case 'r':
+                    escaped_character = '\r';
+                    break;
+                case 't':
+                    escaped_character = '\t';
+                    break;
+                case 'u':
+                {
+                    uint32_t code_point = 0;
+                    for (int surrogate = 0; surrogate < 2; ++surrogate)
+                    {
+                        if (m_size - m_offset < 4)
+                            return fail("invalid unicode escape");
+
+                        uint32_t code_unit = 0;
+                        for (size_t digit = 0; digit < 4; ++digit)
+                        {
+                            const int hex_digit = getHexDigit(m_text[m_offset + digit]);
+                            if (hex_digit < 0)
+                                return fail("invalid unicode escape");
+                            code_unit = (code_unit << 4) | static_cast<uint32_t>(hex_digit);
+                        }
+                        m_offset += 4;
+
+                        if (surrogate == 0)
+                        {
+                            code_point = code_unit;
+                            // a high surrogate has to be followed by an escaped low surrogate
+                            if (code_unit < 0xd800 || code_unit > 0xdbff)
+                                break;
+                            if (m_size - m_offset < 2 || m_text[m_offset] != '\\' || m_text[m_offset + 1] != 'u')
+                                return fail("invalid unicode escape");
+                            m_offset += 2;
+                        }
+                        else
+                        {
+                            if (code_unit < 0xdc00 || code_unit > 0xdfff)
+                                return fail("invalid unicode escape");
+                            code_point = 0x10000 + ((code_point - 0xd800) << 10) + (code_unit - 0xdc00);
+                        }
+                    }
+                    if (value)
+                    {
+                        appendUtf8(code_point, *value);
+                    }
+                    continue;
+                }
+                default:
+                    return fail("invalid escape");
+            }
+            if (value)
+            {
+                value->push_back(escaped_character);
+            }
+        }
+    }
+
+    bool JsonReader::parseMemberName(std::string_view& member_name)
+    {
+        if (hasError() || m_offset >= m_size || m_text[m_offset] != '"')
+            return fail("expected a member name");
+
+        // names without escapes are used in place
+        const size_t name_begin = m_offset + 1;
+        size_t       name_end   = name_begin;
+        while (name_end < m_size && m_text[name_end] != '"' && m_text[name_end] != '\\')
+        {
+            ++name_end;
+        }
+        if (name_end < m_size && m_text[name_end] == '"')
+        {
+            member_name = std::string_view(m_text + name_begin, name_end - name_begin);
+            m_offset    = name_end + 1;
+            return true;
+        }
+
+        m_member_name.clear();
+        if (!parseString(&m_member_name))
+            return false;
+        member_name = m_member_name;
+        return true;
+    }
+
+    bool JsonReader::scanNumber(std::string_view& token)
+    {
+        if (hasError())
+            return false;
+
+        const size_t begin = m_offset;
+        while (m_offset < m_size && isNumberCharacter(m_text[m_offset]))
+        {
+            ++m_offset;
+        }
+        if (m_offset == begin)
+            return fail("expected a number");
+
+        token = std::string_view(m_text + begin, m_offset - begin);
+        return true;
+    }
+
+    bool JsonReader::beginContainer(char open, const char* error)
+    {
+        if (!consume(open, error))
+            return false;
+        if (m_is_first_item.size() >= s_max_depth)
+            return fail("json is nested too deeply");
+
+        m_is_first_item.push_back(true);
+        return true;
+    }
+
+    bool JsonReader::nextContainerItem(char close, const char* error)
+    {
+        skipWhitespace();
+        if (hasError() || m_is_first_item.empty())
+            return false;
+        if (m_offset >= m_size)
+            return fail(error);
+
+        if (m_text[m_offset] == close)
+        {
+            ++m_offset;
+            m_is_first_item.pop_back();
+            return false;
+        }
+
+        if (!m_is_first_item.back())
+        {
+            if (m_text[m_offset] != ',')
+                return fail(error);
+            ++m_offset;
+        }
+        m_is_first_item.back() = false;
+        return true;
+    }
+} // namespace Piccolo
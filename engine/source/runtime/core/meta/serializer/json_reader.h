@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Piccolo
+{
+    /// Pull parser over json text that stays where it is, e.g. in a mapped file. StreamSerializer uses it to read
+    /// assets straight into the reflected types without building a json11 document first.
+    /// The first error stops the parse: every later call fails and the error and its offset are kept for the log.
+    class JsonReader
+    {
+    public:
+        enum class ValueType : uint8_t
+        {
+            Null,
+            Bool,
+            Number,
+            String,
+            Array,
+            Object,
+            Invalid
+        };
+
+        JsonReader(const char* text, size_t size);
+
+        /// type of the next value, Invalid at the end of the text or after an error
+        ValueType peekType();
+
+        bool beginObject();
+        /// false at the closing brace, otherwise the value of the member is the next value
+        bool nextMember(std::string_view& member_name);
+        bool beginArray();
+        /// false at the closing bracket, otherwise the element is the next value
+        bool nextElement();
+
+        bool readNull();
+        bool readBool(bool& value);
+        bool readNumber(double& value);
+        bool readString(std::string& value);
+        bool skipValue();
+        /// text of the next value without parsing it, for values that still go through a json11 document
+        bool readRawValue(std::string_view& text);
+        /// only whitespace may follow the top level value
+        bool finish();
+
+        /// stops the parse, returns false so that callers can return it directly
+        bool fail(const char* error);
+
+        bool        hasError() const { return m_error != nullptr; }
+        const char* getError() const { return m_error ? m_error : ""; }
+        size_t      getErrorOffset() const { return m_error_offset; }
+
+    private:
+        static const uint32_t s_max_depth;
+
+        void skipWhitespace();
+        bool consume(char expected, const char* error);
+        bool consumeLiteral(std::string_view literal);
+        // value is null when the string is skipped
+        bool parseString(std::string* value);
+        bool parseMemberName(std::string_view& member_name);
+        bool scanNumber(std::string_view& token);
+        bool beginContainer(char open, const char* error);
+        bool nextContainerItem(char close, const char* error);
+
+        const char* m_text {nullptr};
+        size_t      m_size {0};
+        size_t      m_offset {0};
+
+        const char* m_error {nullptr};
+        size_t      m_error_offset {0};
+
+        // one entry per open object or array, set until its first item is read
+        std::vector<bool> m_is_first_item;
+        // member names with escapes are decoded into here, the others point into the text
+        std::string m_member_name;
+    };
+} // namespace Piccolo
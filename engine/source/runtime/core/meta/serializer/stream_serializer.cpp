@@ -0,0 +1,62 @@
+#include "runtime/core/meta/serializer/stream_serializer.h"
+
+namespace Piccolo
+{
+    template<>
+    bool StreamSerializer::read(JsonReader& reader, char& instance)
+    {
+        double value;
+        if (!reader.readNumber(value))
+            return false;
+        instance = static_cast<char>(value);
+        return true;
+    }
+
+    template<>
+    bool StreamSerializer::read(JsonReader& reader, int& instance)
+    {
+        double value;
+        if (!reader.readNumber(value))
+            return false;
+        instance = static_cast<int>(value);
+        return true;
+    }
+
+    template<>
+    bool StreamSerializer::read(JsonReader& reader, unsigned int& instance)
+    {
+        double value;
+        if (!reader.readNumber(value))
+            return false;
+        instance = static_cast<unsigned int>(value);
+        return true;
+    }
+
+    template<>
+    bool StreamSerializer::read(JsonReader& reader, float& instance)
+    {
+        double value;
+        if (!reader.readNumber(value))
+            return false;
+        instance = static_cast<float>(value);
+        return true;
+    }
+
+    template<>
+    bool StreamSerializer::read(JsonReader& reader, double& instance)
+    {
+        return reader.readNumber(instance);
+    }
+
+    template<>
+    bool StreamSerializer::read(JsonReader& reader, bool& instance)
+    {
+        return reader.readBool(instance);
+    }
+
+    template<>
+    bool StreamSerializer::read(JsonReader& reader, std::string& instance)
+    {
+        return reader.readString(instance);
+    }
+} // namespace Piccolo
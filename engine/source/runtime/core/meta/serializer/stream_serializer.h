@@ -0,0 +1,110 @@
+#pragma once
+#include "runtime/core/meta/serializer/json_reader.h"
+#include "runtime/core/meta/serializer/serializer.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Piccolo
+{
+    /// Reads json straight into reflected types while JsonReader walks the text, the counterpart of Serializer::read
+    /// without the intermediate Json document. readMember is generated per reflected class next to the Serializer
+    /// specializations. Members missing from the text or set to null keep their value, unknown members are skipped.
+    class StreamSerializer
+    {
+    public:
+        template<typename T>
+        static bool read(JsonReader& reader, T& instance)
+        {
+            if constexpr (std::is_pointer<T>::value)
+            {
+                return readThroughDocument(reader, instance);
+            }
+            else
+            {
+                if (!reader.beginObject())
+                    return false;
+
+                std::string_view member_name;
+                while (reader.nextMember(member_name))
+                {
+                    if (reader.peekType() == JsonReader::ValueType::Null)
+                    {
+                        reader.readNull();
+                    }
+                    else if (!readMember(reader, member_name, instance))
+                    {
+                        reader.skipValue();
+                    }
+                    if (reader.hasError())
+                        return false;
+                }
+                return !reader.hasError();
+            }
+        }
+
+        template<typename T>
+        static bool read(JsonReader& reader, std::vector<T>& instance)
+        {
+            instance.clear();
+            if (!reader.beginArray())
+                return false;
+
+            while (reader.nextElement())
+            {
+                if (!read(reader, instance.emplace_back()))
+                    return false;
+            }
+            return !reader.hasError();
+        }
+
+        // the concrete type is only known from "$typeName", these few values still go through a Json document
+        template<typename T>
+        static bool read(JsonReader& reader, Reflection::ReflectionPtr<T>& instance)
+        {
+            return readThroughDocument(reader, instance);
+        }
+
+        /// reads the value of member_name into instance, false if the type has no such member
+        template<typename T>
+        static bool readMember(JsonReader& reader, std::string_view member_name, T& instance)
+        {
+            static_assert(always_false<T>, "StreamSerializer::readMember<T> has not been implemented yet!");
+            return false;
+        }
+
+    private:
+        template<typename T>
+        static bool readThroughDocument(JsonReader& reader, T& instance)
+        {
+            std::string_view value_text;
+            if (!reader.readRawValue(value_text))
+                return false;
+
+            std::string error;
+            auto&&      value_json = Json::parse(std::string(value_text), error);
+            if (!error.empty())
+                return reader.fail("invalid json value");
+
+            Serializer::read(value_json, instance);
+            return true;
+        }
+    };
+
+    // implementation of base types
+    template<>
+    bool StreamSerializer::read(JsonReader& reader, char& instance);
+    template<>
+    bool StreamSerializer::read(JsonReader& reader, int& instance);
+    template<>
+    bool StreamSerializer::read(JsonReader& reader, unsigned int& instance);
+    template<>
+    bool StreamSerializer::read(JsonReader& reader, float& instance);
+    template<>
+    bool StreamSerializer::read(JsonReader& reader, double& instance);
+    template<>
+    bool StreamSerializer::read(JsonReader& reader, bool& instance);
+    template<>
+    bool StreamSerializer::read(JsonReader& reader, std::string& instance);
+} // namespace Piccolo
@@ -3,19 +3,25 @@
 #include "runtime/core/base/macro.h"
 #include "runtime/core/meta/reflection/reflection_register.h"
 
+#include "runtime/function/animation/animation_system.h"
 #include "runtime/function/framework/world/world_manager.h"
 #include "runtime/function/global/global_context.h"
 #include "runtime/function/input/input_system.h"
 #include "runtime/function/particle/particle_manager.h"
 #include "runtime/function/physics/physics_manager.h"
+#include "runtime/function/physics/physics_scene.h"
 #include "runtime/function/render/render_system.h"
 #include "runtime/function/render/window_system.h"
 #include "runtime/function/render/debugdraw/debug_draw_manager.h"
 
+#include "runtime/resource/config_manager/config_manager.h"
+
+#include <algorithm>
+
 namespace Piccolo
 {
-    bool                            g_is_editor_mode {false};
-    std::unordered_set<std::string> g_editor_tick_component_types {};
+    bool                          g_is_editor_mode {false};
+    Reflection::ComponentTypeMask g_editor_tick_component_mask {0};
 
     void PiccoloEngine::startEngine(const std::string& config_file_path)
     {
@@ -43,10 +49,146 @@ namespace Piccolo
         std::shared_ptr<WindowSystem> window_system = g_runtime_global_context.m_window_system;
         ASSERT(window_system);
 
-        while (!window_system->shouldClose())
+        // the editor ticks through tickOneFrame and stays single threaded, its ui runs inside the render tick and
+        // edits the logic state
+        if (g_runtime_global_context.m_config_manager->isRenderThreadEnabled())
+        {
+            startRenderThread();
+        }
+
+        if (window_system->isHeadless())
+        {
+            runHeadless();
+        }
+        else
         {
-            const float delta_time = calculateDeltaTime();
-            tickOneFrame(delta_time);
+            while (!window_system->shouldClose())
+            {
+                const float delta_time = calculateDeltaTime();
+                tickOneFrame(delta_time);
+            }
+        }
+
+        stopRenderThread();
+    }
+
+    void PiccoloEngine::runHeadless()
+    {
+        using namespace std::chrono;
+
+        // every frame advances the same time, two runs over the same world tick the same simulation and their cpu
+        // timings can be compared frame by frame
+        const uint32_t frame_count = g_runtime_global_context.m_config_manager->getHeadlessFrameCount();
+        LOG_INFO("headless run, {} frames", frame_count);
+
+        float    cpu_time_sum {0.f};
+        float    cpu_time_max {0.f};
+        uint32_t frame_index {0};
+
+        uint32_t physics_step_count {0};
+        uint32_t physics_dropped_step_count {0};
+        float    physics_step_time_sum {0.f};
+
+        uint64_t animation_full_update_count {0};
+        uint64_t animation_interpolated_update_count {0};
+        uint64_t animation_saved_time_us {0};
+        while (frame_count == 0 || frame_index < frame_count)
+        {
+            const steady_clock::time_point frame_start = steady_clock::now();
+            if (!tickOneFrame(s_headless_delta_time))
+                break;
+            const float cpu_time = duration<float>(steady_clock::now() - frame_start).count();
+
+            cpu_time_sum += cpu_time;
+            cpu_time_max = std::max(cpu_time_max, cpu_time);
+            frame_index++;
+
+            std::shared_ptr<PhysicsScene> physics_scene =
+                g_runtime_global_context.m_world_manager->getCurrentActivePhysicsScene().lock();
+            if (physics_scene)
+            {
+                const PhysicsStepStats& physics_stats = physics_scene->getStepStats();
+                physics_step_count += physics_stats.m_step_count;
+                physics_dropped_step_count += physics_stats.m_dropped_step_count;
+                physics_step_time_sum += physics_stats.m_step_time_ms;
+            }
+
+            const AnimationLodStats& animation_stats = AnimationManager::getLodStats();
+            animation_full_update_count += animation_stats.m_full_update_count;
+            animation_interpolated_update_count += animation_stats.m_interpolated_update_count;
+            animation_saved_time_us += animation_stats.m_saved_time_us;
+        }
+
+        const FrameTimingStats& stats = m_frame_timing_stats;
+        LOG_INFO("headless run done, {} frames, cpu time per frame {:.3f} ms average, {:.3f} ms max, logic {:.3f} ms, "
+                 "render {:.3f} ms",
+                 frame_index,
+                 frame_index > 0 ? cpu_time_sum * 1000.f / frame_index : 0.f,
+                 cpu_time_max * 1000.f,
+                 stats.m_logic_time * 1000.f,
+                 stats.m_render_time * 1000.f);
+        LOG_INFO("physics {} steps, {:.2f} steps and {:.3f} ms per frame, {} steps dropped",
+                 physics_step_count,
+                 frame_index > 0 ? static_cast<float>(physics_step_count) / frame_index : 0.f,
+                 frame_index > 0 ? physics_step_time_sum / frame_index : 0.f,
+                 physics_dropped_step_count);
+        LOG_INFO("animation {} full and {} interpolated updates, about {:.3f} ms per frame saved by the lod",
+                 animation_full_update_count,
+                 animation_interpolated_update_count,
+                 frame_index > 0 ? animation_saved_time_us / 1000.f / frame_index : 0.f);
+    }
+
+    void PiccoloEngine::startRenderThread()
+    {
+        ASSERT(!m_is_render_thread_running);
+
+        m_is_render_thread_enabled = true;
+        m_is_render_thread_running.store(true, std::memory_order_release);
+        m_render_thread = std::thread(&PiccoloEngine::renderThreadMain, this);
+
+        LOG_INFO("render thread started, pipeline depth {}",
+                 g_runtime_global_context.m_render_system->getSwapContext().getPipelineDepth());
+    }
+
+    void PiccoloEngine::stopRenderThread()
+    {
+        if (!m_is_render_thread_enabled)
+            return;
+
+        m_is_render_thread_running.store(false, std::memory_order_release);
+        g_runtime_global_context.m_render_system->getRHI()->requestShutdown();
+        if (m_render_thread.joinable())
+        {
+            m_render_thread.join();
+        }
+        m_is_render_thread_enabled = false;
+    }
+
+    void PiccoloEngine::renderThreadMain()
+    {
+        using namespace std::chrono;
+
+        RenderSwapContext&       swap_context         = g_runtime_global_context.m_render_system->getSwapContext();
+        steady_clock::time_point last_tick_time_point = steady_clock::now();
+        steady_clock::time_point wait_start           = last_tick_time_point;
+
+        while (m_is_render_thread_running.load(std::memory_order_acquire))
+        {
+            // every frame renders at least one new packet of the logic side, the timeout only rechecks the stop
+            // request
+            if (!swap_context.waitForRenderSwapData(s_render_thread_wait_timeout))
+                continue;
+
+            const steady_clock::time_point render_start = steady_clock::now();
+            const float                    delta_time = duration<float>(render_start - last_tick_time_point).count();
+            last_tick_time_point                       = render_start;
+
+            rendererTick(delta_time);
+
+            m_render_thread_wait_time.store(duration<float>(render_start - wait_start).count(),
+                                            std::memory_order_relaxed);
+            wait_start = steady_clock::now();
+            m_render_thread_time.store(duration<float>(wait_start - render_start).count(), std::memory_order_relaxed);
         }
     }
 
@@ -67,14 +209,31 @@ namespace Piccolo
 
     bool PiccoloEngine::tickOneFrame(float delta_time)
     {
+        using namespace std::chrono;
+
+        const steady_clock::time_point logic_start = steady_clock::now();
         logicalTick(delta_time);
+        const float logic_time = duration<float>(steady_clock::now() - logic_start).count();
+
         calculateFPS(delta_time);
 
-        // single thread
-        // exchange data between logic and render contexts
-        g_runtime_global_context.m_render_system->swapLogicRenderData();
+        // publish the frame packet of the logic side, this only waits when the render side is pipeline depth
+        // frames behind
+        const float logic_wait_time = g_runtime_global_context.m_render_system->swapLogicRenderData();
+
+        if (!m_is_render_thread_enabled)
+        {
+            const steady_clock::time_point render_start = steady_clock::now();
+            rendererTick(delta_time);
+            m_render_thread_time.store(duration<float>(steady_clock::now() - render_start).count(),
+                                       std::memory_order_relaxed);
+
+            // the editor moves the render camera directly, logic reads it through the logic camera
+            std::shared_ptr<RenderSystem> render_system = g_runtime_global_context.m_render_system;
+            render_system->getSwapContext().syncLogicCamera(*render_system->getRenderCamera());
+        }
 
-        rendererTick(delta_time);
+        updateFrameTimingStats(delta_time, logic_time, logic_wait_time);
 
 #ifdef ENABLE_PHYSICS_DEBUG_RENDERER
         g_runtime_global_context.m_physics_manager->renderPhysicsWorld(delta_time);
@@ -82,9 +241,22 @@ namespace Piccolo
 
         g_runtime_global_context.m_window_system->pollEvents();
 
-
-        g_runtime_global_context.m_window_system->setTitle(
-            std::string("Piccolo - " + std::to_string(getFPS()) + " FPS").c_str());
+        if (m_is_render_thread_enabled)
+        {
+            // milliseconds of logic, render and the estimated part of them that ran in parallel
+            const FrameTimingStats& stats = m_frame_timing_stats;
+            g_runtime_global_context.m_window_system->setTitle(
+                std::string("Piccolo - " + std::to_string(getFPS()) + " FPS - logic " +
+                            std::to_string(static_cast<int>(stats.m_logic_time * 1000.f)) + " ms, render " +
+                            std::to_string(static_cast<int>(stats.m_render_time * 1000.f)) + " ms, overlap ~" +
+                            std::to_string(static_cast<int>(stats.m_estimated_overlap_time * 1000.f)) + " ms")
+                    .c_str());
+        }
+        else
+        {
+            g_runtime_global_context.m_window_system->setTitle(
+                std::string("Piccolo - " + std::to_string(getFPS()) + " FPS").c_str());
+        }
 
         const bool should_window_close = g_runtime_global_context.m_window_system->shouldClose();
         return !should_window_close;
@@ -92,6 +264,9 @@ namespace Piccolo
 
     void PiccoloEngine::logicalTick(float delta_time)
     {
+        // the animation lod stats count the updates of one frame
+        AnimationManager::getLodStats().reset();
+
         g_runtime_global_context.m_world_manager->tick(delta_time);
         g_runtime_global_context.m_input_system->tick();
     }
@@ -102,7 +277,9 @@ namespace Piccolo
         return true;
     }
 
-    const float PiccoloEngine::s_fps_alpha = 1.f / 100;
+    const float PiccoloEngine::s_fps_alpha                  = 1.f / 100;
+    const float PiccoloEngine::s_render_thread_wait_timeout = 0.01f;
+    const float PiccoloEngine::s_headless_delta_time        = 1.f / 60;
     void        PiccoloEngine::calculateFPS(float delta_time)
     {
         m_frame_count++;
@@ -118,4 +295,27 @@ namespace Piccolo
 
         m_fps = static_cast<int>(1.f / m_average_duration);
     }
+
+    void PiccoloEngine::updateFrameTimingStats(float delta_time, float logic_time, float logic_wait_time)
+    {
+        const float render_time      = m_render_thread_time.load(std::memory_order_relaxed);
+        const float render_wait_time = m_render_thread_wait_time.load(std::memory_order_relaxed);
+        // single threaded the frame is the sum of both, with the render thread everything above the frame time is
+        // assumed to have run in parallel. The render time is the one of the last rendered packet, not of the
+        // interval the logic ran in, so this is an estimate
+        const float estimated_overlap_time = std::max(logic_time + render_time - delta_time, 0.f);
+
+        FrameTimingStats& stats = m_frame_timing_stats;
+        const float       alpha = m_frame_count == 1 ? 1.f : s_fps_alpha;
+
+        stats.m_frame_time       = stats.m_frame_time * (1 - alpha) + delta_time * alpha;
+        stats.m_logic_time       = stats.m_logic_time * (1 - alpha) + logic_time * alpha;
+        stats.m_logic_wait_time  = stats.m_logic_wait_time * (1 - alpha) + logic_wait_time * alpha;
+        stats.m_render_time      = stats.m_render_time * (1 - alpha) + render_time * alpha;
+        stats.m_render_wait_time = stats.m_render_wait_time * (1 - alpha) + render_wait_time * alpha;
+        stats.m_estimated_overlap_time =
+            stats.m_estimated_overlap_time * (1 - alpha) + estimated_overlap_time * alpha;
+        stats.m_frames_in_flight =
+            g_runtime_global_context.m_render_system->getSwapContext().getPendingPacketCount();
+    }
 } // namespace Piccolo
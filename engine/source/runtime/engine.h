@@ -4,18 +4,35 @@
 #include <chrono>
 #include <filesystem>
 #include <string>
-#include <unordered_set>
+#include <thread>
+
+#include "runtime/core/meta/reflection/type_id.h"
 
 namespace Piccolo
 {
-    extern bool                            g_is_editor_mode;
-    extern std::unordered_set<std::string> g_editor_tick_component_types;
+    extern bool                          g_is_editor_mode;
+    extern Reflection::ComponentTypeMask g_editor_tick_component_mask;
+
+    /// Smoothed per frame timings in seconds. With the render thread the logic and render times overlap. The overlap
+    /// is estimated as the part of them that did not add to the frame time, the intervals are not intersected.
+    struct FrameTimingStats
+    {
+        float    m_frame_time {0.f};
+        float    m_logic_time {0.f};
+        float    m_logic_wait_time {0.f};
+        float    m_render_time {0.f};
+        float    m_render_wait_time {0.f};
+        float    m_estimated_overlap_time {0.f};
+        uint32_t m_frames_in_flight {0};
+    };
 
     class PiccoloEngine
     {
         friend class PiccoloEditor;
 
         static const float s_fps_alpha;
+        static const float s_render_thread_wait_timeout;
+        static const float s_headless_delta_time;
 
     public:
         void startEngine(const std::string& config_file_path);
@@ -30,11 +47,21 @@ namespace Piccolo
 
         int getFPS() const { return m_fps; }
 
+        const FrameTimingStats& getFrameTimingStats() const { return m_frame_timing_stats; }
+
     protected:
         void logicalTick(float delta_time);
         bool rendererTick(float delta_time);
 
         void calculateFPS(float delta_time);
+        void updateFrameTimingStats(float delta_time, float logic_time, float logic_wait_time);
+
+        void startRenderThread();
+        void stopRenderThread();
+        void renderThreadMain();
+
+        // ticks with a fixed frame time and logs the per frame cpu timings, used with the null rhi
+        void runHeadless();
 
         /**
          *  Each frame can only be called once
@@ -49,6 +76,15 @@ namespace Piccolo
         float m_average_duration {0.f};
         int   m_frame_count {0};
         int   m_fps {0};
+
+        bool              m_is_render_thread_enabled {false};
+        std::thread       m_render_thread;
+        std::atomic<bool> m_is_render_thread_running {false};
+        // last frame of the render thread, published for the timing stats
+        std::atomic<float> m_render_thread_time {0.f};
+        std::atomic<float> m_render_thread_wait_time {0.f};
+
+        FrameTimingStats m_frame_timing_stats;
     };
 
 } // namespace Piccolo
@@ -2,6 +2,7 @@
 #include "runtime/function/animation/animation_loader.h"
 
 #include "runtime/resource/asset_manager/asset_manager.h"
+#include "runtime/resource/config_manager/config_manager.h"
 #include "runtime/resource/res_type/data/animation_clip.h"
 #include "runtime/resource/res_type/data/skeleton_mask.h"
 
@@ -78,6 +79,46 @@ namespace Piccolo
         return std::make_shared<Piccolo::AnimationClip>(animation_clip.clip_data);
     }
 
+    std::shared_ptr<CookedAnimationClip> AnimationLoader::loadCookedAnimationClip(std::string animation_clip_url)
+    {
+        const std::filesystem::path clip_path =
+            g_runtime_global_context.m_asset_manager->getFullPath(animation_clip_url);
+        std::filesystem::path cooked_clip_path = clip_path;
+        cooked_clip_path.replace_extension(".cooked");
+
+        std::shared_ptr<CookedAnimationClip> cooked_clip = std::make_shared<CookedAnimationClip>();
+
+        std::error_code error_code;
+        const bool      is_cooked_clip_valid =
+            std::filesystem::exists(cooked_clip_path, error_code) &&
+            (!std::filesystem::exists(clip_path, error_code) ||
+             std::filesystem::last_write_time(cooked_clip_path, error_code) >=
+                 std::filesystem::last_write_time(clip_path, error_code));
+        std::shared_ptr<ConfigManager> config_manager = g_runtime_global_context.m_config_manager;
+        if (is_cooked_clip_valid && cooked_clip->loadFromFile(cooked_clip_path) &&
+            cooked_clip->getKeyTolerance() == config_manager->getAnimationKeyTolerance())
+        {
+            return cooked_clip;
+        }
+
+        std::shared_ptr<AnimationClip> clip = loadAnimationClipData(animation_clip_url);
+
+        std::vector<uint8_t>           cooked_bytes;
+        AnimationClipCooker::cook(*clip, config_manager->getAnimationKeyTolerance(), cooked_bytes);
+        LOG_INFO("cooked animation clip {}: {} bytes -> {} bytes",
+                 animation_clip_url,
+                 AnimationClipCooker::getClipMemorySize(*clip),
+                 cooked_bytes.size());
+
+        if (config_manager->shouldSaveCookedAnimation())
+        {
+            AnimationClipCooker::save(cooked_bytes, cooked_clip_path);
+        }
+
+        cooked_clip->loadFromMemory(std::move(cooked_bytes));
+        return cooked_clip;
+    }
+
     std::shared_ptr<Piccolo::SkeletonData> AnimationLoader::loadSkeletonData(std::string skeleton_data_url)
     {
         SkeletonData data;
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "runtime/function/animation/cooked_animation_clip.h"
 #include "runtime/resource/res_type/data/animation_clip.h"
 #include "runtime/resource/res_type/data/animation_skeleton_node_map.h"
 #include "runtime/resource/res_type/data/skeleton_data.h"
@@ -14,6 +15,8 @@ namespace Piccolo
     {
     public:
         std::shared_ptr<AnimationClip> loadAnimationClipData(std::string animation_clip_url);
+        // maps the cooked clip next to the json clip if it is up to date, cooks the json clip otherwise
+        std::shared_ptr<CookedAnimationClip> loadCookedAnimationClip(std::string animation_clip_url);
         std::shared_ptr<SkeletonData>  loadSkeletonData(std::string skeleton_data_url);
         std::shared_ptr<AnimSkelMap>   loadAnimSkelMap(std::string anim_skel_map_url);
         std::shared_ptr<BoneBlendMask> loadSkeletonMask(std::string skeleton_mask_file_url);
@@ -2,19 +2,28 @@
 #include "runtime/core/math/vector3.h"
 #include "runtime/core/math/quaternion.h"
 
+#include "runtime/core/base/macro.h"
+
 #include "runtime/function/animation/animation_loader.h"
 #include "runtime/function/animation/skeleton.h"
 #include "runtime/function/animation/utilities.h"
 
+#include <algorithm>
+
 namespace Piccolo
 {
     std::map<std::string, std::shared_ptr<SkeletonData>>  AnimationManager::m_skeleton_definition_cache;
     std::map<std::string, std::shared_ptr<AnimationClip>> AnimationManager::m_animation_data_cache;
+    std::map<std::string, std::shared_ptr<CookedAnimationClip>> AnimationManager::m_cooked_animation_cache;
     std::map<std::string, std::shared_ptr<AnimSkelMap>>   AnimationManager::m_animation_skeleton_map_cache;
     std::map<std::string, std::shared_ptr<BoneBlendMask>> AnimationManager::m_skeleton_mask_cache;
+    std::recursive_mutex                                   AnimationManager::m_cache_mutex;
+    AnimationLodStats                                      AnimationManager::m_lod_stats;
 
     std::shared_ptr<SkeletonData> AnimationManager::tryLoadSkeleton(std::string file_path)
     {
+        std::lock_guard<std::recursive_mutex> lock_guard(m_cache_mutex);
+
         std::shared_ptr<SkeletonData> res;
         AnimationLoader               loader;
         auto                          found = m_skeleton_definition_cache.find(file_path);
@@ -32,6 +41,8 @@ namespace Piccolo
 
     std::shared_ptr<AnimationClip> AnimationManager::tryLoadAnimation(std::string file_path)
     {
+        std::lock_guard<std::recursive_mutex> lock_guard(m_cache_mutex);
+
         std::shared_ptr<AnimationClip> res;
         AnimationLoader                loader;
         auto                           found = m_animation_data_cache.find(file_path);
@@ -47,8 +58,29 @@ namespace Piccolo
         return res;
     }
 
+    std::shared_ptr<CookedAnimationClip> AnimationManager::tryLoadCookedAnimation(std::string file_path)
+    {
+        std::lock_guard<std::recursive_mutex> lock_guard(m_cache_mutex);
+
+        std::shared_ptr<CookedAnimationClip> res;
+        AnimationLoader                      loader;
+        auto                                 found = m_cooked_animation_cache.find(file_path);
+        if (found == m_cooked_animation_cache.end())
+        {
+            res = loader.loadCookedAnimationClip(file_path);
+            m_cooked_animation_cache.emplace(file_path, res);
+        }
+        else
+        {
+            res = found->second;
+        }
+        return res;
+    }
+
     std::shared_ptr<AnimSkelMap> AnimationManager::tryLoadAnimationSkeletonMap(std::string file_path)
     {
+        std::lock_guard<std::recursive_mutex> lock_guard(m_cache_mutex);
+
         std::shared_ptr<AnimSkelMap> res;
         AnimationLoader              loader;
         auto                         found = m_animation_skeleton_map_cache.find(file_path);
@@ -66,6 +98,8 @@ namespace Piccolo
 
     std::shared_ptr<BoneBlendMask> AnimationManager::tryLoadSkeletonMask(std::string file_path)
     {
+        std::lock_guard<std::recursive_mutex> lock_guard(m_cache_mutex);
+
         std::shared_ptr<BoneBlendMask> res;
         AnimationLoader                loader;
         auto                           found = m_skeleton_mask_cache.find(file_path);
@@ -81,72 +115,133 @@ namespace Piccolo
         return res;
     }
 
-    BlendStateWithClipData AnimationManager::getBlendStateWithClipData(const BlendState& blend_state)
+    void AnimationManager::updateBlendStateCache(const BlendState& blend_state, BlendStateCache& out_cache)
     {
-        for (auto animation_file_path : blend_state.blend_clip_file_path)
-        {
-            tryLoadAnimation(animation_file_path);
-        }
-        for (auto anim_skel_map_path : blend_state.blend_anim_skel_map_path)
+        if (!out_cache.isBuiltFrom(blend_state))
         {
-            tryLoadAnimationSkeletonMap(anim_skel_map_path);
+            rebuildBlendStateCache(blend_state, out_cache);
         }
-        for (auto skeleton_mask_path : blend_state.blend_mask_file_path)
+        out_cache.m_blend_ratios.assign(blend_state.blend_ratio.begin(), blend_state.blend_ratio.end());
+    }
+
+    void AnimationManager::rebuildBlendStateCache(const BlendState& blend_state, BlendStateCache& out_cache)
+    {
+        std::vector<std::shared_ptr<BoneBlendMask>> blend_masks;
+        std::shared_ptr<SkeletonData>               mask_skeleton;
+
+        out_cache.m_blend_clips.clear();
+        out_cache.m_blend_anim_skel_maps.clear();
         {
-            tryLoadSkeletonMask(skeleton_mask_path);
+            // only hold the lock while touching the caches, the cached data itself is never modified
+            std::lock_guard<std::recursive_mutex> lock_guard(m_cache_mutex);
+
+            for (const auto& animation_file_path : blend_state.blend_clip_file_path)
+            {
+                out_cache.m_blend_clips.push_back(tryLoadCookedAnimation(animation_file_path));
+            }
+            for (const auto& anim_skel_map_path : blend_state.blend_anim_skel_map_path)
+            {
+                out_cache.m_blend_anim_skel_maps.push_back(tryLoadAnimationSkeletonMap(anim_skel_map_path));
+            }
+            for (const auto& skeleton_mask_path : blend_state.blend_mask_file_path)
+            {
+                blend_masks.push_back(tryLoadSkeletonMask(skeleton_mask_path));
+            }
+            if (!blend_masks.empty())
+            {
+                mask_skeleton = tryLoadSkeleton(blend_masks[0]->skeleton_file_path);
+            }
         }
 
-        BlendStateWithClipData blend_state_with_clip_data;
-        blend_state_with_clip_data.clip_count  = blend_state.clip_count;
-        blend_state_with_clip_data.blend_ratio = blend_state.blend_ratio;
-        for (const auto& iter : blend_state.blend_clip_file_path)
+        // clips without all of their data are not sampled
+        const size_t clip_count = std::min({static_cast<size_t>(std::max(blend_state.clip_count, 0)),
+                                            out_cache.m_blend_clips.size(),
+                                            out_cache.m_blend_anim_skel_maps.size(),
+                                            blend_state.blend_ratio.size()});
+        out_cache.m_clip_count = static_cast<int>(clip_count);
+
+        auto is_additive = [&blend_state](size_t clip_index) {
+            return clip_index < blend_state.blend_is_additive.size() && blend_state.blend_is_additive[clip_index] != 0;
+        };
+        auto get_clip_weight = [&blend_state](size_t clip_index) {
+            return clip_index < blend_state.blend_weight.size() ? blend_state.blend_weight[clip_index] : 0.f;
+        };
+
+        // additive clips keep their own weight, the other clips are normalized to sum up to one
+        float override_weight_sum = 0;
+        out_cache.m_is_additive.resize(clip_count);
+        for (size_t clip_index = 0; clip_index < clip_count; clip_index++)
         {
-            blend_state_with_clip_data.blend_clip.push_back(*m_animation_data_cache[iter]);
+            out_cache.m_is_additive[clip_index] = is_additive(clip_index);
+            if (!is_additive(clip_index))
+            {
+                override_weight_sum += get_clip_weight(clip_index);
+            }
         }
-        for (const auto& iter : blend_state.blend_anim_skel_map_path)
+        out_cache.m_clip_weights.resize(clip_count);
+        for (size_t clip_index = 0; clip_index < clip_count; clip_index++)
         {
-            blend_state_with_clip_data.blend_anim_skel_map.push_back(*m_animation_skeleton_map_cache[iter]);
+            const float clip_weight = get_clip_weight(clip_index);
+            if (is_additive(clip_index))
+            {
+                out_cache.m_clip_weights[clip_index] = clip_weight;
+            }
+            else
+            {
+                out_cache.m_clip_weights[clip_index] =
+                    fabs(override_weight_sum) < 0.0001f ? 0.f : clip_weight / override_weight_sum;
+            }
         }
-        std::vector<std::shared_ptr<BoneBlendMask>> blend_masks;
-        for (auto& iter : blend_state.blend_mask_file_path)
+
+        // per bone weights are only known if every clip has a mask, the clip weights are used otherwise
+        size_t skeleton_bone_count = mask_skeleton ? mask_skeleton->bones_map.size() : 0;
+        if (blend_masks.size() < clip_count)
         {
-            blend_masks.push_back(m_skeleton_mask_cache[iter]);
-            tryLoadAnimationSkeletonMap(m_skeleton_mask_cache[iter]->skeleton_file_path);
+            if (!blend_masks.empty())
+            {
+                LOG_ERROR("blend state has fewer masks than clips");
+            }
+            skeleton_bone_count = 0;
         }
-        size_t skeleton_bone_count = m_skeleton_definition_cache[blend_masks[0]->skeleton_file_path]->bones_map.size();
-        blend_state_with_clip_data.blend_weight.resize(blend_state.clip_count);
-        for (size_t clip_index = 0; clip_index < blend_state.clip_count; clip_index++)
+        out_cache.m_blend_weights.resize(clip_count);
+        for (size_t clip_index = 0; clip_index < clip_count; clip_index++)
         {
-            blend_state_with_clip_data.blend_weight[clip_index].blend_weight.resize(skeleton_bone_count);
+            out_cache.m_blend_weights[clip_index].blend_weight.assign(skeleton_bone_count, 0.f);
         }
+
+        auto is_bone_enabled = [&blend_masks](size_t clip_index, size_t bone_index) {
+            const std::vector<int>& enabled = blend_masks[clip_index]->enabled;
+            return bone_index < enabled.size() && enabled[bone_index] != 0;
+        };
         for (size_t bone_index = 0; bone_index < skeleton_bone_count; bone_index++)
         {
             float sum_weight = 0;
-            for (size_t clip_index = 0; clip_index < blend_state.clip_count; clip_index++)
+            for (size_t clip_index = 0; clip_index < clip_count; clip_index++)
             {
-                if (blend_masks[clip_index]->enabled[bone_index])
+                if (!is_additive(clip_index) && is_bone_enabled(clip_index, bone_index))
                 {
-                    sum_weight += blend_state.blend_weight[clip_index];
+                    sum_weight += get_clip_weight(clip_index);
                 }
             }
-            if (fabs(sum_weight) < 0.0001f)
-            {
-                // LOG_ERROR
-            }
-            for (size_t clip_index = 0; clip_index < blend_state.clip_count; clip_index++)
+            for (size_t clip_index = 0; clip_index < clip_count; clip_index++)
             {
-                if (blend_masks[clip_index]->enabled[bone_index])
+                if (!is_bone_enabled(clip_index, bone_index))
+                    continue;
+
+                float& bone_weight = out_cache.m_blend_weights[clip_index].blend_weight[bone_index];
+                if (is_additive(clip_index))
                 {
-                    blend_state_with_clip_data.blend_weight[clip_index].blend_weight[bone_index] =
-                        blend_state.blend_weight[clip_index] / sum_weight;
+                    bone_weight = get_clip_weight(clip_index);
                 }
-                else
+                else if (fabs(sum_weight) >= 0.0001f)
                 {
-                    blend_state_with_clip_data.blend_weight[clip_index].blend_weight[bone_index] = 0;
+                    bone_weight = get_clip_weight(clip_index) / sum_weight;
                 }
             }
         }
-        return blend_state_with_clip_data;
+
+        out_cache.m_source_hash = BlendStateCache::computeSourceHash(blend_state);
+        out_cache.m_is_built    = true;
     }
 
     void AnimationManager::blendPoses(const AnimationPose& pose1, const AnimationPose& pose2, float blendFactor, AnimationPose& outPose)
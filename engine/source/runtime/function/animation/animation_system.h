@@ -7,33 +7,65 @@
 #include "runtime/resource/res_type/data/skeleton_mask.h"
 #include "runtime/core/math/math_headers.h" 
 #include "runtime/function/animation/skeleton.h"
+#include <atomic>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 #include "json11.hpp"
 
 namespace Piccolo
 {
+    /// Counters of the animation lod system since the last reset, animation components update them from the workers
+    struct AnimationLodStats
+    {
+        std::atomic<uint32_t> m_full_update_count {0};
+        std::atomic<uint32_t> m_interpolated_update_count {0};
+        std::atomic<uint32_t> m_skipped_lod_bone_update_count {0};
+        // estimated from the average full update time of each component
+        std::atomic<uint64_t> m_saved_time_us {0};
+
+        void reset()
+        {
+            m_full_update_count             = 0;
+            m_interpolated_update_count     = 0;
+            m_skipped_lod_bone_update_count = 0;
+            m_saved_time_us                 = 0;
+        }
+    };
+
     class AnimationManager
     {
     private:
         static std::map<std::string, std::shared_ptr<SkeletonData>>  m_skeleton_definition_cache;
         static std::map<std::string, std::shared_ptr<AnimationClip>> m_animation_data_cache;
+        static std::map<std::string, std::shared_ptr<CookedAnimationClip>> m_cooked_animation_cache;
         static std::map<std::string, std::shared_ptr<AnimSkelMap>>   m_animation_skeleton_map_cache;
         static std::map<std::string, std::shared_ptr<BoneBlendMask>> m_skeleton_mask_cache;
+        // animation components are ticked in parallel, the caches are filled lazily
+        static std::recursive_mutex m_cache_mutex;
+
+        static AnimationLodStats m_lod_stats;
 
     public:
         static std::shared_ptr<SkeletonData>  tryLoadSkeleton(std::string file_path);
         static std::shared_ptr<AnimationClip> tryLoadAnimation(std::string file_path);
+        static std::shared_ptr<CookedAnimationClip> tryLoadCookedAnimation(std::string file_path);
         static std::shared_ptr<AnimSkelMap>   tryLoadAnimationSkeletonMap(std::string file_path);
         static std::shared_ptr<BoneBlendMask> tryLoadSkeletonMask(std::string file_path);
-        static BlendStateWithClipData         getBlendStateWithClipData(const BlendState& blend_state);
+        // resolve the clip data again only if the blend state changed since the last update
+        static void updateBlendStateCache(const BlendState& blend_state, BlendStateCache& out_cache);
+
+        static AnimationLodStats& getLodStats() { return m_lod_stats; }
 
         static void blendPoses(const AnimationPose& pose1, const AnimationPose& pose2, float blendFactor, AnimationPose& outPose);
         static bool updateAnimationFSM(const std::map<std::string, bool>& signals);
 
         AnimationManager() = default;
+
+    private:
+        static void rebuildBlendStateCache(const BlendState& blend_state, BlendStateCache& out_cache);
     };
 
     class AnimationFSM
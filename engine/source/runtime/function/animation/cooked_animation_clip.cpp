@@ -0,0 +1,638 @@
+#include "runtime/function/animation/cooked_animation_clip.h"
+
+#include "runtime/core/base/macro.h"
+#include "runtime/core/math/simd.h"
+
+#include "runtime/resource/res_type/data/animation_clip.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+namespace Piccolo
+{
+    namespace
+    {
+        // the three smallest components of a unit quaternion lie in [-1/sqrt(2), 1/sqrt(2)]
+        constexpr float k_smallest_three_range = 0.70710678f;
+
+        uint32_t alignUp(uint32_t value, uint32_t alignment) { return (value + alignment - 1) & ~(alignment - 1); }
+
+        uint16_t quantizeRotationComponent(float value)
+        {
+            const float normalized = (value + k_smallest_three_range) / (2.f * k_smallest_three_range);
+            return static_cast<uint16_t>(std::lround(std::clamp(normalized, 0.f, 1.f) * 65535.f));
+        }
+
+        float dequantizeRotationComponent(uint16_t value)
+        {
+            return value * (2.f * k_smallest_three_range / 65535.f) - k_smallest_three_range;
+        }
+
+        void encodeRotation(Quaternion rotation, uint16_t out_components[3], uint8_t& out_largest_index)
+        {
+            rotation.normalise();
+
+            float components[4] = {rotation.x, rotation.y, rotation.z, rotation.w};
+
+            uint8_t largest_index = 0;
+            for (uint8_t component_index = 1; component_index < 4; ++component_index)
+            {
+                if (std::fabs(components[component_index]) > std::fabs(components[largest_index]))
+                {
+                    largest_index = component_index;
+                }
+            }
+
+            // q and -q are the same rotation, keep the dropped component positive
+            const float sign = components[largest_index] < 0.f ? -1.f : 1.f;
+
+            uint32_t stored_index = 0;
+            for (uint8_t component_index = 0; component_index < 4; ++component_index)
+            {
+                if (component_index != largest_index)
+                {
+                    out_components[stored_index++] = quantizeRotationComponent(components[component_index] * sign);
+                }
+            }
+            out_largest_index = largest_index;
+        }
+
+        // decode count rotations into x[] y[] z[] w[]
+        void decodeRotations(const uint8_t* rotation_data, uint32_t count, float* out_rotations)
+        {
+            const uint16_t* stored_a      = reinterpret_cast<const uint16_t*>(rotation_data);
+            const uint16_t* stored_b      = stored_a + count;
+            const uint16_t* stored_c      = stored_b + count;
+            const uint8_t*  largest_index = reinterpret_cast<const uint8_t*>(stored_c + count);
+
+            uint32_t rotation_index = 0;
+#if PICCOLO_SIMD_SSE2
+            const __m128i zero  = _mm_setzero_si128();
+            const __m128  scale = _mm_set1_ps(2.f * k_smallest_three_range / 65535.f);
+            const __m128  range = _mm_set1_ps(k_smallest_three_range);
+            const __m128  one   = _mm_set1_ps(1.f);
+
+            const auto dequantize4 = [&](const uint16_t* stored) {
+                const __m128i packed = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(stored));
+                const __m128i values = _mm_unpacklo_epi16(packed, zero);
+                return _mm_sub_ps(_mm_mul_ps(_mm_cvtepi32_ps(values), scale), range);
+            };
+            // mask ? if_true : if_false
+            const auto select4 = [](__m128 mask, __m128 if_true, __m128 if_false) {
+                return _mm_or_ps(_mm_and_ps(mask, if_true), _mm_andnot_ps(mask, if_false));
+            };
+
+            for (; rotation_index + 4 <= count; rotation_index += 4)
+            {
+                const __m128 a = dequantize4(stored_a + rotation_index);
+                const __m128 b = dequantize4(stored_b + rotation_index);
+                const __m128 c = dequantize4(stored_c + rotation_index);
+                const __m128 d = _mm_sqrt_ps(_mm_max_ps(
+                    _mm_setzero_ps(),
+                    _mm_sub_ps(one, _mm_add_ps(_mm_add_ps(_mm_mul_ps(a, a), _mm_mul_ps(b, b)), _mm_mul_ps(c, c)))));
+
+                int32_t packed_indices;
+                std::memcpy(&packed_indices, largest_index + rotation_index, sizeof(packed_indices));
+                __m128i indices = _mm_unpacklo_epi8(_mm_cvtsi32_si128(packed_indices), zero);
+                indices         = _mm_and_si128(_mm_unpacklo_epi16(indices, zero), _mm_set1_epi32(3));
+
+                const __m128 is_x = _mm_castsi128_ps(_mm_cmpeq_epi32(indices, _mm_set1_epi32(0)));
+                const __m128 is_y = _mm_castsi128_ps(_mm_cmpeq_epi32(indices, _mm_set1_epi32(1)));
+                const __m128 is_z = _mm_castsi128_ps(_mm_cmpeq_epi32(indices, _mm_set1_epi32(2)));
+                const __m128 is_w = _mm_castsi128_ps(_mm_cmpeq_epi32(indices, _mm_set1_epi32(3)));
+
+                // the stored components are the three that are not the largest one, in x y z w order
+                _mm_storeu_ps(out_rotations + rotation_index, select4(is_x, d, a));
+                _mm_storeu_ps(out_rotations + count + rotation_index, select4(is_x, a, select4(is_y, d, b)));
+                _mm_storeu_ps(out_rotations + count * 2 + rotation_index,
+                              select4(_mm_or_ps(is_x, is_y), b, select4(is_z, d, c)));
+                _mm_storeu_ps(out_rotations + count * 3 + rotation_index, select4(is_w, d, c));
+            }
+#endif
+            for (; rotation_index < count; ++rotation_index)
+            {
+                const float a = dequantizeRotationComponent(stored_a[rotation_index]);
+                const float b = dequantizeRotationComponent(stored_b[rotation_index]);
+                const float c = dequantizeRotationComponent(stored_c[rotation_index]);
+                const float d = std::sqrt(std::max(0.f, 1.f - a * a - b * b - c * c));
+
+                float components[4];
+                switch (largest_index[rotation_index] & 3)
+                {
+                    case 0:
+                        components[0] = d, components[1] = a, components[2] = b, components[3] = c;
+                        break;
+                    case 1:
+                        components[0] = a, components[1] = d, components[2] = b, components[3] = c;
+                        break;
+                    case 2:
+                        components[0] = a, components[1] = b, components[2] = d, components[3] = c;
+                        break;
+                    default:
+                        components[0] = a, components[1] = b, components[2] = c, components[3] = d;
+                        break;
+                }
+
+                out_rotations[rotation_index]             = components[0];
+                out_rotations[count + rotation_index]     = components[1];
+                out_rotations[count * 2 + rotation_index] = components[2];
+                out_rotations[count * 3 + rotation_index] = components[3];
+            }
+        }
+
+        // out[i] = from[i] + (to[i] - from[i]) * ratio
+        void lerpFloats(const float* from, const float* to, float ratio, float* out, uint32_t count)
+        {
+            uint32_t index = 0;
+#if PICCOLO_SIMD_SSE2
+            const __m128 ratio4 = _mm_set1_ps(ratio);
+            for (; index + 4 <= count; index += 4)
+            {
+                const __m128 from4 = _mm_loadu_ps(from + index);
+                const __m128 to4   = _mm_loadu_ps(to + index);
+                _mm_storeu_ps(out + index, _mm_add_ps(from4, _mm_mul_ps(_mm_sub_ps(to4, from4), ratio4)));
+            }
+#endif
+            for (; index < count; ++index)
+            {
+                out[index] = from[index] + (to[index] - from[index]) * ratio;
+            }
+        }
+
+        // shortest path normalized lerp of count rotations stored as x[] y[] z[] w[], same as Quaternion::nLerp
+        void nlerpRotations(const float* from, const float* to, float ratio, float* out, uint32_t count)
+        {
+            const float* from_x = from;
+            const float* from_y = from + count;
+            const float* from_z = from + count * 2;
+            const float* from_w = from + count * 3;
+            const float* to_x   = to;
+            const float* to_y   = to + count;
+            const float* to_z   = to + count * 2;
+            const float* to_w   = to + count * 3;
+            float*       out_x  = out;
+            float*       out_y  = out + count;
+            float*       out_z  = out + count * 2;
+            float*       out_w  = out + count * 3;
+
+            uint32_t index = 0;
+#if PICCOLO_SIMD_SSE2
+            const __m128 ratio4    = _mm_set1_ps(ratio);
+            const __m128 sign_mask = _mm_set1_ps(-0.f);
+            const __m128 one       = _mm_set1_ps(1.f);
+            for (; index + 4 <= count; index += 4)
+            {
+                const __m128 fx = _mm_loadu_ps(from_x + index);
+                const __m128 fy = _mm_loadu_ps(from_y + index);
+                const __m128 fz = _mm_loadu_ps(from_z + index);
+                const __m128 fw = _mm_loadu_ps(from_w + index);
+                __m128       tx = _mm_loadu_ps(to_x + index);
+                __m128       ty = _mm_loadu_ps(to_y + index);
+                __m128       tz = _mm_loadu_ps(to_z + index);
+                __m128       tw = _mm_loadu_ps(to_w + index);
+
+                // negate the target where the dot product is negative
+                const __m128 dot =
+                    _mm_add_ps(_mm_add_ps(_mm_mul_ps(fx, tx), _mm_mul_ps(fy, ty)),
+                               _mm_add_ps(_mm_mul_ps(fz, tz), _mm_mul_ps(fw, tw)));
+                const __m128 flip = _mm_and_ps(dot, sign_mask);
+                tx                = _mm_xor_ps(tx, flip);
+                ty                = _mm_xor_ps(ty, flip);
+                tz                = _mm_xor_ps(tz, flip);
+                tw                = _mm_xor_ps(tw, flip);
+
+                const __m128 rx = _mm_add_ps(fx, _mm_mul_ps(_mm_sub_ps(tx, fx), ratio4));
+                const __m128 ry = _mm_add_ps(fy, _mm_mul_ps(_mm_sub_ps(ty, fy), ratio4));
+                const __m128 rz = _mm_add_ps(fz, _mm_mul_ps(_mm_sub_ps(tz, fz), ratio4));
+                const __m128 rw = _mm_add_ps(fw, _mm_mul_ps(_mm_sub_ps(tw, fw), ratio4));
+
+                const __m128 length_squared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(rx, rx), _mm_mul_ps(ry, ry)),
+                                                         _mm_add_ps(_mm_mul_ps(rz, rz), _mm_mul_ps(rw, rw)));
+                const __m128 inverse_length = _mm_div_ps(one, _mm_sqrt_ps(length_squared));
+
+                _mm_storeu_ps(out_x + index, _mm_mul_ps(rx, inverse_length));
+                _mm_storeu_ps(out_y + index, _mm_mul_ps(ry, inverse_length));
+                _mm_storeu_ps(out_z + index, _mm_mul_ps(rz, inverse_length));
+                _mm_storeu_ps(out_w + index, _mm_mul_ps(rw, inverse_length));
+            }
+#endif
+            for (; index < count; ++index)
+            {
+                const float dot = from_x[index] * to_x[index] + from_y[index] * to_y[index] +
+                                  from_z[index] * to_z[index] + from_w[index] * to_w[index];
+                const float sign = dot < 0.f ? -1.f : 1.f;
+
+                const float rx = from_x[index] + (to_x[index] * sign - from_x[index]) * ratio;
+                const float ry = from_y[index] + (to_y[index] * sign - from_y[index]) * ratio;
+                const float rz = from_z[index] + (to_z[index] * sign - from_z[index]) * ratio;
+                const float rw = from_w[index] + (to_w[index] * sign - from_w[index]) * ratio;
+
+                const float inverse_length = 1.f / std::sqrt(rx * rx + ry * ry + rz * rz + rw * rw);
+
+                out_x[index] = rx * inverse_length;
+                out_y[index] = ry * inverse_length;
+                out_z[index] = rz * inverse_length;
+                out_w[index] = rw * inverse_length;
+            }
+        }
+
+        bool isTrackInRange(uint16_t track, uint32_t animated_count, uint32_t constant_count)
+        {
+            if (track & CookedAnimationClip::s_constant_track_bit)
+            {
+                return (track & ~CookedAnimationClip::s_constant_track_bit) < constant_count;
+            }
+            return track < animated_count;
+        }
+
+        Vector3 readVector3Track(uint16_t track, const float* constants, const float* animated, uint32_t animated_count)
+        {
+            if (track & CookedAnimationClip::s_constant_track_bit)
+            {
+                return Vector3(constants + (track & ~CookedAnimationClip::s_constant_track_bit) * 3);
+            }
+            return Vector3(animated[track], animated[animated_count + track], animated[animated_count * 2 + track]);
+        }
+
+        Quaternion
+        readRotationTrack(uint16_t track, const float* constants, const float* animated, uint32_t animated_count)
+        {
+            if (track & CookedAnimationClip::s_constant_track_bit)
+            {
+                const float* constant = constants + (track & ~CookedAnimationClip::s_constant_track_bit) * 4;
+                return Quaternion(constant[3], constant[0], constant[1], constant[2]);
+            }
+            return Quaternion(animated[animated_count * 3 + track],
+                              animated[track],
+                              animated[animated_count + track],
+                              animated[animated_count * 2 + track]);
+        }
+
+        template<typename TKey>
+        const TKey& getKey(const std::vector<TKey>& keys, uint32_t frame)
+        {
+            return keys[std::min<size_t>(frame, keys.size() - 1)];
+        }
+
+        bool isConstantTrack(const std::vector<Vector3>& keys, uint32_t frame_count, float tolerance)
+        {
+            for (uint32_t frame = 1; frame < frame_count && frame < keys.size(); ++frame)
+            {
+                const Vector3& key = keys[frame];
+                if (std::fabs(key.x - keys[0].x) > tolerance || std::fabs(key.y - keys[0].y) > tolerance ||
+                    std::fabs(key.z - keys[0].z) > tolerance)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        bool isConstantTrack(const std::vector<Quaternion>& keys, uint32_t frame_count, float tolerance)
+        {
+            for (uint32_t frame = 1; frame < frame_count && frame < keys.size(); ++frame)
+            {
+                const Quaternion& key  = keys[frame];
+                const float       sign = key.dot(keys[0]) < 0.f ? -1.f : 1.f;
+                if (std::fabs(key.x * sign - keys[0].x) > tolerance ||
+                    std::fabs(key.y * sign - keys[0].y) > tolerance ||
+                    std::fabs(key.z * sign - keys[0].z) > tolerance ||
+                    std::fabs(key.w * sign - keys[0].w) > tolerance)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        uint16_t addTrack(bool                   is_constant,
+                          std::vector<uint32_t>& animated_channels,
+                          uint32_t&              constant_count,
+                          uint32_t               channel_index)
+        {
+            if (is_constant)
+            {
+                ASSERT(constant_count < CookedAnimationClip::s_constant_track_bit);
+                return static_cast<uint16_t>(constant_count++) | CookedAnimationClip::s_constant_track_bit;
+            }
+            ASSERT(animated_channels.size() < CookedAnimationClip::s_constant_track_bit);
+            animated_channels.push_back(channel_index);
+            return static_cast<uint16_t>(animated_channels.size() - 1);
+        }
+
+        template<typename TValue>
+        void writeArray(std::vector<uint8_t>& bytes, size_t offset, const std::vector<TValue>& values)
+        {
+            if (!values.empty())
+            {
+                std::memcpy(bytes.data() + offset, values.data(), values.size() * sizeof(TValue));
+            }
+        }
+    } // namespace
+
+    bool CookedAnimationClip::loadFromFile(const std::filesystem::path& file_path)
+    {
+        m_bytes.clear();
+        if (!m_mapped_file.open(file_path))
+            return false;
+
+        if (!bind(m_mapped_file.getData(), m_mapped_file.getSize()))
+        {
+            m_mapped_file.close();
+            return false;
+        }
+        return true;
+    }
+
+    bool CookedAnimationClip::loadFromMemory(std::vector<uint8_t>&& bytes)
+    {
+        m_mapped_file.close();
+        m_bytes = std::move(bytes);
+        return bind(m_bytes.data(), m_bytes.size());
+    }
+
+    bool CookedAnimationClip::bind(const uint8_t* data, size_t size)
+    {
+        m_header    = nullptr;
+        m_channels  = nullptr;
+        m_constants = nullptr;
+        m_frames    = nullptr;
+        m_size      = 0;
+
+        if (data == nullptr || size < sizeof(Header))
+            return false;
+
+        const Header& header = *reinterpret_cast<const Header*>(data);
+        if (header.m_magic != s_magic || header.m_version != s_version)
+        {
+            LOG_ERROR("cooked animation clip has an unknown format");
+            return false;
+        }
+        if (reinterpret_cast<uintptr_t>(data) % alignof(Header) != 0 ||
+            header.m_channels_offset % alignof(ChannelTracks) != 0)
+        {
+            LOG_ERROR("cooked animation clip is misaligned");
+            return false;
+        }
+
+        const uint64_t constant_float_count = 3ull * header.m_constant_position_count +
+                                              3ull * header.m_constant_scale_count +
+                                              4ull * header.m_constant_rotation_count;
+        const uint64_t frame_data_size = 4ull * 3 * (header.m_animated_position_count + header.m_animated_scale_count) +
+                                         7ull * header.m_animated_rotation_count;
+
+        const bool is_valid =
+            header.m_frame_count > 0 && header.m_frame_stride >= frame_data_size &&
+            header.m_constants_offset % alignof(float) == 0 && header.m_frames_offset % 16 == 0 &&
+            header.m_frame_stride % 16 == 0 &&
+            header.m_channels_offset + uint64_t(header.m_channel_count) * sizeof(ChannelTracks) <= size &&
+            header.m_constants_offset + constant_float_count * sizeof(float) <= size &&
+            header.m_frames_offset + uint64_t(header.m_frame_count) * header.m_frame_stride <= size;
+        if (!is_valid)
+        {
+            LOG_ERROR("cooked animation clip is truncated or corrupted");
+            return false;
+        }
+
+        // sample reads the tracks without checks
+        const ChannelTracks* channels = reinterpret_cast<const ChannelTracks*>(data + header.m_channels_offset);
+        for (uint32_t channel_index = 0; channel_index < header.m_channel_count; ++channel_index)
+        {
+            const ChannelTracks& tracks = channels[channel_index];
+            if (!isTrackInRange(
+                    tracks.m_position_track, header.m_animated_position_count, header.m_constant_position_count) ||
+                !isTrackInRange(tracks.m_scale_track, header.m_animated_scale_count, header.m_constant_scale_count) ||
+                !isTrackInRange(
+                    tracks.m_rotation_track, header.m_animated_rotation_count, header.m_constant_rotation_count))
+            {
+                LOG_ERROR("cooked animation clip channel {} has a track out of range", channel_index);
+                return false;
+            }
+        }
+
+        m_header    = &header;
+        m_channels  = channels;
+        m_constants = reinterpret_cast<const float*>(data + header.m_constants_offset);
+        m_frames    = data + header.m_frames_offset;
+        m_size      = size;
+        return true;
+    }
+
+    void CookedAnimationClip::sample(float phase, SampledClipPose& out_pose) const
+    {
+        if (m_header == nullptr)
+            return;
+
+        const Header&  header         = *m_header;
+        const uint32_t position_count = header.m_animated_position_count;
+        const uint32_t scale_count    = header.m_animated_scale_count;
+        const uint32_t rotation_count = header.m_animated_rotation_count;
+
+        out_pose.m_positions.resize(header.m_channel_count);
+        out_pose.m_rotations.resize(header.m_channel_count);
+        out_pose.m_scales.resize(header.m_channel_count);
+
+        const uint32_t float_track_count = 3 * (position_count + scale_count);
+        out_pose.m_scratch.resize(float_track_count + 12 * rotation_count);
+        float* lerped_floats    = out_pose.m_scratch.data();
+        float* from_rotations   = lerped_floats + float_track_count;
+        float* to_rotations     = from_rotations + 4 * rotation_count;
+        float* lerped_rotations = to_rotations + 4 * rotation_count;
+
+        const float    exact_frame = std::max(phase, 0.f) * (header.m_frame_count - 1);
+        const uint32_t frame_high  = std::min(static_cast<uint32_t>(std::ceil(exact_frame)), header.m_frame_count - 1);
+        const uint32_t frame_low   = std::min(static_cast<uint32_t>(std::floor(exact_frame)), frame_high);
+        const float    lerp_ratio  = exact_frame - std::floor(exact_frame);
+
+        const uint8_t* from_frame = m_frames + size_t(frame_low) * header.m_frame_stride;
+        const uint8_t* to_frame   = m_frames + size_t(frame_high) * header.m_frame_stride;
+
+        // positions and scales are contiguous floats, one lerp covers all of them
+        lerpFloats(reinterpret_cast<const float*>(from_frame),
+                   reinterpret_cast<const float*>(to_frame),
+                   lerp_ratio,
+                   lerped_floats,
+                   float_track_count);
+
+        const size_t rotation_offset = float_track_count * sizeof(float);
+        decodeRotations(from_frame + rotation_offset, rotation_count, from_rotations);
+        decodeRotations(to_frame + rotation_offset, rotation_count, to_rotations);
+        nlerpRotations(from_rotations, to_rotations, lerp_ratio, lerped_rotations, rotation_count);
+
+        const float* constant_positions = m_constants;
+        const float* constant_scales    = constant_positions + 3 * header.m_constant_position_count;
+        const float* constant_rotations = constant_scales + 3 * header.m_constant_scale_count;
+        const float* animated_positions = lerped_floats;
+        const float* animated_scales    = lerped_floats + 3 * position_count;
+
+        for (uint32_t channel_index = 0; channel_index < header.m_channel_count; ++channel_index)
+        {
+            const ChannelTracks& tracks = m_channels[channel_index];
+
+            out_pose.m_positions[channel_index] =
+                readVector3Track(tracks.m_position_track, constant_positions, animated_positions, position_count);
+            out_pose.m_scales[channel_index] =
+                readVector3Track(tracks.m_scale_track, constant_scales, animated_scales, scale_count);
+            out_pose.m_rotations[channel_index] =
+                readRotationTrack(tracks.m_rotation_track, constant_rotations, lerped_rotations, rotation_count);
+        }
+    }
+
+    void AnimationClipCooker::cook(const AnimationClip& clip, float tolerance, std::vector<uint8_t>& out_bytes)
+    {
+        using Header        = CookedAnimationClip::Header;
+        using ChannelTracks = CookedAnimationClip::ChannelTracks;
+
+        const uint32_t frame_count = static_cast<uint32_t>(std::max(clip.total_frame, 1));
+        const uint32_t channel_count =
+            static_cast<uint32_t>(std::min<size_t>(std::max(clip.node_count, 0), clip.node_channels.size()));
+
+        Header header {};
+        header.m_magic         = CookedAnimationClip::s_magic;
+        header.m_version       = CookedAnimationClip::s_version;
+        header.m_key_tolerance = tolerance;
+        header.m_frame_count   = frame_count;
+        header.m_channel_count = channel_count;
+
+        // split the tracks into constants and animated tracks
+        std::vector<ChannelTracks> channel_tracks(channel_count);
+        std::vector<float>         constants_positions;
+        std::vector<float>         constants_scales;
+        std::vector<float>         constants_rotations;
+        std::vector<uint32_t>      animated_position_channels;
+        std::vector<uint32_t>      animated_scale_channels;
+        std::vector<uint32_t>      animated_rotation_channels;
+
+        for (uint32_t channel_index = 0; channel_index < channel_count; ++channel_index)
+        {
+            const AnimationChannel& channel = clip.node_channels[channel_index];
+            ChannelTracks&          tracks  = channel_tracks[channel_index];
+
+            const bool is_position_constant = isConstantTrack(channel.position_keys, frame_count, tolerance);
+            tracks.m_position_track         = addTrack(
+                is_position_constant, animated_position_channels, header.m_constant_position_count, channel_index);
+            if (is_position_constant)
+            {
+                const Vector3 position = channel.position_keys.empty() ? Vector3::ZERO : channel.position_keys[0];
+                constants_positions.insert(constants_positions.end(), {position.x, position.y, position.z});
+            }
+
+            const bool is_scale_constant = isConstantTrack(channel.scaling_keys, frame_count, tolerance);
+            tracks.m_scale_track =
+                addTrack(is_scale_constant, animated_scale_channels, header.m_constant_scale_count, channel_index);
+            if (is_scale_constant)
+            {
+                const Vector3 scale = channel.scaling_keys.empty() ? Vector3::UNIT_SCALE : channel.scaling_keys[0];
+                constants_scales.insert(constants_scales.end(), {scale.x, scale.y, scale.z});
+            }
+
+            const bool is_rotation_constant = isConstantTrack(channel.rotation_keys, frame_count, tolerance);
+            tracks.m_rotation_track         = addTrack(
+                is_rotation_constant, animated_rotation_channels, header.m_constant_rotation_count, channel_index);
+            if (is_rotation_constant)
+            {
+                Quaternion rotation = channel.rotation_keys.empty() ? Quaternion::IDENTITY : channel.rotation_keys[0];
+                rotation.normalise();
+                constants_rotations.insert(constants_rotations.end(), {rotation.x, rotation.y, rotation.z, rotation.w});
+            }
+
+            tracks.m_padding = 0;
+        }
+
+        const uint32_t position_count = static_cast<uint32_t>(animated_position_channels.size());
+        const uint32_t scale_count    = static_cast<uint32_t>(animated_scale_channels.size());
+        const uint32_t rotation_count = static_cast<uint32_t>(animated_rotation_channels.size());
+
+        header.m_animated_position_count = position_count;
+        header.m_animated_scale_count    = scale_count;
+        header.m_animated_rotation_count = rotation_count;
+
+        const uint32_t constants_size = static_cast<uint32_t>(
+            (constants_positions.size() + constants_scales.size() + constants_rotations.size()) * sizeof(float));
+        const uint32_t float_track_count = 3 * (position_count + scale_count);
+
+        header.m_channels_offset  = sizeof(Header);
+        header.m_constants_offset = alignUp(header.m_channels_offset + channel_count * sizeof(ChannelTracks), 16);
+        header.m_frames_offset    = alignUp(header.m_constants_offset + constants_size, 16);
+        header.m_frame_stride =
+            alignUp(float_track_count * sizeof(float) + rotation_count * (3 * sizeof(uint16_t) + sizeof(uint8_t)), 16);
+
+        out_bytes.assign(header.m_frames_offset + size_t(frame_count) * header.m_frame_stride, 0);
+        std::memcpy(out_bytes.data(), &header, sizeof(Header));
+        writeArray(out_bytes, header.m_channels_offset, channel_tracks);
+        writeArray(out_bytes, header.m_constants_offset, constants_positions);
+        writeArray(out_bytes, header.m_constants_offset + constants_positions.size() * sizeof(float), constants_scales);
+        writeArray(out_bytes,
+                   header.m_constants_offset + (constants_positions.size() + constants_scales.size()) * sizeof(float),
+                   constants_rotations);
+
+        std::vector<float>    frame_floats(float_track_count);
+        std::vector<uint16_t> frame_rotations(3 * rotation_count);
+        std::vector<uint8_t>  frame_largest_indices(rotation_count);
+        for (uint32_t frame = 0; frame < frame_count; ++frame)
+        {
+            // a track with fewer keys than frames holds its last key
+            for (uint32_t track = 0; track < position_count; ++track)
+            {
+                const Vector3& position =
+                    getKey(clip.node_channels[animated_position_channels[track]].position_keys, frame);
+                frame_floats[track]                      = position.x;
+                frame_floats[position_count + track]     = position.y;
+                frame_floats[position_count * 2 + track] = position.z;
+            }
+            float* scale_floats = frame_floats.data() + 3 * position_count;
+            for (uint32_t track = 0; track < scale_count; ++track)
+            {
+                const Vector3& scale = getKey(clip.node_channels[animated_scale_channels[track]].scaling_keys, frame);
+                scale_floats[track]                   = scale.x;
+                scale_floats[scale_count + track]     = scale.y;
+                scale_floats[scale_count * 2 + track] = scale.z;
+            }
+            for (uint32_t track = 0; track < rotation_count; ++track)
+            {
+                const Quaternion& rotation =
+                    getKey(clip.node_channels[animated_rotation_channels[track]].rotation_keys, frame);
+
+                uint16_t components[3];
+                encodeRotation(rotation, components, frame_largest_indices[track]);
+                frame_rotations[track]                      = components[0];
+                frame_rotations[rotation_count + track]     = components[1];
+                frame_rotations[rotation_count * 2 + track] = components[2];
+            }
+
+            const size_t frame_offset = header.m_frames_offset + size_t(frame) * header.m_frame_stride;
+            writeArray(out_bytes, frame_offset, frame_floats);
+            writeArray(out_bytes, frame_offset + float_track_count * sizeof(float), frame_rotations);
+            writeArray(out_bytes,
+                       frame_offset + float_track_count * sizeof(float) + frame_rotations.size() * sizeof(uint16_t),
+                       frame_largest_indices);
+        }
+    }
+
+    bool AnimationClipCooker::save(const std::vector<uint8_t>& bytes, const std::filesystem::path& file_path)
+    {
+        std::ofstream cooked_file(file_path, std::ios::binary | std::ios::trunc);
+        if (!cooked_file)
+        {
+            LOG_ERROR("open file {} failed!", file_path.generic_string());
+            return false;
+        }
+        cooked_file.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+        return static_cast<bool>(cooked_file);
+    }
+
+    size_t AnimationClipCooker::getClipMemorySize(const AnimationClip& clip)
+    {
+        size_t memory_size = sizeof(AnimationClip) + clip.node_channels.capacity() * sizeof(AnimationChannel);
+        for (const AnimationChannel& channel : clip.node_channels)
+        {
+            memory_size += channel.name.capacity();
+            memory_size += channel.position_keys.capacity() * sizeof(Vector3);
+            memory_size += channel.rotation_keys.capacity() * sizeof(Quaternion);
+            memory_size += channel.scaling_keys.capacity() * sizeof(Vector3);
+        }
+        return memory_size;
+    }
+} // namespace Piccolo
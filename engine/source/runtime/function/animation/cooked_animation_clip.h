@@ -0,0 +1,102 @@
+#pragma once
+
+#include "runtime/core/math/quaternion.h"
+#include "runtime/core/math/vector3.h"
+#include "runtime/platform/file_service/mapped_file.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+namespace Piccolo
+{
+    class AnimationClip;
+
+    /// Pose sampled from a cooked clip, one transform per clip channel.
+    /// The decoded frame data is kept in m_scratch so that sampling into a reused pose does not allocate.
+    struct SampledClipPose
+    {
+        std::vector<Vector3>    m_positions;
+        std::vector<Quaternion> m_rotations;
+        std::vector<Vector3>    m_scales;
+
+        std::vector<float> m_scratch;
+    };
+
+    /// Binary runtime clip, usable in place from a mapped file.
+    /// Tracks whose keys stay within the cooking tolerance are stored once as constants, the animated tracks of all
+    /// channels are stored frame by frame in structure of arrays layout:
+    ///     position x[] y[] z[] | scale x[] y[] z[] | rotation a[] b[] c[] (uint16) | rotation largest index[] (uint8)
+    /// rotations use the smallest three quantization.
+    class CookedAnimationClip
+    {
+    public:
+        static constexpr uint32_t s_magic              = 0x50434c50; // "PLCP"
+        static constexpr uint32_t s_version            = 2;
+        static constexpr uint16_t s_constant_track_bit = 0x8000;
+
+        struct Header
+        {
+            uint32_t m_magic;
+            uint32_t m_version;
+            // tolerance the clip was cooked with, the clip is cooked again when the configured one differs
+            float    m_key_tolerance;
+            uint32_t m_frame_count;
+            uint32_t m_channel_count;
+            uint32_t m_animated_position_count;
+            uint32_t m_animated_scale_count;
+            uint32_t m_animated_rotation_count;
+            uint32_t m_constant_position_count;
+            uint32_t m_constant_scale_count;
+            uint32_t m_constant_rotation_count;
+            uint32_t m_frame_stride;
+            uint32_t m_channels_offset;
+            uint32_t m_constants_offset;
+            uint32_t m_frames_offset;
+        };
+
+        // index into the animated tracks, or into the constants if s_constant_track_bit is set
+        struct ChannelTracks
+        {
+            uint16_t m_position_track;
+            uint16_t m_scale_track;
+            uint16_t m_rotation_track;
+            uint16_t m_padding;
+        };
+
+        bool loadFromFile(const std::filesystem::path& file_path);
+        bool loadFromMemory(std::vector<uint8_t>&& bytes);
+
+        uint32_t getFrameCount() const { return m_header ? m_header->m_frame_count : 0; }
+        uint32_t getChannelCount() const { return m_header ? m_header->m_channel_count : 0; }
+        float    getKeyTolerance() const { return m_header ? m_header->m_key_tolerance : 0.f; }
+        size_t   getMemorySize() const { return m_size; }
+
+        /// phase in [0, 1], keys are interpolated between the two nearest frames
+        void sample(float phase, SampledClipPose& out_pose) const;
+
+    private:
+        bool bind(const uint8_t* data, size_t size);
+
+        MappedFile           m_mapped_file;
+        std::vector<uint8_t> m_bytes;
+        size_t               m_size {0};
+
+        const Header*        m_header {nullptr};
+        const ChannelTracks* m_channels {nullptr};
+        const float*         m_constants {nullptr};
+        const uint8_t*       m_frames {nullptr};
+    };
+
+    class AnimationClipCooker
+    {
+    public:
+        /// tracks whose keys all stay within tolerance of their first key are stored as a single constant key
+        static void cook(const AnimationClip& clip, float tolerance, std::vector<uint8_t>& out_bytes);
+        static bool save(const std::vector<uint8_t>& bytes, const std::filesystem::path& file_path);
+
+        /// heap size of a clip loaded from json, to compare against the cooked size
+        static size_t getClipMemorySize(const AnimationClip& clip);
+    };
+} // namespace Piccolo
@@ -1,139 +1,395 @@
 #include "runtime/function/animation/skeleton.h"
+#include "runtime/core/base/hash.h"
 #include "runtime/core/math/math.h"
+#include "runtime/core/math/simd.h"
 #include "runtime/function/animation/utilities.h"
+#include "runtime/resource/res_type/data/skeleton_data.h"
 
 namespace Piccolo
 {
-    Skeleton::~Skeleton() { delete[] m_bones; }
+    size_t BlendStateCache::computeSourceHash(const BlendState& blend_state)
+    {
+        // blend ratios change every frame and are not part of the cached data, only their count is
+        size_t hash = 0;
+        hash_combine(hash, blend_state.clip_count, blend_state.blend_ratio.size());
+        for (const std::string& animation_file_path : blend_state.blend_clip_file_path)
+        {
+            hash_combine(hash, animation_file_path);
+        }
+        for (const std::string& anim_skel_map_path : blend_state.blend_anim_skel_map_path)
+        {
+            hash_combine(hash, anim_skel_map_path);
+        }
+        for (const std::string& skeleton_mask_path : blend_state.blend_mask_file_path)
+        {
+            hash_combine(hash, skeleton_mask_path);
+        }
+        for (float clip_weight : blend_state.blend_weight)
+        {
+            hash_combine(hash, clip_weight);
+        }
+        for (int is_additive : blend_state.blend_is_additive)
+        {
+            hash_combine(hash, is_additive);
+        }
+        // the vector sizes keep paths moved from one list to the next apart
+        hash_combine(hash,
+                     blend_state.blend_clip_file_path.size(),
+                     blend_state.blend_anim_skel_map_path.size(),
+                     blend_state.blend_mask_file_path.size(),
+                     blend_state.blend_weight.size(),
+                     blend_state.blend_is_additive.size());
+        return hash;
+    }
 
-    void Skeleton::resetSkeleton()
+    bool BlendStateCache::isBuiltFrom(const BlendState& blend_state) const
     {
-        for (size_t i = 0; i < m_bone_count; i++)
-            m_bones[i].resetToInitialPose();
+        return m_is_built && m_source_hash == computeSourceHash(blend_state);
     }
 
-    void Skeleton::buildSkeleton(const SkeletonData& skeleton_definition)
+    namespace
     {
-        m_is_flat = skeleton_definition.is_flat;
-        if (m_bones != nullptr)
+#if PICCOLO_SIMD_SSE2
+        // quaternions are kept in (w, x, y, z) lanes and vectors in (x, y, z, 0) lanes
+        inline __m128 loadQuaternion(const Quaternion& q) { return _mm_loadu_ps(q.ptr()); }
+        inline __m128 loadVector3(const Vector3& v) { return _mm_set_ps(0.f, v.z, v.y, v.x); }
+
+        inline void storeQuaternion(__m128 q, Quaternion& out) { _mm_storeu_ps(out.ptr(), q); }
+        inline void storeVector3(__m128 v, Vector3& out)
+        {
+            alignas(16) float lanes[4];
+            _mm_store_ps(lanes, v);
+            out = Vector3(lanes[0], lanes[1], lanes[2]);
+        }
+
+        inline __m128 multiplyQuaternion(__m128 lhs, __m128 rhs)
         {
-            delete[] m_bones;
+            const __m128 lhs_w = _mm_shuffle_ps(lhs, lhs, _MM_SHUFFLE(0, 0, 0, 0));
+            const __m128 lhs_x = _mm_shuffle_ps(lhs, lhs, _MM_SHUFFLE(1, 1, 1, 1));
+            const __m128 lhs_y = _mm_shuffle_ps(lhs, lhs, _MM_SHUFFLE(2, 2, 2, 2));
+            const __m128 lhs_z = _mm_shuffle_ps(lhs, lhs, _MM_SHUFFLE(3, 3, 3, 3));
+
+            const __m128 sign_x = _mm_set_ps(0.f, -0.f, 0.f, -0.f);
+            const __m128 sign_y = _mm_set_ps(-0.f, 0.f, 0.f, -0.f);
+            const __m128 sign_z = _mm_set_ps(0.f, 0.f, -0.f, -0.f);
+
+            __m128 result = _mm_mul_ps(lhs_w, rhs);
+            result        = _mm_add_ps(
+                result,
+                _mm_xor_ps(_mm_mul_ps(lhs_x, _mm_shuffle_ps(rhs, rhs, _MM_SHUFFLE(2, 3, 0, 1))), sign_x));
+            result = _mm_add_ps(
+                result,
+                _mm_xor_ps(_mm_mul_ps(lhs_y, _mm_shuffle_ps(rhs, rhs, _MM_SHUFFLE(1, 0, 3, 2))), sign_y));
+            result = _mm_add_ps(
+                result,
+                _mm_xor_ps(_mm_mul_ps(lhs_z, _mm_shuffle_ps(rhs, rhs, _MM_SHUFFLE(0, 1, 2, 3))), sign_z));
+            return result;
         }
+
+        inline __m128 normaliseQuaternion(__m128 q)
+        {
+            __m128 length_squared = _mm_mul_ps(q, q);
+            length_squared        = _mm_add_ps(length_squared,
+                                        _mm_shuffle_ps(length_squared, length_squared, _MM_SHUFFLE(2, 3, 0, 1)));
+            length_squared        = _mm_add_ps(length_squared,
+                                        _mm_shuffle_ps(length_squared, length_squared, _MM_SHUFFLE(1, 0, 3, 2)));
+            return _mm_div_ps(q, _mm_sqrt_ps(length_squared));
+        }
+
+        inline __m128 crossProduct(__m128 lhs, __m128 rhs)
+        {
+            const __m128 lhs_yzx = _mm_shuffle_ps(lhs, lhs, _MM_SHUFFLE(3, 0, 2, 1));
+            const __m128 rhs_yzx = _mm_shuffle_ps(rhs, rhs, _MM_SHUFFLE(3, 0, 2, 1));
+            const __m128 result  = _mm_sub_ps(_mm_mul_ps(lhs, rhs_yzx), _mm_mul_ps(lhs_yzx, rhs));
+            return _mm_shuffle_ps(result, result, _MM_SHUFFLE(3, 0, 2, 1));
+        }
+
+        // same as Quaternion::operator*(const Vector3&)
+        inline __m128 rotateVector(__m128 q, __m128 v)
+        {
+            const __m128 q_vector = _mm_and_ps(_mm_shuffle_ps(q, q, _MM_SHUFFLE(0, 3, 2, 1)),
+                                               _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1)));
+            const __m128 q_w      = _mm_shuffle_ps(q, q, _MM_SHUFFLE(0, 0, 0, 0));
+            const __m128 two      = _mm_set1_ps(2.f);
+
+            const __m128 uv  = crossProduct(q_vector, v);
+            const __m128 uuv = crossProduct(q_vector, uv);
+            return _mm_add_ps(v, _mm_add_ps(_mm_mul_ps(uv, _mm_mul_ps(two, q_w)), _mm_mul_ps(uuv, two)));
+        }
+#endif
+    } // namespace
+
+    void SkeletonPoseJob::execute() const
+    {
+        // same composition as the former Node::updateDerivedTransform, without the virtual calls and dirty flags
+        for (size_t bone_index = 0; bone_index < m_bone_count; bone_index++)
+        {
+            const Transform& local        = m_local_transforms[bone_index];
+            Transform&       model        = m_model_transforms[bone_index];
+            const int32_t    parent_index = m_parent_indices[bone_index];
+            if (parent_index < 0)
+            {
+                model = local;
+                continue;
+            }
+
+            const Transform& parent = m_model_transforms[parent_index];
+#if PICCOLO_SIMD_SSE2
+            const __m128 parent_rotation = loadQuaternion(parent.m_rotation);
+            const __m128 parent_scale    = loadVector3(parent.m_scale);
+
+            storeQuaternion(normaliseQuaternion(multiplyQuaternion(parent_rotation, loadQuaternion(local.m_rotation))),
+                            model.m_rotation);
+            storeVector3(_mm_mul_ps(parent_scale, loadVector3(local.m_scale)), model.m_scale);
+            const __m128 scaled_position = _mm_mul_ps(parent_scale, loadVector3(local.m_position));
+            storeVector3(_mm_add_ps(rotateVector(parent_rotation, scaled_position), loadVector3(parent.m_position)),
+                         model.m_position);
+#else
+            model.m_rotation = parent.m_rotation * local.m_rotation;
+            model.m_rotation.normalise();
+            model.m_scale    = parent.m_scale * local.m_scale;
+            model.m_position = parent.m_rotation * (parent.m_scale * local.m_position) + parent.m_position;
+#endif
+        }
+    }
+
+    void Skeleton::resetSkeleton()
+    {
+        m_previous_key_transforms = m_initial_transforms;
+        m_key_transforms          = m_initial_transforms;
+        m_has_key_pose            = false;
+        evaluatePose();
+    }
+
+    void Skeleton::buildSkeleton(const SkeletonData& skeleton_definition)
+    {
+        m_is_flat    = skeleton_definition.is_flat;
+        m_bone_count = 0;
         if (!m_is_flat || !skeleton_definition.in_topological_order)
         {
             // LOG_ERROR
             return;
         }
         m_bone_count = skeleton_definition.bones_map.size();
-        m_bones      = new Bone[m_bone_count];
+
+        m_parent_indices.resize(m_bone_count);
+        m_bone_ids.resize(m_bone_count);
+        m_bone_names.resize(m_bone_count);
+        m_inverse_tposes.resize(m_bone_count);
+        m_is_lod_bone.assign(m_bone_count, 0);
+        m_initial_transforms.resize(m_bone_count);
         for (size_t i = 0; i < m_bone_count; i++)
         {
-            const RawBone bone_definition = skeleton_definition.bones_map[i];
-            Bone*         parent_bone     = find_by_index(m_bones, bone_definition.parent_index, i, m_is_flat);
-            m_bones[i].initialize(std::make_shared<RawBone>(bone_definition), parent_bone);
+            const RawBone& bone_definition = skeleton_definition.bones_map[i];
+
+            // a parent has to come before its children, roots and invalid parents get -1
+            const int parent_index = bone_definition.parent_index;
+            m_parent_indices[i]    = (parent_index >= 0 && parent_index < i) ? parent_index : -1;
+            m_bone_ids[i]          = bone_definition.index;
+            m_bone_names[i]        = bone_definition.name;
+            m_inverse_tposes[i]    = bone_definition.tpose_matrix;
+
+            Transform& initial_transform = m_initial_transforms[i];
+            initial_transform            = bone_definition.binding_pose;
+            if (initial_transform.m_rotation.isNaN())
+            {
+                initial_transform.m_rotation = Quaternion::IDENTITY;
+            }
+            initial_transform.m_rotation.normalise();
+        }
+        for (const std::string& lod_bone_name : skeleton_definition.lod_bones)
+        {
+            const int bone_index = find_index_by_name(skeleton_definition, lod_bone_name);
+            if (bone_index >= 0 && bone_index < m_bone_count)
+            {
+                m_is_lod_bone[bone_index] = 1;
+            }
         }
+        m_model_transforms.resize(m_bone_count);
+        resetSkeleton();
     }
 
-    void Skeleton::applyAnimation(const BlendStateWithClipData& blend_state)
+    void Skeleton::accumulateClip(const BlendStateCache& blend_state, size_t clip_index, bool skip_lod_bones)
     {
-        if (!m_bones)
+        const CookedAnimationClip& animation_clip = *blend_state.m_blend_clips[clip_index];
+        const AnimSkelMap&         anim_skel_map  = *blend_state.m_blend_anim_skel_maps[clip_index];
+
+        // decode and interpolate all channels of the clip at once
+        animation_clip.sample(blend_state.m_blend_ratios[clip_index], m_sampled_pose);
+
+        for (size_t node_index = 0;
+             node_index < animation_clip.getChannelCount() && node_index < anim_skel_map.convert.size();
+             node_index++)
         {
-            return;
-        }
-        resetSkeleton();
-        for (size_t clip_index = 0; clip_index < 1; clip_index++)
-        {
-            const AnimationClip& animation_clip = blend_state.blend_clip[clip_index];
-            const float          phase          = blend_state.blend_ratio[clip_index];
-            const AnimSkelMap&   anim_skel_map  = blend_state.blend_anim_skel_map[clip_index];
-
-            float exact_frame        = phase * (animation_clip.total_frame - 1);
-            int   current_frame_low  = floor(exact_frame);
-            int   current_frame_high = ceil(exact_frame);
-            float lerp_ratio         = exact_frame - current_frame_low;
-            for (size_t node_index = 0;
-                 node_index < animation_clip.node_count && node_index < anim_skel_map.convert.size();
-                 node_index++)
+            const int bone_index = anim_skel_map.convert[node_index];
+            if (bone_index < 0 || bone_index >= m_bone_count || (skip_lod_bones && m_is_lod_bone[bone_index]))
+            {
+                continue;
+            }
+            const float weight = blend_state.getBoneWeight(clip_index, bone_index);
+            if (weight < 0.0001f)
             {
-                AnimationChannel channel    = animation_clip.node_channels[node_index];
-                size_t           bone_index = anim_skel_map.convert[node_index];
-                float            weight     = 1;
-                if (fabs(weight) < 0.0001f)
-                {
-                    continue;
-                }
-                if (bone_index == std::numeric_limits<size_t>().max())
-                {
-                    // LOG_WARNING
-                    continue;
-                }
-                Bone* bone = &m_bones[bone_index];
-                if (channel.position_keys.size() <= current_frame_high)
-                {
-                    current_frame_high = channel.position_keys.size() - 1;
-                }
-                if (channel.scaling_keys.size() <= current_frame_high)
-                {
-                    current_frame_high = channel.scaling_keys.size() - 1;
-                }
-                if (channel.rotation_keys.size() <= current_frame_high)
-                {
-                    current_frame_high = channel.rotation_keys.size() - 1;
-                }
-                current_frame_low = (current_frame_low < current_frame_high) ? current_frame_low : current_frame_high;
-                Vector3 position  = Vector3::lerp(
-                    channel.position_keys[current_frame_low], channel.position_keys[current_frame_high], lerp_ratio);
-                Vector3 scaling = Vector3::lerp(
-                    channel.scaling_keys[current_frame_low], channel.scaling_keys[current_frame_high], lerp_ratio);
-                Quaternion rotation = Quaternion::nLerp(lerp_ratio,
-                                                        channel.rotation_keys[current_frame_low],
-                                                        channel.rotation_keys[current_frame_high],
-                                                        true);
-
-                {
-                    bone->rotate(rotation);
-                    bone->scale(scaling);
-                    bone->translate(position);
-                }
+                continue;
             }
+
+            Transform&        bone_pose = m_local_pose.m_bone_poses[bone_index];
+            const Quaternion& rotation  = m_sampled_pose.m_rotations[node_index];
+
+            bone_pose.m_position += m_sampled_pose.m_positions[node_index] * weight;
+            bone_pose.m_scale += m_sampled_pose.m_scales[node_index] * weight;
+            // q and -q are the same rotation, keep all clips in the hemisphere of the accumulated rotation
+            bone_pose.m_rotation =
+                bone_pose.m_rotation + rotation * (bone_pose.m_rotation.dot(rotation) < 0 ? -weight : weight);
+            m_local_pose.m_weight.blend_weight[bone_index] += weight;
         }
-        for (size_t i = 0; i < m_bone_count; i++)
+    }
+
+    void Skeleton::addAdditiveClip(const BlendStateCache& blend_state, size_t clip_index, bool skip_lod_bones)
+    {
+        const CookedAnimationClip& animation_clip = *blend_state.m_blend_clips[clip_index];
+        const AnimSkelMap&         anim_skel_map  = *blend_state.m_blend_anim_skel_maps[clip_index];
+
+        animation_clip.sample(blend_state.m_blend_ratios[clip_index], m_sampled_pose);
+
+        for (size_t node_index = 0;
+             node_index < animation_clip.getChannelCount() && node_index < anim_skel_map.convert.size();
+             node_index++)
         {
-            m_bones[i].update();
+            const int bone_index = anim_skel_map.convert[node_index];
+            if (bone_index < 0 || bone_index >= m_bone_count || (skip_lod_bones && m_is_lod_bone[bone_index]))
+            {
+                continue;
+            }
+            const float weight = blend_state.getBoneWeight(clip_index, bone_index);
+            if (weight < 0.0001f)
+            {
+                continue;
+            }
+
+            // additive clips store offsets from the bind pose, scale them by the weight and stack them
+            Transform& bone_pose = m_local_pose.m_bone_poses[bone_index];
+            bone_pose.m_position += m_sampled_pose.m_positions[node_index] * weight;
+            bone_pose.m_scale *= Vector3::lerp(Vector3::UNIT_SCALE, m_sampled_pose.m_scales[node_index], weight);
+            bone_pose.m_rotation =
+                bone_pose.m_rotation *
+                Quaternion::nLerp(weight, Quaternion::IDENTITY, m_sampled_pose.m_rotations[node_index], true);
         }
     }
 
-    AnimationResult Skeleton::outputAnimationResult()
+    void Skeleton::applyAnimation(const BlendStateCache& blend_state, bool skip_lod_bones)
     {
-        AnimationResult animation_result;
-        for (size_t i = 0; i < m_bone_count; i++)
+        if (m_bone_count == 0)
+        {
+            return;
+        }
+
+        m_local_pose.m_bone_poses.assign(m_bone_count,
+                                         Transform(Vector3::ZERO, Quaternion(0, 0, 0, 0), Vector3::ZERO));
+        m_local_pose.m_weight.blend_weight.assign(m_bone_count, 0.f);
+
+        const size_t clip_count = static_cast<size_t>(blend_state.m_clip_count);
+        for (size_t clip_index = 0; clip_index < clip_count; clip_index++)
+        {
+            if (!blend_state.m_is_additive[clip_index])
+            {
+                accumulateClip(blend_state, clip_index, skip_lod_bones);
+            }
+        }
+
+        // bones no clip writes to stay in the initial pose
+        for (size_t bone_index = 0; bone_index < m_bone_count; bone_index++)
         {
-            std::shared_ptr<AnimationResultElement> animation_result_element =
-                std::make_shared<AnimationResultElement>();
-            Bone* bone                      = &m_bones[i];
-            animation_result_element->index = bone->getID() + 1;
-            Vector3 temp_translation        = bone->_getDerivedPosition();
+            Transform&  bone_pose   = m_local_pose.m_bone_poses[bone_index];
+            const float bone_weight = m_local_pose.m_weight.blend_weight[bone_index];
+            if (bone_weight > 0.0001f)
+            {
+                bone_pose.m_position /= bone_weight;
+                bone_pose.m_scale /= bone_weight;
+                bone_pose.m_rotation.normalise();
+            }
+            else
+            {
+                bone_pose = Transform();
+            }
+        }
 
-            Vector3 temp_scale = bone->_getDerivedScale();
+        for (size_t clip_index = 0; clip_index < clip_count; clip_index++)
+        {
+            if (blend_state.m_is_additive[clip_index])
+            {
+                addAdditiveClip(blend_state, clip_index, skip_lod_bones);
+            }
+        }
 
-            Quaternion temp_rotation = bone->_getDerivedOrientation();
+        // every bone is written once, relative to its initial pose
+        std::swap(m_previous_key_transforms, m_key_transforms);
+        for (size_t bone_index = 0; bone_index < m_bone_count; bone_index++)
+        {
+            const Transform& bone_pose = m_local_pose.m_bone_poses[bone_index];
+            const Transform& initial   = m_initial_transforms[bone_index];
+            Transform&       local     = m_key_transforms[bone_index];
 
-            auto objMat =
-                Transform(bone->_getDerivedPosition(), bone->_getDerivedOrientation(), bone->_getDerivedScale())
-                    .getMatrix();
+            local.m_rotation = initial.m_rotation * bone_pose.m_rotation;
+            if (local.m_rotation.isNaN())
+            {
+                local.m_rotation = Quaternion::IDENTITY;
+            }
+            local.m_rotation.normalise();
+            local.m_scale    = initial.m_scale * bone_pose.m_scale;
+            local.m_position = initial.m_position + bone_pose.m_position;
+        }
 
-            auto resMat = objMat * bone->_getInverseTpose();
+        // nothing to interpolate from yet, blending from the initial pose would show the bind pose
+        if (!m_has_key_pose)
+        {
+            m_previous_key_transforms = m_key_transforms;
+            m_has_key_pose            = true;
+        }
+    }
+
+    void Skeleton::evaluatePose(float key_ratio)
+    {
+        if (key_ratio >= 1.f)
+        {
+            m_local_transforms = m_key_transforms;
+        }
+        else
+        {
+            for (size_t bone_index = 0; bone_index < m_bone_count; bone_index++)
+            {
+                const Transform& from  = m_previous_key_transforms[bone_index];
+                const Transform& to    = m_key_transforms[bone_index];
+                Transform&       local = m_local_transforms[bone_index];
 
-            animation_result_element->transform = resMat.toMatrix4x4_();
+                local.m_position = Vector3::lerp(from.m_position, to.m_position, key_ratio);
+                local.m_scale    = Vector3::lerp(from.m_scale, to.m_scale, key_ratio);
+                local.m_rotation = Quaternion::nLerp(key_ratio, from.m_rotation, to.m_rotation, true);
+            }
+        }
+        getPoseJob().execute();
+    }
+
+    void Skeleton::outputAnimationResult(AnimationResult& out_result) const
+    {
+        out_result.node.resize(m_bone_count);
+        for (size_t i = 0; i < m_bone_count; i++)
+        {
+            auto resMat = m_model_transforms[i].getMatrix() * m_inverse_tposes[i];
 
-            animation_result.node.push_back(*animation_result_element);
+            AnimationResultElement& animation_result_element = out_result.node[i];
+            animation_result_element.index                   = m_bone_ids[i] + 1;
+            animation_result_element.transform               = resMat.toMatrix4x4_();
         }
-        return animation_result;
     }
 
-    const Bone* Skeleton::getBones() const
+    SkeletonPoseJob Skeleton::getPoseJob()
     {
-        return m_bones;
+        SkeletonPoseJob pose_job;
+        pose_job.m_parent_indices   = m_parent_indices.data();
+        pose_job.m_local_transforms = m_local_transforms.data();
+        pose_job.m_model_transforms = m_model_transforms.data();
+        pose_job.m_bone_count       = m_bone_count;
+        return pose_job;
     }
 
     int32_t Skeleton::getBonesCount() const
@@ -1,12 +1,49 @@
 #pragma once
 
 #include "runtime/resource/res_type/components/animation.h"
-#include "runtime/function/animation/node.h"
+#include "runtime/function/animation/cooked_animation_clip.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
 
 namespace Piccolo
 {
     class SkeletonData;
-    class BlendStateWithClipData;
+
+    /// Clip data of a BlendState resolved from the AnimationManager caches.
+    /// Clips and maps are shared with the caches and never modified after loading, the per bone weights only depend
+    /// on the file paths and clip weights of the blend state, so they are rebuilt only when those change and the
+    /// steady state update just copies the blend ratios.
+    struct BlendStateCache
+    {
+        int                                                     m_clip_count {0};
+        std::vector<std::shared_ptr<const CookedAnimationClip>> m_blend_clips;
+        std::vector<std::shared_ptr<const AnimSkelMap>>         m_blend_anim_skel_maps;
+        // per bone weights from the masks, normalized over the non additive clips
+        std::vector<BoneBlendWeight> m_blend_weights;
+        // weight of the bones a clip has no mask weight for
+        std::vector<float>   m_clip_weights;
+        std::vector<uint8_t> m_is_additive;
+        std::vector<float>   m_blend_ratios;
+
+        float getBoneWeight(size_t clip_index, size_t bone_index) const
+        {
+            const std::vector<float>& bone_weights = m_blend_weights[clip_index].blend_weight;
+            return bone_index < bone_weights.size() ? bone_weights[bone_index] : m_clip_weights[clip_index];
+        }
+
+        /// hash of everything in the blend state the cache is built from, the blend ratios are left out
+        static size_t computeSourceHash(const BlendState& blend_state);
+
+        bool isBuiltFrom(const BlendState& blend_state) const;
+
+    private:
+        friend class AnimationManager;
+
+        bool   m_is_built {false};
+        size_t m_source_hash {0};
+    };
 
     class AnimationPose
     {
@@ -17,21 +54,64 @@ namespace Piccolo
         void blend(const AnimationPose& other);
     };
 
+    /// Local to model evaluation of one skeleton over flat buffers, bones are in topological order so a single
+    /// linear pass composes every bone with its already evaluated parent. A job only touches the buffers it points
+    /// to, so the jobs of different characters can run in parallel.
+    struct SkeletonPoseJob
+    {
+        const int32_t*   m_parent_indices {nullptr};
+        const Transform* m_local_transforms {nullptr};
+        Transform*       m_model_transforms {nullptr};
+        size_t           m_bone_count {0};
+
+        void execute() const;
+    };
+
     class Skeleton
     {
     private:
-        bool  m_is_flat {false};
-        int   m_bone_count {0};
-        Bone* m_bones {nullptr};
+        bool m_is_flat {false};
+        int  m_bone_count {0};
+
+        // per bone data, indexed by bone, a parent index is always smaller than the index of its children
+        std::vector<int32_t>     m_parent_indices;
+        std::vector<int32_t>     m_bone_ids;
+        std::vector<std::string> m_bone_names;
+        std::vector<Matrix4x4>   m_inverse_tposes;
+        std::vector<uint8_t>     m_is_lod_bone;
+        std::vector<Transform>   m_initial_transforms;
+        // the last two poses sampled from the clips, the local pose is interpolated between them
+        std::vector<Transform> m_previous_key_transforms;
+        std::vector<Transform> m_key_transforms;
+        // false until the first key pose is sampled, which then also becomes the previous one
+        bool                   m_has_key_pose {false};
+        std::vector<Transform> m_local_transforms;
+        std::vector<Transform> m_model_transforms;
+
+        SampledClipPose m_sampled_pose;
+        // offsets from the initial pose blended from all clips, one entry per bone
+        AnimationPose m_local_pose;
+
+        void accumulateClip(const BlendStateCache& blend_state, size_t clip_index, bool skip_lod_bones);
+        void addAdditiveClip(const BlendStateCache& blend_state, size_t clip_index, bool skip_lod_bones);
 
     public:
-        ~Skeleton();
-
-        void            buildSkeleton(const SkeletonData& skeleton_definition);
-        void            applyAnimation(const BlendStateWithClipData& blend_state);
-        AnimationResult outputAnimationResult();
-        void            resetSkeleton();
-        const Bone*     getBones() const;
-        int32_t         getBonesCount() const;
+        void buildSkeleton(const SkeletonData& skeleton_definition);
+        // samples a new key pose from the clips, lod bones are left in their initial pose if skipped
+        void applyAnimation(const BlendStateCache& blend_state, bool skip_lod_bones = false);
+        // blends the previous key pose into the last one by key_ratio and evaluates the model transforms
+        void evaluatePose(float key_ratio = 1.f);
+        // writes into out_result in place, so an already sized result is reused without allocating
+        void outputAnimationResult(AnimationResult& out_result) const;
+        void resetSkeleton();
+        bool hasKeyPose() const { return m_has_key_pose; }
+
+        // evaluates m_model_transforms from m_local_transforms when executed
+        SkeletonPoseJob getPoseJob();
+
+        int32_t            getBonesCount() const;
+        int32_t            getBoneParentIndex(int32_t bone_index) const { return m_parent_indices[bone_index]; }
+        const std::string& getBoneName(int32_t bone_index) const { return m_bone_names[bone_index]; }
+        const Transform&   getBoneModelTransform(int32_t bone_index) const { return m_model_transforms[bone_index]; }
     };
-} // namespace Piccolo
\ No newline at end of file
+} // namespace Piccolo
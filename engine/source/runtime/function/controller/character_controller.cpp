@@ -7,9 +7,25 @@
 #include "runtime/function/global/global_context.h"
 #include "runtime/function/physics/physics_scene.h"
 
+#include <algorithm>
+
 namespace Piccolo
 {
-    CharacterController::CharacterController(const Capsule& capsule) : m_capsule(capsule)
+    namespace
+    {
+        // gap kept between the capsule and the surfaces, so that the next sweep does not start in contact
+        constexpr float k_contact_offset = 0.01f;
+        // shorter moves are not worth a sweep
+        constexpr float k_min_move_distance = 1e-4f;
+        // surfaces with a normal below this are walls, about 45 degrees
+        constexpr float k_min_ground_normal_z = 0.7f;
+    } // namespace
+
+    CharacterController::CharacterController(const PhysicsControllerConfig& config) :
+        m_capsule(config.m_capsule_shape),
+        m_max_slide_iterations(static_cast<uint32_t>(std::max(config.m_max_slide_iterations, 1))),
+        m_step_height(std::max(config.m_step_height, 0.f)),
+        m_ground_snap_distance(std::max(config.m_ground_snap_distance, 0.f))
     {
         m_rigidbody_shape                                    = RigidBodyShape();
         m_rigidbody_shape.m_geometry                         = PICCOLO_REFLECTION_NEW(Capsule);
@@ -21,79 +37,166 @@ namespace Piccolo
         orientation.fromAngleAxis(Radian(Degree(90.f)), Vector3::UNIT_X);
 
         m_rigidbody_shape.m_local_transform =
-            Transform(Vector3(0, 0, capsule.m_half_height + capsule.m_radius), orientation, Vector3::UNIT_SCALE);
+            Transform(Vector3(0, 0, m_capsule.m_half_height + m_capsule.m_radius), orientation, Vector3::UNIT_SCALE);
+
+        m_query_shape = std::make_unique<PhysicsQueryShape>(m_rigidbody_shape);
+
+        m_sweep_requests.resize(1);
+        m_sweep_requests[0].m_query_shape = m_query_shape.get();
     }
 
     Vector3 CharacterController::move(const Vector3& current_position, const Vector3& displacement)
     {
-        std::shared_ptr<PhysicsScene> physics_scene = g_runtime_global_context.m_world_manager->getCurrentActivePhysicsScene().lock();
+        std::shared_ptr<PhysicsScene> physics_scene =
+            g_runtime_global_context.m_world_manager->getCurrentActivePhysicsScene().lock();
         ASSERT(physics_scene);
 
-        Vector3 final_position = current_position;
-        Vector3 remaining_displacement = displacement;
-
-        // Vertical pass
-        Vector3 vertical_displacement = Vector3(0, 0, remaining_displacement.z);
-        std::vector<PhysicsHitInfo> hits;
-        if (physics_scene->sweep(m_rigidbody_shape, 
-                                Transform(final_position, Quaternion::IDENTITY, Vector3::UNIT_SCALE).getMatrix(),
-                                vertical_displacement.normalisedCopy(),
-                                vertical_displacement.length(),
-                                hits))
+        const Vector3 horizontal_displacement(displacement.x, displacement.y, 0.f);
+        const bool    is_walking = m_is_touch_ground && displacement.z <= 0.f;
+
+        Vector3        final_position = current_position;
+        PhysicsHitInfo hit;
+
+        // most moves are free, a blocked one first tries to walk over the obstacle from a lifted capsule, then slides
+        float       step_up_distance    = 0.f;
+        const float horizontal_distance = horizontal_displacement.length();
+        if (horizontal_distance >= k_min_move_distance)
         {
-            final_position += hits[0].hit_distance * vertical_displacement.normalisedCopy();
-            m_is_touch_ground = (hits[0].hit_normal.z > 0.7f);
-            
-            // If we hit a ceiling while jumping, set vertical velocity to zero
-            if (hits[0].hit_normal.z < -0.7f && vertical_displacement.z > 0)
+            const Vector3 horizontal_direction = horizontal_displacement / horizontal_distance;
+            const float   sweep_distance       = horizontal_distance + k_contact_offset;
+
+            bool is_blocked = sweep(*physics_scene, final_position, horizontal_direction, sweep_distance, hit);
+
+            // obstacles touched higher than the step height are too high to walk over
+            if (is_blocked && is_walking && m_step_height > 0.f &&
+                hit.hit_position.z <= final_position.z + m_step_height)
             {
-                remaining_displacement.z = 0;
+                step_up_distance =
+                    sweep(*physics_scene, final_position, Vector3::UNIT_Z, m_step_height + k_contact_offset, hit) ?
+                        std::max(hit.hit_distance - k_contact_offset, 0.f) :
+                        m_step_height;
+                final_position.z += step_up_distance;
+
+                is_blocked = sweep(*physics_scene, final_position, horizontal_direction, sweep_distance, hit);
             }
+
+            final_position = is_blocked ? slide(*physics_scene, final_position, horizontal_displacement, hit) :
+                                          final_position + horizontal_displacement;
         }
-        else
+
+        // the vertical pass also puts the lifted capsule back down
+        const float vertical_distance = displacement.z - step_up_distance;
+        if (vertical_distance > 0.f)
         {
-            final_position += vertical_displacement;
+            if (sweep(*physics_scene, final_position, Vector3::UNIT_Z, vertical_distance + k_contact_offset, hit))
+            {
+                final_position.z += std::max(hit.hit_distance - k_contact_offset, 0.f);
+            }
+            else
+            {
+                final_position.z += vertical_distance;
+            }
             m_is_touch_ground = false;
+            return final_position;
         }
 
-        // Horizontal pass
-        Vector3 horizontal_displacement = Vector3(remaining_displacement.x, remaining_displacement.y, 0);
-        hits.clear();
-        if (physics_scene->sweep(m_rigidbody_shape,
-                                Transform(final_position, Quaternion::IDENTITY, Vector3::UNIT_SCALE).getMatrix(),
-                                horizontal_displacement.normalisedCopy(),
-                                horizontal_displacement.length(),
-                                hits))
+        // walking characters look a bit further down to stay on the ground
+        const float fall_distance = -vertical_distance;
+        const float snap_distance = is_walking ? m_ground_snap_distance : 0.f;
+        if (sweep(*physics_scene,
+                  final_position,
+                  Vector3::NEGATIVE_UNIT_Z,
+                  fall_distance + snap_distance + k_contact_offset,
+                  hit))
         {
-            Vector3 slide_plane_normal = hits[0].hit_normal;
-            Vector3 slide_vector = horizontal_displacement - slide_plane_normal * horizontal_displacement.dotProduct(slide_plane_normal);
-            
-            final_position += hits[0].hit_distance * horizontal_displacement.normalisedCopy();
-            
-            // Try to slide along the wall
-            if (slide_vector.length() > 0.01f)
+            // sweep normals point into the surface
+            const bool is_ground = -hit.hit_normal.z >= k_min_ground_normal_z;
+            if (is_ground || hit.hit_distance <= fall_distance + k_contact_offset)
             {
-                hits.clear();
-                if (!physics_scene->sweep(m_rigidbody_shape,
-                                        Transform(final_position, Quaternion::IDENTITY, Vector3::UNIT_SCALE).getMatrix(),
-                                        slide_vector.normalisedCopy(),
-                                        slide_vector.length(),
-                                        hits))
-                {
-                    final_position += slide_vector;
-                }
-                else
-                {
-                    final_position += hits[0].hit_distance * slide_vector.normalisedCopy();
-                }
+                // may lift a capsule resting closer than the contact offset, the horizontal sweeps would hit the ground
+                final_position.z -= hit.hit_distance - k_contact_offset;
+                m_is_touch_ground = is_ground;
+                return final_position;
             }
         }
-        else
+
+        final_position.z -= fall_distance;
+        m_is_touch_ground = false;
+        return final_position;
+    }
+
+    Vector3 CharacterController::slide(const PhysicsScene& physics_scene,
+                                       const Vector3&      start_position,
+                                       const Vector3&      displacement,
+                                       PhysicsHitInfo      hit)
+    {
+        Vector3 position        = start_position;
+        Vector3 remaining       = displacement;
+        Vector3 previous_normal = Vector3::ZERO;
+
+        for (uint32_t iteration = 1;; ++iteration)
         {
-            final_position += horizontal_displacement;
+            const float   distance  = remaining.length();
+            const Vector3 direction = remaining / distance;
+
+            const float travel_distance = std::max(hit.hit_distance - k_contact_offset, 0.f);
+            position += direction * travel_distance;
+
+            // slide along the surface, treated as vertical so that sliding never lifts or sinks the capsule
+            Vector3 normal = -hit.hit_normal;
+            normal.z       = 0.f;
+            if (normal.squaredLength() < k_min_move_distance)
+                break;
+            normal.normalise();
+
+            remaining = direction * (distance - travel_distance);
+            remaining -= normal * remaining.dotProduct(normal);
+
+            // sliding into the previous surface again means the capsule is stuck in a corner
+            if (iteration > 1 && remaining.dotProduct(previous_normal) < 0.f)
+                break;
+            // never slide back against the requested move
+            if (remaining.dotProduct(displacement) <= 0.f)
+                break;
+
+            previous_normal = normal;
+
+            const float remaining_distance = remaining.length();
+            if (iteration == m_max_slide_iterations || remaining_distance < k_min_move_distance)
+                break;
+
+            if (!sweep(physics_scene,
+                       position,
+                       remaining / remaining_distance,
+                       remaining_distance + k_contact_offset,
+                       hit))
+            {
+                position += remaining;
+                break;
+            }
         }
-        
 
-        return final_position;
+        return position;
+    }
+
+    bool CharacterController::sweep(const PhysicsScene& physics_scene,
+                                    const Vector3&      position,
+                                    const Vector3&      direction,
+                                    float               distance,
+                                    PhysicsHitInfo&     out_hit)
+    {
+        PhysicsSweepRequest& request = m_sweep_requests[0];
+        request.m_shape_transform.makeTrans(position);
+        request.m_direction = direction;
+        request.m_length    = distance;
+
+        physics_scene.sweepBatch(m_sweep_requests, m_sweep_results, m_sweep_hits);
+
+        const PhysicsQueryResult& result = m_sweep_results[0];
+        if (result.m_hit_count == 0)
+            return false;
+
+        out_hit = m_sweep_hits[result.m_first_hit];
+        return true;
     }
-} // namespace Piccolo
\ No newline at end of file
+} // namespace Piccolo
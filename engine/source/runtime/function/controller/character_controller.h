@@ -1,9 +1,15 @@
 #pragma once
 
 #include "runtime/core/math/vector3.h"
+#include "runtime/resource/res_type/components/motor.h"
 #include "runtime/resource/res_type/components/rigid_body.h"
 #include "runtime/resource/res_type/data/basic_shape.h"
 
+#include "runtime/function/physics/physics_scene.h"
+
+#include <memory>
+#include <vector>
+
 namespace Piccolo
 {
     enum SweepPass
@@ -22,17 +28,44 @@ namespace Piccolo
         virtual Vector3 move(const Vector3& current_position, const Vector3& displacement) = 0;
     };
 
+    /// Kinematic capsule moved by collide and slide: a step up, an iterative horizontal pass sliding along what it
+    /// runs into, and a vertical pass that lands the capsule and snaps walking characters to the ground.
     class CharacterController : public Controller
     {
     public:
-        CharacterController(const Capsule& capsule);
+        CharacterController(const PhysicsControllerConfig& config);
         ~CharacterController() = default;
 
         Vector3 move(const Vector3& current_position, const Vector3& displacement) override;
 
+        bool isTouchGround() const { return m_is_touch_ground; }
+
     private:
+        // hit is what the capsule runs into when moving the whole displacement from start_position
+        Vector3 slide(const PhysicsScene& physics_scene,
+                      const Vector3&      start_position,
+                      const Vector3&      displacement,
+                      PhysicsHitInfo      hit);
+
+        // closest hit of the capsule swept from position, false if the way is free
+        bool sweep(const PhysicsScene& physics_scene,
+                   const Vector3&      position,
+                   const Vector3&      direction,
+                   float               distance,
+                   PhysicsHitInfo&     out_hit);
+
         Capsule        m_capsule;
         RigidBodyShape m_rigidbody_shape;
         bool           m_is_touch_ground {false};
+
+        uint32_t m_max_slide_iterations {4};
+        float    m_step_height {0.f};
+        float    m_ground_snap_distance {0.f};
+
+        // the capsule converted once, and a single request batch reused by every sweep
+        std::unique_ptr<PhysicsQueryShape> m_query_shape;
+        std::vector<PhysicsSweepRequest>   m_sweep_requests;
+        std::vector<PhysicsQueryResult>    m_sweep_results;
+        std::vector<PhysicsHitInfo>        m_sweep_hits;
     };
-} // namespace Piccolo
\ No newline at end of file
+} // namespace Piccolo
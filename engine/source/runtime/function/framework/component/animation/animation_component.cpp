@@ -1,7 +1,14 @@
 #include "runtime/function/framework/component/animation/animation_component.h"
 
 #include "runtime/function/animation/animation_system.h"
+#include "runtime/function/framework/component/transform/transform_component.h"
 #include "runtime/function/framework/object/object.h"
+#include "runtime/function/global/global_context.h"
+#include "runtime/function/render/render_camera.h"
+#include "runtime/function/render/render_system.h"
+
+#include <algorithm>
+#include <chrono>
 
 namespace Piccolo
 {
@@ -12,16 +19,93 @@ namespace Piccolo
         auto skeleton_res = AnimationManager::tryLoadSkeleton(m_animation_res.skeleton_file_path);
 
         m_skeleton.buildSkeleton(*skeleton_res);
+
+        // seeded per object, so that the throttled full updates of the components are spread over the frames
+        std::shared_ptr<GObject> parent = parent_object.lock();
+        m_frames_since_update           = parent ? static_cast<uint32_t>(parent->getID()) : 0;
     }
 
     void AnimationComponent::tick(float delta_time)
     {
-        m_animation_res.blend_state.blend_ratio[0] +=
-            (delta_time / m_animation_res.blend_state.blend_clip_file_length[0]);
-        m_animation_res.blend_state.blend_ratio[0] -= floor(m_animation_res.blend_state.blend_ratio[0]);
+        using namespace std::chrono;
+
+        const steady_clock::time_point tick_start = steady_clock::now();
+
+        // every clip of the blend state plays at its own length
+        BlendState&  blend_state = m_animation_res.blend_state;
+        const size_t clip_count  = std::min(blend_state.blend_ratio.size(), blend_state.blend_clip_file_length.size());
+        for (size_t clip_index = 0; clip_index < clip_count; clip_index++)
+        {
+            blend_state.blend_ratio[clip_index] += (delta_time / blend_state.blend_clip_file_length[clip_index]);
+            blend_state.blend_ratio[clip_index] -= floor(blend_state.blend_ratio[clip_index]);
+        }
+
+        const AnimationLodLevel* lod_level = selectLodLevel();
+        const uint32_t update_interval = lod_level ? static_cast<uint32_t>(std::max(lod_level->update_interval, 1)) : 1;
+        const bool     skip_lod_bones  = lod_level && lod_level->skip_lod_bones;
+
+        // the clips are only sampled every update_interval frames, the frames in between interpolate from the
+        // previous key pose to the last one, so the pose lags update_interval - 1 frames behind the clips
+        m_frames_since_update %= update_interval;
+        // the first tick samples the clips whatever the seed of m_frames_since_update
+        const bool is_full_update = m_frames_since_update == 0 || !m_skeleton.hasKeyPose();
+        if (is_full_update)
+        {
+            AnimationManager::updateBlendStateCache(m_animation_res.blend_state, m_blend_state_cache);
+            m_skeleton.applyAnimation(m_blend_state_cache, skip_lod_bones);
+        }
+        m_skeleton.evaluatePose(static_cast<float>(m_frames_since_update + 1) / update_interval);
+        m_skeleton.outputAnimationResult(m_animation_res.animation_result);
+        m_frames_since_update++;
+
+        const float update_time_us = duration<float, std::micro>(steady_clock::now() - tick_start).count();
+
+        AnimationLodStats& lod_stats = AnimationManager::getLodStats();
+        if (is_full_update)
+        {
+            // moving average, the first update sets it directly
+            m_full_update_time_us = m_full_update_time_us > 0.f ?
+                                        m_full_update_time_us + (update_time_us - m_full_update_time_us) * 0.1f :
+                                        update_time_us;
+            lod_stats.m_full_update_count++;
+            if (skip_lod_bones)
+            {
+                lod_stats.m_skipped_lod_bone_update_count++;
+            }
+        }
+        else
+        {
+            lod_stats.m_interpolated_update_count++;
+            lod_stats.m_saved_time_us += static_cast<uint64_t>(std::max(m_full_update_time_us - update_time_us, 0.f));
+        }
+    }
+
+    const AnimationLodLevel* AnimationComponent::selectLodLevel() const
+    {
+        const std::vector<AnimationLodLevel>& lod_levels = m_animation_res.lod_levels;
+        if (lod_levels.empty())
+            return nullptr;
+
+        std::shared_ptr<GObject>  parent_object = m_parent_object.lock();
+        const TransformComponent* transform_component =
+            parent_object ? parent_object->tryGetComponentConst<TransformComponent>() : nullptr;
+        std::shared_ptr<RenderSystem> render_system = g_runtime_global_context.m_render_system;
+        if (transform_component == nullptr || render_system == nullptr)
+            return nullptr;
+
+        // the render camera belongs to the render thread
+        const float camera_distance =
+            (render_system->getSwapContext().getLogicCamera().m_position - transform_component->getPosition()).length();
 
-        m_skeleton.applyAnimation(AnimationManager::getBlendStateWithClipData(m_animation_res.blend_state));
-        m_animation_res.animation_result = m_skeleton.outputAnimationResult();
+        const AnimationLodLevel* lod_level = nullptr;
+        for (const AnimationLodLevel& level : lod_levels)
+        {
+            if (camera_distance >= level.min_distance)
+            {
+                lod_level = &level;
+            }
+        }
+        return lod_level;
     }
 
     const AnimationResult& AnimationComponent::getResult() const { return m_animation_res.animation_result; }
@@ -17,6 +17,7 @@ namespace Piccolo
         void postLoadResource(std::weak_ptr<GObject> parent_object) override;
 
         void tick(float delta_time) override;
+        ComponentTickPhase getTickPhase() const override { return ComponentTickPhase::animation; }
 
         const AnimationResult& getResult() const;
 
@@ -26,6 +27,14 @@ namespace Piccolo
         META(Enable)
         AnimationComponentRes m_animation_res;
 
-        Skeleton m_skeleton;
+        Skeleton        m_skeleton;
+        BlendStateCache m_blend_state_cache;
+
+    private:
+        // nullptr when the component is updated at full detail
+        const AnimationLodLevel* selectLodLevel() const;
+
+        uint32_t m_frames_since_update {0};
+        float    m_full_update_time_us {0.f};
     };
 } // namespace Piccolo
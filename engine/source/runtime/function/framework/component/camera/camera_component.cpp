@@ -41,8 +41,8 @@ namespace Piccolo
 
         RenderSwapContext& swap_context = g_runtime_global_context.m_render_system->getSwapContext();
         CameraSwapData     camera_swap_data;
-        camera_swap_data.m_fov_x                           = m_camera_res.m_parameter->m_fov;
-        swap_context.getLogicSwapData().m_camera_swap_data = camera_swap_data;
+        camera_swap_data.m_fov_x = m_camera_res.m_parameter->m_fov;
+        swap_context.setCameraSwapData(camera_swap_data);
     }
 
     void CameraComponent::tick(float delta_time)
@@ -97,9 +97,9 @@ namespace Piccolo
 
         RenderSwapContext& swap_context = g_runtime_global_context.m_render_system->getSwapContext();
         CameraSwapData     camera_swap_data;
-        camera_swap_data.m_camera_type                     = RenderCameraType::Motor;
-        camera_swap_data.m_view_matrix                     = desired_mat;
-        swap_context.getLogicSwapData().m_camera_swap_data = camera_swap_data;
+        camera_swap_data.m_camera_type = RenderCameraType::Motor;
+        camera_swap_data.m_view_matrix = desired_mat;
+        swap_context.setCameraSwapData(camera_swap_data);
 
         Vector3    object_facing = m_forward - m_forward.dotProduct(Vector3::UNIT_Z) * Vector3::UNIT_Z;
         Vector3    object_left   = Vector3::UNIT_Z.crossProduct(object_facing);
@@ -142,9 +142,9 @@ namespace Piccolo
 
         RenderSwapContext& swap_context = g_runtime_global_context.m_render_system->getSwapContext();
         CameraSwapData     camera_swap_data;
-        camera_swap_data.m_camera_type                     = RenderCameraType::Motor;
-        camera_swap_data.m_view_matrix                     = desired_mat;
-        swap_context.getLogicSwapData().m_camera_swap_data = camera_swap_data;
+        camera_swap_data.m_camera_type = RenderCameraType::Motor;
+        camera_swap_data.m_view_matrix = desired_mat;
+        swap_context.setCameraSwapData(camera_swap_data);
     }
 
     void CameraComponent::tickFreeCamera(float delta_time)
@@ -201,6 +201,6 @@ namespace Piccolo
         CameraSwapData     camera_swap_data;
         camera_swap_data.m_camera_type = RenderCameraType::Motor;
         camera_swap_data.m_view_matrix = desired_mat;
-        swap_context.getLogicSwapData().m_camera_swap_data = camera_swap_data;
+        swap_context.setCameraSwapData(camera_swap_data);
     }
 } // namespace Piccolo
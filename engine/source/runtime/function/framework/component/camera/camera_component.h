@@ -29,6 +29,7 @@ namespace Piccolo
         void postLoadResource(std::weak_ptr<GObject> parent_object) override;
 
         void tick(float delta_time) override;
+        ComponentTickPhase getTickPhase() const override { return ComponentTickPhase::post_physics; }
 
         CameraMode getCameraMode() const { return m_camera_mode; }
         void setCameraMode(CameraMode mode) { m_camera_mode = mode; }
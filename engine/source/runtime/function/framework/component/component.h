@@ -4,6 +4,19 @@
 namespace Piccolo
 {
     class GObject;
+
+    /// The phase a component is ticked in. The order between phases is recorded by LevelTickScheduler,
+    /// objects within one phase may be ticked in parallel
+    enum class ComponentTickPhase : unsigned char
+    {
+        pre_physics,
+        physics,
+        post_physics,
+        animation,
+        render_extract,
+        count
+    };
+
     // Component
     REFLECTION_TYPE(Component)
     CLASS(Component, WhiteListFields)
@@ -23,6 +36,8 @@ namespace Piccolo
 
         virtual void tick(float delta_time) {};
 
+        virtual ComponentTickPhase getTickPhase() const { return ComponentTickPhase::pre_physics; }
+
         bool isDirty() const { return m_is_dirty; }
 
         void setDirtyFlag(bool is_dirty) { m_is_dirty = is_dirty; }
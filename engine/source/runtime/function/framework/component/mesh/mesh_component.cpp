@@ -20,12 +20,12 @@ namespace Piccolo
         std::shared_ptr<AssetManager> asset_manager = g_runtime_global_context.m_asset_manager;
         ASSERT(asset_manager);
 
-        m_raw_meshes.resize(m_mesh_res.m_sub_meshes.size());
+        std::vector<GameObjectPartDesc> raw_meshes(m_mesh_res.m_sub_meshes.size());
 
         size_t raw_mesh_count = 0;
         for (const SubMeshRes& sub_mesh : m_mesh_res.m_sub_meshes)
         {
-            GameObjectPartDesc& meshComponent = m_raw_meshes[raw_mesh_count];
+            GameObjectPartDesc& meshComponent = raw_meshes[raw_mesh_count];
             meshComponent.m_mesh_desc.m_mesh_file =
                 asset_manager->getFullPath(sub_mesh.m_obj_file_ref).generic_string();
 
@@ -54,50 +54,56 @@ namespace Piccolo
 
             ++raw_mesh_count;
         }
+
+        m_raw_meshes               = std::make_shared<const std::vector<GameObjectPartDesc>>(std::move(raw_meshes));
+        m_is_render_desc_submitted = false;
     }
 
     void MeshComponent::tick(float delta_time)
     {
-        if (!m_parent_object.lock())
+        std::shared_ptr<GObject> parent_object = m_parent_object.lock();
+        if (!parent_object)
             return;
 
-        TransformComponent*       transform_component = m_parent_object.lock()->tryGetComponent(TransformComponent);
-        const AnimationComponent* animation_component =
-            m_parent_object.lock()->tryGetComponentConst(AnimationComponent);
+        TransformComponent*       transform_component = parent_object->tryGetComponent(TransformComponent);
+        const AnimationComponent* animation_component = parent_object->tryGetComponentConst(AnimationComponent);
 
-        if (transform_component->isDirty())
+        if (m_raw_meshes && (transform_component->isDirty() || !m_is_render_desc_submitted))
         {
-            std::vector<GameObjectPartDesc> dirty_mesh_parts;
-            SkeletonAnimationResult         animation_result;
-            animation_result.m_transforms.push_back({Matrix4x4::IDENTITY});
-            if (animation_component != nullptr)
-            {
-                for (auto& node : animation_component->getResult().node)
-                {
-                    animation_result.m_transforms.push_back({Matrix4x4(node.transform)});
-                }
-            }
-            for (GameObjectPartDesc& mesh_part : m_raw_meshes)
-            {
-                if (animation_component)
-                {
-                    mesh_part.m_with_animation                                = true;
-                    mesh_part.m_skeleton_animation_result                     = animation_result;
-                    mesh_part.m_skeleton_binding_desc.m_skeleton_binding_file = mesh_part.m_mesh_desc.m_mesh_file;
-                }
-                Matrix4x4 object_transform_matrix = mesh_part.m_transform_desc.m_transform_matrix;
-
-                mesh_part.m_transform_desc.m_transform_matrix =
-                    transform_component->getMatrix() * object_transform_matrix;
-                dirty_mesh_parts.push_back(mesh_part);
-
-                mesh_part.m_transform_desc.m_transform_matrix = object_transform_matrix;
-            }
+            const AnimationResult* animation_result =
+                animation_component != nullptr ? &animation_component->getResult() : nullptr;
+            // the first joint is the identity, animated bones follow
+            const uint32_t joint_count =
+                1 + (animation_result != nullptr ? static_cast<uint32_t>(animation_result->node.size()) : 0);
 
             RenderSwapContext& render_swap_context = g_runtime_global_context.m_render_system->getSwapContext();
             RenderSwapData&    logic_swap_data     = render_swap_context.getLogicSwapData();
 
-            logic_swap_data.addDirtyGameObject(GameObjectDesc {m_parent_object.lock()->getID(), dirty_mesh_parts});
+            // write the frame data straight into the packet, the shared part descs only go with the first one
+            const GObjectID       go_id               = parent_object->getID();
+            const uint32_t        part_count          = static_cast<uint32_t>(m_raw_meshes->size());
+            const bool            is_transform_update = m_is_render_desc_submitted;
+            DirtyGameObjectBatch& dirty_game_objects =
+                is_transform_update ? logic_swap_data.m_moved_game_objects : logic_swap_data.m_dirty_game_objects;
+            const DirtyGameObjectDesc& gobject =
+                is_transform_update ? dirty_game_objects.addTransformUpdate(go_id, part_count, joint_count)
+                                    : dirty_game_objects.add(go_id, m_raw_meshes, joint_count);
+            m_is_render_desc_submitted = true;
+
+            const Matrix4x4 object_transform_matrix = transform_component->getMatrix();
+            Matrix4x4*      part_transforms         = dirty_game_objects.getPartTransforms(gobject);
+            for (uint32_t part_index = 0; part_index < part_count; ++part_index)
+            {
+                part_transforms[part_index] =
+                    object_transform_matrix * (*m_raw_meshes)[part_index].m_transform_desc.m_transform_matrix;
+            }
+
+            Matrix4x4* joint_matrices = dirty_game_objects.getJointMatrices(gobject);
+            joint_matrices[0]         = Matrix4x4::IDENTITY;
+            for (uint32_t joint_index = 1; joint_index < joint_count; ++joint_index)
+            {
+                joint_matrices[joint_index] = Matrix4x4(animation_result->node[joint_index - 1].transform);
+            }
 
             transform_component->setDirtyFlag(false);
         }
@@ -6,6 +6,7 @@
 
 #include "runtime/function/render/render_object.h"
 
+#include <memory>
 #include <vector>
 
 namespace Piccolo
@@ -21,14 +22,18 @@ namespace Piccolo
 
         void postLoadResource(std::weak_ptr<GObject> parent_object) override;
 
-        const std::vector<GameObjectPartDesc>& getRawMeshes() const { return m_raw_meshes; }
+        const std::vector<GameObjectPartDesc>& getRawMeshes() const { return *m_raw_meshes; }
 
         void tick(float delta_time) override;
+        ComponentTickPhase getTickPhase() const override { return ComponentTickPhase::render_extract; }
 
     private:
         META(Enable)
         MeshComponentRes m_mesh_res;
 
-        std::vector<GameObjectPartDesc> m_raw_meshes;
+        // immutable after loading, shared with the frame packets of the renderer
+        std::shared_ptr<const std::vector<GameObjectPartDesc>> m_raw_meshes;
+        // the full part descs are only sent once, afterwards the renderer gets transform updates
+        bool m_is_render_desc_submitted {false};
     };
 } // namespace Piccolo
@@ -25,7 +25,7 @@ namespace Piccolo
             m_controller_type = ControllerType::physics;
             PhysicsControllerConfig* controller_config =
                 static_cast<PhysicsControllerConfig*>(m_motor_res.m_controller_config);
-            m_controller = new CharacterController(controller_config->m_capsule_shape);
+            m_controller = new CharacterController(*controller_config);
         }
         else if (m_motor_res.m_controller_config != nullptr)
         {
@@ -63,8 +63,7 @@ namespace Piccolo
         if (current_character->getObjectID() != m_parent_object.lock()->getID())
             return;
 
-        TransformComponent* transform_component =
-            m_parent_object.lock()->tryGetComponent<TransformComponent>("TransformComponent");
+        TransformComponent* transform_component = m_parent_object.lock()->tryGetComponent<TransformComponent>();
 
         Radian turn_angle_yaw = g_runtime_global_context.m_input_system->m_cursor_delta_yaw;
 
@@ -32,6 +32,7 @@ namespace Piccolo
         ~MotorComponent() override;
 
         void tick(float delta_time) override;
+        ComponentTickPhase getTickPhase() const override { return ComponentTickPhase::pre_physics; }
         void tickPlayerMotor(float delta_time);
 
         const Vector3& getTargetPosition() const { return m_target_position; }
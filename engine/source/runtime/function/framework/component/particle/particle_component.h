@@ -21,6 +21,7 @@ namespace Piccolo
         void postLoadResource(std::weak_ptr<GObject> parent_object) override;
 
         void tick(float delta_time) override;
+        ComponentTickPhase getTickPhase() const override { return ComponentTickPhase::render_extract; }
 
     private:
         void computeGlobalTransform();
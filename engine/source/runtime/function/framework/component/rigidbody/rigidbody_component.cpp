@@ -84,4 +84,14 @@ namespace Piccolo
         physics_scene->getShapeBoundingBoxes(m_rigidbody_id, out_bounding_boxes);
     }
 
+    bool RigidBodyComponent::getSimulatedTransform(Vector3& out_position, Quaternion& out_rotation) const
+    {
+        std::shared_ptr<PhysicsScene> physics_scene =
+            g_runtime_global_context.m_world_manager->getCurrentActivePhysicsScene().lock();
+        if (!physics_scene)
+            return false;
+
+        return physics_scene->getSimulatedTransform(m_rigidbody_id, out_position, out_rotation);
+    }
+
 } // namespace Piccolo
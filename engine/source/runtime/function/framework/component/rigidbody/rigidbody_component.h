@@ -17,8 +17,11 @@ namespace Piccolo
         void postLoadResource(std::weak_ptr<GObject> parent_object) override;
 
         void tick(float delta_time) override {}
+        ComponentTickPhase getTickPhase() const override { return ComponentTickPhase::physics; }
         void updateGlobalTransform(const Transform& transform, bool is_scale_dirty);
         void getShapeBoundingBoxes(std::vector<AxisAlignedBox> & out_boudning_boxes) const;
+        // false if the body is not moved by the simulation, see PhysicsScene::getSimulatedTransform
+        bool getSimulatedTransform(Vector3 & out_position, Quaternion & out_rotation) const;
 
     protected:
         void createRigidBody(const Transform& global_transform);
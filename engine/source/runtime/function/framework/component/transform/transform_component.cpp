@@ -18,6 +18,7 @@ namespace Piccolo
         m_transform_buffer[m_next_index].m_position = new_translation;
         m_transform.m_position                      = new_translation;
         m_is_dirty                                  = true;
+        m_is_set_by_gameplay                        = true;
     }
 
     void TransformComponent::setScale(const Vector3& new_scale)
@@ -26,6 +27,7 @@ namespace Piccolo
         m_transform.m_scale                      = new_scale;
         m_is_dirty                               = true;
         m_is_scale_dirty                         = true;
+        m_is_set_by_gameplay                     = true;
     }
 
     void TransformComponent::setRotation(const Quaternion& new_rotation)
@@ -33,13 +35,24 @@ namespace Piccolo
         m_transform_buffer[m_next_index].m_rotation = new_rotation;
         m_transform.m_rotation                      = new_rotation;
         m_is_dirty                                  = true;
+        m_is_set_by_gameplay                        = true;
     }
 
     void TransformComponent::tick(float delta_time)
     {
         std::swap(m_current_index, m_next_index);
 
-        if (m_is_dirty)
+        if (m_is_set_by_gameplay)
+        {
+            // a transform set by gameplay wins over the simulated pose
+            tryUpdateRigidBodyComponent();
+            m_is_set_by_gameplay = false;
+        }
+        else if (!g_is_editor_mode && tryReadSimulatedTransform())
+        {
+            m_is_dirty = true;
+        }
+        else if (m_is_dirty)
         {
             // update transform component, dirty flag will be reset in mesh component
             tryUpdateRigidBodyComponent();
@@ -64,4 +77,29 @@ namespace Piccolo
         }
     }
 
+    bool TransformComponent::tryReadSimulatedTransform()
+    {
+        std::shared_ptr<GObject> parent_object = m_parent_object.lock();
+        if (!parent_object)
+            return false;
+
+        const RigidBodyComponent* rigid_body_component = parent_object->tryGetComponentConst(RigidBodyComponent);
+        if (!rigid_body_component)
+            return false;
+
+        Vector3    position;
+        Quaternion rotation;
+        if (!rigid_body_component->getSimulatedTransform(position, rotation))
+            return false;
+
+        Transform& current_transform = m_transform_buffer[m_current_index];
+        current_transform.m_position = position;
+        current_transform.m_rotation = rotation;
+        m_transform.m_position       = position;
+        m_transform.m_rotation       = rotation;
+
+        m_transform_buffer[m_next_index] = current_transform;
+        return true;
+    }
+
 } // namespace Piccolo
\ No newline at end of file
@@ -34,8 +34,11 @@ namespace Piccolo
         Matrix4x4 getMatrix() const { return m_transform_buffer[m_current_index].getMatrix(); }
 
         void tick(float delta_time) override;
+        ComponentTickPhase getTickPhase() const override { return ComponentTickPhase::physics; }
 
         void tryUpdateRigidBodyComponent();
+        // takes the pose of a body moved by the simulation, false if the object has none
+        bool tryReadSimulatedTransform();
 
     protected:
         META(Enable)
@@ -44,5 +47,9 @@ namespace Piccolo
         Transform m_transform_buffer[2];
         size_t    m_current_index {0};
         size_t    m_next_index {1};
+
+        // set by setPosition, setScale and setRotation, the next tick pushes the transform to the rigid body instead
+        // of reading back the simulated pose
+        bool m_is_set_by_gameplay {false};
     };
 } // namespace Piccolo
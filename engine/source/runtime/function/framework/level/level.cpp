@@ -19,6 +19,7 @@ namespace Piccolo
     {
         m_current_active_character.reset();
         m_gobjects.clear();
+        m_tick_scheduler.markObjectsDirty();
 
         ASSERT(g_runtime_global_context.m_physics_manager);
         g_runtime_global_context.m_physics_manager->deletePhysicsScene(m_physics_scene);
@@ -43,6 +44,7 @@ namespace Piccolo
         if (is_loaded)
         {
             m_gobjects.emplace(object_id, gobject);
+            m_tick_scheduler.markObjectsDirty();
         }
         else
         {
@@ -142,14 +144,8 @@ namespace Piccolo
             return;
         }
 
-        for (const auto& id_object_pair : m_gobjects)
-        {
-            assert(id_object_pair.second);
-            if (id_object_pair.second)
-            {
-                id_object_pair.second->tick(delta_time);
-            }
-        }
+        m_tick_scheduler.tick(m_gobjects, delta_time);
+
         if (m_current_active_character && g_is_editor_mode == false)
         {
             m_current_active_character->tick(delta_time);
@@ -158,7 +154,8 @@ namespace Piccolo
         std::shared_ptr<PhysicsScene> physics_scene = m_physics_scene.lock();
         if (physics_scene)
         {
-            physics_scene->tick(delta_time);
+            // the editor places the bodies without simulating them, the tick only applies the pending body changes
+            physics_scene->tick(g_is_editor_mode ? 0.f : delta_time);
         }
     }
 
@@ -189,6 +186,7 @@ namespace Piccolo
         }
 
         m_gobjects.erase(go_id);
+        m_tick_scheduler.markObjectsDirty();
     }
 
 } // namespace Piccolo
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "runtime/function/framework/level/level_tick_scheduler.h"
 #include "runtime/function/framework/object/object_id_allocator.h"
 
 #include <memory>
@@ -13,8 +14,6 @@ namespace Piccolo
     class ObjectInstanceRes;
     class PhysicsScene;
 
-    using LevelObjectsMap = std::unordered_map<GObjectID, std::shared_ptr<GObject>>;
-
     /// The main class to manage all game objects
     class Level
     {
@@ -40,6 +39,9 @@ namespace Piccolo
 
         std::weak_ptr<PhysicsScene> getPhysicsScene() const { return m_physics_scene; }
 
+        LevelTickScheduler&   getTickScheduler() { return m_tick_scheduler; }
+        const LevelTickStats& getTickStats() const { return m_tick_scheduler.getStats(); }
+
     protected:
         void clear();
 
@@ -49,6 +51,8 @@ namespace Piccolo
         // all game objects in this level, key: object id, value: object instance
         LevelObjectsMap m_gobjects;
 
+        LevelTickScheduler m_tick_scheduler;
+
         std::shared_ptr<Character> m_current_active_character;
 
         std::weak_ptr<PhysicsScene> m_physics_scene;
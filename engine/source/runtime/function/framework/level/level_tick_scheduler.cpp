@@ -0,0 +1,164 @@
+#include "runtime/function/framework/level/level_tick_scheduler.h"
+
+#include "runtime/core/base/macro.h"
+#include "runtime/core/job/job_system.h"
+
+#include "runtime/function/framework/object/object.h"
+#include "runtime/function/global/global_context.h"
+
+#include <chrono>
+
+namespace Piccolo
+{
+    const uint32_t LevelTickScheduler::s_min_objects_per_job = 16;
+
+    LevelTickScheduler::LevelTickScheduler()
+    {
+        addPhaseDependency(ComponentTickPhase::pre_physics, ComponentTickPhase::physics);
+        addPhaseDependency(ComponentTickPhase::physics, ComponentTickPhase::post_physics);
+        addPhaseDependency(ComponentTickPhase::physics, ComponentTickPhase::animation);
+        addPhaseDependency(ComponentTickPhase::post_physics, ComponentTickPhase::render_extract);
+        addPhaseDependency(ComponentTickPhase::animation, ComponentTickPhase::render_extract);
+
+        setPhaseParallel(ComponentTickPhase::pre_physics, true);
+        setPhaseParallel(ComponentTickPhase::physics, true);
+        setPhaseParallel(ComponentTickPhase::post_physics, true);
+        setPhaseParallel(ComponentTickPhase::animation, true);
+        // render extraction writes into the logic swap data, which is not synchronized
+        setPhaseParallel(ComponentTickPhase::render_extract, false);
+    }
+
+    void LevelTickScheduler::addPhaseDependency(ComponentTickPhase before, ComponentTickPhase after)
+    {
+        ASSERT(before != after);
+        m_phase_dependencies[static_cast<size_t>(after)] |= 1u << static_cast<uint32_t>(before);
+        m_is_phase_order_dirty = true;
+    }
+
+    void LevelTickScheduler::setPhaseParallel(ComponentTickPhase phase, bool is_parallel)
+    {
+        m_is_phase_parallel[static_cast<size_t>(phase)] = is_parallel;
+    }
+
+    const std::vector<ComponentTickPhase>& LevelTickScheduler::getPhaseOrder()
+    {
+        if (m_is_phase_order_dirty)
+        {
+            sortPhases();
+        }
+        return m_phase_order;
+    }
+
+    void LevelTickScheduler::sortPhases()
+    {
+        m_phase_order.clear();
+
+        // topological sort, ties are broken by the declaration order of the phases
+        uint32_t sorted_mask = 0;
+        while (m_phase_order.size() < k_component_tick_phase_count)
+        {
+            bool is_progressed = false;
+            for (size_t phase_index = 0; phase_index < k_component_tick_phase_count; ++phase_index)
+            {
+                const uint32_t phase_bit = 1u << phase_index;
+                if ((sorted_mask & phase_bit) == 0 && (m_phase_dependencies[phase_index] & ~sorted_mask) == 0)
+                {
+                    m_phase_order.push_back(static_cast<ComponentTickPhase>(phase_index));
+                    sorted_mask |= phase_bit;
+                    is_progressed = true;
+                    break;
+                }
+            }
+
+            if (!is_progressed)
+            {
+                LOG_ERROR("cyclic tick phase dependencies, fall back to declaration order");
+                m_phase_order.clear();
+                for (size_t phase_index = 0; phase_index < k_component_tick_phase_count; ++phase_index)
+                {
+                    m_phase_order.push_back(static_cast<ComponentTickPhase>(phase_index));
+                }
+                break;
+            }
+        }
+
+        m_is_phase_order_dirty = false;
+    }
+
+    void LevelTickScheduler::rebuildPhaseObjects(const LevelObjectsMap& objects)
+    {
+        for (std::vector<GObject*>& phase_objects : m_phase_objects)
+        {
+            phase_objects.clear();
+        }
+
+        for (const auto& id_object_pair : objects)
+        {
+            GObject* object = id_object_pair.second.get();
+            assert(object);
+            if (object == nullptr)
+                continue;
+
+            for (size_t phase_index = 0; phase_index < k_component_tick_phase_count; ++phase_index)
+            {
+                if (object->hasTickPhase(static_cast<ComponentTickPhase>(phase_index)))
+                {
+                    m_phase_objects[phase_index].push_back(object);
+                }
+            }
+        }
+
+        m_stats.m_object_count = static_cast<uint32_t>(objects.size());
+        m_is_objects_dirty     = false;
+    }
+
+    void LevelTickScheduler::tick(const LevelObjectsMap& objects, float delta_time)
+    {
+        using namespace std::chrono;
+
+        const steady_clock::time_point tick_start = steady_clock::now();
+
+        if (m_is_objects_dirty)
+        {
+            rebuildPhaseObjects(objects);
+        }
+
+        for (ComponentTickPhase phase : getPhaseOrder())
+        {
+            const steady_clock::time_point phase_start = steady_clock::now();
+
+            tickPhase(phase, delta_time);
+
+            m_stats.m_phase_time_ms[static_cast<size_t>(phase)] =
+                duration<float, std::milli>(steady_clock::now() - phase_start).count();
+        }
+
+        m_stats.m_tick_time_ms = duration<float, std::milli>(steady_clock::now() - tick_start).count();
+    }
+
+    void LevelTickScheduler::tickPhase(ComponentTickPhase phase, float delta_time)
+    {
+        const std::vector<GObject*>& phase_objects = m_phase_objects[static_cast<size_t>(phase)];
+
+        std::shared_ptr<JobSystem> job_system = g_runtime_global_context.m_job_system;
+        m_stats.m_worker_count                = job_system ? job_system->getWorkerCount() : 0;
+
+        if (!m_is_phase_parallel[static_cast<size_t>(phase)] || m_stats.m_worker_count == 0)
+        {
+            for (GObject* object : phase_objects)
+            {
+                object->tickPhase(phase, delta_time);
+            }
+            return;
+        }
+
+        job_system->parallelFor(static_cast<uint32_t>(phase_objects.size()),
+                                s_min_objects_per_job,
+                                [&phase_objects, phase, delta_time](uint32_t begin, uint32_t end) {
+                                    for (uint32_t object_index = begin; object_index < end; ++object_index)
+                                    {
+                                        phase_objects[object_index]->tickPhase(phase, delta_time);
+                                    }
+                                });
+    }
+} // namespace Piccolo
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "runtime/function/framework/component/component.h"
+#include "runtime/function/framework/object/object_id_allocator.h"
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace Piccolo
+{
+    class GObject;
+
+    using LevelObjectsMap = std::unordered_map<GObjectID, std::shared_ptr<GObject>>;
+
+    static constexpr size_t k_component_tick_phase_count = static_cast<size_t>(ComponentTickPhase::count);
+
+    struct LevelTickStats
+    {
+        float    m_phase_time_ms[k_component_tick_phase_count] {};
+        float    m_tick_time_ms {0.f};
+        uint32_t m_object_count {0};
+        uint32_t m_worker_count {0};
+    };
+
+    /// Ticks the objects of a level phase by phase, the objects within a parallel phase are ticked in chunks
+    /// on the job system.
+    /// Phases run in an order satisfying the recorded dependencies, by default:
+    ///     pre_physics -> physics -> post_physics -> render_extract
+    ///                    physics -> animation    -> render_extract
+    /// e.g. MotorComponent (pre_physics) moves the transform before TransformComponent (physics) publishes it,
+    /// and MeshComponent (render_extract) consumes the transform and the animation result after both are updated.
+    class LevelTickScheduler
+    {
+        static const uint32_t s_min_objects_per_job;
+
+    public:
+        LevelTickScheduler();
+
+        /// phase before will always be ticked before phase after
+        void addPhaseDependency(ComponentTickPhase before, ComponentTickPhase after);
+        /// objects of a non-parallel phase are ticked one by one on the calling thread
+        void setPhaseParallel(ComponentTickPhase phase, bool is_parallel);
+
+        /// rebuild the phase object lists on next tick, call it whenever objects are created or deleted
+        void markObjectsDirty() { m_is_objects_dirty = true; }
+
+        void tick(const LevelObjectsMap& objects, float delta_time);
+
+        const std::vector<ComponentTickPhase>& getPhaseOrder();
+        const LevelTickStats&                  getStats() const { return m_stats; }
+
+    private:
+        void sortPhases();
+        void rebuildPhaseObjects(const LevelObjectsMap& objects);
+        void tickPhase(ComponentTickPhase phase, float delta_time);
+
+        // bit i of m_phase_dependencies[j] is set if phase i must be ticked before phase j
+        uint32_t                        m_phase_dependencies[k_component_tick_phase_count] {};
+        bool                            m_is_phase_parallel[k_component_tick_phase_count] {};
+        std::vector<ComponentTickPhase> m_phase_order;
+        bool                            m_is_phase_order_dirty {true};
+
+        std::vector<GObject*> m_phase_objects[k_component_tick_phase_count];
+        bool                  m_is_objects_dirty {true};
+
+        LevelTickStats m_stats;
+    };
+} // namespace Piccolo
@@ -10,18 +10,20 @@
 #include "runtime/function/framework/component/transform/transform_component.h"
 #include "runtime/function/global/global_context.h"
 
+#include <algorithm>
 #include <cassert>
-#include <unordered_set>
+#include <iterator>
 
 #include "_generated/serializer/all_serializer.h"
 
 namespace Piccolo
 {
-    bool shouldComponentTick(std::string component_type_name)
+    bool shouldComponentTick(Reflection::ComponentTypeIndex component_type_index)
     {
         if (g_is_editor_mode)
         {
-            return g_editor_tick_component_types.find(component_type_name) != g_editor_tick_component_types.end();
+            return component_type_index != Reflection::k_invalid_component_type_index &&
+                   (g_editor_tick_component_mask & (Reflection::ComponentTypeMask(1) << component_type_index)) != 0;
         }
         else
         {
@@ -40,9 +42,22 @@ namespace Piccolo
 
     void GObject::tick(float delta_time)
     {
-        for (auto& component : m_components)
+        for (size_t component_index = 0; component_index < m_components.size(); ++component_index)
+        {
+            if (m_components[component_index] && shouldComponentTick(m_component_type_indices[component_index]))
+            {
+                m_components[component_index]->tick(delta_time);
+            }
+        }
+    }
+
+    void GObject::tickPhase(ComponentTickPhase phase, float delta_time)
+    {
+        for (size_t component_index = 0; component_index < m_components.size(); ++component_index)
         {
-            if (shouldComponentTick(component.getTypeName()))
+            Component* component = m_components[component_index].operator->();
+            if (component != nullptr && component->getTickPhase() == phase &&
+                shouldComponentTick(m_component_type_indices[component_index]))
             {
                 component->tick(delta_time);
             }
@@ -69,13 +84,6 @@ namespace Piccolo
 
         // load object instanced components
         m_components = object_instance_res.m_instanced_components;
-        for (auto component : m_components)
-        {
-            if (component)
-            {
-                component->postLoadResource(weak_from_this());
-            }
-        }
 
         // load object definition components
         m_definition_url = object_instance_res.m_definition;
@@ -83,22 +91,55 @@ namespace Piccolo
         ObjectDefinitionRes definition_res;
 
         const bool is_loaded_success = g_runtime_global_context.m_asset_manager->loadAsset(m_definition_url, definition_res);
-        if (!is_loaded_success)
-            return false;
+        if (is_loaded_success)
+        {
+            for (auto loaded_component : definition_res.m_components)
+            {
+                const std::string type_name = loaded_component.getTypeName();
+                // don't create component if it has been instanced
+                if (hasComponent(type_name))
+                    continue;
 
-        for (auto loaded_component : definition_res.m_components)
+                m_components.push_back(loaded_component);
+            }
+        }
+
+        // resolve the type names once, lookups and tick filtering then work on type indices. The table is complete
+        // before any postLoadResource, so that components can look up each other while they load
+        m_component_type_indices.clear();
+        m_component_type_mask = 0;
+        std::fill(std::begin(m_components_by_type), std::end(m_components_by_type), nullptr);
+        m_tick_phase_mask = 0;
+        for (auto& component : m_components)
         {
-            const std::string type_name = loaded_component.getTypeName();
-            // don't create component if it has been instanced
-            if (hasComponent(type_name))
+            // the indices stay parallel to m_components, a component that failed to load gets an invalid one
+            if (!component)
+            {
+                m_component_type_indices.push_back(Reflection::k_invalid_component_type_index);
                 continue;
+            }
+
+            const Reflection::ComponentTypeIndex type_index =
+                Reflection::getComponentTypeIndex(component.getTypeName());
+            m_component_type_indices.push_back(type_index);
+            if (type_index != Reflection::k_invalid_component_type_index && m_components_by_type[type_index] == nullptr)
+            {
+                m_component_type_mask |= Reflection::ComponentTypeMask(1) << type_index;
+                m_components_by_type[type_index] = component.operator->();
+            }
 
-            loaded_component->postLoadResource(weak_from_this());
+            m_tick_phase_mask |= 1u << static_cast<uint32_t>(component->getTickPhase());
+        }
 
-            m_components.push_back(loaded_component);
+        for (auto& component : m_components)
+        {
+            if (component)
+            {
+                component->postLoadResource(weak_from_this());
+            }
         }
 
-        return true;
+        return is_loaded_success;
     }
 
     void GObject::save(ObjectInstanceRes& out_object_instance_res)
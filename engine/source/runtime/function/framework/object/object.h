@@ -5,6 +5,8 @@
 
 #include "runtime/resource/res_type/common/object.h"
 
+#include "_generated/reflection/all_type_id.h"
+
 #include <memory>
 #include <string>
 #include <unordered_set>
@@ -23,6 +25,13 @@ namespace Piccolo
 
         virtual void tick(float delta_time);
 
+        // tick only the components of the phase, called by the level tick scheduler
+        void tickPhase(ComponentTickPhase phase, float delta_time);
+        bool hasTickPhase(ComponentTickPhase phase) const
+        {
+            return (m_tick_phase_mask & (1u << static_cast<uint32_t>(phase))) != 0;
+        }
+
         bool load(const ObjectInstanceRes& object_instance_res);
         void save(ObjectInstanceRes& out_object_instance_res);
 
@@ -33,37 +42,32 @@ namespace Piccolo
 
         bool hasComponent(const std::string& compenent_type_name) const;
 
+        template<typename TComponent>
+        bool hasComponent() const
+        {
+            return (m_component_type_mask & Reflection::getComponentTypeMask<TComponent>()) != 0;
+        }
+
+        Reflection::ComponentTypeMask getComponentTypeMask() const { return m_component_type_mask; }
+
         std::vector<Reflection::ReflectionPtr<Component>> getComponents() { return m_components; }
 
+        /// O(1) lookup by the component type index generated by the meta parser, the exact type must match
         template<typename TComponent>
-        TComponent* tryGetComponent(const std::string& compenent_type_name)
+        TComponent* tryGetComponent()
         {
-            for (auto& component : m_components)
-            {
-                if (component.getTypeName() == compenent_type_name)
-                {
-                    return static_cast<TComponent*>(component.operator->());
-                }
-            }
-
-            return nullptr;
+            return static_cast<TComponent*>(m_components_by_type[Reflection::getComponentTypeIndex<TComponent>()]);
         }
 
         template<typename TComponent>
-        const TComponent* tryGetComponentConst(const std::string& compenent_type_name) const
+        const TComponent* tryGetComponentConst() const
         {
-            for (const auto& component : m_components)
-            {
-                if (component.getTypeName() == compenent_type_name)
-                {
-                    return static_cast<const TComponent*>(component.operator->());
-                }
-            }
-            return nullptr;
+            return static_cast<const TComponent*>(
+                m_components_by_type[Reflection::getComponentTypeIndex<TComponent>()]);
         }
 
-#define tryGetComponent(COMPONENT_TYPE) tryGetComponent<COMPONENT_TYPE>(#COMPONENT_TYPE)
-#define tryGetComponentConst(COMPONENT_TYPE) tryGetComponentConst<const COMPONENT_TYPE>(#COMPONENT_TYPE)
+#define tryGetComponent(COMPONENT_TYPE) tryGetComponent<COMPONENT_TYPE>()
+#define tryGetComponentConst(COMPONENT_TYPE) tryGetComponentConst<const COMPONENT_TYPE>()
 
     protected:
         GObjectID   m_id {k_invalid_gobject_id};
@@ -73,5 +77,13 @@ namespace Piccolo
         // we have to use the ReflectionPtr due to that the components need to be reflected 
         // in editor, and it's polymorphism
         std::vector<Reflection::ReflectionPtr<Component>> m_components;
+
+        // parallel to m_components, filled on load
+        std::vector<Reflection::ComponentTypeIndex> m_component_type_indices;
+        Reflection::ComponentTypeMask               m_component_type_mask {0};
+        Component*                                  m_components_by_type[Reflection::k_component_type_count] {};
+
+        // bit i is set if any component ticks in ComponentTickPhase i
+        uint32_t m_tick_phase_mask {0};
     };
 } // namespace Piccolo
@@ -1,5 +1,6 @@
 #include "runtime/function/global/global_context.h"
 
+#include "core/job/job_system.h"
 #include "core/log/log_system.h"
 
 #include "runtime/engine.h"
@@ -32,6 +33,11 @@ namespace Piccolo
 
         m_logger_system = std::make_shared<LogSystem>();
 
+        m_job_system = std::make_shared<JobSystem>();
+        const int job_worker_count = m_config_manager->getJobWorkerCount();
+        m_job_system->initialize(job_worker_count < 0 ? JobSystem::getDefaultWorkerCount()
+                                                      : static_cast<uint32_t>(job_worker_count));
+
         m_asset_manager = std::make_shared<AssetManager>();
 
         m_physics_manager = std::make_shared<PhysicsManager>();
@@ -42,6 +48,7 @@ namespace Piccolo
 
         m_window_system = std::make_shared<WindowSystem>();
         WindowCreateInfo window_create_info;
+        window_create_info.is_headless = m_config_manager->isNullRHIEnabled();
         m_window_system->initialize(window_create_info);
 
         m_input_system = std::make_shared<InputSystem>();
@@ -83,6 +90,9 @@ namespace Piccolo
 
         m_asset_manager.reset();
 
+        m_job_system->clear();
+        m_job_system.reset();
+
         m_logger_system.reset();
 
         m_file_system.reset();
@@ -6,6 +6,7 @@
 namespace Piccolo
 {
     class LogSystem;
+    class JobSystem;
     class InputSystem;
     class PhysicsManager;
     class FileSystem;
@@ -31,6 +32,7 @@ namespace Piccolo
 
     public:
         std::shared_ptr<LogSystem>         m_logger_system;
+        std::shared_ptr<JobSystem>         m_job_system;
         std::shared_ptr<InputSystem>       m_input_system;
         std::shared_ptr<FileSystem>        m_file_system;
         std::shared_ptr<AssetManager>      m_asset_manager;
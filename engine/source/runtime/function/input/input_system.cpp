@@ -127,8 +127,7 @@ namespace Piccolo
             return;
         }
 
-        std::shared_ptr<RenderCamera> render_camera = g_runtime_global_context.m_render_system->getRenderCamera();
-        const Vector2&                fov           = render_camera->getFOV();
+        const Vector2 fov = g_runtime_global_context.m_render_system->getSwapContext().getLogicCamera().getFOV();
 
         Radian cursor_delta_x(Math::degreesToRadians(m_cursor_delta_x));
         Radian cursor_delta_y(Math::degreesToRadians(m_cursor_delta_y));
@@ -0,0 +1,126 @@
+#include "runtime/function/physics/jolt/job_system_adapter.h"
+
+#include "runtime/core/base/macro.h"
+
+namespace Piccolo
+{
+    void JoltJobSystemAdapter::BarrierImpl::AddJob(const JobHandle& job_handle) { AddJobs(&job_handle, 1); }
+
+    void JoltJobSystemAdapter::BarrierImpl::AddJobs(const JobHandle* job_handles, JPH::uint job_handle_count)
+    {
+        for (JPH::uint index = 0; index < job_handle_count; ++index)
+        {
+            // count the job before the barrier is set on it, the job may finish on a worker right after that
+            m_pending_job_count.fetch_add(1, std::memory_order_relaxed);
+            if (!job_handles[index].GetPtr()->SetBarrier(this))
+            {
+                // the job is done already
+                m_pending_job_count.fetch_sub(1, std::memory_order_release);
+            }
+        }
+    }
+
+    void JoltJobSystemAdapter::BarrierImpl::OnJobFinished(Job* job)
+    {
+        m_pending_job_count.fetch_sub(1, std::memory_order_release);
+    }
+
+    JoltJobSystemAdapter::JoltJobSystemAdapter(Piccolo::JobSystem& job_system,
+                                               uint32_t            max_job_count,
+                                               uint32_t            max_barrier_count) :
+        m_job_system(job_system), m_barriers(std::make_unique<BarrierImpl[]>(max_barrier_count)),
+        m_max_barrier_count(max_barrier_count)
+    {
+        m_jobs.Init(max_job_count, max_job_count);
+    }
+
+    JoltJobSystemAdapter::~JoltJobSystemAdapter()
+    {
+        // queued jobs point into the job pool
+        m_job_system.wait(m_queued_job_counter);
+
+        for (uint32_t index = 0; index < m_max_barrier_count; ++index)
+        {
+            ASSERT(!m_barriers[index].m_is_in_use);
+        }
+    }
+
+    int JoltJobSystemAdapter::GetMaxConcurrency() const
+    {
+        // the thread waiting on the barrier executes jobs as well
+        return static_cast<int>(m_job_system.getWorkerCount()) + 1;
+    }
+
+    JPH::JobHandle JoltJobSystemAdapter::CreateJob(const char*        name,
+                                                   JPH::ColorArg      color,
+                                                   const JobFunction& job_function,
+                                                   JPH::uint32        dependency_count)
+    {
+        uint32_t job_index = m_jobs.ConstructObject(name, color, this, job_function, dependency_count);
+        if (job_index == JobPool::cInvalidObjectIndex)
+        {
+            LOG_ERROR("jolt job pool is exhausted, increase the max job count of the physics config");
+
+            // all jobs are in flight, wait for the workers to finish some of them
+            m_job_system.waitUntil([&]() {
+                job_index = m_jobs.ConstructObject(name, color, this, job_function, dependency_count);
+                return job_index != JobPool::cInvalidObjectIndex;
+            });
+        }
+        Job* job = &m_jobs.Get(job_index);
+
+        // the handle keeps the job alive, it may be queued and even finish right away
+        JobHandle job_handle(job);
+        if (dependency_count == 0)
+        {
+            QueueJob(job);
+        }
+        return job_handle;
+    }
+
+    JPH::JobSystem::Barrier* JoltJobSystemAdapter::CreateBarrier()
+    {
+        for (uint32_t index = 0; index < m_max_barrier_count; ++index)
+        {
+            bool is_in_use = false;
+            if (m_barriers[index].m_is_in_use.compare_exchange_strong(is_in_use, true))
+                return &m_barriers[index];
+        }
+        return nullptr;
+    }
+
+    void JoltJobSystemAdapter::DestroyBarrier(Barrier* barrier)
+    {
+        BarrierImpl* barrier_impl = static_cast<BarrierImpl*>(barrier);
+        ASSERT(barrier_impl->isDone());
+        barrier_impl->m_is_in_use.store(false, std::memory_order_release);
+    }
+
+    void JoltJobSystemAdapter::WaitForJobs(Barrier* barrier)
+    {
+        const BarrierImpl* barrier_impl = static_cast<const BarrierImpl*>(barrier);
+        m_job_system.waitUntil([barrier_impl]() { return barrier_impl->isDone(); });
+    }
+
+    void JoltJobSystemAdapter::QueueJob(Job* job)
+    {
+        // the queue holds a reference until the job has run
+        job->AddRef();
+        m_job_system.run(
+            [job]() {
+                job->Execute();
+                job->Release();
+            },
+            m_queued_job_counter);
+    }
+
+    void JoltJobSystemAdapter::QueueJobs(Job** jobs, JPH::uint job_count)
+    {
+        for (JPH::uint index = 0; index < job_count; ++index)
+        {
+            QueueJob(jobs[index]);
+        }
+    }
+
+    void JoltJobSystemAdapter::FreeJob(Job* job) { m_jobs.DestructObject(job); }
+} // namespace Piccolo
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "runtime/core/job/job_system.h"
+
+#include "Jolt/Jolt.h"
+
+#include "Jolt/Core/FixedSizeFreeList.h"
+#include "Jolt/Core/JobSystem.h"
+
+#include <atomic>
+#include <memory>
+
+namespace Piccolo
+{
+    /// Runs the jobs of the jolt physics update on the engine job system, so that physics shares the workers with
+    /// the rest of the engine instead of starting a thread pool of its own. Jobs are queued into the engine job
+    /// system once their dependencies are resolved, a thread waiting on a barrier executes engine jobs meanwhile.
+    class JoltJobSystemAdapter final : public JPH::JobSystem
+    {
+        class BarrierImpl final : public Barrier
+        {
+        public:
+            void AddJob(const JobHandle& job_handle) override;
+            void AddJobs(const JobHandle* job_handles, JPH::uint job_handle_count) override;
+
+            bool isDone() const { return m_pending_job_count.load(std::memory_order_acquire) == 0; }
+
+            std::atomic<bool> m_is_in_use {false};
+
+        protected:
+            void OnJobFinished(Job* job) override;
+
+        private:
+            std::atomic<uint32_t> m_pending_job_count {0};
+        };
+
+    public:
+        /// @max_job_count: jobs alive at the same time, a physics step of a scene allocates a few per body island
+        /// @max_barrier_count: barriers alive at the same time, one per scene being updated
+        JoltJobSystemAdapter(Piccolo::JobSystem& job_system, uint32_t max_job_count, uint32_t max_barrier_count);
+        ~JoltJobSystemAdapter() override;
+
+        int       GetMaxConcurrency() const override;
+        JobHandle CreateJob(const char*        name,
+                            JPH::ColorArg      color,
+                            const JobFunction& job_function,
+                            JPH::uint32        dependency_count = 0) override;
+        Barrier*  CreateBarrier() override;
+        void      DestroyBarrier(Barrier* barrier) override;
+        void      WaitForJobs(Barrier* barrier) override;
+
+    protected:
+        void QueueJob(Job* job) override;
+        void QueueJobs(Job** jobs, JPH::uint job_count) override;
+        void FreeJob(Job* job) override;
+
+    private:
+        using JobPool = JPH::FixedSizeFreeList<Job>;
+
+        Piccolo::JobSystem& m_job_system;
+        JobCounter          m_queued_job_counter;
+
+        JobPool                        m_jobs;
+        std::unique_ptr<BarrierImpl[]> m_barriers;
+        uint32_t                       m_max_barrier_count {0};
+    };
+} // namespace Piccolo
@@ -6,6 +6,14 @@
 
 namespace Piccolo
 {
+    enum class PhysicsInterpolationMode : uint8_t
+    {
+        // simulated bodies show the pose of the last step
+        none,
+        // simulated bodies show a blend of the last two steps, one step behind but without stepping artifacts
+        interpolate
+    };
+
     class PhysicsConfig
     {
     public:
@@ -15,13 +23,19 @@ namespace Piccolo
         uint32_t m_max_body_pairs {65536};
         uint32_t m_max_contact_constraints {10240};
 
-        // job setting
+        // job setting, the jobs run on the engine job system and are shared by all scenes
         uint32_t m_max_job_count {1024};
         uint32_t m_max_barrier_count {8};
-        uint32_t m_max_concurrent_job_count {4};
+
+        // temp memory of a physics step, one allocator is shared by all scenes since they are ticked one by one
+        uint32_t m_temp_allocator_size {16 * 1024 * 1024};
 
         Vector3 m_gravity {0.f, 0.f, -9.8f};
 
-        float m_update_frequency {60.f};
+        // the simulation advances in fixed steps of 1 / m_update_frequency whatever the frame time is
+        float    m_update_frequency {60.f};
+        uint32_t m_max_substeps {4};
+
+        PhysicsInterpolationMode m_interpolation_mode {PhysicsInterpolationMode::interpolate};
     };
 } // namespace Piccolo
@@ -1,13 +1,22 @@
 #include "runtime/function/physics/physics_manager.h"
 
+#include "runtime/core/base/macro.h"
+
 #include "runtime/resource/config_manager/config_manager.h"
 
 #include "runtime/function/framework/world/world_manager.h"
 #include "runtime/function/global/global_context.h"
+#include "runtime/function/physics/jolt/job_system_adapter.h"
 #include "runtime/function/physics/jolt/utils.h"
 #include "runtime/function/physics/physics_scene.h"
 #include "runtime/function/render/render_system.h"
 
+#include "Jolt/Jolt.h"
+#include "Jolt/RegisterTypes.h"
+
+#include "Jolt/Core/Factory.h"
+#include "Jolt/Core/TempAllocator.h"
+
 #ifdef ENABLE_PHYSICS_DEBUG_RENDERER
 #include "TestFramework.h"
 
@@ -21,10 +30,27 @@ namespace Piccolo
 {
     void PhysicsManager::initialize()
     {
-#ifdef ENABLE_PHYSICS_DEBUG_RENDERER
         std::shared_ptr<ConfigManager> config_manager = g_runtime_global_context.m_config_manager;
         ASSERT(config_manager);
 
+        m_config.m_update_frequency   = config_manager->getPhysicsUpdateFrequency();
+        m_config.m_max_substeps       = config_manager->getPhysicsMaxSubsteps();
+        m_config.m_interpolation_mode = config_manager->isPhysicsInterpolationEnabled() ?
+                                            PhysicsInterpolationMode::interpolate :
+                                            PhysicsInterpolationMode::none;
+
+        // the factory is global to jolt, it is registered once for all scenes
+        JPH::Factory::sInstance = new JPH::Factory();
+        JPH::RegisterTypes();
+
+        std::shared_ptr<JobSystem> job_system = g_runtime_global_context.m_job_system;
+        ASSERT(job_system);
+
+        m_jolt_job_system =
+            new JoltJobSystemAdapter(*job_system, m_config.m_max_job_count, m_config.m_max_barrier_count);
+        m_temp_allocator = new JPH::TempAllocatorImpl(m_config.m_temp_allocator_size);
+
+#ifdef ENABLE_PHYSICS_DEBUG_RENDERER
         Trace = TraceImpl;
 
         m_renderer = new Renderer;
@@ -41,6 +67,14 @@ namespace Piccolo
     {
         m_scenes.clear();
 
+        delete m_temp_allocator;
+        m_temp_allocator = nullptr;
+        delete m_jolt_job_system;
+        m_jolt_job_system = nullptr;
+
+        delete JPH::Factory::sInstance;
+        JPH::Factory::sInstance = nullptr;
+
 #ifdef ENABLE_PHYSICS_DEBUG_RENDERER
         delete m_debug_renderer;
         m_font = nullptr;
@@ -50,7 +84,8 @@ namespace Piccolo
 
     std::weak_ptr<PhysicsScene> PhysicsManager::createPhysicsScene(const Vector3& gravity)
     {
-        std::shared_ptr<PhysicsScene> physics_scene = std::make_shared<PhysicsScene>(gravity);
+        std::shared_ptr<PhysicsScene> physics_scene =
+            std::make_shared<PhysicsScene>(m_config, gravity, m_jolt_job_system, m_temp_allocator);
 
         m_scenes.push_back(physics_scene);
 
@@ -74,8 +109,9 @@ namespace Piccolo
         std::shared_ptr<PhysicsScene> physics_scene =
             g_runtime_global_context.m_world_manager->getCurrentActivePhysicsScene().lock();
 
-        std::shared_ptr<RenderCamera> render_camera = g_runtime_global_context.m_render_system->getRenderCamera();
-        const Vector2&                fov           = render_camera->getFOV();
+        // drawn from the logic thread, the render camera may be updated by the render thread meanwhile
+        const LogicCameraState& camera = g_runtime_global_context.m_render_system->getSwapContext().getLogicCamera();
+        const Vector2           fov    = camera.getFOV();
 
         const EngineContentViewport& engine_viewport =
             g_runtime_global_context.m_render_system->getEngineContentViewport();
@@ -100,12 +136,12 @@ namespace Piccolo
         }
 
         CameraState world_camera;
-        world_camera.mPos       = toVec3(render_camera->position());
-        world_camera.mForward   = toVec3(render_camera->forward());
-        world_camera.mUp        = toVec3(render_camera->up());
+        world_camera.mPos       = toVec3(camera.m_position);
+        world_camera.mForward   = toVec3(camera.m_forward);
+        world_camera.mUp        = toVec3(camera.m_up);
         world_camera.mFOVY      = fov.y;
-        world_camera.mFarPlane  = render_camera->m_zfar;
-        world_camera.mNearPlane = render_camera->m_znear;
+        world_camera.mFarPlane  = camera.m_zfar;
+        world_camera.mNearPlane = camera.m_znear;
 
         m_renderer->BeginFrame(world_camera, 1.f);
 
@@ -2,18 +2,24 @@
 
 #include "runtime/core/math/vector3.h"
 
+#include "runtime/function/physics/physics_config.h"
+
 #include <memory>
 #include <vector>
 
 #ifdef ENABLE_PHYSICS_DEBUG_RENDERER
 class Renderer;
 class Font;
+#endif
 
 namespace JPH
 {
+    class JobSystem;
+    class TempAllocator;
+#ifdef ENABLE_PHYSICS_DEBUG_RENDERER
     class DebugRenderer;
-}
 #endif
+} // namespace JPH
 
 namespace Piccolo
 {
@@ -33,6 +39,13 @@ namespace Piccolo
 #endif
 
     protected:
+        // step settings shared by all scenes
+        PhysicsConfig m_config;
+
+        // shared by all scenes, the jobs of a physics step run on the engine job system
+        JPH::JobSystem*     m_jolt_job_system {nullptr};
+        JPH::TempAllocator* m_temp_allocator {nullptr};
+
         std::vector<std::shared_ptr<PhysicsScene>> m_scenes;
 
 #ifdef ENABLE_PHYSICS_DEBUG_RENDERER
@@ -8,14 +8,12 @@
 #include "runtime/function/physics/physics_config.h"
 
 #include "Jolt/Jolt.h"
-#include "Jolt/RegisterTypes.h"
 
-#include "Jolt/Core/Factory.h"
 #include "Jolt/Core/JobSystem.h"
-#include "Jolt/Core/JobSystemThreadPool.h"
 #include "Jolt/Core/TempAllocator.h"
 
 #include "Jolt/Physics/Body/BodyCreationSettings.h"
+#include "Jolt/Physics/Body/BodyFilter.h"
 #include "Jolt/Physics/Collision/CastResult.h"
 #include "Jolt/Physics/Collision/CollideShape.h"
 #include "Jolt/Physics/Collision/CollisionCollectorImpl.h"
@@ -29,25 +27,195 @@
 #include "Jolt/Physics/Collision/ShapeCast.h"
 #include "Jolt/Physics/PhysicsSystem.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
 namespace Piccolo
 {
-    PhysicsScene::PhysicsScene(const Vector3& gravity)
+    namespace
     {
-        static_assert(s_invalid_rigidbody_id == JPH::BodyID::cInvalidBodyID);
+        // a query takes microseconds, smaller ranges cost more in job overhead than they win in balance
+        constexpr uint32_t k_min_queries_per_job = 32;
+        // hits of a query kept on the stack, larger max hit counts use a heap buffer per range
+        constexpr uint32_t k_inline_hit_capacity = 8;
 
-        JPH::Factory::sInstance = new JPH::Factory();
-        JPH::RegisterTypes();
+        class QueryBroadPhaseLayerFilter final : public JPH::BroadPhaseLayerFilter
+        {
+        public:
+            explicit QueryBroadPhaseLayerFilter(const PhysicsQueryFilter& filter) : m_filter(filter) {}
 
-        m_physics.m_jolt_physics_system              = new JPH::PhysicsSystem();
-        m_physics.m_jolt_broad_phase_layer_interface = new BPLayerInterfaceImpl();
+            bool ShouldCollide(JPH::BroadPhaseLayer layer) const override
+            {
+                return layer == BroadPhaseLayers::NON_MOVING ? m_filter.m_hit_static_bodies :
+                                                               m_filter.m_hit_moving_bodies;
+            }
+
+        private:
+            const PhysicsQueryFilter& m_filter;
+        };
+
+        // keeps the closest hits sorted in a fixed buffer, once the buffer is full the query only looks for closer
+        // hits, unlike AllHitCollisionCollector that allocates and collects every hit before sorting
+        template<class CollectorType>
+        class BoundedHitCollector final : public CollectorType
+        {
+        public:
+            using ResultType = typename CollectorType::ResultType;
+
+            BoundedHitCollector(ResultType* hits, uint32_t max_hit_count, bool is_any_hit) :
+                m_hits(hits), m_max_hit_count(max_hit_count), m_is_any_hit(is_any_hit)
+            {}
+
+            void AddHit(const ResultType& result) override
+            {
+                const float fraction = result.GetEarlyOutFraction();
+                if (m_hit_count == m_max_hit_count)
+                {
+                    if (fraction >= m_hits[m_hit_count - 1].GetEarlyOutFraction())
+                        return;
+                    --m_hit_count;
+                }
+
+                uint32_t hit_index = m_hit_count;
+                for (; hit_index > 0 && m_hits[hit_index - 1].GetEarlyOutFraction() > fraction; --hit_index)
+                {
+                    m_hits[hit_index] = m_hits[hit_index - 1];
+                }
+                m_hits[hit_index] = result;
+                ++m_hit_count;
+
+                if (m_is_any_hit)
+                {
+                    this->ForceEarlyOut();
+                }
+                else if (m_hit_count == m_max_hit_count)
+                {
+                    this->UpdateEarlyOutFraction(m_hits[m_hit_count - 1].GetEarlyOutFraction());
+                }
+            }
+
+            uint32_t getHitCount() const { return m_hit_count; }
+
+        private:
+            ResultType* m_hits {nullptr};
+            uint32_t    m_max_hit_count {1};
+            uint32_t    m_hit_count {0};
+            bool        m_is_any_hit {false};
+        };
+
+        // sorted hits of the query being run by a range, the small buffers of the usual queries stay on the stack
+        template<typename ResultType>
+        class QueryHitScratch
+        {
+        public:
+            explicit QueryHitScratch(uint32_t max_hit_capacity)
+            {
+                if (max_hit_capacity > k_inline_hit_capacity)
+                {
+                    m_heap_hits.resize(max_hit_capacity);
+                }
+            }
+
+            ResultType* getData() { return m_heap_hits.empty() ? m_inline_hits : m_heap_hits.data(); }
+
+        private:
+            ResultType              m_inline_hits[k_inline_hit_capacity];
+            std::vector<ResultType> m_heap_hits;
+        };
+
+        template<typename RequestType>
+        uint32_t getHitCapacity(const RequestType& request)
+        {
+            return request.m_hit_mode == PhysicsQueryHitMode::all ? std::max(request.m_max_hit_count, 1u) : 1u;
+        }
+
+        // the jolt shape of a sweep or overlap request and its world transform, converted_shape holds shapes converted
+        // for this query only
+        template<typename RequestType>
+        const JPH::Shape* getRequestShape(const RequestType&         request,
+                                          JPH::RefConst<JPH::Shape>& converted_shape,
+                                          Matrix4x4&                 out_shape_transform)
+        {
+            if (request.m_query_shape != nullptr)
+            {
+                out_shape_transform = request.m_shape_transform * request.m_query_shape->getLocalTransform();
+                return request.m_query_shape->getJoltShape();
+            }
+            if (request.m_shape == nullptr)
+                return nullptr;
+
+            out_shape_transform = request.m_shape_transform * request.m_shape->m_local_transform.getMatrix();
+
+            Vector3    global_position, global_scale;
+            Quaternion global_rotation;
+            out_shape_transform.decomposition(global_position, global_scale, global_rotation);
+
+            converted_shape = toShape(*request.m_shape, global_scale);
+            return converted_shape.GetPtr();
+        }
+
+        // gives every request its range of hits, returns the largest range
+        template<typename RequestType>
+        uint32_t layoutQueryResults(const std::vector<RequestType>&  requests,
+                                    std::vector<PhysicsQueryResult>& out_results,
+                                    std::vector<PhysicsHitInfo>&     out_hits)
+        {
+            out_results.resize(requests.size());
+
+            uint32_t hit_count        = 0;
+            uint32_t max_hit_capacity = 0;
+            for (size_t request_index = 0; request_index < requests.size(); ++request_index)
+            {
+                const uint32_t hit_capacity = getHitCapacity(requests[request_index]);
+
+                out_results[request_index].m_first_hit = hit_count;
+                out_results[request_index].m_hit_count = 0;
+
+                hit_count += hit_capacity;
+                max_hit_capacity = std::max(max_hit_capacity, hit_capacity);
+            }
+
+            out_hits.resize(hit_count);
+            return max_hit_capacity;
+        }
+    } // namespace
 
-        m_physics.m_jolt_job_system =
-            new JPH::JobSystemThreadPool(m_config.m_max_job_count,
-                                         m_config.m_max_barrier_count,
-                                         static_cast<int>(m_config.m_max_concurrent_job_count));
+    PhysicsQueryShape::PhysicsQueryShape(const RigidBodyShape& shape)
+    {
+        // the scale goes into the shape, jolt expects query transforms without scale
+        const Transform& local_transform = shape.m_local_transform;
+        m_local_transform =
+            Transform(local_transform.m_position, local_transform.m_rotation, Vector3::UNIT_SCALE).getMatrix();
+
+        m_jolt_shape = toShape(shape, local_transform.m_scale);
+        if (m_jolt_shape != nullptr)
+        {
+            m_jolt_shape->AddRef();
+        }
+    }
+
+    PhysicsQueryShape::~PhysicsQueryShape()
+    {
+        if (m_jolt_shape != nullptr)
+        {
+            m_jolt_shape->Release();
+        }
+    }
+
+    PhysicsScene::PhysicsScene(const PhysicsConfig& config,
+                               const Vector3&       gravity,
+                               JPH::JobSystem*      job_system,
+                               JPH::TempAllocator*  temp_allocator) :
+        m_config(config)
+    {
+        static_assert(s_invalid_rigidbody_id == JPH::BodyID::cInvalidBodyID);
+        ASSERT(job_system && temp_allocator);
 
-        // 16M temp memory
-        m_physics.m_temp_allocator = new JPH::TempAllocatorImpl(16 * 1024 * 1024);
+        m_physics.m_jolt_physics_system              = new JPH::PhysicsSystem();
+        m_physics.m_jolt_broad_phase_layer_interface = new BPLayerInterfaceImpl();
+        m_physics.m_jolt_job_system                  = job_system;
+        m_physics.m_temp_allocator                   = temp_allocator;
 
         m_physics.m_jolt_physics_system->Init(m_config.m_max_body_count,
                                               m_config.m_body_mutex_count,
@@ -66,12 +234,7 @@ namespace Piccolo
     PhysicsScene::~PhysicsScene()
     {
         delete m_physics.m_jolt_physics_system;
-        delete m_physics.m_jolt_job_system;
-        delete m_physics.m_temp_allocator;
         delete m_physics.m_jolt_broad_phase_layer_interface;
-
-        delete JPH::Factory::sInstance;
-        JPH::Factory::sInstance = nullptr;
     }
 
     uint32_t PhysicsScene::createRigidBody(const Transform&             global_transform,
@@ -116,9 +279,20 @@ namespace Piccolo
             return JPH::BodyID::cInvalidBodyID;
         }
 
-        //$TODO: currently just support static object
-        JPH::EMotionType motion_type = JPH::EMotionType::Static;
-        JPH::ObjectLayer layer       = Layers::NON_MOVING;
+        const RigidBodyActorType actor_type  = rigidbody_actor_res.getActorType();
+        JPH::EMotionType         motion_type = JPH::EMotionType::Static;
+        switch (actor_type)
+        {
+            case RigidBodyActorType::dynamic_actor:
+                motion_type = JPH::EMotionType::Dynamic;
+                break;
+            case RigidBodyActorType::kinematic_actor:
+                motion_type = JPH::EMotionType::Kinematic;
+                break;
+            default:
+                break;
+        }
+        const JPH::ObjectLayer layer = motion_type == JPH::EMotionType::Static ? Layers::NON_MOVING : Layers::MOVING;
 
         JPH::Ref<JPH::StaticCompoundShapeSettings> compund_shape_setting = new JPH::StaticCompoundShapeSettings;
         for (const JPHShapeData& shape_data : jph_shapes)
@@ -128,11 +302,26 @@ namespace Piccolo
                                             shape_data.shape);
         }
 
-        JPH::Body* jph_body = body_interface.CreateBody(JPH::BodyCreationSettings(compund_shape_setting,
-                                                                                  toVec3(global_transform.m_position),
-                                                                                  toQuat(global_transform.m_rotation),
-                                                                                  motion_type,
-                                                                                  layer));
+        JPH::BodyCreationSettings body_settings(compund_shape_setting,
+                                                toVec3(global_transform.m_position),
+                                                toQuat(global_transform.m_rotation),
+                                                motion_type,
+                                                layer);
+        if (motion_type != JPH::EMotionType::Static)
+        {
+            body_settings.mLinearDamping   = rigidbody_actor_res.m_linear_damping;
+            body_settings.mAngularDamping  = rigidbody_actor_res.m_angular_damping;
+            body_settings.mLinearVelocity  = toVec3(rigidbody_actor_res.m_linear_velocity);
+            body_settings.mAngularVelocity = toVec3(rigidbody_actor_res.m_angular_velocity);
+        }
+        if (motion_type == JPH::EMotionType::Dynamic && rigidbody_actor_res.m_inverse_mass > 0.f)
+        {
+            // keep the inertia of the shapes, scaled to the given mass
+            body_settings.mOverrideMassProperties       = JPH::EOverrideMassProperties::CalculateInertia;
+            body_settings.mMassPropertiesOverride.mMass = 1.f / rigidbody_actor_res.m_inverse_mass;
+        }
+
+        JPH::Body* jph_body = body_interface.CreateBody(body_settings);
 
         if (jph_body == nullptr)
         {
@@ -145,42 +334,250 @@ namespace Piccolo
             return JPH::BodyID::cInvalidBodyID;
         }
 
-        body_interface.AddBody(jph_body->GetID(), JPH::EActivation::Activate);
-        LOG_INFO("Add Body: {}", jph_body->GetID().GetIndexAndSequenceNumber());
+        const uint32_t body_id = jph_body->GetID().GetIndexAndSequenceNumber();
 
-        return jph_body->GetID().GetIndexAndSequenceNumber();
+        // bodies are added to the simulation together on the next tick, adding them one by one locks the broad phase
+        // for every body
+        std::lock_guard<std::mutex> lock_guard(m_pending_bodies_mutex);
+        if (motion_type == JPH::EMotionType::Static)
+        {
+            m_pending_add_static_bodies.push_back(body_id);
+        }
+        else
+        {
+            m_pending_add_moving_bodies.push_back(body_id);
+        }
+
+        if (motion_type == JPH::EMotionType::Dynamic)
+        {
+            m_pending_body_states.push_back({body_id,
+                                             {global_transform.m_position,
+                                              global_transform.m_rotation,
+                                              global_transform.m_position,
+                                              global_transform.m_rotation}});
+        }
+
+        return body_id;
     }
 
-    void PhysicsScene::removeRigidBody(uint32_t body_id) { m_pending_remove_bodies.push_back(body_id); }
+    void PhysicsScene::removeRigidBody(uint32_t body_id)
+    {
+        std::lock_guard<std::mutex> lock_guard(m_pending_bodies_mutex);
+        m_pending_remove_bodies.push_back(body_id);
+    }
 
     void PhysicsScene::updateRigidBodyGlobalTransform(uint32_t body_id, const Transform& global_transform)
     {
-        JPH::BodyInterface& body_interface = m_physics.m_jolt_physics_system->GetBodyInterface();
+        std::lock_guard<std::mutex> lock_guard(m_pending_bodies_mutex);
+        m_pending_body_transforms.push_back({body_id, global_transform.m_position, global_transform.m_rotation});
+    }
+
+    void PhysicsScene::applyPendingBodyChanges(float kinematic_move_time, bool is_simulating)
+    {
+        // the simulation is not running and the objects are not ticked, nothing else touches the bodies here
+        JPH::BodyInterface&                 body_interface = m_physics.m_jolt_physics_system->GetBodyInterfaceNoLock();
+        const JPH::BodyLockInterfaceNoLock& body_lock_interface =
+            m_physics.m_jolt_physics_system->GetBodyLockInterfaceNoLock();
+
+        std::lock_guard<std::mutex> lock_guard(m_pending_bodies_mutex);
+
+        const auto add_bodies = [&body_interface](std::vector<uint32_t>& body_ids, JPH::EActivation activation) {
+            if (body_ids.empty())
+                return;
+
+            std::vector<JPH::BodyID> jph_body_ids(body_ids.begin(), body_ids.end());
+            const int                body_count = static_cast<int>(jph_body_ids.size());
+
+            JPH::BodyInterface::AddState add_state = body_interface.AddBodiesPrepare(jph_body_ids.data(), body_count);
+            body_interface.AddBodiesFinalize(jph_body_ids.data(), body_count, add_state, activation);
+            body_ids.clear();
+        };
+        add_bodies(m_pending_add_static_bodies, JPH::EActivation::DontActivate);
+        add_bodies(m_pending_add_moving_bodies, JPH::EActivation::Activate);
+
+        for (const auto& [body_id, body_state] : m_pending_body_states)
+        {
+            m_body_states[body_id] = body_state;
+        }
+        m_pending_body_states.clear();
+
+        if (!m_pending_remove_bodies.empty())
+        {
+            std::vector<JPH::BodyID> jph_body_ids(m_pending_remove_bodies.begin(), m_pending_remove_bodies.end());
+            const int                body_count = static_cast<int>(jph_body_ids.size());
 
-        body_interface.SetPositionAndRotation(JPH::BodyID(body_id),
-                                              toVec3(global_transform.m_position),
-                                              toQuat(global_transform.m_rotation),
-                                              JPH::EActivation::Activate);
+            LOG_INFO("Remove {} Bodies", body_count);
+            body_interface.RemoveBodies(jph_body_ids.data(), body_count);
+            body_interface.DestroyBodies(jph_body_ids.data(), body_count);
+
+            for (uint32_t body_id : m_pending_remove_bodies)
+            {
+                m_body_states.erase(body_id);
+            }
+            m_pending_remove_bodies.clear();
+        }
+
+        // kinematic bodies get the velocity that reaches the new transform over the steps of this tick, the other
+        // bodies are teleported. While the simulation runs, a tick without steps keeps the latest kinematic transforms
+        // pending for the next tick that steps, a teleport would lose their motion
+        const bool is_kinematic_move_deferred = is_simulating && kinematic_move_time <= 0.f;
+
+        std::vector<uint32_t> moving_kinematic_bodies;
+        size_t                deferred_transform_count = 0;
+        for (size_t transform_index = 0; transform_index < m_pending_body_transforms.size(); ++transform_index)
+        {
+            const PendingBodyTransform body_transform = m_pending_body_transforms[transform_index];
+            const JPH::BodyID          jph_body_id(body_transform.m_body_id);
+
+            bool is_kinematic = false;
+            {
+                JPH::BodyLockRead body_lock(body_lock_interface, jph_body_id);
+                is_kinematic = body_lock.Succeeded() && body_lock.GetBody().IsKinematic();
+            }
+
+            if (is_kinematic && is_kinematic_move_deferred)
+            {
+                m_pending_body_transforms[deferred_transform_count++] = body_transform;
+            }
+            else if (is_kinematic && kinematic_move_time > 0.f)
+            {
+                body_interface.MoveKinematic(jph_body_id,
+                                             toVec3(body_transform.m_position),
+                                             toQuat(body_transform.m_rotation),
+                                             kinematic_move_time);
+                moving_kinematic_bodies.push_back(body_transform.m_body_id);
+            }
+            else
+            {
+                body_interface.SetPositionAndRotation(jph_body_id,
+                                                      toVec3(body_transform.m_position),
+                                                      toQuat(body_transform.m_rotation),
+                                                      JPH::EActivation::Activate);
+
+                // a teleport is not interpolated
+                auto iter = m_body_states.find(body_transform.m_body_id);
+                if (iter != m_body_states.end())
+                {
+                    iter->second = {body_transform.m_position,
+                                    body_transform.m_rotation,
+                                    body_transform.m_position,
+                                    body_transform.m_rotation};
+                }
+            }
+        }
+        m_pending_body_transforms.resize(deferred_transform_count);
+
+        // nothing moved this tick, the kinematic bodies keep the velocity of the last tick that stepped
+        if (is_kinematic_move_deferred)
+            return;
+
+        // kinematic bodies keep their velocity, stop the ones that reached their transform and got no new one
+        std::sort(moving_kinematic_bodies.begin(), moving_kinematic_bodies.end());
+        moving_kinematic_bodies.erase(std::unique(moving_kinematic_bodies.begin(), moving_kinematic_bodies.end()),
+                                      moving_kinematic_bodies.end());
+        for (uint32_t body_id : m_moving_kinematic_bodies)
+        {
+            if (!std::binary_search(moving_kinematic_bodies.begin(), moving_kinematic_bodies.end(), body_id))
+            {
+                body_interface.SetLinearAndAngularVelocity(
+                    JPH::BodyID(body_id), JPH::Vec3::sZero(), JPH::Vec3::sZero());
+            }
+        }
+        m_moving_kinematic_bodies.swap(moving_kinematic_bodies);
     }
 
     void PhysicsScene::tick(float delta_time)
     {
         const float time_step = 1.f / m_config.m_update_frequency;
 
-        m_physics.m_jolt_physics_system->Update(time_step,
-                                                m_physics.m_collision_steps,
-                                                m_physics.m_integration_substeps,
-                                                m_physics.m_temp_allocator,
-                                                m_physics.m_jolt_job_system);
+        m_accumulated_time += std::max(delta_time, 0.f);
 
-        JPH::BodyInterface& body_interface = m_physics.m_jolt_physics_system->GetBodyInterface();
-        for (uint32_t body_id : m_pending_remove_bodies)
+        // a frame runs at most max substeps, the time beyond them is dropped rather than carried over, otherwise a
+        // single long frame makes the following frames slower and they fall further and further behind
+        const uint32_t owed_step_count = static_cast<uint32_t>(m_accumulated_time / time_step);
+        const uint32_t step_count      = std::min(owed_step_count, m_config.m_max_substeps);
+
+        m_step_stats                      = PhysicsStepStats();
+        m_step_stats.m_step_count         = step_count;
+        m_step_stats.m_dropped_step_count = owed_step_count - step_count;
+
+        applyPendingBodyChanges(step_count * time_step, delta_time > 0.f);
+
+        const std::chrono::steady_clock::time_point step_start = std::chrono::steady_clock::now();
+        for (uint32_t step_index = 0; step_index < step_count; ++step_index)
+        {
+            // only the last two steps are interpolated
+            if (step_index + 1 == step_count)
+            {
+                readBodyStates(true);
+            }
+
+            m_physics.m_jolt_physics_system->Update(time_step,
+                                                    m_physics.m_collision_steps,
+                                                    m_physics.m_integration_substeps,
+                                                    m_physics.m_temp_allocator,
+                                                    m_physics.m_jolt_job_system);
+        }
+        if (step_count > 0)
         {
-            LOG_INFO("Remove Body {}", body_id)
-            body_interface.RemoveBody(JPH::BodyID(body_id));
-            body_interface.DestroyBody(JPH::BodyID(body_id));
+            readBodyStates(false);
         }
-        m_pending_remove_bodies.clear();
+        m_step_stats.m_step_time_ms =
+            std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - step_start).count();
+
+        m_accumulated_time = owed_step_count > step_count ? std::fmod(m_accumulated_time, time_step) :
+                                                            m_accumulated_time - step_count * time_step;
+        m_interpolation_alpha              = std::min(m_accumulated_time / time_step, 1.f);
+        m_step_stats.m_interpolation_alpha = m_interpolation_alpha;
+    }
+
+    void PhysicsScene::readBodyStates(bool is_previous)
+    {
+        // the simulation is not running here, the bodies can be read without locking them one by one
+        const JPH::BodyLockInterfaceNoLock& body_lock_interface =
+            m_physics.m_jolt_physics_system->GetBodyLockInterfaceNoLock();
+
+        for (auto& [body_id, body_state] : m_body_states)
+        {
+            JPH::BodyLockRead body_lock(body_lock_interface, JPH::BodyID(body_id));
+            if (!body_lock.Succeeded())
+                continue;
+
+            const JPH::Body& body = body_lock.GetBody();
+            if (is_previous)
+            {
+                body_state.m_previous_position = toVec3(body.GetPosition());
+                body_state.m_previous_rotation = toQuat(body.GetRotation());
+            }
+            else
+            {
+                body_state.m_current_position = toVec3(body.GetPosition());
+                body_state.m_current_rotation = toQuat(body.GetRotation());
+            }
+        }
+    }
+
+    bool PhysicsScene::getSimulatedTransform(uint32_t body_id, Vector3& out_position, Quaternion& out_rotation) const
+    {
+        // the states only change during tick, the objects ticked in parallel read them without a lock
+        auto iter = m_body_states.find(body_id);
+        if (iter == m_body_states.end())
+            return false;
+
+        const BodyState& body_state = iter->second;
+        if (m_config.m_interpolation_mode == PhysicsInterpolationMode::interpolate)
+        {
+            out_position =
+                Vector3::lerp(body_state.m_previous_position, body_state.m_current_position, m_interpolation_alpha);
+            out_rotation = Quaternion::nLerp(
+                m_interpolation_alpha, body_state.m_previous_rotation, body_state.m_current_rotation, true);
+        }
+        else
+        {
+            out_position = body_state.m_current_position;
+            out_rotation = body_state.m_current_rotation;
+        }
+        return true;
     }
 
     bool PhysicsScene::raycast(Vector3                      ray_origin,
@@ -316,6 +713,196 @@ namespace Piccolo
         return collector.HadHit();
     }
 
+    template<typename RangeFunction>
+    void PhysicsScene::runQueryJobs(uint32_t count, const RangeFunction& range_function) const
+    {
+        if (count == 0)
+            return;
+
+        JPH::JobSystem* job_system      = m_physics.m_jolt_job_system;
+        const uint32_t  max_concurrency = static_cast<uint32_t>(job_system->GetMaxConcurrency());
+
+        // a few ranges per thread so that the ranges with expensive queries balance out
+        const uint32_t range_size =
+            std::max(k_min_queries_per_job, (count + max_concurrency * 4 - 1) / (max_concurrency * 4));
+
+        // small batches, e.g. the single queries of the character controller, run inline without job allocations
+        JPH::JobSystem::Barrier* barrier =
+            max_concurrency > 1 && range_size < count ? job_system->CreateBarrier() : nullptr;
+        if (barrier == nullptr)
+        {
+            range_function(0, count);
+            return;
+        }
+
+        for (uint32_t begin = 0; begin < count; begin += range_size)
+        {
+            const uint32_t end = std::min(begin + range_size, count);
+            barrier->AddJob(job_system->CreateJob(
+                "SceneQueries", JPH::Color::sCyan, [&range_function, begin, end]() { range_function(begin, end); }));
+        }
+
+        job_system->WaitForJobs(barrier);
+        job_system->DestroyBarrier(barrier);
+    }
+
+    void PhysicsScene::raycastBatch(const std::vector<PhysicsRaycastRequest>& requests,
+                                    std::vector<PhysicsQueryResult>&          out_results,
+                                    std::vector<PhysicsHitInfo>&              out_hits) const
+    {
+        const uint32_t max_hit_capacity = layoutQueryResults(requests, out_results, out_hits);
+
+        const JPH::NarrowPhaseQuery&  scene_query         = m_physics.m_jolt_physics_system->GetNarrowPhaseQuery();
+        const JPH::BodyLockInterface& body_lock_interface = m_physics.m_jolt_physics_system->GetBodyLockInterface();
+
+        runQueryJobs(static_cast<uint32_t>(requests.size()), [&](uint32_t begin, uint32_t end) {
+            QueryHitScratch<JPH::RayCastResult> cast_results(max_hit_capacity);
+            const JPH::ObjectLayerFilter        object_layer_filter;
+
+            for (uint32_t request_index = begin; request_index < end; ++request_index)
+            {
+                const PhysicsRaycastRequest& request = requests[request_index];
+                PhysicsQueryResult&          result  = out_results[request_index];
+
+                JPH::RayCast ray;
+                ray.mOrigin    = toVec3(request.m_origin);
+                ray.mDirection = toVec3(request.m_direction.normalisedCopy() * request.m_length);
+
+                const QueryBroadPhaseLayerFilter  broad_phase_layer_filter(request.m_filter);
+                const JPH::IgnoreSingleBodyFilter body_filter(JPH::BodyID(request.m_filter.m_ignored_body_id));
+
+                BoundedHitCollector<JPH::CastRayCollector> collector(
+                    cast_results.getData(), getHitCapacity(request), request.m_hit_mode == PhysicsQueryHitMode::any);
+                scene_query.CastRay(
+                    ray, JPH::RayCastSettings(), collector, broad_phase_layer_filter, object_layer_filter, body_filter);
+
+                result.m_hit_count = collector.getHitCount();
+                for (uint32_t hit_index = 0; hit_index < result.m_hit_count; ++hit_index)
+                {
+                    const JPH::RayCastResult& cast_result = cast_results.getData()[hit_index];
+                    const JPH::Vec3           hit_position = ray.mOrigin + cast_result.mFraction * ray.mDirection;
+
+                    PhysicsHitInfo& hit = out_hits[result.m_first_hit + hit_index];
+                    hit.hit_position    = toVec3(hit_position);
+                    hit.hit_distance    = cast_result.mFraction * request.m_length;
+                    hit.body_id         = cast_result.mBodyID.GetIndexAndSequenceNumber();
+
+                    JPH::BodyLockRead body_lock(body_lock_interface, cast_result.mBodyID);
+                    hit.hit_normal =
+                        toVec3(body_lock.GetBody().GetWorldSpaceSurfaceNormal(cast_result.mSubShapeID2, hit_position));
+                }
+            }
+        });
+    }
+
+    void PhysicsScene::sweepBatch(const std::vector<PhysicsSweepRequest>& requests,
+                                  std::vector<PhysicsQueryResult>&        out_results,
+                                  std::vector<PhysicsHitInfo>&            out_hits) const
+    {
+        const uint32_t max_hit_capacity = layoutQueryResults(requests, out_results, out_hits);
+
+        const JPH::NarrowPhaseQuery& scene_query = m_physics.m_jolt_physics_system->GetNarrowPhaseQuery();
+
+        runQueryJobs(static_cast<uint32_t>(requests.size()), [&](uint32_t begin, uint32_t end) {
+            QueryHitScratch<JPH::ShapeCastResult> sweep_results(max_hit_capacity);
+            const JPH::ObjectLayerFilter          object_layer_filter;
+
+            for (uint32_t request_index = begin; request_index < end; ++request_index)
+            {
+                const PhysicsSweepRequest& request = requests[request_index];
+                PhysicsQueryResult&        result  = out_results[request_index];
+
+                JPH::RefConst<JPH::Shape> converted_shape;
+                Matrix4x4                 shape_global_transform;
+                const JPH::Shape* jph_shape = getRequestShape(request, converted_shape, shape_global_transform);
+                if (jph_shape == nullptr)
+                    continue;
+
+                const Vector3        sweep_vector = request.m_direction.normalisedCopy() * request.m_length;
+                const JPH::ShapeCast shape_cast   = JPH::ShapeCast::sFromWorldTransform(
+                    jph_shape, JPH::Vec3::sReplicate(1.f), toMat44(shape_global_transform), toVec3(sweep_vector));
+
+                const QueryBroadPhaseLayerFilter  broad_phase_layer_filter(request.m_filter);
+                const JPH::IgnoreSingleBodyFilter body_filter(JPH::BodyID(request.m_filter.m_ignored_body_id));
+
+                BoundedHitCollector<JPH::CastShapeCollector> collector(
+                    sweep_results.getData(), getHitCapacity(request), request.m_hit_mode == PhysicsQueryHitMode::any);
+                scene_query.CastShape(shape_cast,
+                                      JPH::ShapeCastSettings(),
+                                      collector,
+                                      broad_phase_layer_filter,
+                                      object_layer_filter,
+                                      body_filter);
+
+                result.m_hit_count = collector.getHitCount();
+                for (uint32_t hit_index = 0; hit_index < result.m_hit_count; ++hit_index)
+                {
+                    const JPH::ShapeCastResult& sweep_result = sweep_results.getData()[hit_index];
+
+                    PhysicsHitInfo& hit = out_hits[result.m_first_hit + hit_index];
+                    hit.hit_position    = toVec3(sweep_result.mContactPointOn2);
+                    hit.hit_normal      = toVec3(sweep_result.mPenetrationAxis.Normalized());
+                    hit.hit_distance    = sweep_result.mFraction * request.m_length;
+                    hit.body_id         = sweep_result.mBodyID2.GetIndexAndSequenceNumber();
+                }
+            }
+        });
+    }
+
+    void PhysicsScene::overlapBatch(const std::vector<PhysicsOverlapRequest>& requests,
+                                    std::vector<PhysicsQueryResult>&          out_results,
+                                    std::vector<PhysicsHitInfo>&              out_hits) const
+    {
+        const uint32_t max_hit_capacity = layoutQueryResults(requests, out_results, out_hits);
+
+        const JPH::NarrowPhaseQuery& scene_query = m_physics.m_jolt_physics_system->GetNarrowPhaseQuery();
+
+        runQueryJobs(static_cast<uint32_t>(requests.size()), [&](uint32_t begin, uint32_t end) {
+            QueryHitScratch<JPH::CollideShapeResult> overlap_results(max_hit_capacity);
+            const JPH::ObjectLayerFilter             object_layer_filter;
+
+            for (uint32_t request_index = begin; request_index < end; ++request_index)
+            {
+                const PhysicsOverlapRequest& request = requests[request_index];
+                PhysicsQueryResult&          result  = out_results[request_index];
+
+                JPH::RefConst<JPH::Shape> converted_shape;
+                Matrix4x4                 shape_global_transform;
+                const JPH::Shape* jph_shape = getRequestShape(request, converted_shape, shape_global_transform);
+                if (jph_shape == nullptr)
+                    continue;
+
+                const QueryBroadPhaseLayerFilter  broad_phase_layer_filter(request.m_filter);
+                const JPH::IgnoreSingleBodyFilter body_filter(JPH::BodyID(request.m_filter.m_ignored_body_id));
+
+                BoundedHitCollector<JPH::CollideShapeCollector> collector(
+                    overlap_results.getData(), getHitCapacity(request), request.m_hit_mode == PhysicsQueryHitMode::any);
+                scene_query.CollideShape(jph_shape,
+                                         JPH::Vec3::sReplicate(1.f),
+                                         toMat44(shape_global_transform),
+                                         JPH::CollideShapeSettings(),
+                                         collector,
+                                         broad_phase_layer_filter,
+                                         object_layer_filter,
+                                         body_filter);
+
+                result.m_hit_count = collector.getHitCount();
+                for (uint32_t hit_index = 0; hit_index < result.m_hit_count; ++hit_index)
+                {
+                    const JPH::CollideShapeResult& overlap_result = overlap_results.getData()[hit_index];
+
+                    PhysicsHitInfo& hit = out_hits[result.m_first_hit + hit_index];
+                    hit.hit_position    = toVec3(overlap_result.mContactPointOn2);
+                    hit.hit_normal      = overlap_result.mPenetrationAxis.IsNearZero() ?
+                                              Vector3::ZERO :
+                                              toVec3(overlap_result.mPenetrationAxis.Normalized());
+                    hit.hit_distance    = overlap_result.mPenetrationDepth;
+                    hit.body_id         = overlap_result.mBodyID2.GetIndexAndSequenceNumber();
+                }
+            }
+        });
+    }
+
     void PhysicsScene::getShapeBoundingBoxes(uint32_t body_id, std::vector<AxisAlignedBox>& out_bounding_boxes) const
     {
         JPH::BodyLockRead body_lock(m_physics.m_jolt_physics_system->GetBodyLockInterface(), JPH::BodyID(body_id));
@@ -1,12 +1,19 @@
 #pragma once
 
 #include "runtime/core/math/axis_aligned.h"
+#include "runtime/core/math/matrix4.h"
+#include "runtime/core/math/quaternion.h"
 
 #include "runtime/function/physics/physics_config.h"
 
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
 namespace JPH
 {
     class PhysicsSystem;
+    class Shape;
     class JobSystem;
     class TempAllocator;
     class BroadPhaseLayerInterface;
@@ -31,6 +38,96 @@ namespace Piccolo
         uint32_t body_id {s_invalid_rigidbody_id};
     };
 
+    enum class PhysicsQueryHitMode : uint8_t
+    {
+        // the hit nearest to the start of the query, for overlaps the deepest one
+        closest,
+        // the first hit found, cheapest when only the presence of a hit matters
+        any,
+        // up to m_max_hit_count hits, the closest ones, sorted by distance
+        all
+    };
+
+    /// which bodies a query can hit
+    struct PhysicsQueryFilter
+    {
+        bool     m_hit_static_bodies {true};
+        bool     m_hit_moving_bodies {true};
+        uint32_t m_ignored_body_id {s_invalid_rigidbody_id};
+    };
+
+    /// a shape converted for the queries once, for owners sweeping the same shape every frame like a character
+    /// controller. The scale of the shape is applied at creation, the query transform should not scale it again
+    class PhysicsQueryShape
+    {
+    public:
+        explicit PhysicsQueryShape(const RigidBodyShape& shape);
+        ~PhysicsQueryShape();
+
+        PhysicsQueryShape(const PhysicsQueryShape&) = delete;
+        PhysicsQueryShape& operator=(const PhysicsQueryShape&) = delete;
+
+        bool              isValid() const { return m_jolt_shape != nullptr; }
+        const JPH::Shape* getJoltShape() const { return m_jolt_shape; }
+        const Matrix4x4&  getLocalTransform() const { return m_local_transform; }
+
+    private:
+        // holds a reference to the shape
+        const JPH::Shape* m_jolt_shape {nullptr};
+        Matrix4x4         m_local_transform;
+    };
+
+    struct PhysicsRaycastRequest
+    {
+        Vector3             m_origin;
+        Vector3             m_direction;
+        float               m_length {0.f};
+        PhysicsQueryHitMode m_hit_mode {PhysicsQueryHitMode::closest};
+        uint32_t            m_max_hit_count {1};
+        PhysicsQueryFilter  m_filter;
+    };
+
+    struct PhysicsSweepRequest
+    {
+        const RigidBodyShape*    m_shape {nullptr};
+        // used instead of m_shape when set
+        const PhysicsQueryShape* m_query_shape {nullptr};
+        Matrix4x4                m_shape_transform;
+        Vector3                  m_direction;
+        float                    m_length {0.f};
+        PhysicsQueryHitMode      m_hit_mode {PhysicsQueryHitMode::closest};
+        uint32_t                 m_max_hit_count {1};
+        PhysicsQueryFilter       m_filter;
+    };
+
+    /// the hit distance of an overlap hit is the penetration depth
+    struct PhysicsOverlapRequest
+    {
+        const RigidBodyShape*    m_shape {nullptr};
+        // used instead of m_shape when set
+        const PhysicsQueryShape* m_query_shape {nullptr};
+        Matrix4x4                m_shape_transform;
+        PhysicsQueryHitMode      m_hit_mode {PhysicsQueryHitMode::any};
+        uint32_t                 m_max_hit_count {1};
+        PhysicsQueryFilter       m_filter;
+    };
+
+    /// the hits of a request of a batch are out_hits[m_first_hit, m_first_hit + m_hit_count)
+    struct PhysicsQueryResult
+    {
+        uint32_t m_first_hit {0};
+        uint32_t m_hit_count {0};
+    };
+
+    /// steps run by the last tick, the dropped steps are the time the tick could not catch up within the max substeps
+    struct PhysicsStepStats
+    {
+        uint32_t m_step_count {0};
+        uint32_t m_dropped_step_count {0};
+        float    m_step_time_ms {0.f};
+        float    m_interpolation_alpha {0.f};
+    };
+
     class PhysicsScene
     {
         struct JoltPhysics
@@ -44,19 +141,48 @@ namespace Piccolo
             int m_integration_substeps {1};
         };
 
+        // poses of a simulated body before and after the last step
+        struct BodyState
+        {
+            Vector3    m_previous_position;
+            Quaternion m_previous_rotation;
+            Vector3    m_current_position;
+            Quaternion m_current_rotation;
+        };
+
+        struct PendingBodyTransform
+        {
+            uint32_t   m_body_id;
+            Vector3    m_position;
+            Quaternion m_rotation;
+        };
+
     public:
-        PhysicsScene(const Vector3& gravity);
+        /// the job system and the temp allocator are owned by the physics manager and outlive the scene
+        PhysicsScene(const PhysicsConfig& config,
+                     const Vector3&       gravity,
+                     JPH::JobSystem*      job_system,
+                     JPH::TempAllocator*  temp_allocator);
         virtual ~PhysicsScene();
 
-        const Vector3& getGravity() const { return m_config.m_gravity; }
+        const Vector3&          getGravity() const { return m_config.m_gravity; }
+        const PhysicsStepStats& getStepStats() const { return m_step_stats; }
 
+        /// the body joins the simulation and the scene queries on the next tick
         uint32_t createRigidBody(const Transform& global_transform, const RigidBodyComponentRes& rigidbody_actor_res);
         void     removeRigidBody(uint32_t body_id);
 
+        /// applied on the next tick, kinematic bodies move there over the steps of the tick, other bodies teleport
         void updateRigidBodyGlobalTransform(uint32_t body_id, const Transform& global_transform);
 
+        /// advances the simulation by whole fixed steps, the remaining time is carried over to the next tick
         void tick(float delta_time);
 
+        /// pose of a body moved by the simulation, interpolated between the last two steps depending on the config.
+        /// Safe to call from several threads, but not during tick
+        /// @return: false for bodies the simulation does not move, e.g. static bodies
+        bool getSimulatedTransform(uint32_t body_id, Vector3& out_position, Quaternion& out_rotation) const;
+
         /// cast a ray and find the hits
         /// @ray_origin: origin of ray
         /// @ray_direction: ray direction
@@ -84,6 +210,20 @@ namespace Piccolo
         /// @return: true if overlapped with any rigidbodies
         bool isOverlap(const RigidBodyShape& shape, const Matrix4x4& global_transform);
 
+        /// batched queries, the requests are split into jobs on the physics job system and the calling thread waits
+        /// for them. out_results[i] is the result of requests[i], out_hits holds room for the hits of every request
+        /// and both keep their capacity, so reusing them across frames avoids allocations. Safe to call from
+        /// several threads, but not during tick
+        void raycastBatch(const std::vector<PhysicsRaycastRequest>& requests,
+                          std::vector<PhysicsQueryResult>&          out_results,
+                          std::vector<PhysicsHitInfo>&              out_hits) const;
+        void sweepBatch(const std::vector<PhysicsSweepRequest>& requests,
+                        std::vector<PhysicsQueryResult>&        out_results,
+                        std::vector<PhysicsHitInfo>&            out_hits) const;
+        void overlapBatch(const std::vector<PhysicsOverlapRequest>& requests,
+                          std::vector<PhysicsQueryResult>&          out_results,
+                          std::vector<PhysicsHitInfo>&              out_hits) const;
+
         void getShapeBoundingBoxes(uint32_t body_id, std::vector<AxisAlignedBox>& out_bounding_boxes) const;
 
 #ifdef ENABLE_PHYSICS_DEBUG_RENDERER
@@ -91,11 +231,38 @@ namespace Piccolo
 #endif
 
     protected:
+        // kinematic_move_time is the time the steps of this tick simulate. Without steps kinematic bodies wait for the
+        // next tick that steps while the simulation runs, and are teleported otherwise, e.g. in the editor
+        void applyPendingBodyChanges(float kinematic_move_time, bool is_simulating);
+        void readBodyStates(bool is_previous);
+
+        // splits [0, count) into ranges run as jolt jobs, all on the calling thread when no barrier is free or the
+        // ranges would not be split. range_function(begin, end) is called without being copied
+        template<typename RangeFunction>
+        void runQueryJobs(uint32_t count, const RangeFunction& range_function) const;
+
         // we use single Jolt physics system for each scene
         JoltPhysics m_physics;
 
         PhysicsConfig m_config;
 
-        std::vector<uint32_t> m_pending_remove_bodies;
+        // bodies are created, moved and removed from objects ticked in parallel, the changes are applied in batches
+        std::mutex                        m_pending_bodies_mutex;
+        std::vector<uint32_t>             m_pending_add_static_bodies;
+        std::vector<uint32_t>             m_pending_add_moving_bodies;
+        std::vector<uint32_t>             m_pending_remove_bodies;
+        std::vector<PendingBodyTransform> m_pending_body_transforms;
+        // states of the dynamic bodies created since the last tick
+        std::vector<std::pair<uint32_t, BodyState>> m_pending_body_states;
+        // sorted, kinematic bodies that were given a velocity by the last tick
+        std::vector<uint32_t> m_moving_kinematic_bodies;
+
+        // time not simulated yet, always less than one step after a tick
+        float            m_accumulated_time {0.f};
+        float            m_interpolation_alpha {1.f};
+        PhysicsStepStats m_step_stats;
+
+        // only changed during tick, read without a lock by the objects ticked in parallel
+        std::unordered_map<uint32_t, BodyState> m_body_states;
     };
 } // namespace Piccolo
\ No newline at end of file
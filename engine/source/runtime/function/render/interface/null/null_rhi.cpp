@@ -0,0 +1,895 @@
+#include "runtime/function/render/interface/null/null_rhi.h"
+
+#include "runtime/function/render/window_system.h"
+
+#include "runtime/core/base/macro.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace Piccolo
+{
+    namespace
+    {
+        uint32_t getFormatSize(RHIFormat format)
+        {
+            switch (format)
+            {
+                case RHI_FORMAT_R8_UNORM:
+                    return 1;
+                case RHI_FORMAT_R8G8_UNORM:
+                    return 2;
+                case RHI_FORMAT_R8G8B8_UNORM:
+                case RHI_FORMAT_R8G8B8_SRGB:
+                    return 3;
+                case RHI_FORMAT_R16G16B16A16_SFLOAT:
+                case RHI_FORMAT_R32G32_SFLOAT:
+                    return 8;
+                case RHI_FORMAT_R32G32B32_SFLOAT:
+                    return 12;
+                case RHI_FORMAT_R32G32B32A32_SFLOAT:
+                    return 16;
+                default:
+                    return 4;
+            }
+        }
+
+        uint64_t getImageSize(uint32_t width, uint32_t height, RHIFormat format)
+        {
+            return static_cast<uint64_t>(width) * height * getFormatSize(format);
+        }
+
+        NullImage* createNullImage(uint32_t width, uint32_t height, RHIFormat format, uint32_t array_layers, uint32_t mip_levels)
+        {
+            NullImage* image      = new NullImage();
+            image->m_width        = width;
+            image->m_height       = height;
+            image->m_format       = format;
+            image->m_array_layers = array_layers;
+            image->m_mip_levels   = mip_levels;
+            return image;
+        }
+    } // namespace
+
+    void NullRHIStats::add(const NullRHIStats& other)
+    {
+        m_frame_count += other.m_frame_count;
+        m_command_count += other.m_command_count;
+        m_render_pass_count += other.m_render_pass_count;
+        m_draw_count += other.m_draw_count;
+        m_instance_count += other.m_instance_count;
+        m_dispatch_count += other.m_dispatch_count;
+        m_state_change_count += other.m_state_change_count;
+        m_pipeline_bind_count += other.m_pipeline_bind_count;
+        m_descriptor_set_bind_count += other.m_descriptor_set_bind_count;
+        m_descriptor_update_count += other.m_descriptor_update_count;
+        m_uploaded_bytes += other.m_uploaded_bytes;
+        m_submit_count += other.m_submit_count;
+    }
+
+    NullRHI::~NullRHI()
+    {
+        // the objects handed out are owned by their callers, like the vulkan handles
+    }
+
+    void NullRHI::initialize(RHIInitInfo init_info)
+    {
+        m_window_system = init_info.window_system;
+
+        m_graphics_queue  = new RHIQueue();
+        m_compute_queue   = new RHIQueue();
+        m_descriptor_pool = new RHIDescriptorPool();
+        createCommandPool();
+
+        for (uint32_t i = 0; i < k_max_frames_in_flight; ++i)
+        {
+            m_command_buffers[i]                             = new NullCommandBuffer();
+            m_is_frame_in_flight_fences[i]                   = new RHIFence();
+            m_image_available_for_texturescopy_semaphores[i] = new RHISemaphore();
+        }
+
+        createSwapchain();
+        createSwapchainImageViews();
+        createFramebufferImageAndView();
+
+        LOG_INFO("null rhi initialized, {}x{} swapchain", m_swapchain_extent.width, m_swapchain_extent.height);
+    }
+
+    void NullRHI::prepareContext() {}
+
+    bool NullRHI::isPointLightShadowEnabled() { return true; }
+
+    bool NullRHI::allocateCommandBuffers(const RHICommandBufferAllocateInfo* pAllocateInfo, RHICommandBuffer* &pCommandBuffers)
+    {
+        pCommandBuffers = new NullCommandBuffer();
+        return RHI_SUCCESS;
+    }
+
+    bool NullRHI::allocateDescriptorSets(const RHIDescriptorSetAllocateInfo* pAllocateInfo, RHIDescriptorSet* &pDescriptorSets)
+    {
+        pDescriptorSets = new RHIDescriptorSet();
+        return RHI_SUCCESS;
+    }
+
+    void NullRHI::createSwapchain()
+    {
+        std::array<int, 2> window_size = {1280, 720};
+        if (m_window_system)
+        {
+            window_size = m_window_system->getWindowSize();
+        }
+
+        m_swapchain_extent.width  = static_cast<uint32_t>(std::max(window_size[0], 1));
+        m_swapchain_extent.height = static_cast<uint32_t>(std::max(window_size[1], 1));
+
+        m_viewport = {0.0f, 0.0f, (float)m_swapchain_extent.width, (float)m_swapchain_extent.height, 0.0f, 1.0f};
+        m_scissor  = {{0, 0}, {m_swapchain_extent.width, m_swapchain_extent.height}};
+    }
+
+    void NullRHI::recreateSwapchain()
+    {
+        createSwapchain();
+    }
+
+    void NullRHI::createSwapchainImageViews()
+    {
+        if (!m_swapchain_imageviews.empty())
+            return;
+
+        for (uint32_t i = 0; i < k_swapchain_image_count; ++i)
+        {
+            m_swapchain_imageviews.push_back(new RHIImageView());
+        }
+    }
+
+    void NullRHI::createFramebufferImageAndView()
+    {
+        if (m_depth_image == nullptr)
+        {
+            m_depth_image = createNullImage(
+                m_swapchain_extent.width, m_swapchain_extent.height, m_depth_image_format, 1, 1);
+            m_depth_image_view = new RHIImageView();
+        }
+        else
+        {
+            NullImage* depth_image = static_cast<NullImage*>(m_depth_image);
+            depth_image->m_width   = m_swapchain_extent.width;
+            depth_image->m_height  = m_swapchain_extent.height;
+        }
+    }
+
+    RHISampler* NullRHI::getOrCreateDefaultSampler(RHIDefaultSamplerType type)
+    {
+        switch (type)
+        {
+        case Piccolo::Default_Sampler_Linear:
+            if (m_linear_sampler == nullptr)
+            {
+                m_linear_sampler = new RHISampler();
+            }
+            return m_linear_sampler;
+
+        case Piccolo::Default_Sampler_Nearest:
+            if (m_nearest_sampler == nullptr)
+            {
+                m_nearest_sampler = new RHISampler();
+            }
+            return m_nearest_sampler;
+
+        default:
+            return nullptr;
+        }
+    }
+
+    RHISampler* NullRHI::getOrCreateMipmapSampler(uint32_t width, uint32_t height)
+    {
+        if (width == 0 || height == 0)
+        {
+            LOG_ERROR("width == 0 || height == 0");
+            return nullptr;
+        }
+
+        const uint32_t mip_levels   = static_cast<uint32_t>(std::floor(std::log2(std::max(width, height)))) + 1;
+        auto           find_sampler = m_mipmap_sampler_map.find(mip_levels);
+        if (find_sampler != m_mipmap_sampler_map.end())
+        {
+            return find_sampler->second;
+        }
+
+        RHISampler* sampler = new RHISampler();
+        m_mipmap_sampler_map.insert(std::make_pair(mip_levels, sampler));
+        return sampler;
+    }
+
+    RHIShader* NullRHI::createShaderModule(const std::vector<unsigned char>& shader_code)
+    {
+        return new RHIShader();
+    }
+
+    void NullRHI::createBuffer(RHIDeviceSize size, RHIBufferUsageFlags usage, RHIMemoryPropertyFlags properties, RHIBuffer* &buffer, RHIDeviceMemory* &buffer_memory)
+    {
+        NullDeviceMemory* memory      = new NullDeviceMemory(size);
+        NullBuffer*       null_buffer = new NullBuffer();
+        null_buffer->m_size           = size;
+        null_buffer->m_data           = memory->m_data.get();
+
+        buffer        = null_buffer;
+        buffer_memory = memory;
+    }
+
+    void NullRHI::createBufferAndInitialize(RHIBufferUsageFlags usage, RHIMemoryPropertyFlags properties, RHIBuffer*& buffer, RHIDeviceMemory*& buffer_memory, RHIDeviceSize size, void* data, int datasize)
+    {
+        createBuffer(size, usage, properties, buffer, buffer_memory);
+
+        if (data != nullptr && datasize > 0)
+        {
+            const size_t copy_size = std::min(static_cast<size_t>(datasize), static_cast<size_t>(size));
+            memcpy(static_cast<NullBuffer*>(buffer)->m_data, data, copy_size);
+            m_current_frame_stats.m_uploaded_bytes += copy_size;
+        }
+    }
+
+    bool NullRHI::createBufferVMA(VmaAllocator allocator, const RHIBufferCreateInfo* pBufferCreateInfo, const VmaAllocationCreateInfo* pAllocationCreateInfo, RHIBuffer* &pBuffer, VmaAllocation* pAllocation, VmaAllocationInfo* pAllocationInfo)
+    {
+        return createBufferWithAlignmentVMA(
+            allocator, pBufferCreateInfo, pAllocationCreateInfo, 1, pBuffer, pAllocation, pAllocationInfo);
+    }
+
+    bool NullRHI::createBufferWithAlignmentVMA(VmaAllocator allocator, const RHIBufferCreateInfo* pBufferCreateInfo, const VmaAllocationCreateInfo* pAllocationCreateInfo, RHIDeviceSize minAlignment, RHIBuffer* &pBuffer, VmaAllocation* pAllocation, VmaAllocationInfo* pAllocationInfo)
+    {
+        NullBuffer* buffer = new NullBuffer();
+        buffer->m_size     = pBufferCreateInfo->size;
+        if (buffer->m_size > 0)
+        {
+            buffer->m_owned_data.reset(new uint8_t[static_cast<size_t>(buffer->m_size)]);
+            buffer->m_data = buffer->m_owned_data.get();
+        }
+        pBuffer = buffer;
+
+        // there is no allocator behind the null rhi
+        if (pAllocation != nullptr)
+        {
+            *pAllocation = VK_NULL_HANDLE;
+        }
+        if (pAllocationInfo != nullptr)
+        {
+            *pAllocationInfo = {};
+        }
+        return RHI_SUCCESS;
+    }
+
+    void NullRHI::copyBuffer(RHIBuffer* srcBuffer, RHIBuffer* dstBuffer, RHIDeviceSize srcOffset, RHIDeviceSize dstOffset, RHIDeviceSize size)
+    {
+        NullBuffer* src_buffer = static_cast<NullBuffer*>(srcBuffer);
+        NullBuffer* dst_buffer = static_cast<NullBuffer*>(dstBuffer);
+        ASSERT(srcOffset + size <= src_buffer->m_size && dstOffset + size <= dst_buffer->m_size);
+
+        memcpy(dst_buffer->m_data + dstOffset, src_buffer->m_data + srcOffset, static_cast<size_t>(size));
+        m_current_frame_stats.m_uploaded_bytes += size;
+    }
+
+    void NullRHI::createImage(uint32_t image_width, uint32_t image_height, RHIFormat format, RHIImageTiling image_tiling, RHIImageUsageFlags image_usage_flags, RHIMemoryPropertyFlags memory_property_flags,
+        RHIImage* &image, RHIDeviceMemory* &memory, RHIImageCreateFlags image_create_flags, uint32_t array_layers, uint32_t miplevels)
+    {
+        image  = createNullImage(image_width, image_height, format, array_layers, miplevels);
+        memory = new NullDeviceMemory(0);
+    }
+
+    void NullRHI::createImageView(RHIImage* image, RHIFormat format, RHIImageAspectFlags image_aspect_flags, RHIImageViewType view_type, uint32_t layout_count, uint32_t miplevels,
+        RHIImageView* &image_view)
+    {
+        image_view = new RHIImageView();
+    }
+
+    void NullRHI::createGlobalImage(RHIImage* &image, RHIImageView* &image_view, VmaAllocation& image_allocation, uint32_t texture_image_width, uint32_t texture_image_height, void* texture_image_pixels, RHIFormat texture_image_format, uint32_t miplevels)
+    {
+        if (!texture_image_pixels)
+        {
+            return;
+        }
+
+        image            = createNullImage(texture_image_width, texture_image_height, texture_image_format, 1, std::max(miplevels, 1u));
+        image_view       = new RHIImageView();
+        image_allocation = VK_NULL_HANDLE;
+
+        m_current_frame_stats.m_uploaded_bytes +=
+            getImageSize(texture_image_width, texture_image_height, texture_image_format);
+    }
+
+    void NullRHI::createCubeMap(RHIImage* &image, RHIImageView* &image_view, VmaAllocation& image_allocation, uint32_t texture_image_width, uint32_t texture_image_height, std::array<void*, 6> texture_image_pixels, RHIFormat texture_image_format, uint32_t miplevels)
+    {
+        image            = createNullImage(texture_image_width, texture_image_height, texture_image_format, 6, std::max(miplevels, 1u));
+        image_view       = new RHIImageView();
+        image_allocation = VK_NULL_HANDLE;
+
+        for (void* face_pixels : texture_image_pixels)
+        {
+            if (face_pixels)
+            {
+                m_current_frame_stats.m_uploaded_bytes +=
+                    getImageSize(texture_image_width, texture_image_height, texture_image_format);
+            }
+        }
+    }
+
+    void NullRHI::createCommandPool()
+    {
+        if (m_command_pool == nullptr)
+        {
+            m_command_pool = new RHICommandPool();
+        }
+    }
+
+    bool NullRHI::createCommandPool(const RHICommandPoolCreateInfo* pCreateInfo, RHICommandPool*& pCommandPool)
+    {
+        pCommandPool = new RHICommandPool();
+        return RHI_SUCCESS;
+    }
+
+    bool NullRHI::createDescriptorPool(const RHIDescriptorPoolCreateInfo* pCreateInfo, RHIDescriptorPool* &pDescriptorPool)
+    {
+        pDescriptorPool = new RHIDescriptorPool();
+        return RHI_SUCCESS;
+    }
+
+    bool NullRHI::createDescriptorSetLayout(const RHIDescriptorSetLayoutCreateInfo* pCreateInfo, RHIDescriptorSetLayout* &pSetLayout)
+    {
+        pSetLayout = new RHIDescriptorSetLayout();
+        return RHI_SUCCESS;
+    }
+
+    bool NullRHI::createFence(const RHIFenceCreateInfo* pCreateInfo, RHIFence* &pFence)
+    {
+        pFence = new RHIFence();
+        return RHI_SUCCESS;
+    }
+
+    bool NullRHI::createFramebuffer(const RHIFramebufferCreateInfo* pCreateInfo, RHIFramebuffer* &pFramebuffer)
+    {
+        pFramebuffer = new RHIFramebuffer();
+        return RHI_SUCCESS;
+    }
+
+    bool NullRHI::createGraphicsPipelines(RHIPipelineCache* pipelineCache, uint32_t createInfoCount, const RHIGraphicsPipelineCreateInfo* pCreateInfos, RHIPipeline* &pPipelines)
+    {
+        pPipelines = new RHIPipeline();
+        return RHI_SUCCESS;
+    }
+
+    bool NullRHI::createComputePipelines(RHIPipelineCache* pipelineCache, uint32_t createInfoCount, const RHIComputePipelineCreateInfo* pCreateInfos, RHIPipeline* &pPipelines)
+    {
+        pPipelines = new RHIPipeline();
+        return RHI_SUCCESS;
+    }
+
+    bool NullRHI::createPipelineLayout(const RHIPipelineLayoutCreateInfo* pCreateInfo, RHIPipelineLayout* &pPipelineLayout)
+    {
+        pPipelineLayout = new RHIPipelineLayout();
+        return RHI_SUCCESS;
+    }
+
+    bool NullRHI::createRenderPass(const RHIRenderPassCreateInfo* pCreateInfo, RHIRenderPass* &pRenderPass)
+    {
+        pRenderPass = new RHIRenderPass();
+        return RHI_SUCCESS;
+    }
+
+    bool NullRHI::createSampler(const RHISamplerCreateInfo* pCreateInfo, RHISampler* &pSampler)
+    {
+        pSampler = new RHISampler();
+        return RHI_SUCCESS;
+    }
+
+    bool NullRHI::createSemaphore(const RHISemaphoreCreateInfo* pCreateInfo, RHISemaphore* &pSemaphore)
+    {
+        pSemaphore = new RHISemaphore();
+        return RHI_SUCCESS;
+    }
+
+    bool NullRHI::waitForFencesPFN(uint32_t fenceCount, RHIFence* const* pFence, RHIBool32 waitAll, uint64_t timeout)
+    {
+        return RHI_SUCCESS;
+    }
+
+    bool NullRHI::resetFencesPFN(uint32_t fenceCount, RHIFence* const* pFences)
+    {
+        return RHI_SUCCESS;
+    }
+
+    bool NullRHI::resetCommandPoolPFN(RHICommandPool* commandPool, RHICommandPoolResetFlags flags)
+    {
+        return RHI_SUCCESS;
+    }
+
+    bool NullRHI::beginCommandBufferPFN(RHICommandBuffer* commandBuffer, const RHICommandBufferBeginInfo* pBeginInfo)
+    {
+        return beginCommandBuffer(commandBuffer, pBeginInfo);
+    }
+
+    bool NullRHI::endCommandBufferPFN(RHICommandBuffer* commandBuffer)
+    {
+        return endCommandBuffer(commandBuffer);
+    }
+
+    void NullRHI::cmdBeginRenderPassPFN(RHICommandBuffer* commandBuffer, const RHIRenderPassBeginInfo* pRenderPassBegin, RHISubpassContents contents)
+    {
+        recordCommand(commandBuffer, NullRHICommandType::BeginRenderPass, pRenderPassBegin->renderPass);
+        m_current_frame_stats.m_render_pass_count++;
+    }
+
+    void NullRHI::cmdNextSubpassPFN(RHICommandBuffer* commandBuffer, RHISubpassContents contents)
+    {
+        recordCommand(commandBuffer, NullRHICommandType::NextSubpass);
+    }
+
+    void NullRHI::cmdEndRenderPassPFN(RHICommandBuffer* commandBuffer)
+    {
+        recordCommand(commandBuffer, NullRHICommandType::EndRenderPass);
+    }
+
+    void NullRHI::cmdBindPipelinePFN(RHICommandBuffer* commandBuffer, RHIPipelineBindPoint pipelineBindPoint, RHIPipeline* pipeline)
+    {
+        recordCommand(commandBuffer, NullRHICommandType::BindPipeline, pipeline, pipelineBindPoint);
+        m_current_frame_stats.m_state_change_count++;
+        m_current_frame_stats.m_pipeline_bind_count++;
+    }
+
+    void NullRHI::cmdSetViewportPFN(RHICommandBuffer* commandBuffer, uint32_t firstViewport, uint32_t viewportCount, const RHIViewport* pViewports)
+    {
+        recordCommand(commandBuffer, NullRHICommandType::SetViewport, pViewports, firstViewport, viewportCount);
+        m_current_frame_stats.m_state_change_count++;
+    }
+
+    void NullRHI::cmdSetScissorPFN(RHICommandBuffer* commandBuffer, uint32_t firstScissor, uint32_t scissorCount, const RHIRect2D* pScissors)
+    {
+        recordCommand(commandBuffer, NullRHICommandType::SetScissor, pScissors, firstScissor, scissorCount);
+        m_current_frame_stats.m_state_change_count++;
+    }
+
+    void NullRHI::cmdBindVertexBuffersPFN(RHICommandBuffer* commandBuffer, uint32_t firstBinding, uint32_t bindingCount, RHIBuffer* const* pBuffers, const RHIDeviceSize* pOffsets)
+    {
+        recordCommand(commandBuffer,
+                      NullRHICommandType::BindVertexBuffers,
+                      bindingCount > 0 ? pBuffers[0] : nullptr,
+                      firstBinding,
+                      bindingCount);
+        m_current_frame_stats.m_state_change_count++;
+    }
+
+    void NullRHI::cmdBindIndexBufferPFN(RHICommandBuffer* commandBuffer, RHIBuffer* buffer, RHIDeviceSize offset, RHIIndexType indexType)
+    {
+        recordCommand(commandBuffer, NullRHICommandType::BindIndexBuffer, buffer, static_cast<uint32_t>(offset), indexType);
+        m_current_frame_stats.m_state_change_count++;
+    }
+
+    void NullRHI::cmdBindDescriptorSetsPFN(RHICommandBuffer* commandBuffer, RHIPipelineBindPoint pipelineBindPoint, RHIPipelineLayout* layout, uint32_t firstSet, uint32_t descriptorSetCount, const RHIDescriptorSet* const* pDescriptorSets, uint32_t dynamicOffsetCount, const uint32_t* pDynamicOffsets)
+    {
+        recordCommand(commandBuffer,
+                      NullRHICommandType::BindDescriptorSets,
+                      descriptorSetCount > 0 ? pDescriptorSets[0] : nullptr,
+                      firstSet,
+                      descriptorSetCount,
+                      dynamicOffsetCount);
+        m_current_frame_stats.m_state_change_count++;
+        m_current_frame_stats.m_descriptor_set_bind_count += descriptorSetCount;
+    }
+
+    void NullRHI::cmdDrawIndexedPFN(RHICommandBuffer* commandBuffer, uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, int32_t vertexOffset, uint32_t firstInstance)
+    {
+        recordCommand(commandBuffer, NullRHICommandType::DrawIndexed, nullptr, indexCount, instanceCount, firstIndex);
+        m_current_frame_stats.m_draw_count++;
+        m_current_frame_stats.m_instance_count += instanceCount;
+    }
+
+    void NullRHI::cmdClearAttachmentsPFN(RHICommandBuffer* commandBuffer, uint32_t attachmentCount, const RHIClearAttachment* pAttachments, uint32_t rectCount, const RHIClearRect* pRects)
+    {
+        recordCommand(commandBuffer, NullRHICommandType::ClearAttachments, nullptr, attachmentCount, rectCount);
+    }
+
+    bool NullRHI::beginCommandBuffer(RHICommandBuffer* commandBuffer, const RHICommandBufferBeginInfo* pBeginInfo)
+    {
+        static_cast<NullCommandBuffer*>(commandBuffer)->m_commands.clear();
+        return RHI_SUCCESS;
+    }
+
+    void NullRHI::cmdCopyImageToBuffer(RHICommandBuffer* commandBuffer, RHIImage* srcImage, RHIImageLayout srcImageLayout, RHIBuffer* dstBuffer, uint32_t regionCount, const RHIBufferImageCopy* pRegions)
+    {
+        recordCommand(commandBuffer, NullRHICommandType::CopyImageToBuffer, dstBuffer, regionCount);
+    }
+
+    void NullRHI::cmdCopyImageToImage(RHICommandBuffer* commandBuffer, RHIImage* srcImage, RHIImageAspectFlagBits srcFlag, RHIImage* dstImage, RHIImageAspectFlagBits dstFlag, uint32_t width, uint32_t height)
+    {
+        recordCommand(commandBuffer, NullRHICommandType::CopyImageToImage, dstImage, width, height);
+    }
+
+    void NullRHI::cmdCopyBuffer(RHICommandBuffer* commandBuffer, RHIBuffer* srcBuffer, RHIBuffer* dstBuffer, uint32_t regionCount, RHIBufferCopy* pRegions)
+    {
+        recordCommand(commandBuffer, NullRHICommandType::CopyBuffer, dstBuffer, regionCount);
+
+        // copies run at record time, nothing waits for the submit
+        NullBuffer* src_buffer = static_cast<NullBuffer*>(srcBuffer);
+        NullBuffer* dst_buffer = static_cast<NullBuffer*>(dstBuffer);
+        for (uint32_t i = 0; i < regionCount; ++i)
+        {
+            const RHIBufferCopy& region = pRegions[i];
+            ASSERT(region.srcOffset + region.size <= src_buffer->m_size &&
+                   region.dstOffset + region.size <= dst_buffer->m_size);
+
+            memcpy(dst_buffer->m_data + region.dstOffset,
+                   src_buffer->m_data + region.srcOffset,
+                   static_cast<size_t>(region.size));
+            m_current_frame_stats.m_uploaded_bytes += region.size;
+        }
+    }
+
+    void NullRHI::cmdDraw(RHICommandBuffer* commandBuffer, uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance)
+    {
+        recordCommand(commandBuffer, NullRHICommandType::Draw, nullptr, vertexCount, instanceCount, firstVertex);
+        m_current_frame_stats.m_draw_count++;
+        m_current_frame_stats.m_instance_count += instanceCount;
+    }
+
+    void NullRHI::cmdDispatch(RHICommandBuffer* commandBuffer, uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ)
+    {
+        recordCommand(commandBuffer, NullRHICommandType::Dispatch, nullptr, groupCountX, groupCountY, groupCountZ);
+        m_current_frame_stats.m_dispatch_count++;
+    }
+
+    void NullRHI::cmdDispatchIndirect(RHICommandBuffer* commandBuffer, RHIBuffer* buffer, RHIDeviceSize offset)
+    {
+        recordCommand(commandBuffer, NullRHICommandType::DispatchIndirect, buffer, static_cast<uint32_t>(offset));
+        m_current_frame_stats.m_dispatch_count++;
+    }
+
+    void NullRHI::cmdPipelineBarrier(RHICommandBuffer* commandBuffer, RHIPipelineStageFlags srcStageMask, RHIPipelineStageFlags dstStageMask, RHIDependencyFlags dependencyFlags, uint32_t memoryBarrierCount, const RHIMemoryBarrier* pMemoryBarriers, uint32_t bufferMemoryBarrierCount, const RHIBufferMemoryBarrier* pBufferMemoryBarriers, uint32_t imageMemoryBarrierCount, const RHIImageMemoryBarrier* pImageMemoryBarriers)
+    {
+        recordCommand(commandBuffer,
+                      NullRHICommandType::PipelineBarrier,
+                      nullptr,
+                      memoryBarrierCount,
+                      bufferMemoryBarrierCount,
+                      imageMemoryBarrierCount);
+    }
+
+    bool NullRHI::endCommandBuffer(RHICommandBuffer* commandBuffer)
+    {
+        return RHI_SUCCESS;
+    }
+
+    void NullRHI::updateDescriptorSets(uint32_t descriptorWriteCount, const RHIWriteDescriptorSet* pDescriptorWrites, uint32_t descriptorCopyCount, const RHICopyDescriptorSet* pDescriptorCopies)
+    {
+        m_current_frame_stats.m_descriptor_update_count += descriptorWriteCount + descriptorCopyCount;
+    }
+
+    bool NullRHI::queueSubmit(RHIQueue* queue, uint32_t submitCount, const RHISubmitInfo* pSubmits, RHIFence* fence)
+    {
+        m_current_frame_stats.m_submit_count += submitCount;
+        return RHI_SUCCESS;
+    }
+
+    bool NullRHI::queueWaitIdle(RHIQueue* queue)
+    {
+        return RHI_SUCCESS;
+    }
+
+    void NullRHI::resetCommandPool()
+    {
+        static_cast<NullCommandBuffer*>(m_command_buffers[m_current_frame_index])->m_commands.clear();
+    }
+
+    void NullRHI::waitForFences() {}
+
+    void NullRHI::getPhysicalDeviceProperties(RHIPhysicalDeviceProperties* pProperties)
+    {
+        // limits of a typical desktop gpu, the render resource sizes its ring buffers from them
+        *pProperties            = {};
+        pProperties->apiVersion = VK_API_VERSION_1_0;
+        pProperties->deviceType = RHI_PHYSICAL_DEVICE_TYPE_CPU;
+        strncpy(pProperties->deviceName, "Piccolo Null RHI", RHI_MAX_PHYSICAL_DEVICE_NAME_SIZE - 1);
+
+        pProperties->limits.minUniformBufferOffsetAlignment = 256;
+        pProperties->limits.minStorageBufferOffsetAlignment = 256;
+        pProperties->limits.maxStorageBufferRange           = 1u << 27;
+        pProperties->limits.nonCoherentAtomSize             = 256;
+        pProperties->limits.maxSamplerAnisotropy            = 16.0f;
+    }
+
+    RHICommandBuffer* NullRHI::getCurrentCommandBuffer() const
+    {
+        return m_command_buffers[m_current_frame_index];
+    }
+
+    RHICommandBuffer* const* NullRHI::getCommandBufferList() const
+    {
+        return m_command_buffers;
+    }
+
+    RHICommandPool* NullRHI::getCommandPoor() const
+    {
+        return m_command_pool;
+    }
+
+    RHIDescriptorPool* NullRHI::getDescriptorPoor() const
+    {
+        return m_descriptor_pool;
+    }
+
+    RHIFence* const* NullRHI::getFenceList() const
+    {
+        return m_is_frame_in_flight_fences;
+    }
+
+    QueueFamilyIndices NullRHI::getQueueFamilyIndices() const
+    {
+        QueueFamilyIndices indices;
+        indices.graphics_family  = 0;
+        indices.present_family   = 0;
+        indices.m_compute_family = 0;
+        return indices;
+    }
+
+    RHIQueue* NullRHI::getGraphicsQueue() const
+    {
+        return m_graphics_queue;
+    }
+
+    RHIQueue* NullRHI::getComputeQueue() const
+    {
+        return m_compute_queue;
+    }
+
+    RHISwapChainDesc NullRHI::getSwapchainInfo()
+    {
+        RHISwapChainDesc desc;
+        desc.image_format = m_swapchain_image_format;
+        desc.extent       = m_swapchain_extent;
+        desc.viewport     = &m_viewport;
+        desc.scissor      = &m_scissor;
+        desc.imageViews   = m_swapchain_imageviews;
+        return desc;
+    }
+
+    RHIDepthImageDesc NullRHI::getDepthImageInfo() const
+    {
+        RHIDepthImageDesc desc;
+        desc.depth_image_format = m_depth_image_format;
+        desc.depth_image_view   = m_depth_image_view;
+        desc.depth_image        = m_depth_image;
+        return desc;
+    }
+
+    uint8_t NullRHI::getMaxFramesInFlight() const
+    {
+        return k_max_frames_in_flight;
+    }
+
+    uint8_t NullRHI::getCurrentFrameIndex() const
+    {
+        return m_current_frame_index;
+    }
+
+    void NullRHI::setCurrentFrameIndex(uint8_t index)
+    {
+        m_current_frame_index = index;
+    }
+
+    uint32_t NullRHI::getCurrentSwapchainImageIndex() const
+    {
+        return m_current_swapchain_image_index;
+    }
+
+    VmaAllocator NullRHI::getAssetsAllocator() const
+    {
+        return VK_NULL_HANDLE;
+    }
+
+    RHICommandBuffer* NullRHI::beginSingleTimeCommands()
+    {
+        return new NullCommandBuffer();
+    }
+
+    void NullRHI::endSingleTimeCommands(RHICommandBuffer* command_buffer)
+    {
+        NullCommandBuffer* null_command_buffer = static_cast<NullCommandBuffer*>(command_buffer);
+        m_current_frame_stats.m_command_count += null_command_buffer->m_commands.size();
+        m_current_frame_stats.m_submit_count++;
+        delete null_command_buffer;
+    }
+
+    bool NullRHI::prepareBeforePass(std::function<void()> passUpdateAfterRecreateSwapchain)
+    {
+        m_current_swapchain_image_index = (m_current_swapchain_image_index + 1) % k_swapchain_image_count;
+        return false;
+    }
+
+    void NullRHI::submitRendering(std::function<void()> passUpdateAfterRecreateSwapchain)
+    {
+        NullCommandBuffer* command_buffer = static_cast<NullCommandBuffer*>(m_command_buffers[m_current_frame_index]);
+        m_current_frame_stats.m_command_count += command_buffer->m_commands.size();
+        m_current_frame_stats.m_submit_count++;
+        m_current_frame_stats.m_frame_count = 1;
+
+        m_frame_stats = m_current_frame_stats;
+        m_total_stats.add(m_current_frame_stats);
+        m_current_frame_stats = NullRHIStats {};
+
+        m_current_frame_index = (m_current_frame_index + 1) % k_max_frames_in_flight;
+    }
+
+    void NullRHI::pushEvent(RHICommandBuffer* commond_buffer, const char* name, const float* color)
+    {
+        recordCommand(commond_buffer, NullRHICommandType::PushEvent, name);
+    }
+
+    void NullRHI::popEvent(RHICommandBuffer* commond_buffer)
+    {
+        recordCommand(commond_buffer, NullRHICommandType::PopEvent);
+    }
+
+    void NullRHI::clear()
+    {
+        const NullRHIStats& total  = m_total_stats;
+        const double        frames = static_cast<double>(std::max<uint64_t>(total.m_frame_count, 1));
+        LOG_INFO("null rhi: {} frames, per frame {:.1f} draws, {:.1f} instances, {:.1f} dispatches, {:.1f} render "
+                 "passes, {:.1f} state changes, {:.1f} descriptor updates, {:.1f} commands, {} bytes uploaded in total",
+                 total.m_frame_count,
+                 total.m_draw_count / frames,
+                 total.m_instance_count / frames,
+                 total.m_dispatch_count / frames,
+                 total.m_render_pass_count / frames,
+                 total.m_state_change_count / frames,
+                 total.m_descriptor_update_count / frames,
+                 total.m_command_count / frames,
+                 total.m_uploaded_bytes);
+
+        for (uint32_t i = 0; i < k_max_frames_in_flight; ++i)
+        {
+            delete static_cast<NullCommandBuffer*>(m_command_buffers[i]);
+            m_command_buffers[i] = nullptr;
+            RHI_DELETE_PTR(m_is_frame_in_flight_fences[i]);
+            RHI_DELETE_PTR(m_image_available_for_texturescopy_semaphores[i]);
+        }
+
+        clearSwapchain();
+        destroyDefaultSampler(Default_Sampler_Linear);
+        destroyDefaultSampler(Default_Sampler_Nearest);
+        destroyMipmappedSampler();
+
+        delete static_cast<NullImage*>(m_depth_image);
+        m_depth_image = nullptr;
+        RHI_DELETE_PTR(m_depth_image_view);
+        RHI_DELETE_PTR(m_graphics_queue);
+        RHI_DELETE_PTR(m_compute_queue);
+        RHI_DELETE_PTR(m_descriptor_pool);
+        RHI_DELETE_PTR(m_command_pool);
+    }
+
+    void NullRHI::clearSwapchain()
+    {
+        for (RHIImageView* image_view : m_swapchain_imageviews)
+        {
+            delete image_view;
+        }
+        m_swapchain_imageviews.clear();
+    }
+
+    void NullRHI::destroyDefaultSampler(RHIDefaultSamplerType type)
+    {
+        switch (type)
+        {
+        case Piccolo::Default_Sampler_Linear:
+            RHI_DELETE_PTR(m_linear_sampler);
+            break;
+        case Piccolo::Default_Sampler_Nearest:
+            RHI_DELETE_PTR(m_nearest_sampler);
+            break;
+        default:
+            break;
+        }
+    }
+
+    void NullRHI::destroyMipmappedSampler()
+    {
+        for (auto& sampler : m_mipmap_sampler_map)
+        {
+            delete sampler.second;
+        }
+        m_mipmap_sampler_map.clear();
+    }
+
+    // the plain handles carry no state, like the vulkan backend the destroy calls leave the handle objects alone
+    void NullRHI::destroyShaderModule(RHIShader* shader) {}
+
+    void NullRHI::destroySemaphore(RHISemaphore* semaphore) {}
+
+    void NullRHI::destroySampler(RHISampler* sampler) {}
+
+    void NullRHI::destroyInstance(RHIInstance* instance) {}
+
+    void NullRHI::destroyImageView(RHIImageView* imageView) {}
+
+    void NullRHI::destroyImage(RHIImage* image) {}
+
+    void NullRHI::destroyFramebuffer(RHIFramebuffer* framebuffer) {}
+
+    void NullRHI::destroyFence(RHIFence* fence) {}
+
+    void NullRHI::destroyDevice() {}
+
+    void NullRHI::destroyCommandPool(RHICommandPool* commandPool) {}
+
+    void NullRHI::destroyBuffer(RHIBuffer* &buffer)
+    {
+        delete static_cast<NullBuffer*>(buffer);
+        buffer = nullptr;
+    }
+
+    void NullRHI::destroyBufferVMA(VmaAllocator allocator, RHIBuffer* &buffer, VmaAllocation allocation)
+    {
+        destroyBuffer(buffer);
+    }
+
+    void NullRHI::destroyImageVMA(VmaAllocator allocator, RHIImage* &image, VmaAllocation allocation)
+    {
+        delete static_cast<NullImage*>(image);
+        image = nullptr;
+    }
+
+    void NullRHI::freeDescriptorSet(RHIDescriptorPool* pool, RHIDescriptorSet* &descriptor_set)
+    {
+        delete descriptor_set;
+        descriptor_set = nullptr;
+    }
+
+    void NullRHI::freeCommandBuffers(RHICommandPool* commandPool, uint32_t commandBufferCount, RHICommandBuffer* pCommandBuffers)
+    {
+        delete static_cast<NullCommandBuffer*>(pCommandBuffers);
+    }
+
+    void NullRHI::freeMemory(RHIDeviceMemory* &memory)
+    {
+        delete static_cast<NullDeviceMemory*>(memory);
+        memory = nullptr;
+    }
+
+    bool NullRHI::mapMemory(RHIDeviceMemory* memory, RHIDeviceSize offset, RHIDeviceSize size, RHIMemoryMapFlags flags, void** ppData)
+    {
+        NullDeviceMemory* null_memory = static_cast<NullDeviceMemory*>(memory);
+        if (!null_memory->m_data || offset >= null_memory->m_size)
+        {
+            LOG_ERROR("mapMemory failed, the memory has no host storage!");
+            return false;
+        }
+
+        *ppData = null_memory->m_data.get() + offset;
+        return RHI_SUCCESS;
+    }
+
+    void NullRHI::unmapMemory(RHIDeviceMemory* memory) {}
+
+    void NullRHI::invalidateMappedMemoryRanges(void* pNext, RHIDeviceMemory* memory, RHIDeviceSize offset, RHIDeviceSize size) {}
+
+    void NullRHI::flushMappedMemoryRanges(void* pNext, RHIDeviceMemory* memory, RHIDeviceSize offset, RHIDeviceSize size) {}
+
+    RHISemaphore*& NullRHI::getTextureCopySemaphore(uint32_t index)
+    {
+        return m_image_available_for_texturescopy_semaphores[index];
+    }
+
+    void NullRHI::recordCommand(RHICommandBuffer*  command_buffer,
+                                NullRHICommandType type,
+                                const void*        object,
+                                uint32_t           argument0,
+                                uint32_t           argument1,
+                                uint32_t           argument2)
+    {
+        NullRHICommand command;
+        command.m_type         = type;
+        command.m_object       = object;
+        command.m_arguments[0] = argument0;
+        command.m_arguments[1] = argument1;
+        command.m_arguments[2] = argument2;
+        static_cast<NullCommandBuffer*>(command_buffer)->m_commands.push_back(command);
+    }
+} // namespace Piccolo
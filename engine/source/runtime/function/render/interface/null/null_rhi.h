@@ -0,0 +1,245 @@
+#pragma once
+
+#include "runtime/function/render/interface/null/null_rhi_resource.h"
+#include "runtime/function/render/interface/rhi.h"
+
+#include <map>
+#include <vector>
+
+namespace Piccolo
+{
+    struct NullRHIStats
+    {
+        uint64_t m_frame_count {0};
+        uint64_t m_command_count {0};
+        uint64_t m_render_pass_count {0};
+        uint64_t m_draw_count {0};
+        uint64_t m_instance_count {0};
+        uint64_t m_dispatch_count {0};
+        // pipeline, descriptor set, vertex and index buffer binds plus viewport and scissor changes
+        uint64_t m_state_change_count {0};
+        uint64_t m_pipeline_bind_count {0};
+        uint64_t m_descriptor_set_bind_count {0};
+        // descriptors written or copied by updateDescriptorSets
+        uint64_t m_descriptor_update_count {0};
+        // buffer copies, initialized buffers and image uploads
+        uint64_t m_uploaded_bytes {0};
+        uint64_t m_submit_count {0};
+
+        void add(const NullRHIStats& other);
+    };
+
+    /// RHI backend without a device for headless runs and cpu profiling.
+    /// Command buffers record the commands into memory, buffers and device memory live in host memory and every
+    /// call is counted, so the whole cpu side of the renderer (swap data processing, culling, pass data and draw
+    /// recording) runs without a gpu or a window. A frame spans from prepareBeforePass to submitRendering.
+    class NullRHI final : public RHI
+    {
+    public:
+        // initialize
+        virtual void initialize(RHIInitInfo init_info) override final;
+        virtual void prepareContext() override final;
+
+        // allocate and create
+        bool allocateCommandBuffers(const RHICommandBufferAllocateInfo* pAllocateInfo, RHICommandBuffer* &pCommandBuffers) override;
+        bool allocateDescriptorSets(const RHIDescriptorSetAllocateInfo* pAllocateInfo, RHIDescriptorSet* &pDescriptorSets) override;
+        void createSwapchain() override;
+        void recreateSwapchain() override;
+        void requestShutdown() override {}
+        void createSwapchainImageViews() override;
+        void createFramebufferImageAndView() override;
+        RHISampler* getOrCreateDefaultSampler(RHIDefaultSamplerType type) override;
+        RHISampler* getOrCreateMipmapSampler(uint32_t width, uint32_t height) override;
+        RHIShader* createShaderModule(const std::vector<unsigned char>& shader_code) override;
+        void createBuffer(RHIDeviceSize size, RHIBufferUsageFlags usage, RHIMemoryPropertyFlags properties, RHIBuffer* &buffer, RHIDeviceMemory* &buffer_memory) override;
+        void createBufferAndInitialize(RHIBufferUsageFlags usage, RHIMemoryPropertyFlags properties, RHIBuffer*& buffer, RHIDeviceMemory*& buffer_memory, RHIDeviceSize size, void* data = nullptr, int datasize = 0) override;
+        bool createBufferVMA(VmaAllocator allocator,
+            const RHIBufferCreateInfo* pBufferCreateInfo,
+            const VmaAllocationCreateInfo* pAllocationCreateInfo,
+            RHIBuffer* &pBuffer,
+            VmaAllocation* pAllocation,
+            VmaAllocationInfo* pAllocationInfo) override;
+        bool createBufferWithAlignmentVMA(
+            VmaAllocator allocator,
+            const RHIBufferCreateInfo* pBufferCreateInfo,
+            const VmaAllocationCreateInfo* pAllocationCreateInfo,
+            RHIDeviceSize minAlignment,
+            RHIBuffer* &pBuffer,
+            VmaAllocation* pAllocation,
+            VmaAllocationInfo* pAllocationInfo) override;
+        void copyBuffer(RHIBuffer* srcBuffer, RHIBuffer* dstBuffer, RHIDeviceSize srcOffset, RHIDeviceSize dstOffset, RHIDeviceSize size) override;
+        void createImage(uint32_t image_width, uint32_t image_height, RHIFormat format, RHIImageTiling image_tiling, RHIImageUsageFlags image_usage_flags, RHIMemoryPropertyFlags memory_property_flags,
+            RHIImage* &image, RHIDeviceMemory* &memory, RHIImageCreateFlags image_create_flags, uint32_t array_layers, uint32_t miplevels) override;
+        void createImageView(RHIImage* image, RHIFormat format, RHIImageAspectFlags image_aspect_flags, RHIImageViewType view_type, uint32_t layout_count, uint32_t miplevels,
+            RHIImageView* &image_view) override;
+        void createGlobalImage(RHIImage* &image, RHIImageView* &image_view, VmaAllocation& image_allocation, uint32_t texture_image_width, uint32_t texture_image_height, void* texture_image_pixels, RHIFormat texture_image_format, uint32_t miplevels = 0) override;
+        void createCubeMap(RHIImage* &image, RHIImageView* &image_view, VmaAllocation& image_allocation, uint32_t texture_image_width, uint32_t texture_image_height, std::array<void*, 6> texture_image_pixels, RHIFormat texture_image_format, uint32_t miplevels) override;
+        bool createCommandPool(const RHICommandPoolCreateInfo* pCreateInfo, RHICommandPool* &pCommandPool) override;
+        bool createDescriptorPool(const RHIDescriptorPoolCreateInfo* pCreateInfo, RHIDescriptorPool* &pDescriptorPool) override;
+        bool createDescriptorSetLayout(const RHIDescriptorSetLayoutCreateInfo* pCreateInfo, RHIDescriptorSetLayout* &pSetLayout) override;
+        bool createFence(const RHIFenceCreateInfo* pCreateInfo, RHIFence* &pFence) override;
+        bool createFramebuffer(const RHIFramebufferCreateInfo* pCreateInfo, RHIFramebuffer* &pFramebuffer) override;
+        bool createGraphicsPipelines(RHIPipelineCache* pipelineCache, uint32_t createInfoCount, const RHIGraphicsPipelineCreateInfo* pCreateInfos, RHIPipeline* &pPipelines) override;
+        bool createComputePipelines(RHIPipelineCache* pipelineCache, uint32_t createInfoCount, const RHIComputePipelineCreateInfo* pCreateInfos, RHIPipeline*& pPipelines) override;
+        bool createPipelineLayout(const RHIPipelineLayoutCreateInfo* pCreateInfo, RHIPipelineLayout* &pPipelineLayout) override;
+        bool createRenderPass(const RHIRenderPassCreateInfo* pCreateInfo, RHIRenderPass* &pRenderPass) override;
+        bool createSampler(const RHISamplerCreateInfo* pCreateInfo, RHISampler* &pSampler) override;
+        bool createSemaphore(const RHISemaphoreCreateInfo* pCreateInfo, RHISemaphore* &pSemaphore) override;
+
+        // command and command write
+        bool waitForFencesPFN(uint32_t fenceCount, RHIFence* const* pFence, RHIBool32 waitAll, uint64_t timeout) override;
+        bool resetFencesPFN(uint32_t fenceCount, RHIFence* const* pFences) override;
+        bool resetCommandPoolPFN(RHICommandPool* commandPool, RHICommandPoolResetFlags flags) override;
+        bool beginCommandBufferPFN(RHICommandBuffer* commandBuffer, const RHICommandBufferBeginInfo* pBeginInfo) override;
+        bool endCommandBufferPFN(RHICommandBuffer* commandBuffer) override;
+        void cmdBeginRenderPassPFN(RHICommandBuffer* commandBuffer, const RHIRenderPassBeginInfo* pRenderPassBegin, RHISubpassContents contents) override;
+        void cmdNextSubpassPFN(RHICommandBuffer* commandBuffer, RHISubpassContents contents) override;
+        void cmdEndRenderPassPFN(RHICommandBuffer* commandBuffer) override;
+        void cmdBindPipelinePFN(RHICommandBuffer* commandBuffer, RHIPipelineBindPoint pipelineBindPoint, RHIPipeline* pipeline) override;
+        void cmdSetViewportPFN(RHICommandBuffer* commandBuffer, uint32_t firstViewport, uint32_t viewportCount, const RHIViewport* pViewports) override;
+        void cmdSetScissorPFN(RHICommandBuffer* commandBuffer, uint32_t firstScissor, uint32_t scissorCount, const RHIRect2D* pScissors) override;
+        void cmdBindVertexBuffersPFN(
+            RHICommandBuffer* commandBuffer,
+            uint32_t firstBinding,
+            uint32_t bindingCount,
+            RHIBuffer* const* pBuffers,
+            const RHIDeviceSize* pOffsets) override;
+        void cmdBindIndexBufferPFN(RHICommandBuffer* commandBuffer, RHIBuffer* buffer, RHIDeviceSize offset, RHIIndexType indexType) override;
+        void cmdBindDescriptorSetsPFN(
+            RHICommandBuffer* commandBuffer,
+            RHIPipelineBindPoint pipelineBindPoint,
+            RHIPipelineLayout* layout,
+            uint32_t firstSet,
+            uint32_t descriptorSetCount,
+            const RHIDescriptorSet* const* pDescriptorSets,
+            uint32_t dynamicOffsetCount,
+            const uint32_t* pDynamicOffsets) override;
+        void cmdDrawIndexedPFN(RHICommandBuffer* commandBuffer, uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, int32_t vertexOffset, uint32_t firstInstance) override;
+        void cmdClearAttachmentsPFN(RHICommandBuffer* commandBuffer, uint32_t attachmentCount, const RHIClearAttachment* pAttachments, uint32_t rectCount, const RHIClearRect* pRects) override;
+
+        bool beginCommandBuffer(RHICommandBuffer* commandBuffer, const RHICommandBufferBeginInfo* pBeginInfo) override;
+        void cmdCopyImageToBuffer(RHICommandBuffer* commandBuffer, RHIImage* srcImage, RHIImageLayout srcImageLayout, RHIBuffer* dstBuffer, uint32_t regionCount, const RHIBufferImageCopy* pRegions) override;
+        void cmdCopyImageToImage(RHICommandBuffer* commandBuffer, RHIImage* srcImage, RHIImageAspectFlagBits srcFlag, RHIImage* dstImage, RHIImageAspectFlagBits dstFlag, uint32_t width, uint32_t height) override;
+        void cmdCopyBuffer(RHICommandBuffer* commandBuffer, RHIBuffer* srcBuffer, RHIBuffer* dstBuffer, uint32_t regionCount, RHIBufferCopy* pRegions) override;
+        void cmdDraw(RHICommandBuffer* commandBuffer, uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance) override;
+        void cmdDispatch(RHICommandBuffer* commandBuffer, uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ) override;
+        void cmdDispatchIndirect(RHICommandBuffer* commandBuffer, RHIBuffer* buffer, RHIDeviceSize offset) override;
+        void cmdPipelineBarrier(RHICommandBuffer* commandBuffer, RHIPipelineStageFlags srcStageMask, RHIPipelineStageFlags dstStageMask, RHIDependencyFlags dependencyFlags, uint32_t memoryBarrierCount, const RHIMemoryBarrier* pMemoryBarriers, uint32_t bufferMemoryBarrierCount, const RHIBufferMemoryBarrier* pBufferMemoryBarriers, uint32_t imageMemoryBarrierCount, const RHIImageMemoryBarrier* pImageMemoryBarriers) override;
+        bool endCommandBuffer(RHICommandBuffer* commandBuffer) override;
+        void updateDescriptorSets(uint32_t descriptorWriteCount, const RHIWriteDescriptorSet* pDescriptorWrites, uint32_t descriptorCopyCount, const RHICopyDescriptorSet* pDescriptorCopies) override;
+        bool queueSubmit(RHIQueue* queue, uint32_t submitCount, const RHISubmitInfo* pSubmits, RHIFence* fence) override;
+        bool queueWaitIdle(RHIQueue* queue) override;
+        void resetCommandPool() override;
+        void waitForFences() override;
+
+        // query
+        void getPhysicalDeviceProperties(RHIPhysicalDeviceProperties* pProperties) override;
+        RHICommandBuffer* getCurrentCommandBuffer() const override;
+        RHICommandBuffer* const* getCommandBufferList() const override;
+        RHICommandPool* getCommandPoor() const override;
+        RHIDescriptorPool* getDescriptorPoor()const override;
+        RHIFence* const* getFenceList() const override;
+        QueueFamilyIndices getQueueFamilyIndices() const override;
+        RHIQueue* getGraphicsQueue() const override;
+        RHIQueue* getComputeQueue() const override;
+        RHISwapChainDesc getSwapchainInfo() override;
+        RHIDepthImageDesc getDepthImageInfo() const override;
+        uint8_t getMaxFramesInFlight() const override;
+        uint8_t getCurrentFrameIndex() const override;
+        void setCurrentFrameIndex(uint8_t index) override;
+        uint32_t getCurrentSwapchainImageIndex() const override;
+        VmaAllocator getAssetsAllocator() const override;
+
+        // command write
+        RHICommandBuffer* beginSingleTimeCommands() override;
+        void            endSingleTimeCommands(RHICommandBuffer* command_buffer) override;
+        bool prepareBeforePass(std::function<void()> passUpdateAfterRecreateSwapchain) override;
+        void submitRendering(std::function<void()> passUpdateAfterRecreateSwapchain) override;
+        void pushEvent(RHICommandBuffer* commond_buffer, const char* name, const float* color) override;
+        void popEvent(RHICommandBuffer* commond_buffer) override;
+
+        // destory
+        virtual ~NullRHI() override final;
+        void clear() override;
+        void clearSwapchain() override;
+        void destroyDefaultSampler(RHIDefaultSamplerType type) override;
+        void destroyMipmappedSampler() override;
+        void destroyShaderModule(RHIShader* shader) override;
+        void destroySemaphore(RHISemaphore* semaphore) override;
+        void destroySampler(RHISampler* sampler) override;
+        void destroyInstance(RHIInstance* instance) override;
+        void destroyImageView(RHIImageView* imageView) override;
+        void destroyImage(RHIImage* image) override;
+        void destroyFramebuffer(RHIFramebuffer* framebuffer) override;
+        void destroyFence(RHIFence* fence) override;
+        void destroyDevice() override;
+        void destroyCommandPool(RHICommandPool* commandPool) override;
+        void destroyBuffer(RHIBuffer* &buffer) override;
+        void destroyBufferVMA(VmaAllocator allocator, RHIBuffer* &buffer, VmaAllocation allocation) override;
+        void destroyImageVMA(VmaAllocator allocator, RHIImage* &image, VmaAllocation allocation) override;
+        void freeDescriptorSet(RHIDescriptorPool* pool, RHIDescriptorSet* &descriptor_set) override;
+        void freeCommandBuffers(RHICommandPool* commandPool, uint32_t commandBufferCount, RHICommandBuffer* pCommandBuffers) override;
+
+        // memory
+        void freeMemory(RHIDeviceMemory* &memory) override;
+        bool mapMemory(RHIDeviceMemory* memory, RHIDeviceSize offset, RHIDeviceSize size, RHIMemoryMapFlags flags, void** ppData) override;
+        void unmapMemory(RHIDeviceMemory* memory) override;
+        void invalidateMappedMemoryRanges(void* pNext, RHIDeviceMemory* memory, RHIDeviceSize offset, RHIDeviceSize size) override;
+        void flushMappedMemoryRanges(void* pNext, RHIDeviceMemory* memory, RHIDeviceSize offset, RHIDeviceSize size) override;
+
+        //semaphores
+        RHISemaphore* &getTextureCopySemaphore(uint32_t index) override;
+
+        bool isPointLightShadowEnabled() override;
+
+        // counters of the last submitted frame and of the whole run
+        const NullRHIStats& getFrameStats() const { return m_frame_stats; }
+        const NullRHIStats& getTotalStats() const { return m_total_stats; }
+
+    public:
+        static uint8_t const k_max_frames_in_flight {3};
+        static uint8_t const k_swapchain_image_count {3};
+
+    private:
+        void createCommandPool() override;
+
+        void recordCommand(RHICommandBuffer*  command_buffer,
+                           NullRHICommandType type,
+                           const void*        object    = nullptr,
+                           uint32_t           argument0 = 0,
+                           uint32_t           argument1 = 0,
+                           uint32_t           argument2 = 0);
+
+        std::shared_ptr<WindowSystem> m_window_system;
+
+        RHIFormat                  m_swapchain_image_format {RHI_FORMAT_B8G8R8A8_SRGB};
+        std::vector<RHIImageView*> m_swapchain_imageviews;
+        RHIExtent2D                m_swapchain_extent {};
+        RHIViewport                m_viewport {};
+        RHIRect2D                  m_scissor {};
+        uint32_t                   m_current_swapchain_image_index {0};
+
+        RHIFormat     m_depth_image_format {RHI_FORMAT_D32_SFLOAT};
+        RHIImage*     m_depth_image {nullptr};
+        RHIImageView* m_depth_image_view {nullptr};
+
+        RHIQueue*          m_graphics_queue {nullptr};
+        RHIQueue*          m_compute_queue {nullptr};
+        RHIDescriptorPool* m_descriptor_pool {nullptr};
+        RHICommandPool*    m_command_pool {nullptr};
+
+        uint8_t           m_current_frame_index {0};
+        RHICommandBuffer* m_command_buffers[k_max_frames_in_flight] {};
+        RHIFence*         m_is_frame_in_flight_fences[k_max_frames_in_flight] {};
+        RHISemaphore*     m_image_available_for_texturescopy_semaphores[k_max_frames_in_flight] {};
+
+        // default sampler cache
+        RHISampler*                     m_linear_sampler {nullptr};
+        RHISampler*                     m_nearest_sampler {nullptr};
+        std::map<uint32_t, RHISampler*> m_mipmap_sampler_map;
+
+        NullRHIStats m_current_frame_stats;
+        NullRHIStats m_frame_stats;
+        NullRHIStats m_total_stats;
+    };
+} // namespace Piccolo
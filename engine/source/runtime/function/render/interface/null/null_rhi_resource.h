@@ -0,0 +1,86 @@
+#pragma once
+
+#include "runtime/function/render/interface/rhi.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Piccolo
+{
+    enum class NullRHICommandType : uint8_t
+    {
+        BeginRenderPass = 0,
+        NextSubpass,
+        EndRenderPass,
+        BindPipeline,
+        SetViewport,
+        SetScissor,
+        BindVertexBuffers,
+        BindIndexBuffer,
+        BindDescriptorSets,
+        DrawIndexed,
+        Draw,
+        Dispatch,
+        DispatchIndirect,
+        ClearAttachments,
+        CopyBuffer,
+        CopyImageToBuffer,
+        CopyImageToImage,
+        PipelineBarrier,
+        PushEvent,
+        PopEvent
+    };
+
+    /// one recorded command, the object is the pipeline, buffer or image it refers to and the arguments are its
+    /// counts (index count, instance count, group counts, ...)
+    struct NullRHICommand
+    {
+        NullRHICommandType m_type;
+        const void*        m_object {nullptr};
+        uint32_t           m_arguments[3] {0, 0, 0};
+    };
+
+    class NullCommandBuffer : public RHICommandBuffer
+    {
+    public:
+        std::vector<NullRHICommand> m_commands;
+    };
+
+    /// host memory behind a device memory object, images get a memory object without storage
+    class NullDeviceMemory : public RHIDeviceMemory
+    {
+    public:
+        explicit NullDeviceMemory(RHIDeviceSize size) : m_size(size)
+        {
+            // not value initialized, the pages of large ring buffers are only committed once they are written
+            if (size > 0)
+            {
+                m_data.reset(new uint8_t[static_cast<size_t>(size)]);
+            }
+        }
+
+        std::unique_ptr<uint8_t[]> m_data;
+        RHIDeviceSize              m_size {0};
+    };
+
+    class NullBuffer : public RHIBuffer
+    {
+    public:
+        RHIDeviceSize m_size {0};
+        // points into the bound memory, or into the owned storage of buffers created through the allocator calls
+        uint8_t*                   m_data {nullptr};
+        std::unique_ptr<uint8_t[]> m_owned_data;
+    };
+
+    /// images only keep their description, nothing on the cpu side reads their texels
+    class NullImage : public RHIImage
+    {
+    public:
+        uint32_t  m_width {0};
+        uint32_t  m_height {0};
+        uint32_t  m_array_layers {1};
+        uint32_t  m_mip_levels {1};
+        RHIFormat m_format {RHI_FORMAT_UNDEFINED};
+    };
+} // namespace Piccolo
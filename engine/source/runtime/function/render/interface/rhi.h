@@ -32,6 +32,8 @@ namespace Piccolo
         virtual bool allocateDescriptorSets(const RHIDescriptorSetAllocateInfo* pAllocateInfo, RHIDescriptorSet* &pDescriptorSets) = 0;
         virtual void createSwapchain() = 0;
         virtual void recreateSwapchain() = 0;
+        // makes the waits of recreateSwapchain on another thread give up, so that the thread can be joined
+        virtual void requestShutdown() = 0;
         virtual void createSwapchainImageViews() = 0;
         virtual void createFramebufferImageAndView() = 0;
         virtual RHISampler* getOrCreateDefaultSampler(RHIDefaultSamplerType type) = 0;
@@ -134,6 +136,8 @@ namespace Piccolo
         virtual uint8_t getMaxFramesInFlight() const = 0;
         virtual uint8_t getCurrentFrameIndex() const = 0;
         virtual void setCurrentFrameIndex(uint8_t index) = 0;
+        virtual uint32_t getCurrentSwapchainImageIndex() const = 0;
+        virtual VmaAllocator getAssetsAllocator() const = 0;
 
         // command write
         virtual RHICommandBuffer* beginSingleTimeCommands() = 0;
@@ -159,6 +163,10 @@ namespace Piccolo
         virtual void destroyDevice() = 0;
         virtual void destroyCommandPool(RHICommandPool* commandPool) = 0;
         virtual void destroyBuffer(RHIBuffer* &buffer) = 0;
+        // release what createBufferVMA, createGlobalImage and allocateDescriptorSets created for an asset
+        virtual void destroyBufferVMA(VmaAllocator allocator, RHIBuffer* &buffer, VmaAllocation allocation) = 0;
+        virtual void destroyImageVMA(VmaAllocator allocator, RHIImage* &image, VmaAllocation allocation) = 0;
+        virtual void freeDescriptorSet(RHIDescriptorPool* pool, RHIDescriptorSet* &descriptor_set) = 0;
         virtual void freeCommandBuffers(RHICommandPool* commandPool, uint32_t commandBufferCount, RHICommandBuffer* pCommandBuffers) = 0;
 
         // memory
@@ -68,11 +68,13 @@
 #error Unknown Compiler
 #endif
 
+#include <chrono>
 #include <cstring>
 #include <iostream>
 #include <set>
 #include <stdexcept>
 #include <string>
+#include <thread>
 
 namespace Piccolo
 {
@@ -83,7 +85,9 @@ namespace Piccolo
 
     void VulkanRHI::initialize(RHIInitInfo init_info)
     {
-        m_window = init_info.window_system->getWindow();
+        m_window           = init_info.window_system->getWindow();
+        m_window_system    = init_info.window_system;
+        m_window_thread_id = std::this_thread::get_id();
 
         std::array<int, 2> window_size = init_info.window_system->getWindowSize();
 
@@ -2647,7 +2651,8 @@ namespace Piccolo
         pool_info.pPoolSizes    = pool_sizes;
         pool_info.maxSets =
             1 + 1 + 1 + m_max_material_count + m_max_vertex_blending_mesh_count + 1 + 1; // +skybox + axis descriptor set
-        pool_info.flags = 0U;
+        // the sets of meshes and materials are freed when their asset slot is reused
+        pool_info.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
 
         if (vkCreateDescriptorPool(m_device, &pool_info, nullptr, &m_vk_descriptor_pool) != VK_SUCCESS)
         {
@@ -3208,6 +3213,25 @@ namespace Piccolo
         RHI_DELETE_PTR(buffer);
     }
 
+    void VulkanRHI::destroyBufferVMA(VmaAllocator allocator, RHIBuffer* &buffer, VmaAllocation allocation)
+    {
+        vmaDestroyBuffer(allocator, ((VulkanBuffer*)buffer)->getResource(), allocation);
+        RHI_DELETE_PTR(buffer);
+    }
+
+    void VulkanRHI::destroyImageVMA(VmaAllocator allocator, RHIImage* &image, VmaAllocation allocation)
+    {
+        vmaDestroyImage(allocator, ((VulkanImage*)image)->getResource(), allocation);
+        RHI_DELETE_PTR(image);
+    }
+
+    void VulkanRHI::freeDescriptorSet(RHIDescriptorPool* pool, RHIDescriptorSet* &descriptor_set)
+    {
+        VkDescriptorSet vk_descriptor_set = ((VulkanDescriptorSet*)descriptor_set)->getResource();
+        vkFreeDescriptorSets(m_device, ((VulkanDescriptorPool*)pool)->getResource(), 1, &vk_descriptor_set);
+        RHI_DELETE_PTR(descriptor_set);
+    }
+
     void VulkanRHI::freeCommandBuffers(RHICommandPool* commandPool, uint32_t commandBufferCount, RHICommandBuffer* pCommandBuffers)
     {
         VkCommandBuffer vk_command_buffer = ((VulkanCommandBuffer*)pCommandBuffers)->getResource();
@@ -3267,13 +3291,24 @@ namespace Piccolo
 
     void VulkanRHI::recreateSwapchain()
     {
-        int width  = 0;
-        int height = 0;
-        glfwGetFramebufferSize(m_window, &width, &height);
-        while (width == 0 || height == 0) // minimized 0,0, pause for now
+        std::array<int, 2> framebuffer_size = m_window_system->getFramebufferSize();
+        while (framebuffer_size[0] == 0 || framebuffer_size[1] == 0) // minimized 0,0, pause for now
         {
-            glfwGetFramebufferSize(m_window, &width, &height);
-            glfwWaitEvents();
+            // a window closed while minimized never gets a size again, keep the old swapchain and let the caller
+            // shut down
+            if (m_is_shutdown_requested.load(std::memory_order_acquire) || m_window_system->shouldClose())
+                return;
+
+            if (std::this_thread::get_id() == m_window_thread_id)
+            {
+                glfwWaitEvents();
+            }
+            else
+            {
+                // on the render thread, the main thread keeps polling the events
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+            framebuffer_size = m_window_system->getFramebufferSize();
         }
 
         VkResult res_wait_for_fences =
@@ -3299,6 +3334,8 @@ namespace Piccolo
         createFramebufferImageAndView();
     }
 
+    void VulkanRHI::requestShutdown() { m_is_shutdown_requested.store(true, std::memory_order_release); }
+
     VkResult VulkanRHI::createDebugUtilsMessengerEXT(VkInstance                                instance,
                                                      const VkDebugUtilsMessengerCreateInfoEXT* pCreateInfo,
                                                      const VkAllocationCallbacks*              pAllocator,
@@ -3507,10 +3544,10 @@ namespace Piccolo
         }
         else
         {
-            int width, height;
-            glfwGetFramebufferSize(m_window, &width, &height);
+            const std::array<int, 2> framebuffer_size = m_window_system->getFramebufferSize();
 
-            VkExtent2D actualExtent = {static_cast<uint32_t>(width), static_cast<uint32_t>(height)};
+            VkExtent2D actualExtent = {static_cast<uint32_t>(framebuffer_size[0]),
+                                       static_cast<uint32_t>(framebuffer_size[1])};
 
             actualExtent.width =
                 std::clamp(actualExtent.width, capabilities.minImageExtent.width, capabilities.maxImageExtent.width);
@@ -3606,5 +3643,13 @@ namespace Piccolo
     {
         m_current_frame_index = index;
     }
+    uint32_t VulkanRHI::getCurrentSwapchainImageIndex() const
+    {
+        return m_current_swapchain_image_index;
+    }
+    VmaAllocator VulkanRHI::getAssetsAllocator() const
+    {
+        return m_assets_allocator;
+    }
 
 } // namespace Piccolo
\ No newline at end of file
@@ -6,8 +6,10 @@
 #include <vk_mem_alloc.h>
 #include <vulkan/vulkan.h>
 
+#include <atomic>
 #include <functional>
 #include <map>
+#include <thread>
 #include <vector>
 
 namespace Piccolo
@@ -26,6 +28,7 @@ namespace Piccolo
         bool allocateDescriptorSets(const RHIDescriptorSetAllocateInfo* pAllocateInfo, RHIDescriptorSet* &pDescriptorSets) override;
         void createSwapchain() override;
         void recreateSwapchain() override;
+        void requestShutdown() override;
         void createSwapchainImageViews() override;
         void createFramebufferImageAndView() override;
         RHISampler* getOrCreateDefaultSampler(RHIDefaultSamplerType type) override;
@@ -128,6 +131,8 @@ namespace Piccolo
         uint8_t getMaxFramesInFlight() const override;
         uint8_t getCurrentFrameIndex() const override;
         void setCurrentFrameIndex(uint8_t index) override;
+        uint32_t getCurrentSwapchainImageIndex() const override;
+        VmaAllocator getAssetsAllocator() const override;
 
         // command write
         RHICommandBuffer* beginSingleTimeCommands() override;
@@ -154,6 +159,9 @@ namespace Piccolo
         void destroyDevice() override;
         void destroyCommandPool(RHICommandPool* commandPool) override;
         void destroyBuffer(RHIBuffer* &buffer) override;
+        void destroyBufferVMA(VmaAllocator allocator, RHIBuffer* &buffer, VmaAllocation allocation) override;
+        void destroyImageVMA(VmaAllocator allocator, RHIImage* &image, VmaAllocation allocation) override;
+        void freeDescriptorSet(RHIDescriptorPool* pool, RHIDescriptorSet* &descriptor_set) override;
         void freeCommandBuffers(RHICommandPool* commandPool, uint32_t commandBufferCount, RHICommandBuffer* pCommandBuffers) override;
 
         // memory
@@ -193,6 +201,11 @@ namespace Piccolo
         QueueFamilyIndices m_queue_indices;
 
         GLFWwindow*        m_window {nullptr};
+        // glfw may only be called on the thread that created the window, the framebuffer size is read through the
+        // window system from other threads
+        std::shared_ptr<WindowSystem> m_window_system;
+        std::thread::id               m_window_thread_id;
+        std::atomic<bool>             m_is_shutdown_requested {false};
         VkInstance         m_instance {nullptr};
         VkSurfaceKHR       m_surface {nullptr};
         VkPhysicalDevice   m_physical_device {nullptr};
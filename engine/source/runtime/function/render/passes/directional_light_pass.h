@@ -1,5 +1,6 @@
 #pragma once
 
+#include "runtime/function/render/render_draw_list.h"
 #include "runtime/function/render/render_pass.h"
 
 namespace Piccolo
@@ -29,5 +30,6 @@ namespace Piccolo
         RHIDescriptorSetLayout* m_per_mesh_layout;
         MeshDirectionalLightShadowPerframeStorageBufferObject
             m_mesh_directional_light_shadow_perframe_storage_buffer_object;
+        RenderDrawList m_draw_list;
     };
 } // namespace Piccolo
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "runtime/function/render/render_draw_list.h"
 #include "runtime/function/render/render_pass.h"
 
 #include "runtime/function/render/passes/color_grading_pass.h"
@@ -119,5 +120,6 @@ namespace Piccolo
     private:
         std::vector<RHIFramebuffer*> m_swapchain_framebuffers;
         std::shared_ptr<ParticlePass> m_particle_pass;
+        RenderDrawList                m_draw_list;
     };
 } // namespace Piccolo
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "runtime/function/render/render_draw_list.h"
 #include "runtime/function/render/render_pass.h"
 
 namespace Piccolo
@@ -28,5 +29,6 @@ namespace Piccolo
     private:
         RHIDescriptorSetLayout* m_per_mesh_layout;
         MeshPointLightShadowPerframeStorageBufferObject m_mesh_point_light_shadow_perframe_storage_buffer_object;
+        RenderDrawList                                  m_draw_list;
     };
 } // namespace Piccolo
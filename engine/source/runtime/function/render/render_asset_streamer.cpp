@@ -0,0 +1,350 @@
+#include "runtime/function/render/render_asset_streamer.h"
+
+#include "runtime/function/render/render_resource_base.h"
+
+#include "runtime/core/base/macro.h"
+
+#include <algorithm>
+
+namespace Piccolo
+{
+    namespace
+    {
+        size_t getTextureSize(const std::shared_ptr<TextureData>& texture)
+        {
+            // every texture of a material is decoded to four 8 bit channels
+            return texture ? static_cast<size_t>(texture->m_width) * texture->m_height * 4 : 0;
+        }
+
+        size_t getBufferSize(const std::shared_ptr<BufferData>& buffer) { return buffer ? buffer->m_size : 0; }
+
+        float getMilliseconds(std::chrono::steady_clock::duration duration)
+        {
+            return std::chrono::duration<float, std::milli>(duration).count();
+        }
+    } // namespace
+
+    const size_t   RenderAssetStreamer::s_max_read_ahead_count = 16;
+    const uint32_t RenderAssetStreamer::s_max_attempt_count    = 3;
+
+    bool RenderAssetStreamer::RequestQueue::isLessUrgent(const std::unique_ptr<Request>& lhs,
+                                                         const std::unique_ptr<Request>& rhs)
+    {
+        // the heap keeps its largest element on top, so the lowest priority value and among equal priorities the
+        // oldest request have to compare largest
+        return lhs->m_priority > rhs->m_priority ||
+               (lhs->m_priority == rhs->m_priority && lhs->m_sequence > rhs->m_sequence);
+    }
+
+    void RenderAssetStreamer::RequestQueue::push(std::unique_ptr<Request> request)
+    {
+        m_requests.push_back(std::move(request));
+        std::push_heap(m_requests.begin(), m_requests.end(), isLessUrgent);
+    }
+
+    std::unique_ptr<RenderAssetStreamer::Request> RenderAssetStreamer::RequestQueue::pop()
+    {
+        std::pop_heap(m_requests.begin(), m_requests.end(), isLessUrgent);
+        std::unique_ptr<Request> request = std::move(m_requests.back());
+        m_requests.pop_back();
+        return request;
+    }
+
+    RenderAssetStreamer::~RenderAssetStreamer() { clear(); }
+
+    void RenderAssetStreamer::initialize(uint32_t decode_thread_count)
+    {
+        ASSERT(!m_is_running);
+
+        m_is_running = true;
+        m_io_thread  = std::thread(&RenderAssetStreamer::ioThreadMain, this);
+        for (uint32_t thread_index = 0; thread_index < std::max(decode_thread_count, 1u); ++thread_index)
+        {
+            m_decode_threads.emplace_back(&RenderAssetStreamer::decodeThreadMain, this);
+        }
+
+        LOG_INFO("render asset streamer started, {} decode threads", m_decode_threads.size());
+    }
+
+    void RenderAssetStreamer::clear()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_is_running)
+                return;
+            m_is_running = false;
+        }
+        m_read_condition.notify_all();
+        m_decode_condition.notify_all();
+
+        m_io_thread.join();
+        for (std::thread& decode_thread : m_decode_threads)
+        {
+            decode_thread.join();
+        }
+        m_decode_threads.clear();
+
+        m_read_queue.m_requests.clear();
+        m_decode_queue.m_requests.clear();
+        m_decoded_assets.clear();
+        m_pending_request_count.store(0, std::memory_order_release);
+
+        LOG_INFO("render asset streamer stopped, {} assets uploaded, {} failed, load latency {:.1f} ms average {:.1f} "
+                 "ms max, upload latency {:.1f} ms average {:.1f} ms max",
+                 m_stats.m_uploaded_count,
+                 m_stats.m_failed_count,
+                 m_stats.m_average_load_latency,
+                 m_stats.m_max_load_latency,
+                 m_stats.m_average_upload_latency,
+                 m_stats.m_max_upload_latency);
+    }
+
+    void RenderAssetStreamer::requestMesh(size_t mesh_asset_id, const MeshSourceDesc& source, float priority)
+    {
+        std::unique_ptr<Request> request = std::make_unique<Request>();
+        request->m_type                  = RenderAssetType::Mesh;
+        request->m_asset_id              = mesh_asset_id;
+        request->m_priority              = priority;
+        request->m_mesh_source           = source;
+        pushRequest(std::move(request));
+    }
+
+    void
+    RenderAssetStreamer::requestMaterial(size_t material_asset_id, const MaterialSourceDesc& source, float priority)
+    {
+        std::unique_ptr<Request> request = std::make_unique<Request>();
+        request->m_type                  = RenderAssetType::Material;
+        request->m_asset_id              = material_asset_id;
+        request->m_priority              = priority;
+        request->m_material_source       = source;
+        pushRequest(std::move(request));
+    }
+
+    void RenderAssetStreamer::pushRequest(std::unique_ptr<Request> request)
+    {
+        request->m_request_time = std::chrono::steady_clock::now();
+        m_pending_request_count.fetch_add(1, std::memory_order_acq_rel);
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            request->m_sequence = m_next_sequence++;
+            m_read_queue.push(std::move(request));
+        }
+        m_read_condition.notify_one();
+    }
+
+    void RenderAssetStreamer::popDecodedAssets(size_t byte_budget, std::vector<RenderStreamedAsset>& out_assets)
+    {
+        out_assets.clear();
+
+        size_t                      popped_size = 0;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        while (!m_decoded_assets.empty())
+        {
+            const size_t asset_size = m_decoded_assets.front().m_size;
+            if (!out_assets.empty() && popped_size + asset_size > byte_budget)
+                break;
+
+            popped_size += asset_size;
+            out_assets.push_back(std::move(m_decoded_assets.front()));
+            m_decoded_assets.pop_front();
+        }
+    }
+
+    void RenderAssetStreamer::onAssetsUploaded(const std::vector<RenderStreamedAsset>& assets)
+    {
+        const std::chrono::steady_clock::time_point upload_time = std::chrono::steady_clock::now();
+
+        m_stats.m_frame_uploaded_bytes = 0;
+        for (const RenderStreamedAsset& asset : assets)
+        {
+            if (!asset.m_is_valid)
+            {
+                m_stats.m_failed_count++;
+                continue;
+            }
+
+            const float load_latency   = getMilliseconds(asset.m_decoded_time - asset.m_request_time);
+            const float upload_latency = getMilliseconds(upload_time - asset.m_request_time);
+
+            m_stats.m_uploaded_count++;
+            m_stats.m_frame_uploaded_bytes += asset.m_size;
+            m_load_latency_sum += load_latency;
+            m_upload_latency_sum += upload_latency;
+            m_stats.m_max_load_latency   = std::max(m_stats.m_max_load_latency, load_latency);
+            m_stats.m_max_upload_latency = std::max(m_stats.m_max_upload_latency, upload_latency);
+        }
+
+        if (m_stats.m_uploaded_count > 0)
+        {
+            m_stats.m_average_load_latency   = static_cast<float>(m_load_latency_sum / m_stats.m_uploaded_count);
+            m_stats.m_average_upload_latency = static_cast<float>(m_upload_latency_sum / m_stats.m_uploaded_count);
+        }
+
+        m_pending_request_count.fetch_sub(static_cast<uint32_t>(assets.size()), std::memory_order_acq_rel);
+    }
+
+    RenderAssetStreamingStats RenderAssetStreamer::getStats() const
+    {
+        RenderAssetStreamingStats stats = m_stats;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        stats.m_read_queue_depth   = static_cast<uint32_t>(m_read_queue.m_requests.size()) + m_reading_count;
+        stats.m_decode_queue_depth = static_cast<uint32_t>(m_decode_queue.m_requests.size()) + m_decoding_count;
+        stats.m_upload_queue_depth = static_cast<uint32_t>(m_decoded_assets.size());
+        return stats;
+    }
+
+    void RenderAssetStreamer::ioThreadMain()
+    {
+        while (true)
+        {
+            std::unique_ptr<Request> request;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_read_condition.wait(lock, [this] {
+                    return !m_is_running ||
+                           (!m_read_queue.empty() && m_decode_queue.m_requests.size() < s_max_read_ahead_count);
+                });
+                if (!m_is_running)
+                    return;
+
+                request = m_read_queue.pop();
+                m_reading_count++;
+            }
+
+            readRequestFiles(*request);
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_reading_count--;
+                m_decode_queue.push(std::move(request));
+            }
+            m_decode_condition.notify_one();
+        }
+    }
+
+    void RenderAssetStreamer::decodeThreadMain()
+    {
+        while (true)
+        {
+            std::unique_ptr<Request> request;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_decode_condition.wait(lock, [this] { return !m_is_running || !m_decode_queue.empty(); });
+                if (!m_is_running)
+                    return;
+
+                request = m_decode_queue.pop();
+                m_decoding_count++;
+            }
+            // a slot for reading ahead is free again
+            m_read_condition.notify_one();
+
+            RenderStreamedAsset asset;
+            decodeRequest(*request, asset);
+
+            // a file may be read while it is still being written, read it again behind the requests of the same
+            // priority before giving up
+            const bool should_retry = !asset.m_is_valid && ++request->m_attempt_count < s_max_attempt_count;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_decoding_count--;
+                if (should_retry)
+                {
+                    request->m_sequence = m_next_sequence++;
+                    m_read_queue.push(std::move(request));
+                }
+                else
+                {
+                    m_decoded_assets.push_back(std::move(asset));
+                }
+            }
+            if (should_retry)
+            {
+                m_read_condition.notify_one();
+            }
+        }
+    }
+
+    void RenderAssetStreamer::readRequestFiles(Request& request)
+    {
+        if (request.m_type == RenderAssetType::Mesh)
+        {
+            request.m_cooked_mesh = RenderResourceBase::mapCookedMesh(request.m_mesh_source);
+            if (!request.m_cooked_mesh)
+            {
+                RenderResourceBase::readAssetFile(request.m_mesh_source.m_mesh_file, request.m_file_data[0]);
+            }
+            return;
+        }
+
+        const MaterialSourceDesc& source = request.m_material_source;
+        RenderResourceBase::readAssetFile(source.m_base_color_file, request.m_file_data[0]);
+        RenderResourceBase::readAssetFile(source.m_metallic_roughness_file, request.m_file_data[1]);
+        RenderResourceBase::readAssetFile(source.m_normal_file, request.m_file_data[2]);
+        RenderResourceBase::readAssetFile(source.m_occlusion_file, request.m_file_data[3]);
+        RenderResourceBase::readAssetFile(source.m_emissive_file, request.m_file_data[4]);
+    }
+
+    void RenderAssetStreamer::decodeRequest(Request& request, RenderStreamedAsset& asset)
+    {
+        asset.m_type         = request.m_type;
+        asset.m_asset_id     = request.m_asset_id;
+        asset.m_request_time = request.m_request_time;
+
+        if (request.m_type == RenderAssetType::Mesh)
+        {
+            asset.m_mesh_source = request.m_mesh_source;
+            if (request.m_cooked_mesh)
+            {
+                RenderResourceBase::getCookedMeshData(request.m_cooked_mesh, asset.m_mesh_data, asset.m_bounding_box);
+                asset.m_is_valid = true;
+            }
+            else
+            {
+                asset.m_is_valid = !request.m_file_data[0].empty() &&
+                                   RenderResourceBase::decodeMeshData(request.m_mesh_source,
+                                                                      request.m_file_data[0],
+                                                                      asset.m_mesh_data,
+                                                                      asset.m_bounding_box);
+            }
+            if (asset.m_is_valid)
+            {
+                asset.m_size = getBufferSize(asset.m_mesh_data.m_static_mesh_data.m_vertex_buffer) +
+                               getBufferSize(asset.m_mesh_data.m_static_mesh_data.m_index_buffer) +
+                               getBufferSize(asset.m_mesh_data.m_skeleton_binding_buffer);
+            }
+            else
+            {
+                LOG_WARN("stream mesh {} failed, attempt {} of {}",
+                         request.m_mesh_source.m_mesh_file,
+                         request.m_attempt_count + 1,
+                         s_max_attempt_count);
+            }
+        }
+        else
+        {
+            // textures that are missing are left empty like loadMaterialData does
+            RenderMaterialData& material = asset.m_material_data;
+            material.m_base_color_texture         = RenderResourceBase::decodeTexture(request.m_file_data[0], true);
+            material.m_metallic_roughness_texture = RenderResourceBase::decodeTexture(request.m_file_data[1], false);
+            material.m_normal_texture             = RenderResourceBase::decodeTexture(request.m_file_data[2], false);
+            material.m_occlusion_texture          = RenderResourceBase::decodeTexture(request.m_file_data[3], false);
+            material.m_emissive_texture           = RenderResourceBase::decodeTexture(request.m_file_data[4], false);
+
+            asset.m_is_valid = true;
+            asset.m_size     = getTextureSize(material.m_base_color_texture) +
+                           getTextureSize(material.m_metallic_roughness_texture) +
+                           getTextureSize(material.m_normal_texture) + getTextureSize(material.m_occlusion_texture) +
+                           getTextureSize(material.m_emissive_texture);
+        }
+
+        // the file contents are not needed anymore
+        for (std::vector<uint8_t>& file_data : request.m_file_data)
+        {
+            std::vector<uint8_t>().swap(file_data);
+        }
+
+        asset.m_decoded_time = std::chrono::steady_clock::now();
+    }
+} // namespace Piccolo
@@ -0,0 +1,158 @@
+#pragma once
+
+#include "runtime/function/render/render_type.h"
+
+#include "runtime/core/math/axis_aligned.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Piccolo
+{
+    class CookedMesh;
+
+    enum class RenderAssetType : uint8_t
+    {
+        Mesh,
+        Material
+    };
+
+    /// a decoded asset waiting to be uploaded by the render thread, m_is_valid is false for an asset that failed
+    /// every attempt
+    struct RenderStreamedAsset
+    {
+        RenderAssetType    m_type {RenderAssetType::Mesh};
+        size_t             m_asset_id {0};
+        bool               m_is_valid {false};
+        MeshSourceDesc     m_mesh_source;
+        RenderMeshData     m_mesh_data;
+        AxisAlignedBox     m_bounding_box;
+        RenderMaterialData m_material_data;
+        // decoded bytes, counted against the upload budget of the frame
+        size_t m_size {0};
+
+        std::chrono::steady_clock::time_point m_request_time;
+        std::chrono::steady_clock::time_point m_decoded_time;
+    };
+
+    /// queue depths and latencies in milliseconds, the load latency runs from the request until the asset is
+    /// decoded and the upload latency until it is on the gpu
+    struct RenderAssetStreamingStats
+    {
+        uint32_t m_read_queue_depth {0};
+        uint32_t m_decode_queue_depth {0};
+        uint32_t m_upload_queue_depth {0};
+
+        uint64_t m_uploaded_count {0};
+        uint64_t m_failed_count {0};
+        size_t   m_frame_uploaded_bytes {0};
+
+        float m_average_load_latency {0.f};
+        float m_max_load_latency {0.f};
+        float m_average_upload_latency {0.f};
+        float m_max_upload_latency {0.f};
+    };
+
+    /// Loads meshes and materials off the render thread.
+    /// A single io thread reads the files of the most urgent request into memory and hands them to the decode
+    /// threads, which parse the meshes and decode the textures. Decoded assets wait in a completion queue that the
+    /// render thread drains every frame within an upload budget. Requests with a lower priority value load first,
+    /// the render system uses the squared distance to the camera.
+    class RenderAssetStreamer
+    {
+        struct Request
+        {
+            RenderAssetType    m_type {RenderAssetType::Mesh};
+            size_t             m_asset_id {0};
+            float              m_priority {0.f};
+            uint64_t           m_sequence {0};
+            MeshSourceDesc     m_mesh_source;
+            MaterialSourceDesc m_material_source;
+            // file contents read by the io thread, a material has one file per texture
+            std::array<std::vector<uint8_t>, 5> m_file_data;
+            // meshes with an up to date cooked file are mapped instead of read
+            std::shared_ptr<CookedMesh> m_cooked_mesh;
+            // failed decodes so far, see s_max_attempt_count
+            uint32_t m_attempt_count {0};
+
+            std::chrono::steady_clock::time_point m_request_time;
+        };
+
+        struct RequestQueue
+        {
+            std::vector<std::unique_ptr<Request>> m_requests; // binary heap, most urgent request on top
+
+            bool                     empty() const { return m_requests.empty(); }
+            void                     push(std::unique_ptr<Request> request);
+            std::unique_ptr<Request> pop();
+
+            static bool isLessUrgent(const std::unique_ptr<Request>& lhs, const std::unique_ptr<Request>& rhs);
+        };
+
+    public:
+        ~RenderAssetStreamer();
+
+        /// @decode_thread_count: number of decode threads, at least one is created
+        void initialize(uint32_t decode_thread_count);
+        void clear();
+
+        void requestMesh(size_t mesh_asset_id, const MeshSourceDesc& source, float priority);
+        void requestMaterial(size_t material_asset_id, const MaterialSourceDesc& source, float priority);
+
+        /// moves decoded assets into out_assets in completion order until their sizes exceed the byte budget, at
+        /// least one asset is returned when any is ready so that large assets still make progress
+        void popDecodedAssets(size_t byte_budget, std::vector<RenderStreamedAsset>& out_assets);
+
+        /// called by the render thread once the assets returned by popDecodedAssets are uploaded
+        void onAssetsUploaded(const std::vector<RenderStreamedAsset>& assets);
+
+        bool isIdle() const { return m_pending_request_count.load(std::memory_order_acquire) == 0; }
+
+        RenderAssetStreamingStats getStats() const;
+
+    private:
+        void ioThreadMain();
+        void decodeThreadMain();
+
+        static void readRequestFiles(Request& request);
+        static void decodeRequest(Request& request, RenderStreamedAsset& asset);
+
+        void pushRequest(std::unique_ptr<Request> request);
+
+        // the io thread stops reading ahead when this many requests wait for a decode thread
+        static const size_t s_max_read_ahead_count;
+        // a request that fails to decode this many times is handed to the render thread as invalid
+        static const uint32_t s_max_attempt_count;
+
+        std::thread              m_io_thread;
+        std::vector<std::thread> m_decode_threads;
+        bool                     m_is_running {false};
+
+        mutable std::mutex      m_mutex;
+        std::condition_variable m_read_condition;
+        std::condition_variable m_decode_condition;
+        RequestQueue            m_read_queue;
+        RequestQueue            m_decode_queue;
+        uint64_t                m_next_sequence {0};
+        uint32_t                m_reading_count {0};
+        uint32_t                m_decoding_count {0};
+
+        std::deque<RenderStreamedAsset> m_decoded_assets;
+
+        // requested and not yet uploaded
+        std::atomic<uint32_t> m_pending_request_count {0};
+
+        // render thread only
+        RenderAssetStreamingStats m_stats;
+        double                    m_load_latency_sum {0.0};
+        double                    m_upload_latency_sum {0.0};
+    };
+} // namespace Piccolo
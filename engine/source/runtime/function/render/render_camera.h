@@ -42,6 +42,7 @@ namespace Piccolo
 
         void setAspect(float aspect);
         void setFOVx(float fovx) { m_fovx = fovx; }
+        float getAspect() const { return m_aspect; }
 
         Vector3    position() const { return m_position; }
         Quaternion rotation() const { return m_rotation; }
@@ -0,0 +1,567 @@
+#include "runtime/function/render/render_cooked_mesh.h"
+
+#include "runtime/core/base/macro.h"
+#include "runtime/core/math/vector2.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <string_view>
+#include <unordered_map>
+
+namespace Piccolo
+{
+    namespace
+    {
+        constexpr uint32_t k_invalid_index = std::numeric_limits<uint32_t>::max();
+
+        // scoring constants of Tom Forsyth's linear speed vertex cache optimisation
+        constexpr float k_cache_decay_power   = 1.5f;
+        constexpr float k_last_triangle_score = 0.75f;
+        constexpr float k_valence_boost_scale = 2.f;
+        constexpr float k_valence_boost_power = 0.5f;
+        constexpr float k_min_tangent_length  = 1e-6f;
+        constexpr float k_min_uv_determinant  = 1e-6f;
+
+        uint32_t alignUp(uint32_t value, uint32_t alignment) { return (value + alignment - 1) & ~(alignment - 1); }
+
+        template<typename T>
+        void writeArray(std::vector<uint8_t>& bytes, size_t offset, const std::vector<T>& values)
+        {
+            if (!values.empty())
+            {
+                std::memcpy(bytes.data() + offset, values.data(), values.size() * sizeof(T));
+            }
+        }
+
+        template<typename T>
+        bool areIndicesInRange(const T* indices, uint32_t index_count, const CookedMesh::Header& header)
+        {
+            for (uint32_t index = 0; index < index_count; ++index)
+            {
+                if (indices[index] >= header.m_vertex_count)
+                    return false;
+            }
+            return true;
+        }
+
+        // vertices are welded when all their attributes are bitwise equal
+        struct WeldKey
+        {
+            MeshVertexDataDefinition        m_vertex;
+            MeshVertexBindingDataDefinition m_skinning;
+
+            bool operator==(const WeldKey& rhs) const { return std::memcmp(this, &rhs, sizeof(WeldKey)) == 0; }
+        };
+
+        struct WeldKeyHash
+        {
+            size_t operator()(const WeldKey& key) const noexcept
+            {
+                return std::hash<std::string_view> {}(
+                    std::string_view(reinterpret_cast<const char*>(&key), sizeof(WeldKey)));
+            }
+        };
+
+        // -0 and +0 compare equal but differ bitwise
+        float canonicalize(float value) { return value + 0.f; }
+
+        WeldKey makeWeldKey(const MeshCookSource& source, uint32_t vertex_index)
+        {
+            WeldKey key;
+            std::memset(&key, 0, sizeof(WeldKey));
+
+            const MeshVertexDataDefinition& vertex = source.m_vertices[vertex_index];
+            key.m_vertex.x                         = canonicalize(vertex.x);
+            key.m_vertex.y                         = canonicalize(vertex.y);
+            key.m_vertex.z                         = canonicalize(vertex.z);
+            key.m_vertex.nx                        = canonicalize(vertex.nx);
+            key.m_vertex.ny                        = canonicalize(vertex.ny);
+            key.m_vertex.nz                        = canonicalize(vertex.nz);
+            key.m_vertex.u                         = canonicalize(vertex.u);
+            key.m_vertex.v                         = canonicalize(vertex.v);
+            // computed tangents are accumulated after welding, so they do not keep vertices apart
+            if (!source.m_compute_tangents)
+            {
+                key.m_vertex.tx = canonicalize(vertex.tx);
+                key.m_vertex.ty = canonicalize(vertex.ty);
+                key.m_vertex.tz = canonicalize(vertex.tz);
+            }
+            if (!source.m_skinning.empty())
+            {
+                key.m_skinning = source.m_skinning[vertex_index];
+            }
+            return key;
+        }
+
+        Vector3 getPosition(const MeshVertexDataDefinition& vertex) { return Vector3(vertex.x, vertex.y, vertex.z); }
+
+        void computeTangents(const std::vector<uint32_t>& indices, std::vector<MeshVertexDataDefinition>& vertices)
+        {
+            std::vector<Vector3> tangents(vertices.size(), Vector3::ZERO);
+            for (size_t index = 0; index + 2 < indices.size(); index += 3)
+            {
+                const MeshVertexDataDefinition& v0 = vertices[indices[index]];
+                const MeshVertexDataDefinition& v1 = vertices[indices[index + 1]];
+                const MeshVertexDataDefinition& v2 = vertices[indices[index + 2]];
+
+                const Vector3 edge1     = getPosition(v1) - getPosition(v0);
+                const Vector3 edge2     = getPosition(v2) - getPosition(v1);
+                const Vector2 delta_uv1 = Vector2(v1.u - v0.u, v1.v - v0.v);
+                const Vector2 delta_uv2 = Vector2(v2.u - v1.u, v2.v - v1.v);
+
+                float determinant = delta_uv1.x * delta_uv2.y - delta_uv2.x * delta_uv1.y;
+                if (std::fabs(determinant) < k_min_uv_determinant)
+                {
+                    determinant = determinant < 0.f ? -k_min_uv_determinant : k_min_uv_determinant;
+                }
+
+                // every triangle adds its unit tangent, so the shared tangent is the average over the triangles
+                Vector3 tangent = (edge1 * delta_uv2.y - edge2 * delta_uv1.y) / determinant;
+                if (tangent.squaredLength() < k_min_tangent_length)
+                    continue;
+                tangent.normalise();
+
+                tangents[indices[index]] += tangent;
+                tangents[indices[index + 1]] += tangent;
+                tangents[indices[index + 2]] += tangent;
+            }
+
+            for (size_t vertex_index = 0; vertex_index < vertices.size(); ++vertex_index)
+            {
+                MeshVertexDataDefinition& vertex = vertices[vertex_index];
+                const Vector3             normal(vertex.nx, vertex.ny, vertex.nz);
+
+                // orthogonalize against the normal, vertices without a usable tangent get any perpendicular one
+                Vector3 tangent = tangents[vertex_index] - normal * normal.dotProduct(tangents[vertex_index]);
+                if (tangent.squaredLength() < k_min_tangent_length)
+                {
+                    tangent = normal.crossProduct(std::fabs(normal.x) < 0.9f ? Vector3::UNIT_X : Vector3::UNIT_Y);
+                }
+                tangent.normalise();
+
+                vertex.tx = tangent.x;
+                vertex.ty = tangent.y;
+                vertex.tz = tangent.z;
+            }
+        }
+
+        float getVertexScore(int32_t cache_position, uint32_t remaining_valence)
+        {
+            if (remaining_valence == 0)
+                return -1.f;
+
+            float score = 0.f;
+            if (cache_position >= 0)
+            {
+                // the vertices of the last triangle get a fixed score so that the next triangle does not reuse all
+                // of them, which would produce a strip like order
+                if (cache_position < 3)
+                {
+                    score = k_last_triangle_score;
+                }
+                else
+                {
+                    const float scaler = 1.f / (MeshCooker::s_vertex_cache_size - 3);
+                    score              = std::pow(1.f - (cache_position - 3) * scaler, k_cache_decay_power);
+                }
+            }
+
+            // vertices with few remaining triangles are finished first
+            return score + k_valence_boost_scale * std::pow(static_cast<float>(remaining_valence),
+                                                            -k_valence_boost_power);
+        }
+
+        // Tom Forsyth, linear speed vertex cache optimisation, 2006
+        void optimizeVertexCache(std::vector<uint32_t>& indices, uint32_t vertex_count)
+        {
+            const uint32_t triangle_count = static_cast<uint32_t>(indices.size() / 3);
+            if (triangle_count == 0)
+                return;
+
+            // triangles of every vertex, the first remaining_valence entries are the triangles not yet emitted
+            std::vector<uint32_t> remaining_valence(vertex_count, 0);
+            std::vector<uint32_t> vertex_triangle_offsets(vertex_count + 1, 0);
+            for (uint32_t vertex_index : indices)
+            {
+                vertex_triangle_offsets[vertex_index + 1]++;
+            }
+            for (uint32_t vertex_index = 0; vertex_index < vertex_count; ++vertex_index)
+            {
+                remaining_valence[vertex_index] = vertex_triangle_offsets[vertex_index + 1];
+                vertex_triangle_offsets[vertex_index + 1] += vertex_triangle_offsets[vertex_index];
+            }
+            std::vector<uint32_t> vertex_triangles(indices.size());
+            {
+                std::vector<uint32_t> fill_counts(vertex_count, 0);
+                for (uint32_t triangle = 0; triangle < triangle_count; ++triangle)
+                {
+                    for (uint32_t corner = 0; corner < 3; ++corner)
+                    {
+                        const uint32_t vertex_index = indices[triangle * 3 + corner];
+                        const uint32_t slot    = vertex_triangle_offsets[vertex_index] + fill_counts[vertex_index]++;
+                        vertex_triangles[slot] = triangle;
+                    }
+                }
+            }
+
+            std::vector<int32_t> cache_positions(vertex_count, -1);
+            std::vector<float>   vertex_scores(vertex_count);
+            for (uint32_t vertex_index = 0; vertex_index < vertex_count; ++vertex_index)
+            {
+                vertex_scores[vertex_index] = getVertexScore(-1, remaining_valence[vertex_index]);
+            }
+
+            std::vector<float> triangle_scores(triangle_count);
+            std::vector<bool>  is_triangle_emitted(triangle_count, false);
+            uint32_t           best_triangle = 0;
+            for (uint32_t triangle = 0; triangle < triangle_count; ++triangle)
+            {
+                triangle_scores[triangle] = vertex_scores[indices[triangle * 3]] +
+                                            vertex_scores[indices[triangle * 3 + 1]] +
+                                            vertex_scores[indices[triangle * 3 + 2]];
+                if (triangle_scores[triangle] > triangle_scores[best_triangle])
+                {
+                    best_triangle = triangle;
+                }
+            }
+
+            std::vector<uint32_t> cache;
+            std::vector<uint32_t> next_cache;
+            cache.reserve(MeshCooker::s_vertex_cache_size + 3);
+            next_cache.reserve(MeshCooker::s_vertex_cache_size + 3);
+
+            std::vector<uint32_t> optimized_indices;
+            optimized_indices.reserve(indices.size());
+            uint32_t next_unemitted_triangle = 0;
+
+            for (uint32_t emitted_count = 0; emitted_count < triangle_count; ++emitted_count)
+            {
+                // nothing in the cache has triangles left, continue with the next triangle in input order
+                if (best_triangle == k_invalid_index)
+                {
+                    while (is_triangle_emitted[next_unemitted_triangle])
+                    {
+                        ++next_unemitted_triangle;
+                    }
+                    best_triangle = next_unemitted_triangle;
+                }
+
+                is_triangle_emitted[best_triangle] = true;
+
+                next_cache.clear();
+                for (uint32_t corner = 0; corner < 3; ++corner)
+                {
+                    const uint32_t vertex_index = indices[best_triangle * 3 + corner];
+                    optimized_indices.push_back(vertex_index);
+                    next_cache.push_back(vertex_index);
+
+                    // move the emitted triangle out of the remaining triangles of the vertex
+                    uint32_t* triangles = vertex_triangles.data() + vertex_triangle_offsets[vertex_index];
+                    uint32_t& valence   = remaining_valence[vertex_index];
+                    std::swap(*std::find(triangles, triangles + valence, best_triangle), triangles[valence - 1]);
+                    --valence;
+                }
+                for (uint32_t vertex_index : cache)
+                {
+                    if (std::find(next_cache.begin(), next_cache.begin() + 3, vertex_index) == next_cache.begin() + 3)
+                    {
+                        next_cache.push_back(vertex_index);
+                    }
+                }
+
+                // rescore the vertices that moved in the cache, including those pushed out of it
+                for (uint32_t cache_index = 0; cache_index < next_cache.size(); ++cache_index)
+                {
+                    const uint32_t vertex_index = next_cache[cache_index];
+                    cache_positions[vertex_index] =
+                        cache_index < MeshCooker::s_vertex_cache_size ? static_cast<int32_t>(cache_index) : -1;
+
+                    const float score =
+                        getVertexScore(cache_positions[vertex_index], remaining_valence[vertex_index]);
+                    const float score_delta = score - vertex_scores[vertex_index];
+                    vertex_scores[vertex_index] = score;
+
+                    const uint32_t* triangles = vertex_triangles.data() + vertex_triangle_offsets[vertex_index];
+                    for (uint32_t triangle_index = 0; triangle_index < remaining_valence[vertex_index];
+                         ++triangle_index)
+                    {
+                        triangle_scores[triangles[triangle_index]] += score_delta;
+                    }
+                }
+
+                if (next_cache.size() > MeshCooker::s_vertex_cache_size)
+                {
+                    next_cache.resize(MeshCooker::s_vertex_cache_size);
+                }
+                cache.swap(next_cache);
+
+                // the next triangle is the best one that uses a cached vertex
+                best_triangle    = k_invalid_index;
+                float best_score = -1.f;
+                for (uint32_t vertex_index : cache)
+                {
+                    const uint32_t* triangles = vertex_triangles.data() + vertex_triangle_offsets[vertex_index];
+                    for (uint32_t triangle_index = 0; triangle_index < remaining_valence[vertex_index];
+                         ++triangle_index)
+                    {
+                        const uint32_t triangle = triangles[triangle_index];
+                        if (triangle_scores[triangle] > best_score)
+                        {
+                            best_score    = triangle_scores[triangle];
+                            best_triangle = triangle;
+                        }
+                    }
+                }
+            }
+
+            indices.swap(optimized_indices);
+        }
+    } // namespace
+
+    bool CookedMesh::loadFromFile(const std::filesystem::path& file_path)
+    {
+        m_bytes.clear();
+        if (!m_mapped_file.open(file_path))
+            return false;
+
+        if (!bind(m_mapped_file.getData(), m_mapped_file.getSize()))
+        {
+            m_mapped_file.close();
+            return false;
+        }
+        return true;
+    }
+
+    bool CookedMesh::loadFromMemory(std::vector<uint8_t>&& bytes)
+    {
+        m_mapped_file.close();
+        m_bytes = std::move(bytes);
+        return bind(m_bytes.data(), m_bytes.size());
+    }
+
+    bool CookedMesh::bind(const uint8_t* data, size_t size)
+    {
+        m_header   = nullptr;
+        m_vertices = nullptr;
+        m_indices  = nullptr;
+        m_skinning = nullptr;
+        m_size     = 0;
+
+        if (data == nullptr || size < sizeof(Header))
+            return false;
+
+        const Header& header = *reinterpret_cast<const Header*>(data);
+        if (header.m_magic != s_magic || header.m_version != s_version)
+        {
+            LOG_ERROR("cooked mesh has an unknown format");
+            return false;
+        }
+
+        const bool has_skinning = header.m_flags & s_skinning_flag;
+        const bool is_valid =
+            (header.m_index_size == sizeof(uint16_t) || header.m_index_size == sizeof(uint32_t)) &&
+            header.m_index_count % 3 == 0 && header.m_vertices_offset % 16 == 0 &&
+            header.m_indices_offset % 16 == 0 && header.m_skinning_offset % 16 == 0 &&
+            header.m_vertices_offset + uint64_t(header.m_vertex_count) * sizeof(MeshVertexDataDefinition) <= size &&
+            header.m_indices_offset + uint64_t(header.m_index_count) * header.m_index_size <= size &&
+            (!has_skinning ||
+             header.m_skinning_offset + uint64_t(header.m_vertex_count) * sizeof(MeshVertexBindingDataDefinition) <=
+                 size);
+        if (!is_valid)
+        {
+            LOG_ERROR("cooked mesh is truncated or corrupted");
+            return false;
+        }
+
+        // an index past the vertices would make the gpu read out of the vertex buffer
+        const uint8_t* indices = data + header.m_indices_offset;
+        const bool     are_indices_in_range =
+            header.m_index_size == sizeof(uint16_t) ?
+                areIndicesInRange(reinterpret_cast<const uint16_t*>(indices), header.m_index_count, header) :
+                areIndicesInRange(reinterpret_cast<const uint32_t*>(indices), header.m_index_count, header);
+        if (!are_indices_in_range)
+        {
+            LOG_ERROR("cooked mesh has indices past its {} vertices", header.m_vertex_count);
+            return false;
+        }
+
+        m_header   = &header;
+        m_vertices = reinterpret_cast<const MeshVertexDataDefinition*>(data + header.m_vertices_offset);
+        m_indices  = data + header.m_indices_offset;
+        m_skinning = has_skinning ?
+                         reinterpret_cast<const MeshVertexBindingDataDefinition*>(data + header.m_skinning_offset) :
+                         nullptr;
+        m_size     = size;
+        return true;
+    }
+
+    AxisAlignedBox CookedMesh::getBoundingBox() const
+    {
+        AxisAlignedBox bounding_box;
+        if (m_header && m_header->m_vertex_count > 0)
+        {
+            bounding_box.merge(Vector3(
+                m_header->m_bounding_box_min[0], m_header->m_bounding_box_min[1], m_header->m_bounding_box_min[2]));
+            bounding_box.merge(Vector3(
+                m_header->m_bounding_box_max[0], m_header->m_bounding_box_max[1], m_header->m_bounding_box_max[2]));
+        }
+        return bounding_box;
+    }
+
+    void MeshCooker::cook(const MeshCookSource& source, std::vector<uint8_t>& out_bytes)
+    {
+        ASSERT(source.m_skinning.empty() || source.m_skinning.size() == source.m_vertices.size());
+
+        const uint32_t source_vertex_count = static_cast<uint32_t>(source.m_vertices.size());
+        const size_t   source_index_count =
+            source.m_indices.empty() ? source.m_vertices.size() : source.m_indices.size();
+
+        // weld the vertices
+        std::vector<uint32_t>                              weld_remap(source_vertex_count);
+        std::vector<uint32_t>                              welded_sources;
+        std::unordered_map<WeldKey, uint32_t, WeldKeyHash> welded_vertex_map;
+        welded_vertex_map.reserve(source_vertex_count);
+        for (uint32_t vertex_index = 0; vertex_index < source_vertex_count; ++vertex_index)
+        {
+            auto [found, is_new] = welded_vertex_map.emplace(makeWeldKey(source, vertex_index),
+                                                             static_cast<uint32_t>(welded_sources.size()));
+            if (is_new)
+            {
+                welded_sources.push_back(vertex_index);
+            }
+            weld_remap[vertex_index] = found->second;
+        }
+
+        std::vector<MeshVertexDataDefinition> vertices(welded_sources.size());
+        for (size_t vertex_index = 0; vertex_index < welded_sources.size(); ++vertex_index)
+        {
+            vertices[vertex_index] = source.m_vertices[welded_sources[vertex_index]];
+        }
+
+        // degenerate triangles only cost vertex work
+        std::vector<uint32_t> indices;
+        indices.reserve(source_index_count);
+        for (size_t index = 0; index + 2 < source_index_count; index += 3)
+        {
+            uint32_t triangle[3];
+            for (size_t corner = 0; corner < 3; ++corner)
+            {
+                const uint32_t source_index =
+                    source.m_indices.empty() ? static_cast<uint32_t>(index + corner) : source.m_indices[index + corner];
+                triangle[corner] = source_index < source_vertex_count ? weld_remap[source_index] : k_invalid_index;
+            }
+            if (triangle[0] == k_invalid_index || triangle[1] == k_invalid_index || triangle[2] == k_invalid_index ||
+                triangle[0] == triangle[1] || triangle[1] == triangle[2] || triangle[0] == triangle[2])
+                continue;
+
+            indices.insert(indices.end(), triangle, triangle + 3);
+        }
+
+        if (source.m_compute_tangents)
+        {
+            computeTangents(indices, vertices);
+        }
+
+        optimizeVertexCache(indices, static_cast<uint32_t>(vertices.size()));
+
+        // order the vertices by first use, which also drops unreferenced ones
+        std::vector<uint32_t>                        fetch_remap(vertices.size(), k_invalid_index);
+        std::vector<MeshVertexDataDefinition>        fetch_vertices;
+        std::vector<MeshVertexBindingDataDefinition> fetch_skinning;
+        fetch_vertices.reserve(vertices.size());
+        fetch_skinning.reserve(source.m_skinning.empty() ? 0 : vertices.size());
+        for (uint32_t& vertex_index : indices)
+        {
+            if (fetch_remap[vertex_index] == k_invalid_index)
+            {
+                fetch_remap[vertex_index] = static_cast<uint32_t>(fetch_vertices.size());
+                fetch_vertices.push_back(vertices[vertex_index]);
+                if (!source.m_skinning.empty())
+                {
+                    fetch_skinning.push_back(source.m_skinning[welded_sources[vertex_index]]);
+                }
+            }
+            vertex_index = fetch_remap[vertex_index];
+        }
+
+        CookedMesh::Header header;
+        std::memset(&header, 0, sizeof(CookedMesh::Header));
+        header.m_magic        = CookedMesh::s_magic;
+        header.m_version      = CookedMesh::s_version;
+        header.m_flags        = source.m_skinning.empty() ? 0 : CookedMesh::s_skinning_flag;
+        header.m_vertex_count = static_cast<uint32_t>(fetch_vertices.size());
+        header.m_index_count  = static_cast<uint32_t>(indices.size());
+        header.m_index_size =
+            fetch_vertices.size() <= std::numeric_limits<uint16_t>::max() ? sizeof(uint16_t) : sizeof(uint32_t);
+        header.m_cooker_version = MeshCooker::s_version;
+
+        AxisAlignedBox bounding_box;
+        for (const MeshVertexDataDefinition& vertex : fetch_vertices)
+        {
+            bounding_box.merge(getPosition(vertex));
+        }
+        if (!fetch_vertices.empty())
+        {
+            const Vector3& min_corner = bounding_box.getMinCorner();
+            const Vector3& max_corner = bounding_box.getMaxCorner();
+            std::memcpy(header.m_bounding_box_min, min_corner.ptr(), sizeof(header.m_bounding_box_min));
+            std::memcpy(header.m_bounding_box_max, max_corner.ptr(), sizeof(header.m_bounding_box_max));
+        }
+
+        header.m_vertices_offset = alignUp(sizeof(CookedMesh::Header), 16);
+        header.m_indices_offset =
+            alignUp(header.m_vertices_offset + header.m_vertex_count * sizeof(MeshVertexDataDefinition), 16);
+        header.m_skinning_offset =
+            alignUp(header.m_indices_offset + header.m_index_count * header.m_index_size, 16);
+        const size_t cooked_size =
+            header.m_skinning_offset + fetch_skinning.size() * sizeof(MeshVertexBindingDataDefinition);
+
+        out_bytes.assign(cooked_size, 0);
+        std::memcpy(out_bytes.data(), &header, sizeof(CookedMesh::Header));
+        writeArray(out_bytes, header.m_vertices_offset, fetch_vertices);
+        if (header.m_index_size == sizeof(uint16_t))
+        {
+            writeArray(out_bytes, header.m_indices_offset, std::vector<uint16_t>(indices.begin(), indices.end()));
+        }
+        else
+        {
+            writeArray(out_bytes, header.m_indices_offset, indices);
+        }
+        writeArray(out_bytes, header.m_skinning_offset, fetch_skinning);
+    }
+
+    bool MeshCooker::save(const std::vector<uint8_t>& bytes, const std::filesystem::path& file_path)
+    {
+        std::ofstream cooked_file(file_path, std::ios::binary | std::ios::trunc);
+        if (!cooked_file)
+        {
+            LOG_ERROR("open file {} failed!", file_path.generic_string());
+            return false;
+        }
+        cooked_file.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+        return static_cast<bool>(cooked_file);
+    }
+
+    float MeshCooker::computeAverageCacheMissRatio(const uint32_t* indices, size_t index_count, uint32_t cache_size)
+    {
+        if (index_count < 3)
+            return 0.f;
+
+        std::vector<uint32_t> cache(cache_size, k_invalid_index);
+        size_t                cache_head = 0;
+        size_t                miss_count = 0;
+        for (size_t index = 0; index < index_count; ++index)
+        {
+            if (std::find(cache.begin(), cache.end(), indices[index]) == cache.end())
+            {
+                cache[cache_head] = indices[index];
+                cache_head        = (cache_head + 1) % cache_size;
+                ++miss_count;
+            }
+        }
+        return static_cast<float>(miss_count) / (index_count / 3);
+    }
+} // namespace Piccolo
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "runtime/function/render/render_type.h"
+
+#include "runtime/core/math/axis_aligned.h"
+#include "runtime/platform/file_service/mapped_file.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+namespace Piccolo
+{
+    /// Binary runtime mesh, usable in place from a mapped file:
+    ///     header | vertices (MeshVertexDataDefinition) | indices (uint16 or uint32) | skinning (optional)
+    /// the vertices are welded and ordered by first use, the indices are ordered for the post transform vertex cache.
+    class CookedMesh
+    {
+    public:
+        static constexpr uint32_t s_magic         = 0x484d4350; // "PCMH"
+        static constexpr uint32_t s_version       = 2;
+        static constexpr uint32_t s_skinning_flag = 0x1;
+
+        struct Header
+        {
+            uint32_t m_magic;
+            uint32_t m_version;
+            uint32_t m_flags;
+            uint32_t m_vertex_count;
+            uint32_t m_index_count;
+            uint32_t m_index_size;
+            float    m_bounding_box_min[3];
+            float    m_bounding_box_max[3];
+            uint32_t m_vertices_offset;
+            uint32_t m_indices_offset;
+            uint32_t m_skinning_offset;
+            uint32_t m_cooker_version;
+        };
+
+        bool loadFromFile(const std::filesystem::path& file_path);
+        bool loadFromMemory(std::vector<uint8_t>&& bytes);
+
+        uint32_t getVertexCount() const { return m_header ? m_header->m_vertex_count : 0; }
+        uint32_t getIndexCount() const { return m_header ? m_header->m_index_count : 0; }
+        uint32_t getIndexSize() const { return m_header ? m_header->m_index_size : 0; }
+        uint32_t getCookerVersion() const { return m_header ? m_header->m_cooker_version : 0; }
+        bool     hasSkinning() const { return m_header && (m_header->m_flags & s_skinning_flag); }
+        size_t   getMemorySize() const { return m_size; }
+
+        const MeshVertexDataDefinition*        getVertices() const { return m_vertices; }
+        const void*                            getIndices() const { return m_indices; }
+        const MeshVertexBindingDataDefinition* getSkinning() const { return m_skinning; }
+        AxisAlignedBox                         getBoundingBox() const;
+
+    private:
+        bool bind(const uint8_t* data, size_t size);
+
+        MappedFile           m_mapped_file;
+        std::vector<uint8_t> m_bytes;
+        size_t               m_size {0};
+
+        const Header*                          m_header {nullptr};
+        const MeshVertexDataDefinition*        m_vertices {nullptr};
+        const void*                            m_indices {nullptr};
+        const MeshVertexBindingDataDefinition* m_skinning {nullptr};
+    };
+
+    /// Triangle list as it comes out of the obj or json loaders, vertices may be duplicated and m_indices may be
+    /// empty for a non indexed list. m_skinning is either empty or holds one entry per vertex.
+    struct MeshCookSource
+    {
+        std::vector<MeshVertexDataDefinition>        m_vertices;
+        std::vector<uint32_t>                        m_indices;
+        std::vector<MeshVertexBindingDataDefinition> m_skinning;
+        // obj files have no tangents, they are accumulated over the triangles of each welded vertex
+        bool m_compute_tangents {false};
+    };
+
+    class MeshCooker
+    {
+    public:
+        /// stored in every cooked mesh, bump it with any change to the welding, the ordering, the tangents or
+        /// s_vertex_cache_size so that the meshes cooked by an older cooker are cooked again
+        static constexpr uint32_t s_version           = 1;
+        static constexpr uint32_t s_vertex_cache_size = 32;
+
+        /// welds equal vertices, drops degenerate triangles, orders the triangles for the vertex cache and the
+        /// vertices by first use, 16 bit indices are used when the vertex count allows it
+        static void cook(const MeshCookSource& source, std::vector<uint8_t>& out_bytes);
+        static bool save(const std::vector<uint8_t>& bytes, const std::filesystem::path& file_path);
+
+        /// average cache miss ratio, transformed vertices per triangle with a fifo cache of cache_size entries
+        static float computeAverageCacheMissRatio(const uint32_t* indices, size_t index_count, uint32_t cache_size);
+    };
+} // namespace Piccolo
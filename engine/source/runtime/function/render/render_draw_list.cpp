@@ -0,0 +1,166 @@
+#include "runtime/function/render/render_draw_list.h"
+
+#include "runtime/function/render/render_common.h"
+
+#include <array>
+#include <chrono>
+#include <cmath>
+
+namespace Piccolo
+{
+    namespace
+    {
+        constexpr uint32_t k_radix_bits        = 8;
+        constexpr uint32_t k_radix_size        = 1 << k_radix_bits;
+        constexpr uint32_t k_radix_digit_count = 64 / k_radix_bits;
+
+        // depth buckets grow logarithmically, 16 buckets per doubling of the distance
+        constexpr float k_depth_buckets_per_octave = 16.f;
+
+        uint32_t getRadixDigit(uint64_t key, uint32_t digit)
+        {
+            return static_cast<uint32_t>(key >> (digit * k_radix_bits)) & (k_radix_size - 1);
+        }
+    } // namespace
+
+    uint64_t RenderDrawList::makeSortKey(uint32_t pipeline, uint32_t material, uint32_t mesh, uint32_t depth_bucket)
+    {
+        constexpr uint64_t pipeline_mask     = (uint64_t(1) << s_pipeline_bits) - 1;
+        constexpr uint64_t material_mask     = (uint64_t(1) << s_material_bits) - 1;
+        constexpr uint64_t mesh_mask         = (uint64_t(1) << s_mesh_bits) - 1;
+        constexpr uint64_t depth_bucket_mask = (uint64_t(1) << s_depth_bucket_bits) - 1;
+
+        return ((pipeline & pipeline_mask) << (s_material_bits + s_mesh_bits + s_depth_bucket_bits)) |
+               ((material & material_mask) << (s_mesh_bits + s_depth_bucket_bits)) |
+               ((mesh & mesh_mask) << s_depth_bucket_bits) | (depth_bucket & depth_bucket_mask);
+    }
+
+    uint32_t RenderDrawList::getDepthBucket(float distance)
+    {
+        constexpr uint32_t max_depth_bucket = (1 << s_depth_bucket_bits) - 1;
+
+        if (!(distance > 0.f))
+            return 0;
+        const float bucket = std::log2(1.f + distance) * k_depth_buckets_per_octave;
+        return bucket >= static_cast<float>(max_depth_bucket) ? max_depth_bucket : static_cast<uint32_t>(bucket);
+    }
+
+    void RenderDrawList::build(const std::vector<RenderMeshNode>& mesh_nodes,
+                               uint32_t                           pipeline,
+                               bool                               group_by_material,
+                               const Vector3*                     view_position)
+    {
+        const auto build_begin = std::chrono::steady_clock::now();
+
+        const size_t node_count = mesh_nodes.size();
+        m_keys.resize(node_count);
+        m_node_indices.resize(node_count);
+        for (size_t node_index = 0; node_index < node_count; ++node_index)
+        {
+            const RenderMeshNode& node = mesh_nodes[node_index];
+
+            uint32_t depth_bucket = 0;
+            if (view_position)
+            {
+                depth_bucket = getDepthBucket(view_position->distance(node.model_matrix->getTrans()));
+            }
+
+            const uint32_t material = group_by_material ? node.material_asset_index : 0;
+            m_keys[node_index]      = makeSortKey(pipeline, material, node.mesh_asset_index, depth_bucket);
+            m_node_indices[node_index] = static_cast<uint32_t>(node_index);
+        }
+
+        sortKeys();
+
+        // a batch is a run of keys that only differ in the depth bucket
+        m_nodes.resize(node_count);
+        m_batches.clear();
+        uint64_t batch_key = 0;
+        for (size_t sorted_index = 0; sorted_index < node_count; ++sorted_index)
+        {
+            const RenderMeshNode& node = mesh_nodes[m_node_indices[sorted_index]];
+
+            RenderDrawNode& draw_node = m_nodes[sorted_index];
+            draw_node.model_matrix    = node.model_matrix;
+            draw_node.node_id         = node.node_id;
+            if (node.enable_vertex_blending)
+            {
+                draw_node.joint_matrices = node.joint_matrices;
+                draw_node.joint_count    = node.joint_count;
+            }
+            else
+            {
+                draw_node.joint_matrices = nullptr;
+                draw_node.joint_count    = 0;
+            }
+
+            const uint64_t key = m_keys[sorted_index] >> s_depth_bucket_bits;
+            if (m_batches.empty() || key != batch_key)
+            {
+                RenderDrawBatch batch;
+                batch.material   = node.ref_material;
+                batch.mesh       = node.ref_mesh;
+                batch.first_node = static_cast<uint32_t>(sorted_index);
+                m_batches.push_back(batch);
+                batch_key = key;
+            }
+            m_batches.back().node_count++;
+        }
+
+        m_build_time = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - build_begin).count();
+    }
+
+    void RenderDrawList::clear()
+    {
+        m_keys.clear();
+        m_node_indices.clear();
+        m_nodes.clear();
+        m_batches.clear();
+        m_build_time = 0.f;
+    }
+
+    void RenderDrawList::sortKeys()
+    {
+        // least significant digit first radix sort, stable so nodes with equal keys keep the visible order
+        const size_t key_count = m_keys.size();
+        if (key_count < 2)
+            return;
+
+        std::array<std::array<uint32_t, k_radix_size>, k_radix_digit_count> histograms {};
+        for (uint64_t key : m_keys)
+        {
+            for (uint32_t digit = 0; digit < k_radix_digit_count; ++digit)
+            {
+                histograms[digit][getRadixDigit(key, digit)]++;
+            }
+        }
+
+        m_scratch_keys.resize(key_count);
+        m_scratch_node_indices.resize(key_count);
+        for (uint32_t digit = 0; digit < k_radix_digit_count; ++digit)
+        {
+            std::array<uint32_t, k_radix_size>& histogram = histograms[digit];
+
+            // all keys share this digit, the pass would not move anything
+            if (histogram[getRadixDigit(m_keys[0], digit)] == key_count)
+                continue;
+
+            uint32_t offset = 0;
+            for (uint32_t& count : histogram)
+            {
+                const uint32_t bucket_count = count;
+                count                       = offset;
+                offset += bucket_count;
+            }
+
+            for (size_t key_index = 0; key_index < key_count; ++key_index)
+            {
+                const uint32_t destination          = histogram[getRadixDigit(m_keys[key_index], digit)]++;
+                m_scratch_keys[destination]         = m_keys[key_index];
+                m_scratch_node_indices[destination] = m_node_indices[key_index];
+            }
+            m_keys.swap(m_scratch_keys);
+            m_node_indices.swap(m_scratch_node_indices);
+        }
+    }
+} // namespace Piccolo
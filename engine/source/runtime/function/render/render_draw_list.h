@@ -0,0 +1,76 @@
+#pragma once
+
+#include "runtime/core/math/matrix4.h"
+#include "runtime/core/math/vector3.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace Piccolo
+{
+    struct RenderMeshNode;
+    struct VulkanMesh;
+    struct VulkanPBRMaterial;
+
+    struct RenderDrawNode
+    {
+        const Matrix4x4* model_matrix {nullptr};
+        const Matrix4x4* joint_matrices {nullptr};
+        uint32_t         joint_count {0};
+        uint32_t         node_id {0};
+    };
+
+    /// consecutive nodes of the draw list sharing the same material and mesh, drawn instanced
+    struct RenderDrawBatch
+    {
+        VulkanPBRMaterial* material {nullptr};
+        VulkanMesh*        mesh {nullptr};
+        uint32_t           first_node {0};
+        uint32_t           node_count {0};
+    };
+
+    /// Builds the instanced batches of a pass from its visible mesh nodes.
+    /// Every node gets a 64 bit sort key, from the most to the least significant bits:
+    /// pipeline (8) | material (24) | mesh (24) | depth bucket (8).
+    /// The keys are radix sorted and a single walk over them emits one batch per material and mesh, nodes of a
+    /// batch are ordered from near to far when a view position is given. The arrays are kept between frames, a
+    /// list reused every frame stops allocating once it has seen its largest node count.
+    /// Passes that do not bind materials, like the shadow passes, leave the material out of the key so that a mesh
+    /// is drawn in a single batch whatever its materials.
+    class RenderDrawList
+    {
+    public:
+        static constexpr uint32_t s_pipeline_bits     = 8;
+        static constexpr uint32_t s_material_bits     = 24;
+        static constexpr uint32_t s_mesh_bits         = 24;
+        static constexpr uint32_t s_depth_bucket_bits = 8;
+
+        static uint64_t makeSortKey(uint32_t pipeline, uint32_t material, uint32_t mesh, uint32_t depth_bucket);
+        static uint32_t getDepthBucket(float distance);
+
+        void build(const std::vector<RenderMeshNode>& mesh_nodes,
+                   uint32_t                           pipeline,
+                   bool                               group_by_material,
+                   const Vector3*                     view_position = nullptr);
+        void clear();
+
+        const std::vector<RenderDrawNode>&  getNodes() const { return m_nodes; }
+        const std::vector<RenderDrawBatch>& getBatches() const { return m_batches; }
+
+        // duration of the last build in milliseconds
+        float getBuildTime() const { return m_build_time; }
+
+    private:
+        void sortKeys();
+
+        std::vector<uint64_t> m_keys;
+        std::vector<uint64_t> m_scratch_keys;
+        std::vector<uint32_t> m_node_indices;
+        std::vector<uint32_t> m_scratch_node_indices;
+
+        std::vector<RenderDrawNode>  m_nodes;
+        std::vector<RenderDrawBatch> m_batches;
+
+        float m_build_time {0.f};
+    };
+} // namespace Piccolo
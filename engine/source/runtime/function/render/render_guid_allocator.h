@@ -1,51 +1,99 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <unordered_map>
+#include <vector>
 
 namespace Piccolo
 {
     static const size_t s_invalid_guid = 0;
 
+    // guids keep their slot index plus one in the low bits and the slot generation above
+    static const size_t s_guid_index_bits = 24;
+    static const size_t s_guid_index_mask = (size_t(1) << s_guid_index_bits) - 1;
+
+    // position of a guid in dense per guid arrays, only meaningful for valid guids
+    inline size_t getGuidIndex(size_t guid) { return (guid & s_guid_index_mask) - 1; }
+
+    /// Hands out a small id per distinct element.
+    /// Guids are generational handles: the low bits hold the slot index plus one and the high bits the generation
+    /// of the slot, so a freed guid is not handed out again until its slot has been reused many times. Freed slots
+    /// are recycled through a free list and guid to element lookups index the dense slot array, only the element
+    /// to guid direction goes through a hash map. Guids fit in 32 bits since instance ids end up in the picking
+    /// buffer.
     template<typename T>
     class GuidAllocator
     {
+        static constexpr uint32_t s_generation_mask = 0xff;
+        static constexpr uint32_t s_null_slot       = std::numeric_limits<uint32_t>::max();
+
+        struct Slot
+        {
+            T        m_element {};
+            uint32_t m_generation {0};
+            // next free slot while the slot is in the free list
+            uint32_t m_next_free {s_null_slot};
+            bool     m_is_used {false};
+        };
+
     public:
         static bool isValidGuid(size_t guid) { return guid != s_invalid_guid; }
 
         size_t allocGuid(const T& t)
         {
-            auto find_it = m_elements_guid_map.find(t);
-            if (find_it != m_elements_guid_map.end())
+            bool is_new_guid;
+            return allocGuid(t, is_new_guid);
+        }
+
+        // looks t up and allocates a guid if it has none, with a single hash of t
+        size_t allocGuid(const T& t, bool& is_new_guid)
+        {
+            auto [find_it, is_inserted] = m_elements_guid_map.try_emplace(t, s_invalid_guid);
+            is_new_guid                 = is_inserted;
+            if (!is_inserted)
             {
                 return find_it->second;
             }
 
-            for (size_t i = 0; i < m_guid_elements_map.size() + 1; i++)
+            uint32_t slot_index = m_free_slot;
+            if (slot_index != s_null_slot)
             {
-                size_t guid = i + 1;
-                if (m_guid_elements_map.find(guid) == m_guid_elements_map.end())
-                {
-                    m_guid_elements_map.insert(std::make_pair(guid, t));
-                    m_elements_guid_map.insert(std::make_pair(t, guid));
-                    return guid;
-                }
+                m_free_slot = m_slots[slot_index].m_next_free;
+            }
+            else if (m_slots.size() < s_guid_index_mask)
+            {
+                slot_index = static_cast<uint32_t>(m_slots.size());
+                m_slots.emplace_back();
+            }
+            else
+            {
+                m_elements_guid_map.erase(find_it);
+                is_new_guid = false;
+                return s_invalid_guid;
             }
 
-            return s_invalid_guid;
+            Slot& slot       = m_slots[slot_index];
+            slot.m_element   = t;
+            slot.m_is_used   = true;
+            slot.m_next_free = s_null_slot;
+            find_it->second  = makeGuid(slot_index, slot.m_generation);
+            return find_it->second;
         }
 
-        bool getGuidRelatedElement(size_t guid, T& t)
+        bool getGuidRelatedElement(size_t guid, T& t) const
         {
-            auto find_it = m_guid_elements_map.find(guid);
-            if (find_it != m_guid_elements_map.end())
+            const Slot* slot = findSlot(guid);
+            if (slot != nullptr)
             {
-                t = find_it->second;
+                t = slot->m_element;
                 return true;
             }
             return false;
         }
 
-        bool getElementGuid(const T& t, size_t& guid)
+        bool getElementGuid(const T& t, size_t& guid) const
         {
             auto find_it = m_elements_guid_map.find(t);
             if (find_it != m_elements_guid_map.end())
@@ -56,16 +104,15 @@ namespace Piccolo
             return false;
         }
 
-        bool hasElement(const T& t) { return m_elements_guid_map.find(t) != m_elements_guid_map.end(); }
+        bool hasElement(const T& t) const { return m_elements_guid_map.find(t) != m_elements_guid_map.end(); }
 
         void freeGuid(size_t guid)
         {
-            auto find_it = m_guid_elements_map.find(guid);
-            if (find_it != m_guid_elements_map.end())
+            if (findSlot(guid) != nullptr)
             {
-                const auto& ele = find_it->second;
-                m_elements_guid_map.erase(ele);
-                m_guid_elements_map.erase(guid);
+                const uint32_t slot_index = static_cast<uint32_t>(getGuidIndex(guid));
+                m_elements_guid_map.erase(m_slots[slot_index].m_element);
+                releaseSlot(slot_index);
             }
         }
 
@@ -74,31 +121,69 @@ namespace Piccolo
             auto find_it = m_elements_guid_map.find(t);
             if (find_it != m_elements_guid_map.end())
             {
-                const auto& guid = find_it->second;
-                m_elements_guid_map.erase(t);
-                m_guid_elements_map.erase(guid);
+                const uint32_t slot_index = static_cast<uint32_t>(getGuidIndex(find_it->second));
+                m_elements_guid_map.erase(find_it);
+                releaseSlot(slot_index);
             }
         }
 
         std::vector<size_t> getAllocatedGuids() const
         {
             std::vector<size_t> allocated_guids;
-            for (const auto& ele : m_guid_elements_map)
+            allocated_guids.reserve(m_elements_guid_map.size());
+            for (uint32_t slot_index = 0; slot_index < m_slots.size(); ++slot_index)
             {
-                allocated_guids.push_back(ele.first);
+                if (m_slots[slot_index].m_is_used)
+                {
+                    allocated_guids.push_back(makeGuid(slot_index, m_slots[slot_index].m_generation));
+                }
             }
             return allocated_guids;
         }
 
+        size_t getAllocatedCount() const { return m_elements_guid_map.size(); }
+
         void clear()
         {
             m_elements_guid_map.clear();
-            m_guid_elements_map.clear();
+            m_slots.clear();
+            m_free_slot = s_null_slot;
         }
 
     private:
+        static size_t makeGuid(uint32_t slot_index, uint32_t generation)
+        {
+            return (static_cast<size_t>(generation & s_generation_mask) << s_guid_index_bits) | (slot_index + 1);
+        }
+
+        const Slot* findSlot(size_t guid) const
+        {
+            if ((guid & s_guid_index_mask) == 0)
+                return nullptr;
+
+            const size_t slot_index = getGuidIndex(guid);
+            if (slot_index >= m_slots.size())
+                return nullptr;
+
+            const Slot& slot = m_slots[slot_index];
+            if (!slot.m_is_used || makeGuid(static_cast<uint32_t>(slot_index), slot.m_generation) != guid)
+                return nullptr;
+            return &slot;
+        }
+
+        void releaseSlot(uint32_t slot_index)
+        {
+            Slot& slot       = m_slots[slot_index];
+            slot.m_element   = T {};
+            slot.m_is_used   = false;
+            slot.m_generation++;
+            slot.m_next_free = m_free_slot;
+            m_free_slot      = slot_index;
+        }
+
         std::unordered_map<T, size_t> m_elements_guid_map;
-        std::unordered_map<size_t, T> m_guid_elements_map;
+        std::vector<Slot>             m_slots;
+        uint32_t                      m_free_slot {s_null_slot};
     };
 
 } // namespace Piccolo
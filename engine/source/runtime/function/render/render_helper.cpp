@@ -2,6 +2,8 @@
 #include "runtime/function/render/render_camera.h"
 #include "runtime/function/render/render_scene.h"
 
+#include "runtime/core/math/simd.h"
+
 namespace Piccolo
 {
     ClusterFrustum CreateClusterFrustumFromMatrix(Matrix4x4 mat,
@@ -179,6 +181,86 @@ namespace Piccolo
         return true;
     }
 
+    void TiledFrustumIntersectBoxes(ClusterFrustum const&  f,
+                                    BoundingBoxBatch const& boxes,
+                                    std::vector<uint32_t>&  out_visible_bits)
+    {
+        const size_t box_count = boxes.size();
+        out_visible_bits.assign((box_count + 31) / 32, 0);
+
+        const Vector4* const planes[6] = {
+            &f.m_plane_right, &f.m_plane_left, &f.m_plane_top, &f.m_plane_bottom, &f.m_plane_near, &f.m_plane_far};
+
+        // the plane terms are evaluated in the same order as TiledFrustumIntersectBox, so both give the same result
+        auto is_box_visible = [&](size_t box_index) {
+            for (const Vector4* plane : planes)
+            {
+                const float signed_distance = plane->x * boxes.m_center_x[box_index] +
+                                              plane->y * boxes.m_center_y[box_index] +
+                                              plane->z * boxes.m_center_z[box_index] + plane->w;
+                const float radius = fabs(plane->x) * boxes.m_extent_x[box_index] +
+                                     fabs(plane->y) * boxes.m_extent_y[box_index] +
+                                     fabs(plane->z) * boxes.m_extent_z[box_index];
+                if (!(signed_distance < radius))
+                    return false;
+            }
+            return true;
+        };
+
+        size_t box_index = 0;
+#if PICCOLO_SIMD_SSE2
+        __m128 plane_x[6], plane_y[6], plane_z[6], plane_w[6];
+        __m128 plane_abs_x[6], plane_abs_y[6], plane_abs_z[6];
+        for (size_t plane_index = 0; plane_index < 6; plane_index++)
+        {
+            plane_x[plane_index]     = _mm_set1_ps(planes[plane_index]->x);
+            plane_y[plane_index]     = _mm_set1_ps(planes[plane_index]->y);
+            plane_z[plane_index]     = _mm_set1_ps(planes[plane_index]->z);
+            plane_w[plane_index]     = _mm_set1_ps(planes[plane_index]->w);
+            plane_abs_x[plane_index] = _mm_set1_ps(fabs(planes[plane_index]->x));
+            plane_abs_y[plane_index] = _mm_set1_ps(fabs(planes[plane_index]->y));
+            plane_abs_z[plane_index] = _mm_set1_ps(fabs(planes[plane_index]->z));
+        }
+
+        // no early out, all six planes are tested for four boxes and the lane masks are combined
+        for (; box_index + 4 <= box_count; box_index += 4)
+        {
+            const __m128 center_x = _mm_loadu_ps(boxes.m_center_x.data() + box_index);
+            const __m128 center_y = _mm_loadu_ps(boxes.m_center_y.data() + box_index);
+            const __m128 center_z = _mm_loadu_ps(boxes.m_center_z.data() + box_index);
+            const __m128 extent_x = _mm_loadu_ps(boxes.m_extent_x.data() + box_index);
+            const __m128 extent_y = _mm_loadu_ps(boxes.m_extent_y.data() + box_index);
+            const __m128 extent_z = _mm_loadu_ps(boxes.m_extent_z.data() + box_index);
+
+            __m128 visible = _mm_castsi128_ps(_mm_set1_epi32(-1));
+            for (size_t plane_index = 0; plane_index < 6; plane_index++)
+            {
+                __m128 signed_distance = _mm_mul_ps(plane_x[plane_index], center_x);
+                signed_distance        = _mm_add_ps(signed_distance, _mm_mul_ps(plane_y[plane_index], center_y));
+                signed_distance        = _mm_add_ps(signed_distance, _mm_mul_ps(plane_z[plane_index], center_z));
+                signed_distance        = _mm_add_ps(signed_distance, plane_w[plane_index]);
+
+                __m128 radius = _mm_mul_ps(plane_abs_x[plane_index], extent_x);
+                radius        = _mm_add_ps(radius, _mm_mul_ps(plane_abs_y[plane_index], extent_y));
+                radius        = _mm_add_ps(radius, _mm_mul_ps(plane_abs_z[plane_index], extent_z));
+
+                visible = _mm_and_ps(visible, _mm_cmplt_ps(signed_distance, radius));
+            }
+
+            // box_index is a multiple of four, the four bits never straddle two words
+            const uint32_t lane_bits = static_cast<uint32_t>(_mm_movemask_ps(visible));
+            out_visible_bits[box_index / 32] |= lane_bits << (box_index % 32);
+        }
+#endif
+        for (; box_index < box_count; box_index++)
+        {
+            if (is_box_visible(box_index))
+            {
+                out_visible_bits[box_index / 32] |= 1u << (box_index % 32);
+            }
+        }
+    }
+
     BoundingBox BoundingBoxTransform(BoundingBox const& b, Matrix4x4 const& m)
     {
         // we follow the "BoundingBox::Transform"
@@ -305,13 +387,9 @@ namespace Piccolo
             scene_bounding_box.min_bound = Vector3(FLT_MAX, FLT_MAX, FLT_MAX);
             scene_bounding_box.max_bound = Vector3(FLT_MIN, FLT_MIN, FLT_MIN);
 
-            for (const RenderEntity& entity : scene.m_render_entities)
+            // the world space bounds are cached by the scene when entities are added or moved
+            for (const BoundingBox& mesh_bounding_box_world : scene.getRenderEntityBounds())
             {
-                BoundingBox mesh_asset_bounding_box {entity.m_bounding_box.getMinCorner(),
-                                                     entity.m_bounding_box.getMaxCorner()};
-
-                BoundingBox mesh_bounding_box_world =
-                    BoundingBoxTransform(mesh_asset_bounding_box, entity.m_model_matrix);
                 scene_bounding_box.merge(mesh_bounding_box_world);
             }
         }
@@ -3,6 +3,10 @@
 #include "runtime/core/math/vector3.h"
 #include "runtime/core/math/vector4.h"
 
+#include <cstdint>
+#include <limits>
+#include <vector>
+
 namespace Piccolo
 {
     class RenderScene;
@@ -56,6 +60,39 @@ namespace Piccolo
         }
     };
 
+    // boxes as centers and half extents in separate arrays, the layout the batched culling functions work on
+    struct BoundingBoxBatch
+    {
+        std::vector<float> m_center_x;
+        std::vector<float> m_center_y;
+        std::vector<float> m_center_z;
+        std::vector<float> m_extent_x;
+        std::vector<float> m_extent_y;
+        std::vector<float> m_extent_z;
+
+        size_t size() const { return m_center_x.size(); }
+
+        void clear()
+        {
+            m_center_x.clear();
+            m_center_y.clear();
+            m_center_z.clear();
+            m_extent_x.clear();
+            m_extent_y.clear();
+            m_extent_z.clear();
+        }
+
+        void add(const BoundingBox& b)
+        {
+            m_center_x.push_back((b.max_bound.x + b.min_bound.x) * 0.5f);
+            m_center_y.push_back((b.max_bound.y + b.min_bound.y) * 0.5f);
+            m_center_z.push_back((b.max_bound.z + b.min_bound.z) * 0.5f);
+            m_extent_x.push_back((b.max_bound.x - b.min_bound.x) * 0.5f);
+            m_extent_y.push_back((b.max_bound.y - b.min_bound.y) * 0.5f);
+            m_extent_z.push_back((b.max_bound.z - b.min_bound.z) * 0.5f);
+        }
+    };
+
     struct BoundingSphere
     {
         Vector3   m_center;
@@ -77,6 +114,12 @@ namespace Piccolo
 
     bool TiledFrustumIntersectBox(ClusterFrustum const& f, BoundingBox const& b);
 
+    // same test as TiledFrustumIntersectBox for a batch of boxes, four boxes at a time with SSE2
+    // bit (i % 32) of out_visible_bits[i / 32] is set if box i intersects the frustum
+    void TiledFrustumIntersectBoxes(ClusterFrustum const&  f,
+                                    BoundingBoxBatch const& boxes,
+                                    std::vector<uint32_t>&  out_visible_bits);
+
     BoundingBox BoundingBoxTransform(BoundingBox const& b, Matrix4x4 const& m);
 
     bool BoxIntersectsWithSphere(BoundingBox const& b, BoundingSphere const& s);
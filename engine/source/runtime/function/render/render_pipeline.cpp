@@ -1,5 +1,5 @@
 #include "runtime/function/render/render_pipeline.h"
-#include "runtime/function/render/interface/vulkan/vulkan_rhi.h"
+#include "runtime/function/render/interface/rhi.h"
 
 #include "runtime/function/render/passes/color_grading_pass.h"
 #include "runtime/function/render/passes/combine_ui_pass.h"
@@ -115,17 +115,16 @@ namespace Piccolo
 
     void RenderPipeline::forwardRender(std::shared_ptr<RHI> rhi, std::shared_ptr<RenderResourceBase> render_resource)
     {
-        VulkanRHI*      vulkan_rhi      = static_cast<VulkanRHI*>(rhi.get());
         RenderResource* vulkan_resource = static_cast<RenderResource*>(render_resource.get());
 
-        vulkan_resource->resetRingBufferOffset(vulkan_rhi->m_current_frame_index);
+        vulkan_resource->resetRingBufferOffset(rhi->getCurrentFrameIndex());
 
-        vulkan_rhi->waitForFences();
+        rhi->waitForFences();
 
-        vulkan_rhi->resetCommandPool();
+        rhi->resetCommandPool();
 
         bool recreate_swapchain =
-            vulkan_rhi->prepareBeforePass(std::bind(&RenderPipeline::passUpdateAfterRecreateSwapchain, this));
+            rhi->prepareBeforePass(std::bind(&RenderPipeline::passUpdateAfterRecreateSwapchain, this));
         if (recreate_swapchain)
         {
             return;
@@ -153,29 +152,28 @@ namespace Piccolo
                           ui_pass,
                           combine_ui_pass,
                           particle_pass,
-                          vulkan_rhi->m_current_swapchain_image_index);
+                          rhi->getCurrentSwapchainImageIndex());
 
         
-        g_runtime_global_context.m_debugdraw_manager->draw(vulkan_rhi->m_current_swapchain_image_index);
+        g_runtime_global_context.m_debugdraw_manager->draw(rhi->getCurrentSwapchainImageIndex());
 
-        vulkan_rhi->submitRendering(std::bind(&RenderPipeline::passUpdateAfterRecreateSwapchain, this));
+        rhi->submitRendering(std::bind(&RenderPipeline::passUpdateAfterRecreateSwapchain, this));
         static_cast<ParticlePass*>(m_particle_pass.get())->copyNormalAndDepthImage();
         static_cast<ParticlePass*>(m_particle_pass.get())->simulate();
     }
 
     void RenderPipeline::deferredRender(std::shared_ptr<RHI> rhi, std::shared_ptr<RenderResourceBase> render_resource)
     {
-        VulkanRHI*      vulkan_rhi      = static_cast<VulkanRHI*>(rhi.get());
         RenderResource* vulkan_resource = static_cast<RenderResource*>(render_resource.get());
 
-        vulkan_resource->resetRingBufferOffset(vulkan_rhi->m_current_frame_index);
+        vulkan_resource->resetRingBufferOffset(rhi->getCurrentFrameIndex());
 
-        vulkan_rhi->waitForFences();
+        rhi->waitForFences();
 
-        vulkan_rhi->resetCommandPool();
+        rhi->resetCommandPool();
 
         bool recreate_swapchain =
-            vulkan_rhi->prepareBeforePass(std::bind(&RenderPipeline::passUpdateAfterRecreateSwapchain, this));
+            rhi->prepareBeforePass(std::bind(&RenderPipeline::passUpdateAfterRecreateSwapchain, this));
         if (recreate_swapchain)
         {
             return;
@@ -203,11 +201,11 @@ namespace Piccolo
                    ui_pass,
                    combine_ui_pass,
                    particle_pass,
-                   vulkan_rhi->m_current_swapchain_image_index);
+                   rhi->getCurrentSwapchainImageIndex());
                    
-        g_runtime_global_context.m_debugdraw_manager->draw(vulkan_rhi->m_current_swapchain_image_index);
+        g_runtime_global_context.m_debugdraw_manager->draw(rhi->getCurrentSwapchainImageIndex());
 
-        vulkan_rhi->submitRendering(std::bind(&RenderPipeline::passUpdateAfterRecreateSwapchain, this));
+        rhi->submitRendering(std::bind(&RenderPipeline::passUpdateAfterRecreateSwapchain, this));
         static_cast<ParticlePass*>(m_particle_pass.get())->copyNormalAndDepthImage();
         static_cast<ParticlePass*>(m_particle_pass.get())->simulate();
     }
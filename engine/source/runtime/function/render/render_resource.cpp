@@ -4,7 +4,6 @@
 #include "runtime/function/render/render_helper.h"
 
 #include "runtime/function/render/render_mesh.h"
-#include "runtime/function/render/interface/vulkan/vulkan_rhi.h"
 #include "runtime/function/render/interface/vulkan/vulkan_util.h"
 
 #include "runtime/function/render/passes/main_camera_pass.h"
@@ -168,8 +167,6 @@ namespace Piccolo
 
     void RenderResource::createIBLSamplers(std::shared_ptr<RHI> rhi)
     {
-        VulkanRHI* raw_rhi = static_cast<VulkanRHI*>(rhi.get());
-
         RHIPhysicalDeviceProperties physical_device_properties{};
         rhi->getPhysicalDeviceProperties(&physical_device_properties);
 
@@ -273,25 +270,24 @@ namespace Piccolo
     {
         size_t assetid = entity.m_mesh_asset_id;
 
-        auto it = m_vulkan_meshes.find(assetid);
-        if (it != m_vulkan_meshes.end())
+        auto [vulkan_mesh, is_created] =
+            m_vulkan_meshes.getOrCreate(assetid, [&](VulkanMesh& mesh) { releaseVulkanMesh(*rhi, mesh); });
+        if (!is_created)
         {
-            return it->second;
+            return *vulkan_mesh;
         }
         else
         {
-            VulkanMesh temp;
-            auto       res = m_vulkan_meshes.insert(std::make_pair(assetid, std::move(temp)));
-            assert(res.second);
 
             uint32_t index_buffer_size = static_cast<uint32_t>(mesh_data.m_static_mesh_data.m_index_buffer->m_size);
             void* index_buffer_data = mesh_data.m_static_mesh_data.m_index_buffer->m_data;
+            RHIIndexType index_type  = mesh_data.m_static_mesh_data.m_index_type;
 
             uint32_t vertex_buffer_size = static_cast<uint32_t>(mesh_data.m_static_mesh_data.m_vertex_buffer->m_size);
             MeshVertexDataDefinition* vertex_buffer_data =
                 reinterpret_cast<MeshVertexDataDefinition*>(mesh_data.m_static_mesh_data.m_vertex_buffer->m_data);
 
-            VulkanMesh& now_mesh = res.first->second;
+            VulkanMesh& now_mesh = *vulkan_mesh;
 
             if (mesh_data.m_skeleton_binding_buffer)
             {
@@ -300,6 +296,7 @@ namespace Piccolo
                     reinterpret_cast<MeshVertexBindingDataDefinition*>(mesh_data.m_skeleton_binding_buffer->m_data);
                 updateMeshData(rhi,
                                true,
+                               index_type,
                                index_buffer_size,
                                index_buffer_data,
                                vertex_buffer_size,
@@ -312,6 +309,7 @@ namespace Piccolo
             {
                 updateMeshData(rhi,
                                false,
+                               index_type,
                                index_buffer_size,
                                index_buffer_data,
                                vertex_buffer_size,
@@ -329,20 +327,16 @@ namespace Piccolo
         RenderEntity         entity,
         RenderMaterialData   material_data)
     {
-        VulkanRHI* vulkan_context = static_cast<VulkanRHI*>(rhi.get());
-
         size_t assetid = entity.m_material_asset_id;
 
-        auto it = m_vulkan_pbr_materials.find(assetid);
-        if (it != m_vulkan_pbr_materials.end())
+        auto [vulkan_material, is_created] = m_vulkan_pbr_materials.getOrCreate(
+            assetid, [&](VulkanPBRMaterial& material) { releaseVulkanMaterial(*rhi, material); });
+        if (!is_created)
         {
-            return it->second;
+            return *vulkan_material;
         }
         else
         {
-            VulkanPBRMaterial temp;
-            auto              res = m_vulkan_pbr_materials.insert(std::make_pair(assetid, std::move(temp)));
-            assert(res.second);
 
             float empty_image[] = { 0.5f, 0.5f, 0.5f, 0.5f };
 
@@ -406,7 +400,7 @@ namespace Piccolo
                 emissive_image_format = material_data.m_emissive_texture->m_format;
             }
 
-            VulkanPBRMaterial& now_material = res.first->second;
+            VulkanPBRMaterial& now_material = *vulkan_material;
 
             // similiarly to the vertex/index buffer, we should allocate the uniform
             // buffer in DEVICE_LOCAL memory and use the temp stage buffer to copy the
@@ -457,7 +451,7 @@ namespace Piccolo
                 allocInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
 
                 rhi->createBufferWithAlignmentVMA(
-                    vulkan_context->m_assets_allocator,
+                    rhi->getAssetsAllocator(),
                     &bufferInfo,
                     &allocInfo,
                     m_global_render_resource._storage_buffer._min_uniform_buffer_offset_alignment,
@@ -501,7 +495,7 @@ namespace Piccolo
             RHIDescriptorSetAllocateInfo material_descriptor_set_alloc_info;
             material_descriptor_set_alloc_info.sType = RHI_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
             material_descriptor_set_alloc_info.pNext = NULL;
-            material_descriptor_set_alloc_info.descriptorPool = vulkan_context->m_descriptor_pool;
+            material_descriptor_set_alloc_info.descriptorPool = rhi->getDescriptorPoor();
             material_descriptor_set_alloc_info.descriptorSetCount = 1;
             material_descriptor_set_alloc_info.pSetLayouts        = m_material_descriptor_set_layout;
 
@@ -587,8 +581,71 @@ namespace Piccolo
         }
     }
 
+    void RenderResource::releaseVulkanMesh(RHI& rhi, VulkanMesh& mesh)
+    {
+        // the frames in flight may still draw the mesh
+        rhi.queueWaitIdle(rhi.getGraphicsQueue());
+
+        VmaAllocator allocator = rhi.getAssetsAllocator();
+        auto destroy_buffer    = [&](RHIBuffer*& buffer, VmaAllocation allocation) {
+            if (buffer != nullptr)
+            {
+                rhi.destroyBufferVMA(allocator, buffer, allocation);
+            }
+        };
+        destroy_buffer(mesh.mesh_vertex_position_buffer, mesh.mesh_vertex_position_buffer_allocation);
+        destroy_buffer(mesh.mesh_vertex_varying_enable_blending_buffer,
+                       mesh.mesh_vertex_varying_enable_blending_buffer_allocation);
+        destroy_buffer(mesh.mesh_vertex_joint_binding_buffer, mesh.mesh_vertex_joint_binding_buffer_allocation);
+        destroy_buffer(mesh.mesh_vertex_varying_buffer, mesh.mesh_vertex_varying_buffer_allocation);
+        destroy_buffer(mesh.mesh_index_buffer, mesh.mesh_index_buffer_allocation);
+        if (mesh.mesh_vertex_blending_descriptor_set != nullptr)
+        {
+            rhi.freeDescriptorSet(rhi.getDescriptorPoor(), mesh.mesh_vertex_blending_descriptor_set);
+        }
+    }
+
+    void RenderResource::releaseVulkanMaterial(RHI& rhi, VulkanPBRMaterial& material)
+    {
+        // the frames in flight may still draw the material
+        rhi.queueWaitIdle(rhi.getGraphicsQueue());
+
+        VmaAllocator allocator     = rhi.getAssetsAllocator();
+        auto         destroy_image = [&](RHIImage*& image, RHIImageView* image_view, VmaAllocation allocation) {
+            if (image_view != nullptr)
+            {
+                rhi.destroyImageView(image_view);
+            }
+            if (image != nullptr)
+            {
+                rhi.destroyImageVMA(allocator, image, allocation);
+            }
+        };
+        destroy_image(material.base_color_texture_image,
+                      material.base_color_image_view,
+                      material.base_color_image_allocation);
+        destroy_image(material.metallic_roughness_texture_image,
+                      material.metallic_roughness_image_view,
+                      material.metallic_roughness_image_allocation);
+        destroy_image(material.normal_texture_image, material.normal_image_view, material.normal_image_allocation);
+        destroy_image(
+            material.occlusion_texture_image, material.occlusion_image_view, material.occlusion_image_allocation);
+        destroy_image(
+            material.emissive_texture_image, material.emissive_image_view, material.emissive_image_allocation);
+        if (material.material_uniform_buffer != nullptr)
+        {
+            rhi.destroyBufferVMA(
+                allocator, material.material_uniform_buffer, material.material_uniform_buffer_allocation);
+        }
+        if (material.material_descriptor_set != nullptr)
+        {
+            rhi.freeDescriptorSet(rhi.getDescriptorPoor(), material.material_descriptor_set);
+        }
+    }
+
     void RenderResource::updateMeshData(std::shared_ptr<RHI>                   rhi,
                                         bool                                   enable_vertex_blending,
+                                        RHIIndexType                           index_type,
                                         uint32_t                               index_buffer_size,
                                         void*                                  index_buffer_data,
                                         uint32_t                               vertex_buffer_size,
@@ -606,11 +663,11 @@ namespace Piccolo
                            vertex_buffer_data,
                            joint_binding_buffer_size,
                            joint_binding_buffer_data,
-                           index_buffer_size,
-                           reinterpret_cast<uint16_t*>(index_buffer_data),
                            now_mesh);
-        assert(0 == (index_buffer_size % sizeof(uint16_t)));
-        now_mesh.mesh_index_count = index_buffer_size / sizeof(uint16_t);
+        const uint32_t index_size = index_type == RHI_INDEX_TYPE_UINT32 ? sizeof(uint32_t) : sizeof(uint16_t);
+        assert(0 == (index_buffer_size % index_size));
+        now_mesh.mesh_index_type  = index_type;
+        now_mesh.mesh_index_count = index_buffer_size / index_size;
         updateIndexBuffer(rhi, index_buffer_size, index_buffer_data, now_mesh);
     }
 
@@ -620,25 +677,21 @@ namespace Piccolo
                                             MeshVertexDataDefinition const*        vertex_buffer_data,
                                             uint32_t                               joint_binding_buffer_size,
                                             MeshVertexBindingDataDefinition const* joint_binding_buffer_data,
-                                            uint32_t                               index_buffer_size,
-                                            uint16_t*                              index_buffer_data,
                                             VulkanMesh&                            now_mesh)
     {
-        VulkanRHI* vulkan_context = static_cast<VulkanRHI*>(rhi.get());
-
         if (enable_vertex_blending)
         {
             assert(0 == (vertex_buffer_size % sizeof(MeshVertexDataDefinition)));
             uint32_t vertex_count = vertex_buffer_size / sizeof(MeshVertexDataDefinition);
-            assert(0 == (index_buffer_size % sizeof(uint16_t)));
-            uint32_t index_count = index_buffer_size / sizeof(uint16_t);
+            // the shaders read the bindings with gl_VertexIndex, so there is one per vertex
+            assert(joint_binding_buffer_size >= vertex_count * sizeof(MeshVertexBindingDataDefinition));
 
             RHIDeviceSize vertex_position_buffer_size = sizeof(MeshVertex::VulkanMeshVertexPostition) * vertex_count;
             RHIDeviceSize vertex_varying_enable_blending_buffer_size =
                 sizeof(MeshVertex::VulkanMeshVertexVaryingEnableBlending) * vertex_count;
             RHIDeviceSize vertex_varying_buffer_size = sizeof(MeshVertex::VulkanMeshVertexVarying) * vertex_count;
             RHIDeviceSize vertex_joint_binding_buffer_size =
-                sizeof(MeshVertex::VulkanMeshVertexJointBinding) * index_count;
+                sizeof(MeshVertex::VulkanMeshVertexJointBinding) * vertex_count;
 
             RHIDeviceSize vertex_position_buffer_offset = 0;
             RHIDeviceSize vertex_varying_enable_blending_buffer_offset =
@@ -700,16 +753,14 @@ namespace Piccolo
                     Vector2(vertex_buffer_data[vertex_index].u, vertex_buffer_data[vertex_index].v);
             }
 
-            for (uint32_t index_index = 0; index_index < index_count; ++index_index)
+            for (uint32_t vertex_buffer_index = 0; vertex_buffer_index < vertex_count; ++vertex_buffer_index)
             {
-                uint32_t vertex_buffer_index = index_buffer_data[index_index];
-
                 // TODO: move to assets loading process
 
-                mesh_vertex_joint_binding[index_index].indices[0] = joint_binding_buffer_data[vertex_buffer_index].m_index0;
-                mesh_vertex_joint_binding[index_index].indices[1] = joint_binding_buffer_data[vertex_buffer_index].m_index1;
-                mesh_vertex_joint_binding[index_index].indices[2] = joint_binding_buffer_data[vertex_buffer_index].m_index2;
-                mesh_vertex_joint_binding[index_index].indices[3] = joint_binding_buffer_data[vertex_buffer_index].m_index3;
+                mesh_vertex_joint_binding[vertex_buffer_index].indices[0] = joint_binding_buffer_data[vertex_buffer_index].m_index0;
+                mesh_vertex_joint_binding[vertex_buffer_index].indices[1] = joint_binding_buffer_data[vertex_buffer_index].m_index1;
+                mesh_vertex_joint_binding[vertex_buffer_index].indices[2] = joint_binding_buffer_data[vertex_buffer_index].m_index2;
+                mesh_vertex_joint_binding[vertex_buffer_index].indices[3] = joint_binding_buffer_data[vertex_buffer_index].m_index3;
 
                 float inv_total_weight = joint_binding_buffer_data[vertex_buffer_index].m_weight0 +
                                          joint_binding_buffer_data[vertex_buffer_index].m_weight1 +
@@ -718,7 +769,7 @@ namespace Piccolo
 
                 inv_total_weight = (inv_total_weight != 0.0) ? 1 / inv_total_weight : 1.0;
 
-                mesh_vertex_joint_binding[index_index].weights =
+                mesh_vertex_joint_binding[vertex_buffer_index].weights =
                     Vector4(joint_binding_buffer_data[vertex_buffer_index].m_weight0 * inv_total_weight,
                         joint_binding_buffer_data[vertex_buffer_index].m_weight1 * inv_total_weight,
                         joint_binding_buffer_data[vertex_buffer_index].m_weight2 * inv_total_weight,
@@ -735,21 +786,21 @@ namespace Piccolo
 
             bufferInfo.usage = RHI_BUFFER_USAGE_VERTEX_BUFFER_BIT | RHI_BUFFER_USAGE_TRANSFER_DST_BIT;
             bufferInfo.size = vertex_position_buffer_size;
-            rhi->createBufferVMA(vulkan_context->m_assets_allocator,
+            rhi->createBufferVMA(rhi->getAssetsAllocator(),
                                  &bufferInfo,
                                  &allocInfo,
                                  now_mesh.mesh_vertex_position_buffer,
                                  &now_mesh.mesh_vertex_position_buffer_allocation,
                                  NULL);
             bufferInfo.size = vertex_varying_enable_blending_buffer_size;
-            rhi->createBufferVMA(vulkan_context->m_assets_allocator,
+            rhi->createBufferVMA(rhi->getAssetsAllocator(),
                                  &bufferInfo,
                                  &allocInfo,
                                  now_mesh.mesh_vertex_varying_enable_blending_buffer,
                                  &now_mesh.mesh_vertex_varying_enable_blending_buffer_allocation,
                                  NULL);
             bufferInfo.size = vertex_varying_buffer_size;
-            rhi->createBufferVMA(vulkan_context->m_assets_allocator,
+            rhi->createBufferVMA(rhi->getAssetsAllocator(),
                                  &bufferInfo,
                                  &allocInfo,
                                  now_mesh.mesh_vertex_varying_buffer,
@@ -758,7 +809,7 @@ namespace Piccolo
 
             bufferInfo.usage = RHI_BUFFER_USAGE_STORAGE_BUFFER_BIT | RHI_BUFFER_USAGE_TRANSFER_DST_BIT;
             bufferInfo.size = vertex_joint_binding_buffer_size;
-            rhi->createBufferVMA(vulkan_context->m_assets_allocator,
+            rhi->createBufferVMA(rhi->getAssetsAllocator(),
                                  &bufferInfo,
                                  &allocInfo,
                                  now_mesh.mesh_vertex_joint_binding_buffer,
@@ -796,7 +847,7 @@ namespace Piccolo
             mesh_vertex_blending_per_mesh_descriptor_set_alloc_info.sType =
                 RHI_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
             mesh_vertex_blending_per_mesh_descriptor_set_alloc_info.pNext = NULL;
-            mesh_vertex_blending_per_mesh_descriptor_set_alloc_info.descriptorPool = vulkan_context->m_descriptor_pool;
+            mesh_vertex_blending_per_mesh_descriptor_set_alloc_info.descriptorPool = rhi->getDescriptorPoor();
             mesh_vertex_blending_per_mesh_descriptor_set_alloc_info.descriptorSetCount = 1;
             mesh_vertex_blending_per_mesh_descriptor_set_alloc_info.pSetLayouts        = m_mesh_descriptor_set_layout;
 
@@ -912,21 +963,21 @@ namespace Piccolo
             allocInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
 
             bufferInfo.size = vertex_position_buffer_size;
-            rhi->createBufferVMA(vulkan_context->m_assets_allocator,
+            rhi->createBufferVMA(rhi->getAssetsAllocator(),
                                  &bufferInfo,
                                  &allocInfo,
                                  now_mesh.mesh_vertex_position_buffer,
                                  &now_mesh.mesh_vertex_position_buffer_allocation,
                                  NULL);
             bufferInfo.size = vertex_varying_enable_blending_buffer_size;
-            rhi->createBufferVMA(vulkan_context->m_assets_allocator,
+            rhi->createBufferVMA(rhi->getAssetsAllocator(),
                                  &bufferInfo,
                                  &allocInfo,
                                  now_mesh.mesh_vertex_varying_enable_blending_buffer,
                                  &now_mesh.mesh_vertex_varying_enable_blending_buffer_allocation,
                                  NULL);
             bufferInfo.size = vertex_varying_buffer_size;
-            rhi->createBufferVMA(vulkan_context->m_assets_allocator,
+            rhi->createBufferVMA(rhi->getAssetsAllocator(),
                                  &bufferInfo,
                                  &allocInfo,
                                  now_mesh.mesh_vertex_varying_buffer,
@@ -959,7 +1010,7 @@ namespace Piccolo
             mesh_vertex_blending_per_mesh_descriptor_set_alloc_info.sType =
                 RHI_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
             mesh_vertex_blending_per_mesh_descriptor_set_alloc_info.pNext = NULL;
-            mesh_vertex_blending_per_mesh_descriptor_set_alloc_info.descriptorPool = vulkan_context->m_descriptor_pool;
+            mesh_vertex_blending_per_mesh_descriptor_set_alloc_info.descriptorPool = rhi->getDescriptorPoor();
             mesh_vertex_blending_per_mesh_descriptor_set_alloc_info.descriptorSetCount = 1;
             mesh_vertex_blending_per_mesh_descriptor_set_alloc_info.pSetLayouts        = m_mesh_descriptor_set_layout;
 
@@ -1008,8 +1059,6 @@ namespace Piccolo
                                            void*                index_buffer_data,
                                            VulkanMesh&          now_mesh)
     {
-        VulkanRHI* vulkan_context = static_cast<VulkanRHI*>(rhi.get());
-
         // temp staging buffer
         RHIDeviceSize buffer_size = index_buffer_size;
 
@@ -1034,7 +1083,7 @@ namespace Piccolo
         VmaAllocationCreateInfo allocInfo = {};
         allocInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
 
-        rhi->createBufferVMA(vulkan_context->m_assets_allocator,
+        rhi->createBufferVMA(rhi->getAssetsAllocator(),
                              &bufferInfo,
                              &allocInfo,
                              now_mesh.mesh_index_buffer,
@@ -1097,14 +1146,12 @@ namespace Piccolo
             texture_data.emissive_image_format);
     }
 
-    VulkanMesh& RenderResource::getEntityMesh(RenderEntity entity)
+    VulkanMesh& RenderResource::getEntityMesh(const RenderEntity& entity)
     {
-        size_t assetid = entity.m_mesh_asset_id;
-
-        auto it = m_vulkan_meshes.find(assetid);
-        if (it != m_vulkan_meshes.end())
+        VulkanMesh* vulkan_mesh = m_vulkan_meshes.tryGet(getResidentMeshAssetId(entity));
+        if (vulkan_mesh != nullptr)
         {
-            return it->second;
+            return *vulkan_mesh;
         }
         else
         {
@@ -1112,14 +1159,12 @@ namespace Piccolo
         }
     }
 
-    VulkanPBRMaterial& RenderResource::getEntityMaterial(RenderEntity entity)
+    VulkanPBRMaterial& RenderResource::getEntityMaterial(const RenderEntity& entity)
     {
-        size_t assetid = entity.m_material_asset_id;
-
-        auto it = m_vulkan_pbr_materials.find(assetid);
-        if (it != m_vulkan_pbr_materials.end())
+        VulkanPBRMaterial* vulkan_material = m_vulkan_pbr_materials.tryGet(getResidentMaterialAssetId(entity));
+        if (vulkan_material != nullptr)
         {
-            return it->second;
+            return *vulkan_material;
         }
         else
         {
@@ -1127,6 +1172,17 @@ namespace Piccolo
         }
     }
 
+    size_t RenderResource::getResidentMeshAssetId(const RenderEntity& entity)
+    {
+        return m_vulkan_meshes.tryGet(entity.m_mesh_asset_id) ? entity.m_mesh_asset_id : m_placeholder_mesh_asset_id;
+    }
+
+    size_t RenderResource::getResidentMaterialAssetId(const RenderEntity& entity)
+    {
+        return m_vulkan_pbr_materials.tryGet(entity.m_material_asset_id) ? entity.m_material_asset_id :
+                                                                           m_placeholder_material_asset_id;
+    }
+
     void RenderResource::resetRingBufferOffset(uint8_t current_frame_index)
     {
         m_global_render_resource._storage_buffer._global_upload_ringbuffers_end[current_frame_index] =
@@ -1135,9 +1191,8 @@ namespace Piccolo
 
     void RenderResource::createAndMapStorageBuffer(std::shared_ptr<RHI> rhi)
     {
-        VulkanRHI* raw_rhi = static_cast<VulkanRHI*>(rhi.get());
         StorageBuffer& _storage_buffer = m_global_render_resource._storage_buffer;
-        uint32_t       frames_in_flight = raw_rhi->k_max_frames_in_flight;
+        uint32_t       frames_in_flight = rhi->getMaxFramesInFlight();
 
         RHIPhysicalDeviceProperties properties;
         rhi->getPhysicalDeviceProperties(&properties);
@@ -5,6 +5,7 @@
 #include "runtime/function/render/interface/rhi.h"
 
 #include "runtime/function/render/render_common.h"
+#include "runtime/function/render/render_resource_table.h"
 
 #include <vk_mem_alloc.h>
 #include <vulkan/vulkan.h>
@@ -125,9 +126,13 @@ namespace Piccolo
         virtual void updatePerFrameBuffer(std::shared_ptr<RenderScene>  render_scene,
             std::shared_ptr<RenderCamera> camera) override final;
 
-        VulkanMesh& getEntityMesh(RenderEntity entity);
+        // meshes and materials that are not uploaded yet resolve to the placeholders
+        VulkanMesh& getEntityMesh(const RenderEntity& entity);
 
-        VulkanPBRMaterial& getEntityMaterial(RenderEntity entity);
+        VulkanPBRMaterial& getEntityMaterial(const RenderEntity& entity);
+
+        size_t getResidentMeshAssetId(const RenderEntity& entity);
+        size_t getResidentMaterialAssetId(const RenderEntity& entity);
 
         void resetRingBufferOffset(uint8_t current_frame_index);
 
@@ -145,8 +150,12 @@ namespace Piccolo
         ParticleCollisionPerframeStorageBufferObject   m_particle_collision_perframe_storage_buffer_object;
 
         // cached mesh and material
-        std::map<size_t, VulkanMesh>        m_vulkan_meshes;
-        std::map<size_t, VulkanPBRMaterial> m_vulkan_pbr_materials;
+        RenderResourceTable<VulkanMesh>        m_vulkan_meshes;
+        RenderResourceTable<VulkanPBRMaterial> m_vulkan_pbr_materials;
+
+        // drawn in place of assets the streamer has not delivered yet, uploaded when the render system starts
+        size_t m_placeholder_mesh_asset_id {s_invalid_guid};
+        size_t m_placeholder_material_asset_id {s_invalid_guid};
 
         // descriptor set layout in main camera pass will be used when uploading resource
         RHIDescriptorSetLayout* const* m_mesh_descriptor_set_layout {nullptr};
@@ -162,9 +171,13 @@ namespace Piccolo
         VulkanMesh& getOrCreateVulkanMesh(std::shared_ptr<RHI> rhi, RenderEntity entity, RenderMeshData mesh_data);
         VulkanPBRMaterial&
         getOrCreateVulkanMaterial(std::shared_ptr<RHI> rhi, RenderEntity entity, RenderMaterialData material_data);
+        // destroy the gpu objects of a mesh or material whose asset guid was freed, once no frame uses them anymore
+        void releaseVulkanMesh(RHI& rhi, VulkanMesh& mesh);
+        void releaseVulkanMaterial(RHI& rhi, VulkanPBRMaterial& material);
 
         void updateMeshData(std::shared_ptr<RHI>                          rhi,
                             bool                                          enable_vertex_blending,
+                            RHIIndexType                                  index_type,
                             uint32_t                                      index_buffer_size,
                             void*                                         index_buffer_data,
                             uint32_t                                      vertex_buffer_size,
@@ -178,8 +191,6 @@ namespace Piccolo
                                 struct MeshVertexDataDefinition const*        vertex_buffer_data,
                                 uint32_t                                      joint_binding_buffer_size,
                                 struct MeshVertexBindingDataDefinition const* joint_binding_buffer_data,
-                                uint32_t                                      index_buffer_size,
-                                uint16_t*                                     index_buffer_data,
                                 VulkanMesh&                                   now_mesh);
         void updateIndexBuffer(std::shared_ptr<RHI> rhi,
                                uint32_t             index_buffer_size,
@@ -1,4 +1,5 @@
 #include "runtime/function/render/render_resource_base.h"
+#include "runtime/function/render/render_cooked_mesh.h"
 
 #include "runtime/core/base/macro.h"
 
@@ -16,10 +17,22 @@
 
 #include <algorithm>
 #include <filesystem>
+#include <fstream>
 #include <vector>
 
 namespace Piccolo
 {
+    namespace
+    {
+        // cube.obj is cooked to cube.obj.cooked, so meshes with the same stem do not collide
+        std::filesystem::path getCookedMeshPath(const std::string& mesh_file)
+        {
+            std::filesystem::path cooked_mesh_path = g_runtime_global_context.m_asset_manager->getFullPath(mesh_file);
+            cooked_mesh_path += ".cooked";
+            return cooked_mesh_path;
+        }
+    } // namespace
+
     std::shared_ptr<TextureData> RenderResourceBase::loadTextureHDR(std::string file, int desired_channels)
     {
         std::shared_ptr<AssetManager> asset_manager = g_runtime_global_context.m_asset_manager;
@@ -59,13 +72,64 @@ namespace Piccolo
 
     std::shared_ptr<TextureData> RenderResourceBase::loadTexture(std::string file, bool is_srgb)
     {
+        std::vector<uint8_t> file_data;
+        if (!readAssetFile(file, file_data))
+            return nullptr;
+
+        return decodeTexture(file_data, is_srgb);
+    }
+
+    RenderMeshData RenderResourceBase::loadMeshData(const MeshSourceDesc& source, AxisAlignedBox& bounding_box)
+    {
+        RenderMeshData       ret;
+        std::vector<uint8_t> file_data;
+        if (std::shared_ptr<CookedMesh> cooked_mesh = mapCookedMesh(source))
+        {
+            getCookedMeshData(cooked_mesh, ret, bounding_box);
+        }
+        else if (!readAssetFile(source.m_mesh_file, file_data) || !decodeMeshData(source, file_data, ret, bounding_box))
+        {
+            LOG_ERROR("load mesh {} failed, the placeholder is used instead", source.m_mesh_file);
+            bounding_box = AxisAlignedBox();
+            ret          = createPlaceholderMeshData(bounding_box);
+        }
+
+        cacheBoundingBox(source, bounding_box);
+
+        return ret;
+    }
+
+    bool RenderResourceBase::readAssetFile(const std::string& file, std::vector<uint8_t>& file_data)
+    {
+        if (file.empty())
+            return false;
+
         std::shared_ptr<AssetManager> asset_manager = g_runtime_global_context.m_asset_manager;
         ASSERT(asset_manager);
 
+        std::ifstream asset_file(asset_manager->getFullPath(file), std::ios::binary | std::ios::ate);
+        if (!asset_file)
+            return false;
+
+        const std::streamsize file_size = asset_file.tellg();
+        if (file_size <= 0)
+            return false;
+
+        file_data.resize(static_cast<size_t>(file_size));
+        asset_file.seekg(0);
+        return static_cast<bool>(asset_file.read(reinterpret_cast<char*>(file_data.data()), file_size));
+    }
+
+    std::shared_ptr<TextureData> RenderResourceBase::decodeTexture(const std::vector<uint8_t>& file_data, bool is_srgb)
+    {
+        if (file_data.empty())
+            return nullptr;
+
         std::shared_ptr<TextureData> texture = std::make_shared<TextureData>();
 
         int iw, ih, n;
-        texture->m_pixels = stbi_load(asset_manager->getFullPath(file).generic_string().c_str(), &iw, &ih, &n, 4);
+        texture->m_pixels =
+            stbi_load_from_memory(file_data.data(), static_cast<int>(file_data.size()), &iw, &ih, &n, 4);
 
         if (!texture->m_pixels)
             return nullptr;
@@ -82,74 +146,146 @@ namespace Piccolo
         return texture;
     }
 
-    RenderMeshData RenderResourceBase::loadMeshData(const MeshSourceDesc& source, AxisAlignedBox& bounding_box)
+    bool RenderResourceBase::decodeMeshData(const MeshSourceDesc&       source,
+                                            const std::vector<uint8_t>& file_data,
+                                            RenderMeshData&             ret,
+                                            AxisAlignedBox&             bounding_box)
     {
-        std::shared_ptr<AssetManager> asset_manager = g_runtime_global_context.m_asset_manager;
-        ASSERT(asset_manager);
-
-        RenderMeshData ret;
-
+        MeshCookSource mesh;
         if (std::filesystem::path(source.m_mesh_file).extension() == ".obj")
         {
-            ret.m_static_mesh_data = loadStaticMesh(source.m_mesh_file, bounding_box);
+            const std::string file_text(file_data.begin(), file_data.end());
+            if (!loadStaticMesh(file_text, source.m_mesh_file, mesh))
+                return false;
         }
         else if (std::filesystem::path(source.m_mesh_file).extension() == ".json")
         {
             std::shared_ptr<MeshData> bind_data = std::make_shared<MeshData>();
-            asset_manager->loadAsset<MeshData>(source.m_mesh_file, *bind_data);
+
+            JsonReader reader(reinterpret_cast<const char*>(file_data.data()), file_data.size());
+            if (!StreamSerializer::read(reader, *bind_data) || !reader.finish())
+            {
+                LOG_ERROR("parse json file {} failed: {} at offset {}",
+                          source.m_mesh_file,
+                          reader.getError(),
+                          reader.getErrorOffset());
+                return false;
+            }
 
             // vertex buffer
-            size_t vertex_size                     = bind_data->vertex_buffer.size() * sizeof(MeshVertexDataDefinition);
-            ret.m_static_mesh_data.m_vertex_buffer = std::make_shared<BufferData>(vertex_size);
-            MeshVertexDataDefinition* vertex =
-                (MeshVertexDataDefinition*)ret.m_static_mesh_data.m_vertex_buffer->m_data;
+            mesh.m_vertices.resize(bind_data->vertex_buffer.size());
             for (size_t i = 0; i < bind_data->vertex_buffer.size(); i++)
             {
-                vertex[i].x  = bind_data->vertex_buffer[i].px;
-                vertex[i].y  = bind_data->vertex_buffer[i].py;
-                vertex[i].z  = bind_data->vertex_buffer[i].pz;
-                vertex[i].nx = bind_data->vertex_buffer[i].nx;
-                vertex[i].ny = bind_data->vertex_buffer[i].ny;
-                vertex[i].nz = bind_data->vertex_buffer[i].nz;
-                vertex[i].tx = bind_data->vertex_buffer[i].tx;
-                vertex[i].ty = bind_data->vertex_buffer[i].ty;
-                vertex[i].tz = bind_data->vertex_buffer[i].tz;
-                vertex[i].u  = bind_data->vertex_buffer[i].u;
-                vertex[i].v  = bind_data->vertex_buffer[i].v;
-
-                bounding_box.merge(Vector3(vertex[i].x, vertex[i].y, vertex[i].z));
+                MeshVertexDataDefinition& vertex = mesh.m_vertices[i];
+                vertex.x                         = bind_data->vertex_buffer[i].px;
+                vertex.y                         = bind_data->vertex_buffer[i].py;
+                vertex.z                         = bind_data->vertex_buffer[i].pz;
+                vertex.nx                        = bind_data->vertex_buffer[i].nx;
+                vertex.ny                        = bind_data->vertex_buffer[i].ny;
+                vertex.nz                        = bind_data->vertex_buffer[i].nz;
+                vertex.tx                        = bind_data->vertex_buffer[i].tx;
+                vertex.ty                        = bind_data->vertex_buffer[i].ty;
+                vertex.tz                        = bind_data->vertex_buffer[i].tz;
+                vertex.u                         = bind_data->vertex_buffer[i].u;
+                vertex.v                         = bind_data->vertex_buffer[i].v;
             }
 
             // index buffer
-            size_t index_size                     = bind_data->index_buffer.size() * sizeof(uint16_t);
-            ret.m_static_mesh_data.m_index_buffer = std::make_shared<BufferData>(index_size);
-            uint16_t* index                       = (uint16_t*)ret.m_static_mesh_data.m_index_buffer->m_data;
-            for (size_t i = 0; i < bind_data->index_buffer.size(); i++)
+            mesh.m_indices.assign(bind_data->index_buffer.begin(), bind_data->index_buffer.end());
+
+            // skeleton binding buffer, one binding per vertex
+            if (!bind_data->bind.empty())
             {
-                index[i] = static_cast<uint16_t>(bind_data->index_buffer[i]);
+                mesh.m_skinning.resize(mesh.m_vertices.size());
             }
-
-            // skeleton binding buffer
-            size_t data_size              = bind_data->bind.size() * sizeof(MeshVertexBindingDataDefinition);
-            ret.m_skeleton_binding_buffer = std::make_shared<BufferData>(data_size);
-            MeshVertexBindingDataDefinition* binding_data =
-                reinterpret_cast<MeshVertexBindingDataDefinition*>(ret.m_skeleton_binding_buffer->m_data);
-            for (size_t i = 0; i < bind_data->bind.size(); i++)
+            for (size_t i = 0; i < std::min(bind_data->bind.size(), mesh.m_skinning.size()); i++)
             {
-                binding_data[i].m_index0  = bind_data->bind[i].index0;
-                binding_data[i].m_index1  = bind_data->bind[i].index1;
-                binding_data[i].m_index2  = bind_data->bind[i].index2;
-                binding_data[i].m_index3  = bind_data->bind[i].index3;
-                binding_data[i].m_weight0 = bind_data->bind[i].weight0;
-                binding_data[i].m_weight1 = bind_data->bind[i].weight1;
-                binding_data[i].m_weight2 = bind_data->bind[i].weight2;
-                binding_data[i].m_weight3 = bind_data->bind[i].weight3;
+                MeshVertexBindingDataDefinition& binding = mesh.m_skinning[i];
+                binding.m_index0                         = bind_data->bind[i].index0;
+                binding.m_index1                         = bind_data->bind[i].index1;
+                binding.m_index2                         = bind_data->bind[i].index2;
+                binding.m_index3                         = bind_data->bind[i].index3;
+                binding.m_weight0                        = bind_data->bind[i].weight0;
+                binding.m_weight1                        = bind_data->bind[i].weight1;
+                binding.m_weight2                        = bind_data->bind[i].weight2;
+                binding.m_weight3                        = bind_data->bind[i].weight3;
             }
         }
+        else
+        {
+            LOG_ERROR("unsupported mesh file {}", source.m_mesh_file);
+            return false;
+        }
 
-        m_bounding_box_cache_map.insert(std::make_pair(source, bounding_box));
+        std::vector<uint8_t> cooked_bytes;
+        MeshCooker::cook(mesh, cooked_bytes);
 
-        return ret;
+        if (g_runtime_global_context.m_config_manager->shouldSaveCookedMesh())
+        {
+            MeshCooker::save(cooked_bytes, getCookedMeshPath(source.m_mesh_file));
+        }
+
+        std::shared_ptr<CookedMesh> cooked_mesh = std::make_shared<CookedMesh>();
+        if (!cooked_mesh->loadFromMemory(std::move(cooked_bytes)))
+            return false;
+
+        LOG_INFO("cooked mesh {}: {} vertices -> {} vertices, {} bit indices, {} bytes",
+                 source.m_mesh_file,
+                 mesh.m_vertices.size(),
+                 cooked_mesh->getVertexCount(),
+                 cooked_mesh->getIndexSize() * 8,
+                 cooked_mesh->getMemorySize());
+
+        getCookedMeshData(cooked_mesh, ret, bounding_box);
+        return true;
+    }
+
+    std::shared_ptr<CookedMesh> RenderResourceBase::mapCookedMesh(const MeshSourceDesc& source)
+    {
+        if (source.m_mesh_file.empty())
+            return nullptr;
+
+        const std::filesystem::path mesh_path =
+            g_runtime_global_context.m_asset_manager->getFullPath(source.m_mesh_file);
+        const std::filesystem::path cooked_mesh_path = getCookedMeshPath(source.m_mesh_file);
+
+        std::error_code error_code;
+        const bool      is_cooked_mesh_valid =
+            std::filesystem::exists(cooked_mesh_path, error_code) &&
+            (!std::filesystem::exists(mesh_path, error_code) ||
+             std::filesystem::last_write_time(cooked_mesh_path, error_code) >=
+                 std::filesystem::last_write_time(mesh_path, error_code));
+        if (!is_cooked_mesh_valid)
+            return nullptr;
+
+        // a mesh cooked by another cooker version is cooked again, even when it is newer than its source
+        std::shared_ptr<CookedMesh> cooked_mesh = std::make_shared<CookedMesh>();
+        if (!cooked_mesh->loadFromFile(cooked_mesh_path) || cooked_mesh->getCookerVersion() != MeshCooker::s_version)
+            return nullptr;
+        return cooked_mesh;
+    }
+
+    void RenderResourceBase::getCookedMeshData(const std::shared_ptr<const CookedMesh>& cooked_mesh,
+                                               RenderMeshData&                          mesh_data,
+                                               AxisAlignedBox&                          bounding_box)
+    {
+        StaticMeshData& static_mesh_data = mesh_data.m_static_mesh_data;
+        static_mesh_data.m_vertex_buffer = std::make_shared<BufferData>(
+            cooked_mesh->getVertices(), cooked_mesh->getVertexCount() * sizeof(MeshVertexDataDefinition), cooked_mesh);
+        static_mesh_data.m_index_buffer = std::make_shared<BufferData>(
+            cooked_mesh->getIndices(), size_t(cooked_mesh->getIndexCount()) * cooked_mesh->getIndexSize(), cooked_mesh);
+        static_mesh_data.m_index_type =
+            cooked_mesh->getIndexSize() == sizeof(uint32_t) ? RHI_INDEX_TYPE_UINT32 : RHI_INDEX_TYPE_UINT16;
+
+        if (cooked_mesh->hasSkinning())
+        {
+            mesh_data.m_skeleton_binding_buffer =
+                std::make_shared<BufferData>(cooked_mesh->getSkinning(),
+                                             cooked_mesh->getVertexCount() * sizeof(MeshVertexBindingDataDefinition),
+                                             cooked_mesh);
+        }
+
+        bounding_box = cooked_mesh->getBoundingBox();
     }
 
     RenderMaterialData RenderResourceBase::loadMaterialData(const MaterialSourceDesc& source)
@@ -164,29 +300,97 @@ namespace Piccolo
     }
 
     AxisAlignedBox RenderResourceBase::getCachedBoudingBox(const MeshSourceDesc& source) const
+    {
+        AxisAlignedBox bounding_box;
+        tryGetCachedBoundingBox(source, bounding_box);
+        return bounding_box;
+    }
+
+    bool RenderResourceBase::tryGetCachedBoundingBox(const MeshSourceDesc& source, AxisAlignedBox& bounding_box) const
     {
         auto find_it = m_bounding_box_cache_map.find(source);
         if (find_it != m_bounding_box_cache_map.end())
         {
-            return find_it->second;
+            bounding_box = find_it->second;
+            return true;
         }
-        return AxisAlignedBox();
+        return false;
+    }
+
+    void RenderResourceBase::cacheBoundingBox(const MeshSourceDesc& source, const AxisAlignedBox& bounding_box)
+    {
+        m_bounding_box_cache_map.insert(std::make_pair(source, bounding_box));
     }
 
-    StaticMeshData RenderResourceBase::loadStaticMesh(std::string filename, AxisAlignedBox& bounding_box)
+    RenderMeshData RenderResourceBase::createPlaceholderMeshData(AxisAlignedBox& bounding_box)
     {
-        StaticMeshData mesh_data;
+        // unit cube standing on the origin, 4 vertices per face so every face keeps its own normal
+        static const float face_frames[6][9] = {{1, 0, 0, 0, 1, 0, 0, 0, 1},
+                                                {-1, 0, 0, 0, -1, 0, 0, 0, 1},
+                                                {0, 1, 0, -1, 0, 0, 0, 0, 1},
+                                                {0, -1, 0, 1, 0, 0, 0, 0, 1},
+                                                {0, 0, 1, 1, 0, 0, 0, 1, 0},
+                                                {0, 0, -1, 1, 0, 0, 0, -1, 0}};
+        static const float corners[4][2]      = {{-1, -1}, {1, -1}, {1, 1}, {-1, 1}};
+
+        RenderMeshData ret;
+        ret.m_static_mesh_data.m_vertex_buffer = std::make_shared<BufferData>(24 * sizeof(MeshVertexDataDefinition));
+        ret.m_static_mesh_data.m_index_buffer  = std::make_shared<BufferData>(36 * sizeof(uint16_t));
+
+        MeshVertexDataDefinition* vertices =
+            reinterpret_cast<MeshVertexDataDefinition*>(ret.m_static_mesh_data.m_vertex_buffer->m_data);
+        uint16_t* indices = reinterpret_cast<uint16_t*>(ret.m_static_mesh_data.m_index_buffer->m_data);
+        for (uint16_t face = 0; face < 6; ++face)
+        {
+            const Vector3 normal(face_frames[face][0], face_frames[face][1], face_frames[face][2]);
+            const Vector3 tangent(face_frames[face][3], face_frames[face][4], face_frames[face][5]);
+            const Vector3 bitangent(face_frames[face][6], face_frames[face][7], face_frames[face][8]);
+            for (uint16_t corner = 0; corner < 4; ++corner)
+            {
+                const Vector3 position = normal * 0.5f + tangent * (corners[corner][0] * 0.5f) +
+                                         bitangent * (corners[corner][1] * 0.5f) + Vector3(0.f, 0.f, 0.5f);
+
+                MeshVertexDataDefinition& vertex = vertices[face * 4 + corner];
+                vertex                           = {};
+                vertex.x                         = position.x;
+                vertex.y                         = position.y;
+                vertex.z                         = position.z;
+                vertex.nx                        = normal.x;
+                vertex.ny                        = normal.y;
+                vertex.nz                        = normal.z;
+                vertex.tx                        = tangent.x;
+                vertex.ty                        = tangent.y;
+                vertex.tz                        = tangent.z;
+                vertex.u                         = corners[corner][0] * 0.5f + 0.5f;
+                vertex.v                         = corners[corner][1] * 0.5f + 0.5f;
+
+                bounding_box.merge(position);
+            }
+
+            const uint16_t base = face * 4;
+            const uint16_t face_indices[6] = {base, uint16_t(base + 1), uint16_t(base + 2),
+                                              base, uint16_t(base + 2), uint16_t(base + 3)};
+            std::copy(face_indices, face_indices + 6, indices + face * 6);
+        }
+
+        return ret;
+    }
 
+    bool RenderResourceBase::loadStaticMesh(const std::string& obj_text,
+                                            const std::string& filename,
+                                            MeshCookSource&    mesh)
+    {
         tinyobj::ObjReader       reader;
         tinyobj::ObjReaderConfig reader_config;
         reader_config.vertex_color = false;
-        if (!reader.ParseFromFile(filename, reader_config))
+        // the materials of the obj file are not used
+        if (!reader.ParseFromString(obj_text, std::string(), reader_config))
         {
             if (!reader.Error().empty())
             {
                 LOG_ERROR("loadMesh {} failed, error: {}", filename, reader.Error());
             }
-            assert(0);
+            return false;
         }
 
         if (!reader.Warning().empty())
@@ -197,7 +401,8 @@ namespace Piccolo
         auto& attrib = reader.GetAttrib();
         auto& shapes = reader.GetShapes();
 
-        std::vector<MeshVertexDataDefinition> mesh_vertices;
+        // the triangles are expanded here, the cooker welds equal vertices and computes the tangents
+        mesh.m_compute_tangents = true;
 
         for (size_t s = 0; s < shapes.size(); s++)
         {
@@ -219,7 +424,6 @@ namespace Piccolo
                     continue;
                 }
 
-                // expanding vertex data is not efficient and is for testing purposes only
                 for (size_t v = 0; v < fv; v++)
                 {
                     auto idx = shapes[s].mesh.indices[index_offset + v];
@@ -231,8 +435,6 @@ namespace Piccolo
                     vertex[v].y = static_cast<float>(vy);
                     vertex[v].z = static_cast<float>(vz);
 
-                    bounding_box.merge(Vector3(vertex[v].x, vertex[v].y, vertex[v].z));
-
                     if (idx.normal_index >= 0)
                     {
                         auto nx = attrib.normals[3 * size_t(idx.normal_index) + 0];
@@ -279,26 +481,6 @@ namespace Piccolo
                     uv[2] = Vector2(0.5f, 0.5f);
                 }
 
-                Vector3 tangent {1, 0, 0};
-                {
-                    Vector3 edge1    = vertex[1] - vertex[0];
-                    Vector3 edge2    = vertex[2] - vertex[1];
-                    Vector2 deltaUV1 = uv[1] - uv[0];
-                    Vector2 deltaUV2 = uv[2] - uv[1];
-
-                    auto divide = deltaUV1.x * deltaUV2.y - deltaUV2.x * deltaUV1.y;
-                    if (divide >= 0.0f && divide < 0.000001f)
-                        divide = 0.000001f;
-                    else if (divide < 0.0f && divide > -0.000001f)
-                        divide = -0.000001f;
-
-                    float df  = 1.0f / divide;
-                    tangent.x = df * (deltaUV2.y * edge1.x - deltaUV1.y * edge2.x);
-                    tangent.y = df * (deltaUV2.y * edge1.y - deltaUV1.y * edge2.y);
-                    tangent.z = df * (deltaUV2.y * edge1.z - deltaUV1.y * edge2.z);
-                    tangent   = (tangent).normalisedCopy();
-                }
-
                 for (size_t i = 0; i < 3; i++)
                 {
                     MeshVertexDataDefinition mesh_vert {};
@@ -314,30 +496,11 @@ namespace Piccolo
                     mesh_vert.u = uv[i].x;
                     mesh_vert.v = uv[i].y;
 
-                    mesh_vert.tx = tangent.x;
-                    mesh_vert.ty = tangent.y;
-                    mesh_vert.tz = tangent.z;
-
-                    mesh_vertices.push_back(mesh_vert);
+                    mesh.m_vertices.push_back(mesh_vert);
                 }
             }
         }
 
-        uint32_t stride           = sizeof(MeshVertexDataDefinition);
-        mesh_data.m_vertex_buffer = std::make_shared<BufferData>(mesh_vertices.size() * stride);
-        mesh_data.m_index_buffer  = std::make_shared<BufferData>(mesh_vertices.size() * sizeof(uint16_t));
-
-        assert(mesh_vertices.size() <= std::numeric_limits<uint16_t>::max()); // take care of the index range, should be
-                                                                              // consistent with the index range used by
-                                                                              // vulkan
-
-        uint16_t* indices = (uint16_t*)mesh_data.m_index_buffer->m_data;
-        for (size_t i = 0; i < mesh_vertices.size(); i++)
-        {
-            ((MeshVertexDataDefinition*)(mesh_data.m_vertex_buffer->m_data))[i] = mesh_vertices[i];
-            indices[i]                                                          = static_cast<uint16_t>(i);
-        }
-
-        return mesh_data;
+        return true;
     }
 } // namespace Piccolo
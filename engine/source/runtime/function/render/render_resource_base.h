@@ -7,12 +7,15 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace Piccolo
 {
     class RHI;
     class RenderScene;
     class RenderCamera;
+    class CookedMesh;
+    struct MeshCookSource;
 
     class RenderResourceBase
     {
@@ -45,9 +48,30 @@ namespace Piccolo
         RenderMeshData               loadMeshData(const MeshSourceDesc& source, AxisAlignedBox& bounding_box);
         RenderMaterialData           loadMaterialData(const MaterialSourceDesc& source);
         AxisAlignedBox               getCachedBoudingBox(const MeshSourceDesc& source) const;
+        bool tryGetCachedBoundingBox(const MeshSourceDesc& source, AxisAlignedBox& bounding_box) const;
+        void cacheBoundingBox(const MeshSourceDesc& source, const AxisAlignedBox& bounding_box);
+
+        // reading and decoding are split so that the asset streamer runs them on its own threads, they touch no
+        // state of the render resource and can be called from any thread
+        static bool readAssetFile(const std::string& file, std::vector<uint8_t>& file_data);
+        static std::shared_ptr<TextureData> decodeTexture(const std::vector<uint8_t>& file_data, bool is_srgb);
+        static bool                         decodeMeshData(const MeshSourceDesc&       source,
+                                                           const std::vector<uint8_t>& file_data,
+                                                           RenderMeshData&             mesh_data,
+                                                           AxisAlignedBox&             bounding_box);
+
+        // maps the cooked mesh next to the mesh file, null if there is none or the mesh file is newer
+        static std::shared_ptr<CookedMesh> mapCookedMesh(const MeshSourceDesc& source);
+        // the buffers point into the cooked mesh and keep it alive
+        static void getCookedMeshData(const std::shared_ptr<const CookedMesh>& cooked_mesh,
+                                      RenderMeshData&                          mesh_data,
+                                      AxisAlignedBox&                          bounding_box);
+
+        // unit cube drawn in place of meshes that are still streaming in
+        static RenderMeshData createPlaceholderMeshData(AxisAlignedBox& bounding_box);
 
     private:
-        StaticMeshData loadStaticMesh(std::string mesh_file, AxisAlignedBox& bounding_box);
+        static bool loadStaticMesh(const std::string& obj_text, const std::string& mesh_file, MeshCookSource& mesh);
 
         std::unordered_map<MeshSourceDesc, AxisAlignedBox> m_bounding_box_cache_map;
     };
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "runtime/function/render/render_guid_allocator.h"
+
+#include <cstdint>
+#include <deque>
+#include <utility>
+#include <vector>
+
+namespace Piccolo
+{
+    /// Render resources indexed by the slot index of their asset guid, a lookup is an array access and a guid
+    /// compare. The resources live in a deque, so references handed out stay valid while the table grows.
+    template<typename TResource>
+    class RenderResourceTable
+    {
+    public:
+        TResource* tryGet(size_t guid)
+        {
+            const size_t index = getGuidIndex(guid);
+            if (guid == s_invalid_guid || index >= m_guids.size() || m_guids[index] != guid)
+                return nullptr;
+            return &m_resources[index];
+        }
+
+        // returns the resource of the guid and whether this call created it, release_resource(resource) is called
+        // on the resource of a freed guid before its slot is handed to the new one
+        template<typename TReleaseResource>
+        std::pair<TResource*, bool> getOrCreate(size_t guid, TReleaseResource&& release_resource)
+        {
+            if (TResource* resource = tryGet(guid))
+                return {resource, false};
+
+            const size_t index = getGuidIndex(guid);
+            if (index >= m_guids.size())
+            {
+                m_guids.resize(index + 1, s_invalid_guid);
+                m_resources.resize(index + 1);
+            }
+            else if (m_guids[index] != s_invalid_guid)
+            {
+                // the slot belonged to a freed guid
+                release_resource(m_resources[index]);
+                m_resources[index] = TResource {};
+            }
+            m_guids[index] = guid;
+            return {&m_resources[index], true};
+        }
+
+        void clear()
+        {
+            m_guids.clear();
+            m_resources.clear();
+        }
+
+    private:
+        std::vector<size_t>   m_guids;
+        std::deque<TResource> m_resources;
+    };
+} // namespace Piccolo
@@ -3,8 +3,39 @@
 #include "runtime/function/render/render_pass.h"
 #include "runtime/function/render/render_resource.h"
 
+#include <algorithm>
+
 namespace Piccolo
 {
+    namespace
+    {
+        void fillMeshNode(RenderResource& render_resource, const RenderEntity& entity, RenderMeshNode& mesh_node)
+        {
+            mesh_node.model_matrix = &entity.m_model_matrix;
+
+            assert(entity.m_joint_matrices.size() <= s_mesh_vertex_blending_max_joint_count);
+            if (!entity.m_joint_matrices.empty())
+            {
+                mesh_node.joint_count    = static_cast<uint32_t>(entity.m_joint_matrices.size());
+                mesh_node.joint_matrices = entity.m_joint_matrices.data();
+            }
+            mesh_node.node_id = entity.m_instance_id;
+
+            // assets still streaming in are drawn with the placeholders, the placeholder mesh has no skinning data
+            const size_t mesh_asset_id       = render_resource.getResidentMeshAssetId(entity);
+            VulkanMesh&  mesh_asset          = render_resource.getEntityMesh(entity);
+            mesh_node.ref_mesh               = &mesh_asset;
+            mesh_node.mesh_asset_index       = static_cast<uint32_t>(getGuidIndex(mesh_asset_id));
+            mesh_node.enable_vertex_blending =
+                entity.m_enable_vertex_blending && mesh_asset_id == entity.m_mesh_asset_id;
+
+            const size_t       material_asset_id = render_resource.getResidentMaterialAssetId(entity);
+            VulkanPBRMaterial& material_asset    = render_resource.getEntityMaterial(entity);
+            mesh_node.ref_material               = &material_asset;
+            mesh_node.material_asset_index       = static_cast<uint32_t>(getGuidIndex(material_asset_id));
+        }
+    } // namespace
+
     void RenderScene::clear()
     {
     }
@@ -12,9 +43,7 @@ namespace Piccolo
     void RenderScene::updateVisibleObjects(std::shared_ptr<RenderResource> render_resource,
                                            std::shared_ptr<RenderCamera>   camera)
     {
-        updateVisibleObjectsDirectionalLight(render_resource, camera);
-        updateVisibleObjectsPointLight(render_resource);
-        updateVisibleObjectsMainCamera(render_resource, camera);
+        updateVisibleObjectsMeshes(render_resource, camera);
         updateVisibleObjectsAxis(render_resource);
         updateVisibleObjectsParticle(render_resource);
     }
@@ -39,6 +68,12 @@ namespace Piccolo
     void RenderScene::addInstanceIdToMap(uint32_t instance_id, GObjectID go_id)
     {
         m_mesh_object_id_map[instance_id] = go_id;
+
+        std::vector<uint32_t>& instance_ids = m_game_object_instance_ids[go_id];
+        if (std::find(instance_ids.begin(), instance_ids.end(), instance_id) == instance_ids.end())
+        {
+            instance_ids.push_back(instance_id);
+        }
     }
 
     GObjectID RenderScene::getGObjectIDByMeshID(uint32_t mesh_id) const
@@ -51,41 +86,196 @@ namespace Piccolo
         return GObjectID();
     }
 
+    const std::vector<uint32_t>* RenderScene::getGameObjectInstanceIds(GObjectID go_id) const
+    {
+        auto find_it = m_game_object_instance_ids.find(go_id);
+        return find_it != m_game_object_instance_ids.end() ? &find_it->second : nullptr;
+    }
+
     void RenderScene::deleteEntityByGObjectID(GObjectID go_id)
     {
-        for (auto it = m_mesh_object_id_map.begin(); it != m_mesh_object_id_map.end(); it++)
+        auto instance_ids_it = m_game_object_instance_ids.find(go_id);
+        if (instance_ids_it == m_game_object_instance_ids.end())
+            return;
+
+        for (uint32_t instance_id : instance_ids_it->second)
         {
-            if (it->second == go_id)
+            m_mesh_object_id_map.erase(instance_id);
+            m_instance_id_allocator.freeGuid(instance_id);
+
+            const size_t entity_index = findRenderEntityIndex(instance_id);
+            if (entity_index != s_invalid_entity_index)
             {
-                m_mesh_object_id_map.erase(it);
-                break;
+                removeRenderEntity(entity_index);
             }
         }
+        m_game_object_instance_ids.erase(instance_ids_it);
+    }
 
-        GameObjectPartId part_id = {go_id, 0};
-        size_t           find_guid;
-        if (m_instance_id_allocator.getElementGuid(part_id, find_guid))
+    void RenderScene::addOrUpdateRenderEntity(const RenderEntity& render_entity,
+                                              const Matrix4x4*    joint_matrices,
+                                              size_t              joint_count)
+    {
+        BoundingBox mesh_asset_bounding_box {render_entity.m_bounding_box.getMinCorner(),
+                                             render_entity.m_bounding_box.getMaxCorner()};
+        BoundingBox world_bounding_box = BoundingBoxTransform(mesh_asset_bounding_box, render_entity.m_model_matrix);
+
+        const size_t existing_index = findRenderEntityIndex(render_entity.m_instance_id);
+        if (existing_index != s_invalid_entity_index)
         {
-            for (auto it = m_render_entities.begin(); it != m_render_entities.end(); it++)
+            const size_t old_mesh_asset_id = m_render_entities[existing_index].m_mesh_asset_id;
+            if (old_mesh_asset_id != render_entity.m_mesh_asset_id)
             {
-                if (it->m_instance_id == find_guid)
-                {
-                    m_render_entities.erase(it);
-                    break;
-                }
+                replaceMeshAssetEntityIndex(old_mesh_asset_id, existing_index, s_invalid_entity_index);
+                m_mesh_asset_entity_indices[render_entity.m_mesh_asset_id].push_back(existing_index);
             }
+
+            m_render_entities[existing_index]      = render_entity;
+            m_render_entity_bounds[existing_index] = world_bounding_box;
+            m_render_entities[existing_index].m_joint_matrices.assign(joint_matrices, joint_matrices + joint_count);
+            m_render_entity_bvh.moveLeaf(m_render_entity_bvh_leaves[existing_index], world_bounding_box);
+            return;
         }
+
+        const size_t entity_index = m_render_entities.size();
+        m_render_entities.push_back(render_entity);
+        m_render_entities.back().m_joint_matrices.assign(joint_matrices, joint_matrices + joint_count);
+        m_render_entity_bounds.push_back(world_bounding_box);
+        m_render_entity_bvh_leaves.push_back(
+            m_render_entity_bvh.createLeaf(world_bounding_box, static_cast<uint32_t>(entity_index)));
+        setRenderEntityIndex(render_entity.m_instance_id, entity_index);
+        m_mesh_asset_entity_indices[render_entity.m_mesh_asset_id].push_back(entity_index);
+    }
+
+    bool RenderScene::updateRenderEntityTransform(uint32_t         instance_id,
+                                                  const Matrix4x4& model_matrix,
+                                                  const Matrix4x4* joint_matrices,
+                                                  size_t           joint_count)
+    {
+        const size_t entity_index = findRenderEntityIndex(instance_id);
+        if (entity_index == s_invalid_entity_index)
+            return false;
+
+        RenderEntity& entity  = m_render_entities[entity_index];
+        entity.m_model_matrix = model_matrix;
+        entity.m_joint_matrices.assign(joint_matrices, joint_matrices + joint_count);
+
+        const BoundingBox mesh_asset_bounding_box {entity.m_bounding_box.getMinCorner(),
+                                                   entity.m_bounding_box.getMaxCorner()};
+        m_render_entity_bounds[entity_index] = BoundingBoxTransform(mesh_asset_bounding_box, model_matrix);
+        m_render_entity_bvh.moveLeaf(m_render_entity_bvh_leaves[entity_index], m_render_entity_bounds[entity_index]);
+        return true;
+    }
+
+    void RenderScene::updateMeshBoundingBox(size_t mesh_asset_id, const AxisAlignedBox& bounding_box)
+    {
+        auto entity_indices_it = m_mesh_asset_entity_indices.find(mesh_asset_id);
+        if (entity_indices_it == m_mesh_asset_entity_indices.end())
+            return;
+
+        const BoundingBox mesh_asset_bounding_box {bounding_box.getMinCorner(), bounding_box.getMaxCorner()};
+        for (size_t entity_index : entity_indices_it->second)
+        {
+            RenderEntity& entity = m_render_entities[entity_index];
+
+            entity.m_bounding_box                = bounding_box;
+            m_render_entity_bounds[entity_index] = BoundingBoxTransform(mesh_asset_bounding_box, entity.m_model_matrix);
+            m_render_entity_bvh.moveLeaf(m_render_entity_bvh_leaves[entity_index],
+                                         m_render_entity_bounds[entity_index]);
+        }
+    }
+
+    void RenderScene::removeRenderEntity(size_t entity_index)
+    {
+        // move the last entity into the hole, so only its bvh leaf has to be told about the new index
+        const size_t last_index = m_render_entities.size() - 1;
+
+        setRenderEntityIndex(m_render_entities[entity_index].m_instance_id, s_invalid_entity_index);
+        replaceMeshAssetEntityIndex(
+            m_render_entities[entity_index].m_mesh_asset_id, entity_index, s_invalid_entity_index);
+        m_render_entity_bvh.destroyLeaf(m_render_entity_bvh_leaves[entity_index]);
+        if (entity_index != last_index)
+        {
+            replaceMeshAssetEntityIndex(m_render_entities[last_index].m_mesh_asset_id, last_index, entity_index);
+
+            m_render_entities[entity_index]          = std::move(m_render_entities[last_index]);
+            m_render_entity_bounds[entity_index]     = m_render_entity_bounds[last_index];
+            m_render_entity_bvh_leaves[entity_index] = m_render_entity_bvh_leaves[last_index];
+
+            setRenderEntityIndex(m_render_entities[entity_index].m_instance_id, entity_index);
+            m_render_entity_bvh.setUserData(m_render_entity_bvh_leaves[entity_index],
+                                            static_cast<uint32_t>(entity_index));
+        }
+        m_render_entities.pop_back();
+        m_render_entity_bounds.pop_back();
+        m_render_entity_bvh_leaves.pop_back();
+    }
+
+    void RenderScene::replaceMeshAssetEntityIndex(size_t mesh_asset_id, size_t entity_index, size_t new_entity_index)
+    {
+        // an invalid new index removes the entity from the mesh, the order of the indices does not matter
+        auto entity_indices_it = m_mesh_asset_entity_indices.find(mesh_asset_id);
+        if (entity_indices_it == m_mesh_asset_entity_indices.end())
+            return;
+
+        std::vector<size_t>& entity_indices = entity_indices_it->second;
+        auto                 find_it        = std::find(entity_indices.begin(), entity_indices.end(), entity_index);
+        if (find_it == entity_indices.end())
+            return;
+
+        if (new_entity_index != s_invalid_entity_index)
+        {
+            *find_it = new_entity_index;
+            return;
+        }
+
+        *find_it = entity_indices.back();
+        entity_indices.pop_back();
+        if (entity_indices.empty())
+        {
+            m_mesh_asset_entity_indices.erase(entity_indices_it);
+        }
+    }
+
+    size_t RenderScene::findRenderEntityIndex(uint32_t instance_id) const
+    {
+        const size_t instance_index = getGuidIndex(instance_id);
+        if (!GuidAllocator<GameObjectPartId>::isValidGuid(instance_id) ||
+            instance_index >= m_instance_entity_indices.size())
+            return s_invalid_entity_index;
+
+        // the slot may be left from an older generation of the instance id
+        const size_t entity_index = m_instance_entity_indices[instance_index];
+        if (entity_index == s_invalid_entity_index || m_render_entities[entity_index].m_instance_id != instance_id)
+            return s_invalid_entity_index;
+        return entity_index;
+    }
+
+    void RenderScene::setRenderEntityIndex(uint32_t instance_id, size_t entity_index)
+    {
+        const size_t instance_index = getGuidIndex(instance_id);
+        if (instance_index >= m_instance_entity_indices.size())
+        {
+            m_instance_entity_indices.resize(instance_index + 1, s_invalid_entity_index);
+        }
+        m_instance_entity_indices[instance_index] = entity_index;
     }
 
     void RenderScene::clearForLevelReloading()
     {
         m_instance_id_allocator.clear();
         m_mesh_object_id_map.clear();
+        m_game_object_instance_ids.clear();
         m_render_entities.clear();
+        m_render_entity_bounds.clear();
+        m_render_entity_bvh_leaves.clear();
+        m_instance_entity_indices.clear();
+        m_mesh_asset_entity_indices.clear();
+        m_render_entity_bvh.clear();
     }
 
-    void RenderScene::updateVisibleObjectsDirectionalLight(std::shared_ptr<RenderResource> render_resource,
-                                                           std::shared_ptr<RenderCamera>   camera)
+    void RenderScene::updateVisibleObjectsMeshes(std::shared_ptr<RenderResource> render_resource,
+                                                 std::shared_ptr<RenderCamera>   camera)
     {
         Matrix4x4 directional_light_proj_view = CalculateDirectionalLightCamera(*this, *camera);
 
@@ -95,43 +285,17 @@ namespace Piccolo
             directional_light_proj_view;
 
         m_directional_light_visible_mesh_nodes.clear();
+        m_point_lights_visible_mesh_nodes.clear();
+        m_main_camera_visible_mesh_nodes.clear();
 
-        ClusterFrustum frustum =
+        ClusterFrustum directional_light_frustum =
             CreateClusterFrustumFromMatrix(directional_light_proj_view, -1.0, 1.0, -1.0, 1.0, 0.0, 1.0);
 
-        for (const RenderEntity& entity : m_render_entities)
-        {
-            BoundingBox mesh_asset_bounding_box {entity.m_bounding_box.getMinCorner(),
-                                                 entity.m_bounding_box.getMaxCorner()};
-
-            if (TiledFrustumIntersectBox(frustum, BoundingBoxTransform(mesh_asset_bounding_box, entity.m_model_matrix)))
-            {
-                m_directional_light_visible_mesh_nodes.emplace_back();
-                RenderMeshNode& temp_node = m_directional_light_visible_mesh_nodes.back();
-
-                temp_node.model_matrix = &entity.m_model_matrix;
-
-                assert(entity.m_joint_matrices.size() <= s_mesh_vertex_blending_max_joint_count);
-                if (!entity.m_joint_matrices.empty())
-                {
-                    temp_node.joint_count    = static_cast<uint32_t>(entity.m_joint_matrices.size());
-                    temp_node.joint_matrices = entity.m_joint_matrices.data();
-                }
-                temp_node.node_id = entity.m_instance_id;
-
-                VulkanMesh& mesh_asset           = render_resource->getEntityMesh(entity);
-                temp_node.ref_mesh               = &mesh_asset;
-                temp_node.enable_vertex_blending = entity.m_enable_vertex_blending;
-
-                VulkanPBRMaterial& material_asset = render_resource->getEntityMaterial(entity);
-                temp_node.ref_material            = &material_asset;
-            }
-        }
-    }
-
-    void RenderScene::updateVisibleObjectsPointLight(std::shared_ptr<RenderResource> render_resource)
-    {
-        m_point_lights_visible_mesh_nodes.clear();
+        Matrix4x4      view_matrix      = camera->getViewMatrix();
+        Matrix4x4      proj_matrix      = camera->getPersProjMatrix();
+        Matrix4x4      proj_view_matrix = proj_matrix * view_matrix;
+        ClusterFrustum main_camera_frustum =
+            CreateClusterFrustumFromMatrix(proj_view_matrix, -1.0, 1.0, -1.0, 1.0, 0.0, 1.0);
 
         std::vector<BoundingSphere> point_lights_bounding_spheres;
         uint32_t                    point_light_num = static_cast<uint32_t>(m_point_light_list.m_lights.size());
@@ -142,85 +306,86 @@ namespace Piccolo
             point_lights_bounding_spheres[i].m_radius = m_point_light_list.m_lights[i].calculateRadius();
         }
 
-        for (const RenderEntity& entity : m_render_entities)
+        enum : uint32_t
         {
-            BoundingBox mesh_asset_bounding_box {entity.m_bounding_box.getMinCorner(),
-                                                 entity.m_bounding_box.getMaxCorner()};
-
-            bool intersect_with_point_lights = true;
-            for (size_t i = 0; i < point_light_num; i++)
+            directional_light_view = 1u << 0,
+            point_lights_view      = 1u << 1,
+            main_camera_view       = 1u << 2
+        };
+
+        // a subtree can only contain an entity intersecting a view if its bounds intersect the view too, the
+        // point lights view keeps the entities intersecting every point light
+        auto test_bounds = [&](const BoundingBox& bounds, uint32_t view_mask) {
+            if ((view_mask & directional_light_view) && !TiledFrustumIntersectBox(directional_light_frustum, bounds))
             {
-                if (!BoxIntersectsWithSphere(BoundingBoxTransform(mesh_asset_bounding_box, entity.m_model_matrix),
-                                             point_lights_bounding_spheres[i]))
+                view_mask &= ~directional_light_view;
+            }
+            if (view_mask & point_lights_view)
+            {
+                for (size_t i = 0; i < point_light_num; i++)
                 {
-                    intersect_with_point_lights = false;
-                    break;
+                    if (!BoxIntersectsWithSphere(bounds, point_lights_bounding_spheres[i]))
+                    {
+                        view_mask &= ~point_lights_view;
+                        break;
+                    }
                 }
             }
-
-            if (intersect_with_point_lights)
+            if ((view_mask & main_camera_view) && !TiledFrustumIntersectBox(main_camera_frustum, bounds))
             {
-                m_point_lights_visible_mesh_nodes.emplace_back();
-                RenderMeshNode& temp_node = m_point_lights_visible_mesh_nodes.back();
-
-                temp_node.model_matrix = &entity.m_model_matrix;
-
-                assert(entity.m_joint_matrices.size() <= s_mesh_vertex_blending_max_joint_count);
-                if (!entity.m_joint_matrices.empty())
+                view_mask &= ~main_camera_view;
+            }
+            return view_mask;
+        };
+
+        // the bvh keeps fat bounds, the entities reached by a frustum view are collected and tested again with
+        // their exact bounds in batches
+        m_directional_light_cull_candidates.clear();
+        m_main_camera_cull_candidates.clear();
+        m_render_entity_bvh.query(
+            directional_light_view | point_lights_view | main_camera_view,
+            test_bounds,
+            [&](uint32_t entity_index, uint32_t view_mask) {
+                if (view_mask & directional_light_view)
                 {
-                    temp_node.joint_count    = static_cast<uint32_t>(entity.m_joint_matrices.size());
-                    temp_node.joint_matrices = entity.m_joint_matrices.data();
+                    m_directional_light_cull_candidates.push_back(entity_index);
                 }
-                temp_node.node_id = entity.m_instance_id;
-
-                VulkanMesh& mesh_asset           = render_resource->getEntityMesh(entity);
-                temp_node.ref_mesh               = &mesh_asset;
-                temp_node.enable_vertex_blending = entity.m_enable_vertex_blending;
+                if (view_mask & main_camera_view)
+                {
+                    m_main_camera_cull_candidates.push_back(entity_index);
+                }
+                if (test_bounds(m_render_entity_bounds[entity_index], view_mask & point_lights_view))
+                {
+                    m_point_lights_visible_mesh_nodes.emplace_back();
+                    fillMeshNode(*render_resource,
+                                 m_render_entities[entity_index],
+                                 m_point_lights_visible_mesh_nodes.back());
+                }
+            });
 
-                VulkanPBRMaterial& material_asset = render_resource->getEntityMaterial(entity);
-                temp_node.ref_material            = &material_asset;
+        auto add_visible_candidates = [&](const ClusterFrustum&        frustum,
+                                          const std::vector<uint32_t>& candidates,
+                                          std::vector<RenderMeshNode>& visible_mesh_nodes) {
+            m_cull_batch.clear();
+            for (uint32_t entity_index : candidates)
+            {
+                m_cull_batch.add(m_render_entity_bounds[entity_index]);
             }
-        }
-    }
-
-    void RenderScene::updateVisibleObjectsMainCamera(std::shared_ptr<RenderResource> render_resource,
-                                                     std::shared_ptr<RenderCamera>   camera)
-    {
-        m_main_camera_visible_mesh_nodes.clear();
-
-        Matrix4x4 view_matrix      = camera->getViewMatrix();
-        Matrix4x4 proj_matrix      = camera->getPersProjMatrix();
-        Matrix4x4 proj_view_matrix = proj_matrix * view_matrix;
-
-        ClusterFrustum f = CreateClusterFrustumFromMatrix(proj_view_matrix, -1.0, 1.0, -1.0, 1.0, 0.0, 1.0);
+            TiledFrustumIntersectBoxes(frustum, m_cull_batch, m_cull_visible_bits);
 
-        for (const RenderEntity& entity : m_render_entities)
-        {
-            BoundingBox mesh_asset_bounding_box {entity.m_bounding_box.getMinCorner(),
-                                                 entity.m_bounding_box.getMaxCorner()};
-
-            if (TiledFrustumIntersectBox(f, BoundingBoxTransform(mesh_asset_bounding_box, entity.m_model_matrix)))
+            for (size_t candidate_index = 0; candidate_index < candidates.size(); candidate_index++)
             {
-                m_main_camera_visible_mesh_nodes.emplace_back();
-                RenderMeshNode& temp_node = m_main_camera_visible_mesh_nodes.back();
-                temp_node.model_matrix    = &entity.m_model_matrix;
-
-                assert(entity.m_joint_matrices.size() <= s_mesh_vertex_blending_max_joint_count);
-                if (!entity.m_joint_matrices.empty())
+                if (m_cull_visible_bits[candidate_index / 32] & (1u << (candidate_index % 32)))
                 {
-                    temp_node.joint_count    = static_cast<uint32_t>(entity.m_joint_matrices.size());
-                    temp_node.joint_matrices = entity.m_joint_matrices.data();
+                    visible_mesh_nodes.emplace_back();
+                    fillMeshNode(
+                        *render_resource, m_render_entities[candidates[candidate_index]], visible_mesh_nodes.back());
                 }
-                temp_node.node_id = entity.m_instance_id;
-
-                VulkanMesh& mesh_asset           = render_resource->getEntityMesh(entity);
-                temp_node.ref_mesh               = &mesh_asset;
-                temp_node.enable_vertex_blending = entity.m_enable_vertex_blending;
-
-                VulkanPBRMaterial& material_asset = render_resource->getEntityMaterial(entity);
-                temp_node.ref_material            = &material_asset;
             }
-        }
+        };
+        add_visible_candidates(
+            directional_light_frustum, m_directional_light_cull_candidates, m_directional_light_visible_mesh_nodes);
+        add_visible_candidates(main_camera_frustum, m_main_camera_cull_candidates, m_main_camera_visible_mesh_nodes);
     }
 
     void RenderScene::updateVisibleObjectsAxis(std::shared_ptr<RenderResource> render_resource)
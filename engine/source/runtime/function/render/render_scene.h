@@ -6,9 +6,13 @@
 #include "runtime/function/render/render_common.h"
 #include "runtime/function/render/render_entity.h"
 #include "runtime/function/render/render_guid_allocator.h"
+#include "runtime/function/render/render_helper.h"
 #include "runtime/function/render/render_object.h"
+#include "runtime/function/render/render_scene_bvh.h"
 
+#include <limits>
 #include <optional>
+#include <unordered_map>
 #include <vector>
 
 namespace Piccolo
@@ -24,7 +28,7 @@ namespace Piccolo
         PDirectionalLight m_directional_light;
         PointLightList    m_point_light_list;
 
-        // render entities
+        // render entities, only add or remove them through the methods below to keep the bvh in sync
         std::vector<RenderEntity> m_render_entities;
 
         // axis, for editor
@@ -52,7 +56,24 @@ namespace Piccolo
 
         void      addInstanceIdToMap(uint32_t instance_id, GObjectID go_id);
         GObjectID getGObjectIDByMeshID(uint32_t mesh_id) const;
+        // instance ids of the parts of a game object, nullptr if it is not in the scene
+        const std::vector<uint32_t>* getGameObjectInstanceIds(GObjectID go_id) const;
+        // replaces the entity with the same instance id if there is one, the joint palette is copied into the
+        // storage of the stored entity
+        void      addOrUpdateRenderEntity(const RenderEntity& render_entity,
+                                          const Matrix4x4*    joint_matrices,
+                                          size_t              joint_count);
+        // transform only update of an entity in the scene, returns false if there is none with the instance id
+        bool      updateRenderEntityTransform(uint32_t         instance_id,
+                                              const Matrix4x4& model_matrix,
+                                              const Matrix4x4* joint_matrices,
+                                              size_t           joint_count);
         void      deleteEntityByGObjectID(GObjectID go_id);
+        // a streamed mesh replaced its placeholder, the entities drawing it get the bounding box of the mesh
+        void      updateMeshBoundingBox(size_t mesh_asset_id, const AxisAlignedBox& bounding_box);
+
+        // world space bounds of m_render_entities, updated when an entity is added or updated
+        const std::vector<BoundingBox>& getRenderEntityBounds() const { return m_render_entity_bounds; }
 
         void clearForLevelReloading();
 
@@ -61,13 +82,35 @@ namespace Piccolo
         GuidAllocator<MeshSourceDesc>     m_mesh_asset_id_allocator;
         GuidAllocator<MaterialSourceDesc> m_material_asset_id_allocator;
 
-        std::unordered_map<uint32_t, GObjectID> m_mesh_object_id_map;
-
-        void updateVisibleObjectsDirectionalLight(std::shared_ptr<RenderResource> render_resource,
-                                                  std::shared_ptr<RenderCamera>   camera);
-        void updateVisibleObjectsPointLight(std::shared_ptr<RenderResource> render_resource);
-        void updateVisibleObjectsMainCamera(std::shared_ptr<RenderResource> render_resource,
-                                            std::shared_ptr<RenderCamera>   camera);
+        std::unordered_map<uint32_t, GObjectID>              m_mesh_object_id_map;
+        std::unordered_map<GObjectID, std::vector<uint32_t>> m_game_object_instance_ids;
+
+        // indexed like m_render_entities
+        std::vector<BoundingBox> m_render_entity_bounds;
+        std::vector<int32_t>     m_render_entity_bvh_leaves;
+        RenderSceneBvh           m_render_entity_bvh;
+        // render entity index per instance id slot, see getGuidIndex
+        std::vector<size_t> m_instance_entity_indices;
+        // render entity indices per mesh asset id, so a streamed mesh only visits the entities drawing it
+        std::unordered_map<size_t, std::vector<size_t>> m_mesh_asset_entity_indices;
+
+        // reused by the visibility update every frame to avoid allocations
+        std::vector<uint32_t> m_directional_light_cull_candidates;
+        std::vector<uint32_t> m_main_camera_cull_candidates;
+        BoundingBoxBatch      m_cull_batch;
+        std::vector<uint32_t> m_cull_visible_bits;
+
+        static constexpr size_t s_invalid_entity_index = std::numeric_limits<size_t>::max();
+
+        size_t findRenderEntityIndex(uint32_t instance_id) const;
+        void   setRenderEntityIndex(uint32_t instance_id, size_t entity_index);
+        void   removeRenderEntity(size_t entity_index);
+        void   replaceMeshAssetEntityIndex(size_t mesh_asset_id, size_t entity_index, size_t new_entity_index);
+
+        // culls the entities for the directional light, the point lights and the main camera in one bvh traversal,
+        // the frustum tests of the entities are batched
+        void updateVisibleObjectsMeshes(std::shared_ptr<RenderResource> render_resource,
+                                        std::shared_ptr<RenderCamera>   camera);
         void updateVisibleObjectsAxis(std::shared_ptr<RenderResource> render_resource);
         void updateVisibleObjectsParticle(std::shared_ptr<RenderResource> render_resource);
     };
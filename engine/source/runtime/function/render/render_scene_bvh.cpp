@@ -0,0 +1,318 @@
+#include "runtime/function/render/render_scene_bvh.h"
+
+#include "runtime/core/base/macro.h"
+
+#include <algorithm>
+
+namespace Piccolo
+{
+    namespace
+    {
+        // leaves are fattened by this ratio of their extent, plus a small absolute margin for flat boxes
+        constexpr float k_fat_bounds_ratio  = 0.1f;
+        constexpr float k_fat_bounds_margin = 0.01f;
+
+        BoundingBox mergeBounds(const BoundingBox& lhs, const BoundingBox& rhs)
+        {
+            BoundingBox merged {lhs.min_bound, lhs.max_bound};
+            merged.merge(rhs);
+            return merged;
+        }
+
+        float getSurfaceArea(const BoundingBox& bounds)
+        {
+            const Vector3 extent = bounds.max_bound - bounds.min_bound;
+            return 2.f * (extent.x * extent.y + extent.y * extent.z + extent.z * extent.x);
+        }
+
+        bool containsBounds(const BoundingBox& outer, const BoundingBox& inner)
+        {
+            return outer.min_bound.x <= inner.min_bound.x && outer.min_bound.y <= inner.min_bound.y &&
+                   outer.min_bound.z <= inner.min_bound.z && inner.max_bound.x <= outer.max_bound.x &&
+                   inner.max_bound.y <= outer.max_bound.y && inner.max_bound.z <= outer.max_bound.z;
+        }
+
+        BoundingBox fattenBounds(const BoundingBox& bounds)
+        {
+            const Vector3 margin = (bounds.max_bound - bounds.min_bound) * k_fat_bounds_ratio +
+                                   Vector3(k_fat_bounds_margin, k_fat_bounds_margin, k_fat_bounds_margin);
+            return BoundingBox(bounds.min_bound - margin, bounds.max_bound + margin);
+        }
+    } // namespace
+
+    int32_t RenderSceneBvh::createLeaf(const BoundingBox& bounds, uint32_t user_data)
+    {
+        const int32_t leaf        = allocateNode();
+        m_nodes[leaf].m_bounds    = fattenBounds(bounds);
+        m_nodes[leaf].m_user_data = user_data;
+        m_nodes[leaf].m_height    = 0;
+
+        insertLeaf(leaf);
+        m_leaf_count++;
+        return leaf;
+    }
+
+    void RenderSceneBvh::destroyLeaf(int32_t leaf)
+    {
+        ASSERT(leaf >= 0 && leaf < static_cast<int32_t>(m_nodes.size()) && m_nodes[leaf].isLeaf());
+
+        removeLeaf(leaf);
+        freeNode(leaf);
+        m_leaf_count--;
+    }
+
+    bool RenderSceneBvh::moveLeaf(int32_t leaf, const BoundingBox& bounds)
+    {
+        ASSERT(leaf >= 0 && leaf < static_cast<int32_t>(m_nodes.size()) && m_nodes[leaf].isLeaf());
+
+        if (containsBounds(m_nodes[leaf].m_bounds, bounds))
+            return false;
+
+        removeLeaf(leaf);
+        m_nodes[leaf].m_bounds = fattenBounds(bounds);
+        insertLeaf(leaf);
+        return true;
+    }
+
+    void RenderSceneBvh::clear()
+    {
+        m_nodes.clear();
+        m_root       = s_null_node;
+        m_free_list  = s_null_node;
+        m_leaf_count = 0;
+    }
+
+    int32_t RenderSceneBvh::allocateNode()
+    {
+        if (m_free_list == s_null_node)
+        {
+            m_nodes.emplace_back();
+            return static_cast<int32_t>(m_nodes.size()) - 1;
+        }
+
+        const int32_t node = m_free_list;
+        m_free_list        = m_nodes[node].m_parent;
+        m_nodes[node]      = Node();
+        return node;
+    }
+
+    void RenderSceneBvh::freeNode(int32_t node)
+    {
+        m_nodes[node].m_parent = m_free_list;
+        m_nodes[node].m_left   = s_null_node;
+        m_nodes[node].m_right  = s_null_node;
+        m_nodes[node].m_height = -1;
+        m_free_list            = node;
+    }
+
+    void RenderSceneBvh::insertLeaf(int32_t leaf)
+    {
+        if (m_root == s_null_node)
+        {
+            m_root                 = leaf;
+            m_nodes[leaf].m_parent = s_null_node;
+            return;
+        }
+
+        // descend to the sibling with the lowest cost, the cost of a subtree is the surface area it adds to the
+        // tree, including the growth of all the ancestors on the way
+        const BoundingBox leaf_bounds = m_nodes[leaf].m_bounds;
+        int32_t           sibling     = m_root;
+        while (!m_nodes[sibling].isLeaf())
+        {
+            const Node& node          = m_nodes[sibling];
+            const float area          = getSurfaceArea(node.m_bounds);
+            const float combined_area = getSurfaceArea(mergeBounds(node.m_bounds, leaf_bounds));
+
+            // cost of creating a new parent for this node and the leaf
+            const float cost = 2.f * combined_area;
+            // minimum cost of pushing the leaf further down the tree
+            const float inheritance_cost = 2.f * (combined_area - area);
+
+            auto get_child_cost = [this, &leaf_bounds, inheritance_cost](int32_t child) {
+                const Node& child_node    = m_nodes[child];
+                const float combined_area = getSurfaceArea(mergeBounds(child_node.m_bounds, leaf_bounds));
+                if (child_node.isLeaf())
+                    return combined_area + inheritance_cost;
+                return combined_area - getSurfaceArea(child_node.m_bounds) + inheritance_cost;
+            };
+            const float left_cost  = get_child_cost(node.m_left);
+            const float right_cost = get_child_cost(node.m_right);
+
+            if (cost < left_cost && cost < right_cost)
+                break;
+
+            sibling = left_cost < right_cost ? node.m_left : node.m_right;
+        }
+
+        const int32_t old_parent = m_nodes[sibling].m_parent;
+        const int32_t new_parent = allocateNode();
+
+        Node& new_parent_node    = m_nodes[new_parent];
+        new_parent_node.m_parent = old_parent;
+        new_parent_node.m_bounds = mergeBounds(leaf_bounds, m_nodes[sibling].m_bounds);
+        new_parent_node.m_height = m_nodes[sibling].m_height + 1;
+        new_parent_node.m_left   = sibling;
+        new_parent_node.m_right  = leaf;
+
+        if (old_parent != s_null_node)
+        {
+            Node& old_parent_node = m_nodes[old_parent];
+            if (old_parent_node.m_left == sibling)
+                old_parent_node.m_left = new_parent;
+            else
+                old_parent_node.m_right = new_parent;
+        }
+        else
+        {
+            m_root = new_parent;
+        }
+        m_nodes[sibling].m_parent = new_parent;
+        m_nodes[leaf].m_parent    = new_parent;
+
+        refitAncestors(m_nodes[leaf].m_parent);
+    }
+
+    void RenderSceneBvh::removeLeaf(int32_t leaf)
+    {
+        if (leaf == m_root)
+        {
+            m_root = s_null_node;
+            return;
+        }
+
+        const int32_t parent       = m_nodes[leaf].m_parent;
+        const int32_t grand_parent = m_nodes[parent].m_parent;
+        const int32_t sibling = m_nodes[parent].m_left == leaf ? m_nodes[parent].m_right : m_nodes[parent].m_left;
+
+        // the sibling takes the place of the parent
+        if (grand_parent != s_null_node)
+        {
+            Node& grand_parent_node = m_nodes[grand_parent];
+            if (grand_parent_node.m_left == parent)
+                grand_parent_node.m_left = sibling;
+            else
+                grand_parent_node.m_right = sibling;
+            m_nodes[sibling].m_parent = grand_parent;
+            freeNode(parent);
+
+            refitAncestors(grand_parent);
+        }
+        else
+        {
+            m_root                    = sibling;
+            m_nodes[sibling].m_parent = s_null_node;
+            freeNode(parent);
+        }
+    }
+
+    void RenderSceneBvh::refitAncestors(int32_t node)
+    {
+        while (node != s_null_node)
+        {
+            node = balance(node);
+
+            Node&       current = m_nodes[node];
+            const Node& left    = m_nodes[current.m_left];
+            const Node& right   = m_nodes[current.m_right];
+            current.m_height    = 1 + std::max(left.m_height, right.m_height);
+            current.m_bounds    = mergeBounds(left.m_bounds, right.m_bounds);
+
+            node = current.m_parent;
+        }
+    }
+
+    int32_t RenderSceneBvh::balance(int32_t a)
+    {
+        // rotates the higher child of a up if the heights of the children differ by more than one, returns the new
+        // root of the subtree
+        Node& node_a = m_nodes[a];
+        if (node_a.isLeaf() || node_a.m_height < 2)
+            return a;
+
+        const int32_t b      = node_a.m_left;
+        const int32_t c      = node_a.m_right;
+        Node&         node_b = m_nodes[b];
+        Node&         node_c = m_nodes[c];
+
+        const int32_t height_difference = node_c.m_height - node_b.m_height;
+        if (height_difference > 1)
+        {
+            // c takes the place of a and a becomes the left child of c
+            const int32_t f      = node_c.m_left;
+            const int32_t g      = node_c.m_right;
+            Node&         node_f = m_nodes[f];
+            Node&         node_g = m_nodes[g];
+
+            node_c.m_left   = a;
+            node_c.m_parent = node_a.m_parent;
+            node_a.m_parent = c;
+            if (node_c.m_parent != s_null_node)
+            {
+                Node& parent = m_nodes[node_c.m_parent];
+                if (parent.m_left == a)
+                    parent.m_left = c;
+                else
+                    parent.m_right = c;
+            }
+            else
+            {
+                m_root = c;
+            }
+
+            // the higher grandchild stays under c, the other one moves under a
+            const bool    is_f_higher = node_f.m_height > node_g.m_height;
+            const int32_t kept        = is_f_higher ? f : g;
+            const int32_t moved       = is_f_higher ? g : f;
+            node_c.m_right            = kept;
+            node_a.m_right            = moved;
+            m_nodes[moved].m_parent   = a;
+
+            node_a.m_bounds = mergeBounds(node_b.m_bounds, m_nodes[moved].m_bounds);
+            node_c.m_bounds = mergeBounds(node_a.m_bounds, m_nodes[kept].m_bounds);
+            node_a.m_height = 1 + std::max(node_b.m_height, m_nodes[moved].m_height);
+            node_c.m_height = 1 + std::max(node_a.m_height, m_nodes[kept].m_height);
+            return c;
+        }
+
+        if (height_difference < -1)
+        {
+            // b takes the place of a and a becomes the left child of b
+            const int32_t d      = node_b.m_left;
+            const int32_t e      = node_b.m_right;
+            Node&         node_d = m_nodes[d];
+            Node&         node_e = m_nodes[e];
+
+            node_b.m_left   = a;
+            node_b.m_parent = node_a.m_parent;
+            node_a.m_parent = b;
+            if (node_b.m_parent != s_null_node)
+            {
+                Node& parent = m_nodes[node_b.m_parent];
+                if (parent.m_left == a)
+                    parent.m_left = b;
+                else
+                    parent.m_right = b;
+            }
+            else
+            {
+                m_root = b;
+            }
+
+            const bool    is_d_higher = node_d.m_height > node_e.m_height;
+            const int32_t kept        = is_d_higher ? d : e;
+            const int32_t moved       = is_d_higher ? e : d;
+            node_b.m_right            = kept;
+            node_a.m_left             = moved;
+            m_nodes[moved].m_parent   = a;
+
+            node_a.m_bounds = mergeBounds(node_c.m_bounds, m_nodes[moved].m_bounds);
+            node_b.m_bounds = mergeBounds(node_a.m_bounds, m_nodes[kept].m_bounds);
+            node_a.m_height = 1 + std::max(node_c.m_height, m_nodes[moved].m_height);
+            node_b.m_height = 1 + std::max(node_a.m_height, m_nodes[kept].m_height);
+            return b;
+        }
+
+        return a;
+    }
+} // namespace Piccolo
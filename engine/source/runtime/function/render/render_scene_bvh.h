@@ -0,0 +1,103 @@
+#pragma once
+
+#include "runtime/function/render/render_helper.h"
+
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace Piccolo
+{
+    /// Dynamic bounding volume hierarchy over the world space bounds of render entities.
+    /// Leaves keep fattened bounds, an entity moving inside them does not touch the tree, otherwise its leaf is
+    /// reinserted and the ancestors are refit. Insertion picks the sibling with the smallest surface area increase
+    /// and tree rotations keep the height logarithmic.
+    class RenderSceneBvh
+    {
+    public:
+        static constexpr int32_t s_null_node = -1;
+
+        int32_t createLeaf(const BoundingBox& bounds, uint32_t user_data);
+        void    destroyLeaf(int32_t leaf);
+        // returns true if the leaf left its fat bounds and was reinserted
+        bool moveLeaf(int32_t leaf, const BoundingBox& bounds);
+        void setUserData(int32_t leaf, uint32_t user_data) { m_nodes[leaf].m_user_data = user_data; }
+        void clear();
+
+        size_t  getLeafCount() const { return m_leaf_count; }
+        int32_t getHeight() const { return m_root == s_null_node ? 0 : m_nodes[m_root].m_height; }
+
+        /// Tests up to 32 views in a single traversal.
+        /// test_node(bounds, view_mask) returns the subset of view_mask whose views intersect the bounds, a subtree
+        /// is only entered for the views its parent intersects. visit_leaf(user_data, view_mask) is called for
+        /// every leaf reached by at least one view.
+        template<typename TTestNode, typename TVisitLeaf>
+        void query(uint32_t view_mask, TTestNode&& test_node, TVisitLeaf&& visit_leaf) const
+        {
+            if (m_root == s_null_node || view_mask == 0)
+                return;
+
+            // a depth first traversal holds at most one pending sibling per level, so the stack never grows past
+            // the height of the tree plus one and the buffer is only resized when the tree got taller
+            const size_t max_stack_size = static_cast<size_t>(m_nodes[m_root].m_height) + 1;
+            if (m_query_stack.size() < max_stack_size)
+            {
+                m_query_stack.resize(max_stack_size);
+            }
+
+            std::pair<int32_t, uint32_t>* node_stack      = m_query_stack.data();
+            size_t                        node_stack_size = 0;
+            node_stack[node_stack_size++]                 = {m_root, view_mask};
+            while (node_stack_size > 0)
+            {
+                const std::pair<int32_t, uint32_t>& entry          = node_stack[--node_stack_size];
+                const Node&                         node           = m_nodes[entry.first];
+                const uint32_t                      node_view_mask = test_node(node.m_bounds, entry.second);
+
+                if (node_view_mask == 0)
+                    continue;
+
+                if (node.isLeaf())
+                {
+                    visit_leaf(node.m_user_data, node_view_mask);
+                }
+                else
+                {
+                    node_stack[node_stack_size++] = {node.m_left, node_view_mask};
+                    node_stack[node_stack_size++] = {node.m_right, node_view_mask};
+                }
+            }
+        }
+
+    private:
+        struct Node
+        {
+            BoundingBox m_bounds;
+            // next free node when the node is in the free list
+            int32_t  m_parent {s_null_node};
+            int32_t  m_left {s_null_node};
+            int32_t  m_right {s_null_node};
+            int32_t  m_height {0};
+            uint32_t m_user_data {std::numeric_limits<uint32_t>::max()};
+
+            bool isLeaf() const { return m_left == s_null_node; }
+        };
+
+        int32_t allocateNode();
+        void    freeNode(int32_t node);
+
+        void    insertLeaf(int32_t leaf);
+        void    removeLeaf(int32_t leaf);
+        void    refitAncestors(int32_t node);
+        int32_t balance(int32_t node);
+
+        std::vector<Node> m_nodes;
+        int32_t           m_root {s_null_node};
+        int32_t           m_free_list {s_null_node};
+        size_t            m_leaf_count {0};
+
+        // traversal stack reused by query, the bvh is only queried from the render thread
+        mutable std::vector<std::pair<int32_t, uint32_t>> m_query_stack;
+    };
+} // namespace Piccolo
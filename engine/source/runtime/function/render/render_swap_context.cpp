@@ -1,9 +1,33 @@
 #include "runtime/function/render/render_swap_context.h"
 
+#include "runtime/core/base/macro.h"
+
+#include <algorithm>
+#include <chrono>
 #include <utility>
 
 namespace Piccolo
 {
+    void LogicCameraState::setViewMatrix(const Matrix4x4& view_matrix)
+    {
+        // same decomposition as RenderCamera::setMainViewMatrix
+        const Vector3 s = Vector3(view_matrix[0][0], view_matrix[0][1], view_matrix[0][2]);
+        const Vector3 u = Vector3(view_matrix[1][0], view_matrix[1][1], view_matrix[1][2]);
+        const Vector3 f = Vector3(-view_matrix[2][0], -view_matrix[2][1], -view_matrix[2][2]);
+
+        m_position = s * (-view_matrix[0][3]) + u * (-view_matrix[1][3]) + f * view_matrix[2][3];
+        m_forward  = f;
+        m_up       = u;
+    }
+
+    Vector2 LogicCameraState::getFOV() const
+    {
+        // tan(fovy * 0.5) = tan(fovx * 0.5) / aspect
+        const float fov_y =
+            Radian(Math::atan(Math::tan(Radian(Degree(m_fov_x) * 0.5f)) / m_aspect) * 2.0f).valueDegrees();
+        return {m_fov_x, fov_y};
+    }
+
     void GameObjectResourceDesc::add(GameObjectDesc& desc) { m_game_object_descs.push_back(desc); }
 
     bool GameObjectResourceDesc::isEmpty() const { return m_game_object_descs.empty(); }
@@ -12,6 +36,59 @@ namespace Piccolo
 
     void GameObjectResourceDesc::pop() { m_game_object_descs.pop_front(); }
 
+    const DirtyGameObjectDesc&
+    DirtyGameObjectBatch::add(GObjectID                                                     go_id,
+                              const std::shared_ptr<const std::vector<GameObjectPartDesc>>& parts,
+                              uint32_t                                                      joint_count)
+    {
+        const DirtyGameObjectDesc& desc =
+            addTransformUpdate(go_id, static_cast<uint32_t>(parts->size()), joint_count);
+        m_game_object_descs.back().m_parts = parts;
+        return desc;
+    }
+
+    const DirtyGameObjectDesc&
+    DirtyGameObjectBatch::addTransformUpdate(GObjectID go_id, uint32_t part_count, uint32_t joint_count)
+    {
+        DirtyGameObjectDesc& desc   = m_game_object_descs.emplace_back();
+        desc.m_go_id                = go_id;
+        desc.m_part_count           = part_count;
+        desc.m_first_part_transform = static_cast<uint32_t>(m_part_transforms.size());
+        desc.m_first_joint_matrix   = static_cast<uint32_t>(m_joint_matrices.size());
+        desc.m_joint_matrix_count   = joint_count;
+
+        m_part_transforms.resize(m_part_transforms.size() + part_count);
+        m_joint_matrices.resize(m_joint_matrices.size() + joint_count);
+        return desc;
+    }
+
+    void DirtyGameObjectBatch::clear()
+    {
+        m_game_object_descs.clear();
+        m_part_transforms.clear();
+        m_joint_matrices.clear();
+    }
+
+    Matrix4x4* DirtyGameObjectBatch::getPartTransforms(const DirtyGameObjectDesc& desc)
+    {
+        return m_part_transforms.data() + desc.m_first_part_transform;
+    }
+
+    const Matrix4x4* DirtyGameObjectBatch::getPartTransforms(const DirtyGameObjectDesc& desc) const
+    {
+        return m_part_transforms.data() + desc.m_first_part_transform;
+    }
+
+    Matrix4x4* DirtyGameObjectBatch::getJointMatrices(const DirtyGameObjectDesc& desc)
+    {
+        return m_joint_matrices.data() + desc.m_first_joint_matrix;
+    }
+
+    const Matrix4x4* DirtyGameObjectBatch::getJointMatrices(const DirtyGameObjectDesc& desc) const
+    {
+        return m_joint_matrices.data() + desc.m_first_joint_matrix;
+    }
+
     void ParticleSubmitRequest::add(ParticleEmitterDesc& desc) { m_emitter_descs.push_back(desc); }
 
     unsigned int ParticleSubmitRequest::getEmitterCount() const { return m_emitter_descs.size(); }
@@ -30,85 +107,153 @@ namespace Piccolo
         return m_transform_descs[index];
     }
 
-    RenderSwapData& RenderSwapContext::getLogicSwapData() { return m_swap_data[m_logic_swap_data_index]; }
-
-    RenderSwapData& RenderSwapContext::getRenderSwapData() { return m_swap_data[m_render_swap_data_index]; }
+    RenderSwapContext::RenderSwapContext() : m_packets(s_default_pipeline_depth + 1) {}
 
-    void RenderSwapContext::swapLogicRenderData()
+    void RenderSwapContext::setPipelineDepth(uint32_t pipeline_depth)
     {
-        if (isReadyToSwap())
-        {
-            swap();
-        }
+        // only valid while nothing is in flight, the packet being filled by the logic side is kept
+        ASSERT(!hasRenderSwapData());
+
+        RenderSwapData logic_swap_data = std::move(getLogicSwapData());
+
+        // one more slot than the depth for the packet the logic side is filling
+        m_packets.clear();
+        m_packets.resize(std::max(pipeline_depth, 1u) + 1);
+        m_published_count.store(0, std::memory_order_relaxed);
+        m_released_count.store(0, std::memory_order_relaxed);
+
+        getLogicSwapData() = std::move(logic_swap_data);
     }
 
-    bool RenderSwapContext::isReadyToSwap() const
+    RenderSwapData& RenderSwapContext::getLogicSwapData()
     {
-        return !(m_swap_data[m_render_swap_data_index].m_level_resource_desc.has_value() ||
-                 m_swap_data[m_render_swap_data_index].m_game_object_resource_desc.has_value() ||
-                 m_swap_data[m_render_swap_data_index].m_game_object_to_delete.has_value() ||
-                 m_swap_data[m_render_swap_data_index].m_camera_swap_data.has_value() ||
-                 m_swap_data[m_render_swap_data_index].m_particle_submit_request.has_value() ||
-                 m_swap_data[m_render_swap_data_index].m_emitter_tick_request.has_value() ||
-                 m_swap_data[m_render_swap_data_index].m_emitter_transform_request.has_value());
+        return m_packets[m_published_count.load(std::memory_order_relaxed) % m_packets.size()];
     }
 
-    void RenderSwapContext::resetLevelRsourceSwapData()
+    void RenderSwapContext::setCameraSwapData(const CameraSwapData& camera_swap_data)
     {
-        m_swap_data[m_render_swap_data_index].m_level_resource_desc.reset();
+        // several changes in one frame are merged, a later one overrides only the fields it sets
+        std::optional<CameraSwapData>& packet_camera_swap_data = getLogicSwapData().m_camera_swap_data;
+        if (!packet_camera_swap_data.has_value())
+        {
+            packet_camera_swap_data.emplace();
+        }
+
+        if (camera_swap_data.m_fov_x.has_value())
+        {
+            packet_camera_swap_data->m_fov_x = camera_swap_data.m_fov_x;
+            m_logic_camera.m_fov_x           = *camera_swap_data.m_fov_x;
+        }
+
+        if (camera_swap_data.m_view_matrix.has_value())
+        {
+            packet_camera_swap_data->m_view_matrix = camera_swap_data.m_view_matrix;
+            m_logic_camera.setViewMatrix(*camera_swap_data.m_view_matrix);
+        }
+
+        if (camera_swap_data.m_camera_type.has_value())
+        {
+            packet_camera_swap_data->m_camera_type = camera_swap_data.m_camera_type;
+        }
     }
 
-    void RenderSwapContext::resetGameObjectResourceSwapData()
+    void RenderSwapContext::syncLogicCamera(RenderCamera& render_camera)
     {
-        m_swap_data[m_render_swap_data_index].m_game_object_resource_desc.reset();
+        m_logic_camera.setViewMatrix(render_camera.getViewMatrix());
+        m_logic_camera.m_fov_x  = render_camera.getFOV().x;
+        m_logic_camera.m_aspect = render_camera.getAspect();
+        m_logic_camera.m_znear  = render_camera.m_znear;
+        m_logic_camera.m_zfar   = render_camera.m_zfar;
     }
 
-    void RenderSwapContext::resetGameObjectToDelete()
+    float RenderSwapContext::swapLogicRenderData()
     {
-        m_swap_data[m_render_swap_data_index].m_game_object_to_delete.reset();
+        const uint64_t published_count = m_published_count.load(std::memory_order_relaxed) + 1;
+        m_published_count.store(published_count, std::memory_order_release);
+        notifyWaitingSide();
+
+        // the next logic packet is free once the render side has released everything but depth packets
+        auto is_logic_packet_free = [this, published_count]() {
+            return published_count - m_released_count.load(std::memory_order_acquire) < m_packets.size();
+        };
+        if (is_logic_packet_free())
+            return 0.f;
+
+        const auto wait_start = std::chrono::steady_clock::now();
+        {
+            std::unique_lock<std::mutex> lock(m_wait_mutex);
+            m_wait_condition.wait(lock, is_logic_packet_free);
+        }
+        return std::chrono::duration<float>(std::chrono::steady_clock::now() - wait_start).count();
     }
 
-    void RenderSwapContext::resetPartilceBatchSwapData()
+    bool RenderSwapContext::hasRenderSwapData() const { return getPendingPacketCount() > 0; }
+
+    bool RenderSwapContext::waitForRenderSwapData(float timeout)
     {
-        m_swap_data[m_render_swap_data_index].m_particle_submit_request.reset();
-    }
+        if (hasRenderSwapData())
+            return true;
 
-    void RenderSwapContext::resetCameraSwapData() { m_swap_data[m_render_swap_data_index].m_camera_swap_data.reset(); }
+        std::unique_lock<std::mutex> lock(m_wait_mutex);
+        return m_wait_condition.wait_for(
+            lock, std::chrono::duration<float>(timeout), [this]() { return hasRenderSwapData(); });
+    }
 
-    void RenderSwapContext::resetEmitterTickSwapData()
+    uint32_t RenderSwapContext::getPendingPacketCount() const
     {
-        m_swap_data[m_render_swap_data_index].m_emitter_tick_request.reset();
+        return static_cast<uint32_t>(m_published_count.load(std::memory_order_acquire) -
+                                     m_released_count.load(std::memory_order_relaxed));
     }
 
-    void RenderSwapContext::resetEmitterTransformSwapData()
+    RenderSwapData& RenderSwapContext::getRenderSwapData()
     {
-        m_swap_data[m_render_swap_data_index].m_emitter_transform_request.reset();
+        return m_packets[m_released_count.load(std::memory_order_relaxed) % m_packets.size()];
     }
 
-    void RenderSwapContext::swap()
+    void RenderSwapContext::releaseRenderSwapData()
     {
+        ASSERT(hasRenderSwapData());
+
         resetLevelRsourceSwapData();
         resetGameObjectResourceSwapData();
+        resetGameObjectTransformSwapData();
         resetGameObjectToDelete();
         resetCameraSwapData();
         resetEmitterTickSwapData();
         resetEmitterTransformSwapData();
         resetPartilceBatchSwapData();
-        std::swap(m_logic_swap_data_index, m_render_swap_data_index);
+
+        m_released_count.store(m_released_count.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        notifyWaitingSide();
     }
 
-    void RenderSwapData::addDirtyGameObject(GameObjectDesc&& desc)
+    void RenderSwapContext::notifyWaitingSide()
     {
-        if (m_game_object_resource_desc.has_value())
+        // taking the mutex orders the counter update before the predicate check of a side about to sleep, so the
+        // wake up can not be lost
         {
-            m_game_object_resource_desc->add(desc);
-        }
-        else
-        {
-            GameObjectResourceDesc go_descs;
-            go_descs.add(desc);
-            m_game_object_resource_desc = go_descs;
+            std::lock_guard<std::mutex> lock(m_wait_mutex);
         }
+        m_wait_condition.notify_all();
+    }
+
+    void RenderSwapContext::resetLevelRsourceSwapData() { getRenderSwapData().m_level_resource_desc.reset(); }
+
+    void RenderSwapContext::resetGameObjectResourceSwapData() { getRenderSwapData().m_dirty_game_objects.clear(); }
+
+    void RenderSwapContext::resetGameObjectTransformSwapData() { getRenderSwapData().m_moved_game_objects.clear(); }
+
+    void RenderSwapContext::resetGameObjectToDelete() { getRenderSwapData().m_game_object_to_delete.reset(); }
+
+    void RenderSwapContext::resetPartilceBatchSwapData() { getRenderSwapData().m_particle_submit_request.reset(); }
+
+    void RenderSwapContext::resetCameraSwapData() { getRenderSwapData().m_camera_swap_data.reset(); }
+
+    void RenderSwapContext::resetEmitterTickSwapData() { getRenderSwapData().m_emitter_tick_request.reset(); }
+
+    void RenderSwapContext::resetEmitterTransformSwapData()
+    {
+        getRenderSwapData().m_emitter_transform_request.reset();
     }
 
     void RenderSwapData::addDeleteGameObject(GameObjectDesc&& desc)
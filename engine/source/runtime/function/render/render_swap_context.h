@@ -8,10 +8,15 @@
 #include "runtime/resource/res_type/global/global_particle.h"
 #include "runtime/resource/res_type/global/global_rendering.h"
 
+#include <atomic>
+#include <condition_variable>
 #include <cstdint>
 #include <deque>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
+#include <vector>
 
 namespace Piccolo
 {
@@ -40,6 +45,23 @@ namespace Piccolo
         std::optional<Matrix4x4>        m_view_matrix;
     };
 
+    /// The camera as the logic side last sent it to the render side. Logic code reads this instead of the render
+    /// camera, which the render thread updates while the logic of the next frame runs.
+    struct LogicCameraState
+    {
+        Vector3 m_position;
+        Vector3 m_forward {Vector3::UNIT_Y};
+        Vector3 m_up {Vector3::UNIT_Z};
+        float   m_fov_x {89.f};
+        float   m_aspect {1.f};
+        float   m_znear {0.1f};
+        float   m_zfar {1000.f};
+
+        void setViewMatrix(const Matrix4x4& view_matrix);
+        // horizontal and vertical field of view in degrees, like RenderCamera::getFOV
+        Vector2 getFOV() const;
+    };
+
     struct GameObjectResourceDesc
     {
         std::deque<GameObjectDesc> m_game_object_descs;
@@ -52,6 +74,46 @@ namespace Piccolo
         GameObjectDesc& getNextProcessObject();
     };
 
+    /// Game object whose transform or pose changed this frame. The part descs are shared with the mesh component
+    /// instead of being copied and are only sent when the object is created, a transform update leaves them
+    /// empty. The per frame data lives in the arrays of the owning DirtyGameObjectBatch.
+    struct DirtyGameObjectDesc
+    {
+        GObjectID                                              m_go_id {k_invalid_gobject_id};
+        std::shared_ptr<const std::vector<GameObjectPartDesc>> m_parts;
+        uint32_t                                               m_part_count {0};
+
+        // world transform of every part
+        uint32_t m_first_part_transform {0};
+        // joint palette shared by all the parts, the first joint is the identity
+        uint32_t m_first_joint_matrix {0};
+        uint32_t m_joint_matrix_count {0};
+    };
+
+    /// Per packet arena of the dirty game objects. The descs are constructed in place and the render side reads
+    /// them where they are, clearing keeps the capacity so a warmed up packet is filled without allocating.
+    struct DirtyGameObjectBatch
+    {
+        std::vector<DirtyGameObjectDesc> m_game_object_descs;
+        std::vector<Matrix4x4>           m_part_transforms;
+        std::vector<Matrix4x4>           m_joint_matrices;
+
+        // the transforms and joints of the new desc are left for the caller to write, pointers returned by the
+        // getters below are invalidated by the next add
+        const DirtyGameObjectDesc& add(GObjectID                                                     go_id,
+                                       const std::shared_ptr<const std::vector<GameObjectPartDesc>>& parts,
+                                       uint32_t                                                      joint_count);
+        const DirtyGameObjectDesc& addTransformUpdate(GObjectID go_id, uint32_t part_count, uint32_t joint_count);
+        void                       clear();
+
+        bool isEmpty() const { return m_game_object_descs.empty(); }
+
+        Matrix4x4*       getPartTransforms(const DirtyGameObjectDesc& desc);
+        const Matrix4x4* getPartTransforms(const DirtyGameObjectDesc& desc) const;
+        Matrix4x4*       getJointMatrices(const DirtyGameObjectDesc& desc);
+        const Matrix4x4* getJointMatrices(const DirtyGameObjectDesc& desc) const;
+    };
+
     struct ParticleSubmitRequest
     {
         std::vector<ParticleEmitterDesc> m_emitter_descs;
@@ -84,14 +146,17 @@ namespace Piccolo
     struct RenderSwapData
     {
         std::optional<LevelResourceDesc>       m_level_resource_desc;
-        std::optional<GameObjectResourceDesc>  m_game_object_resource_desc;
+        // objects entering the render scene
+        DirtyGameObjectBatch m_dirty_game_objects;
+        // objects already in the render scene that moved, keyed by their game object id
+        DirtyGameObjectBatch m_moved_game_objects;
+
         std::optional<GameObjectResourceDesc>  m_game_object_to_delete;
         std::optional<CameraSwapData>          m_camera_swap_data;
         std::optional<ParticleSubmitRequest>   m_particle_submit_request;
         std::optional<EmitterTickRequest>      m_emitter_tick_request;
         std::optional<EmitterTransformRequest> m_emitter_transform_request;
 
-        void addDirtyGameObject(GameObjectDesc&& desc);
         void addDeleteGameObject(GameObjectDesc&& desc);
 
         void addNewParticleEmitter(ParticleEmitterDesc& desc);
@@ -99,33 +164,63 @@ namespace Piccolo
         void updateParticleTransform(ParticleEmitterTransformDesc& desc);
     };
 
-    enum SwapDataType : uint8_t
-    {
-        LogicSwapDataType = 0,
-        RenderSwapDataType,
-        SwapDataTypeCount
-    };
-
+    /// Bounded single producer, single consumer ring of frame packets between the logic and the render side.
+    /// The logic side fills the packet at the head of the ring and publishes it at the end of its frame, after
+    /// that the packet belongs to the render side until it is released. Only the two counters are shared, so the
+    /// handoff takes no lock, the mutex only parks a side that has to wait. At most pipeline depth packets are in
+    /// flight, the logic side waits for the render side beyond that.
     class RenderSwapContext
     {
     public:
+        static constexpr uint32_t s_default_pipeline_depth = 2;
+
+        RenderSwapContext();
+
+        void     setPipelineDepth(uint32_t pipeline_depth);
+        uint32_t getPipelineDepth() const { return static_cast<uint32_t>(m_packets.size()) - 1; }
+
+        // logic side
         RenderSwapData& getLogicSwapData();
+        // queue the camera change in the logic packet and apply it to the logic camera
+        void                    setCameraSwapData(const CameraSwapData& camera_swap_data);
+        const LogicCameraState& getLogicCamera() const { return m_logic_camera; }
+        // take over the state of the render camera, only while no render thread runs, e.g. for the editor camera
+        void syncLogicCamera(RenderCamera& render_camera);
+        // publish the logic packet, returns the seconds spent waiting for a free one
+        float swapLogicRenderData();
+
+        // render side, the render packet is the oldest published one
+        bool            hasRenderSwapData() const;
+        // returns false if nothing was published within the timeout
+        bool            waitForRenderSwapData(float timeout);
+        uint32_t        getPendingPacketCount() const;
         RenderSwapData& getRenderSwapData();
-        void            swapLogicRenderData();
-        void            resetLevelRsourceSwapData();
-        void            resetGameObjectResourceSwapData();
-        void            resetGameObjectToDelete();
-        void            resetCameraSwapData();
-        void            resetPartilceBatchSwapData();
-        void            resetEmitterTickSwapData();
-        void            resetEmitterTransformSwapData();
+        // clear the render packet and hand it back to the logic side
+        void releaseRenderSwapData();
+
+        void resetLevelRsourceSwapData();
+        void resetGameObjectResourceSwapData();
+        void resetGameObjectTransformSwapData();
+        void resetGameObjectToDelete();
+        void resetCameraSwapData();
+        void resetPartilceBatchSwapData();
+        void resetEmitterTickSwapData();
+        void resetEmitterTransformSwapData();
 
     private:
-        uint8_t        m_logic_swap_data_index {LogicSwapDataType};
-        uint8_t        m_render_swap_data_index {RenderSwapDataType};
-        RenderSwapData m_swap_data[SwapDataTypeCount];
+        void notifyWaitingSide();
+
+        std::vector<RenderSwapData> m_packets;
+
+        // read and written by the logic side only
+        LogicCameraState m_logic_camera;
+
+        std::mutex              m_wait_mutex;
+        std::condition_variable m_wait_condition;
 
-        bool isReadyToSwap() const;
-        void swap();
+        // written by the logic side only
+        alignas(64) std::atomic<uint64_t> m_published_count {0};
+        // written by the render side only
+        alignas(64) std::atomic<uint64_t> m_released_count {0};
     };
 } // namespace Piccolo
@@ -18,10 +18,29 @@
 #include "runtime/function/render/passes/main_camera_pass.h"
 #include "runtime/function/render/passes/particle_pass.h"
 
+#include "runtime/function/render/interface/null/null_rhi.h"
 #include "runtime/function/render/interface/vulkan/vulkan_rhi.h"
 
+#include <algorithm>
+
 namespace Piccolo
 {
+    namespace
+    {
+        // no file has this name, the placeholder mesh is generated
+        const char* const k_placeholder_mesh_file = "<placeholder mesh>";
+
+        MaterialSourceDesc getDefaultMaterialSource(const AssetManager& asset_manager)
+        {
+            // TODO: move to default material definition json file
+            return {asset_manager.getFullPath("asset/texture/default/albedo.jpg").generic_string(),
+                    asset_manager.getFullPath("asset/texture/default/mr.jpg").generic_string(),
+                    asset_manager.getFullPath("asset/texture/default/normal.jpg").generic_string(),
+                    "",
+                    ""};
+        }
+    } // namespace
+
     RenderSystem::~RenderSystem()
     {
         clear();
@@ -34,11 +53,20 @@ namespace Piccolo
         std::shared_ptr<AssetManager> asset_manager = g_runtime_global_context.m_asset_manager;
         ASSERT(asset_manager);
 
+        m_swap_context.setPipelineDepth(config_manager->getRenderPipelineDepth());
+
         // render context initialize
         RHIInitInfo rhi_init_info;
         rhi_init_info.window_system = init_info.window_system;
 
-        m_rhi = std::make_shared<VulkanRHI>();
+        if (config_manager->isNullRHIEnabled())
+        {
+            m_rhi = std::make_shared<NullRHI>();
+        }
+        else
+        {
+            m_rhi = std::make_shared<VulkanRHI>();
+        }
         m_rhi->initialize(rhi_init_info);
 
         // global rendering resource
@@ -65,6 +93,7 @@ namespace Piccolo
         m_render_camera->m_znear = global_rendering_res.m_camera_config.m_z_near;
         m_render_camera->setAspect(global_rendering_res.m_camera_config.m_aspect.x /
                                    global_rendering_res.m_camera_config.m_aspect.y);
+        m_swap_context.syncLogicCamera(*m_render_camera);
 
         // setup render scene
         m_render_scene                  = std::make_shared<RenderScene>();
@@ -92,12 +121,116 @@ namespace Piccolo
             &static_cast<RenderPass*>(m_render_pipeline->m_main_camera_pass.get())
                  ->m_descriptor_infos[MainCameraPass::LayoutType::_mesh_per_material]
                  .layout;
+
+        createPlaceholderAssets();
+
+        if (config_manager->isAssetStreamingEnabled())
+        {
+            m_asset_upload_budget = config_manager->getAssetUploadBudget();
+            m_asset_streamer      = std::make_shared<RenderAssetStreamer>();
+            m_asset_streamer->initialize(config_manager->getAssetDecodeThreadCount());
+        }
+    }
+
+    void RenderSystem::createPlaceholderAssets()
+    {
+        std::shared_ptr<AssetManager> asset_manager = g_runtime_global_context.m_asset_manager;
+        ASSERT(asset_manager);
+
+        RenderResource& render_resource = *std::static_pointer_cast<RenderResource>(m_render_resource);
+
+        // the default material doubles as the placeholder, objects without textures use it right away
+        RenderEntity placeholder_entity;
+        placeholder_entity.m_mesh_asset_id =
+            m_render_scene->getMeshAssetIdAllocator().allocGuid(MeshSourceDesc {k_placeholder_mesh_file});
+        placeholder_entity.m_material_asset_id =
+            m_render_scene->getMaterialAssetdAllocator().allocGuid(getDefaultMaterialSource(*asset_manager));
+
+        AxisAlignedBox placeholder_bounding_box;
+        RenderMeshData placeholder_mesh_data = RenderResourceBase::createPlaceholderMeshData(placeholder_bounding_box);
+        m_render_resource->cacheBoundingBox(MeshSourceDesc {k_placeholder_mesh_file}, placeholder_bounding_box);
+
+        m_render_resource->uploadGameObjectRenderResource(
+            m_rhi,
+            placeholder_entity,
+            placeholder_mesh_data,
+            m_render_resource->loadMaterialData(getDefaultMaterialSource(*asset_manager)));
+
+        render_resource.m_placeholder_mesh_asset_id     = placeholder_entity.m_mesh_asset_id;
+        render_resource.m_placeholder_material_asset_id = placeholder_entity.m_material_asset_id;
+    }
+
+    void RenderSystem::uploadStreamedAssets()
+    {
+        if (!m_asset_streamer)
+            return;
+
+        m_asset_streamer->popDecodedAssets(m_asset_upload_budget, m_streamed_assets);
+        for (RenderStreamedAsset& asset : m_streamed_assets)
+        {
+            if (!asset.m_is_valid)
+            {
+                onStreamedAssetFailed(asset);
+                continue;
+            }
+
+            RenderEntity render_entity;
+            if (asset.m_type == RenderAssetType::Mesh)
+            {
+                render_entity.m_mesh_asset_id = asset.m_asset_id;
+                m_render_resource->uploadGameObjectRenderResource(m_rhi, render_entity, asset.m_mesh_data);
+                m_render_resource->cacheBoundingBox(asset.m_mesh_source, asset.m_bounding_box);
+                m_render_scene->updateMeshBoundingBox(asset.m_asset_id, asset.m_bounding_box);
+            }
+            else
+            {
+                render_entity.m_material_asset_id = asset.m_asset_id;
+                m_render_resource->uploadGameObjectRenderResource(m_rhi, render_entity, asset.m_material_data);
+            }
+        }
+        m_asset_streamer->onAssetsUploaded(m_streamed_assets);
+
+        // the decoded data is not needed once it is on the gpu
+        m_streamed_assets.clear();
+    }
+
+    void RenderSystem::onStreamedAssetFailed(const RenderStreamedAsset& asset)
+    {
+        // the entities keep drawing the placeholder, freeing the asset id makes the next object sent with the
+        // same source request it again instead of holding on to the failed id
+        if (asset.m_type == RenderAssetType::Mesh)
+        {
+            LOG_ERROR("stream mesh {} failed, drawing the placeholder until it is requested again",
+                      asset.m_mesh_source.m_mesh_file);
+            m_render_scene->getMeshAssetIdAllocator().freeGuid(asset.m_asset_id);
+        }
+        else
+        {
+            MaterialSourceDesc material_source;
+            m_render_scene->getMaterialAssetdAllocator().getGuidRelatedElement(asset.m_asset_id, material_source);
+            LOG_ERROR("stream material {} failed, drawing the placeholder until it is requested again",
+                      material_source.m_base_color_file);
+            m_render_scene->getMaterialAssetdAllocator().freeGuid(asset.m_asset_id);
+        }
+    }
+
+    RenderAssetStreamingStats RenderSystem::getAssetStreamingStats() const
+    {
+        return m_asset_streamer ? m_asset_streamer->getStats() : RenderAssetStreamingStats {};
     }
 
     void RenderSystem::tick(float delta_time)
     {
-        // process swap data between logic and render contexts
-        processSwapData();
+        // process every packet the logic side published since the last frame in order, the frame renders the
+        // latest state
+        while (m_swap_context.hasRenderSwapData())
+        {
+            processSwapData();
+            m_swap_context.releaseRenderSwapData();
+        }
+
+        // meshes and materials the streamer finished since the last frame replace their placeholders
+        uploadStreamedAssets();
 
         // prepare render command context
         m_rhi->prepareContext();
@@ -131,6 +264,13 @@ namespace Piccolo
 
     void RenderSystem::clear()
     {
+        // the streaming threads stop before the resources they deliver to go away
+        if (m_asset_streamer)
+        {
+            m_asset_streamer->clear();
+        }
+        m_asset_streamer.reset();
+
         if (m_rhi)
         {
             m_rhi->clear();
@@ -156,7 +296,7 @@ namespace Piccolo
         m_render_pipeline.reset();
     }
 
-    void RenderSystem::swapLogicRenderData() { m_swap_context.swapLogicRenderData(); }
+    float RenderSystem::swapLogicRenderData() { return m_swap_context.swapLogicRenderData(); }
 
     RenderSwapContext& RenderSystem::getSwapContext() { return m_swap_context; }
 
@@ -166,23 +306,21 @@ namespace Piccolo
 
     void RenderSystem::updateEngineContentViewport(float offset_x, float offset_y, float width, float height)
     {
-        std::static_pointer_cast<VulkanRHI>(m_rhi)->m_viewport.x        = offset_x;
-        std::static_pointer_cast<VulkanRHI>(m_rhi)->m_viewport.y        = offset_y;
-        std::static_pointer_cast<VulkanRHI>(m_rhi)->m_viewport.width    = width;
-        std::static_pointer_cast<VulkanRHI>(m_rhi)->m_viewport.height   = height;
-        std::static_pointer_cast<VulkanRHI>(m_rhi)->m_viewport.minDepth = 0.0f;
-        std::static_pointer_cast<VulkanRHI>(m_rhi)->m_viewport.maxDepth = 1.0f;
+        RHIViewport* viewport = m_rhi->getSwapchainInfo().viewport;
+        viewport->x           = offset_x;
+        viewport->y           = offset_y;
+        viewport->width       = width;
+        viewport->height      = height;
+        viewport->minDepth    = 0.0f;
+        viewport->maxDepth    = 1.0f;
 
         m_render_camera->setAspect(width / height);
     }
 
     EngineContentViewport RenderSystem::getEngineContentViewport() const
     {
-        float x      = std::static_pointer_cast<VulkanRHI>(m_rhi)->m_viewport.x;
-        float y      = std::static_pointer_cast<VulkanRHI>(m_rhi)->m_viewport.y;
-        float width  = std::static_pointer_cast<VulkanRHI>(m_rhi)->m_viewport.width;
-        float height = std::static_pointer_cast<VulkanRHI>(m_rhi)->m_viewport.height;
-        return {x, y, width, height};
+        const RHIViewport* viewport = m_rhi->getSwapchainInfo().viewport;
+        return {viewport->x, viewport->y, viewport->width, viewport->height};
     }
 
     uint32_t RenderSystem::getGuidOfPickedMesh(const Vector2& picked_uv)
@@ -263,52 +401,58 @@ namespace Piccolo
             m_swap_context.resetLevelRsourceSwapData();
         }
 
-        // update game object if needed
-        if (swap_data.m_game_object_resource_desc.has_value())
+        // update game object if needed, the descs and joint palettes are read in place from the packet
+        if (!swap_data.m_dirty_game_objects.isEmpty())
         {
-            while (!swap_data.m_game_object_resource_desc->isEmpty())
+            const DirtyGameObjectBatch& dirty_game_objects = swap_data.m_dirty_game_objects;
+            for (const DirtyGameObjectDesc& gobject : dirty_game_objects.m_game_object_descs)
             {
-                GameObjectDesc gobject = swap_data.m_game_object_resource_desc->getNextProcessObject();
+                const std::vector<GameObjectPartDesc>& object_parts    = *gobject.m_parts;
+                const Matrix4x4*                       part_transforms = dirty_game_objects.getPartTransforms(gobject);
+                const Matrix4x4*                       joint_matrices  = dirty_game_objects.getJointMatrices(gobject);
 
-                for (size_t part_index = 0; part_index < gobject.getObjectParts().size(); part_index++)
+                for (size_t part_index = 0; part_index < object_parts.size(); part_index++)
                 {
-                    const auto&      game_object_part = gobject.getObjectParts()[part_index];
-                    GameObjectPartId part_id          = {gobject.getId(), part_index};
-
-                    bool is_entity_in_scene = m_render_scene->getInstanceIdAllocator().hasElement(part_id);
+                    const auto&      game_object_part = object_parts[part_index];
+                    GameObjectPartId part_id          = {gobject.m_go_id, part_index};
 
                     RenderEntity render_entity;
                     render_entity.m_instance_id =
                         static_cast<uint32_t>(m_render_scene->getInstanceIdAllocator().allocGuid(part_id));
-                    render_entity.m_model_matrix = game_object_part.m_transform_desc.m_transform_matrix;
+                    render_entity.m_model_matrix = part_transforms[part_index];
+
+                    m_render_scene->addInstanceIdToMap(render_entity.m_instance_id, gobject.m_go_id);
 
-                    m_render_scene->addInstanceIdToMap(render_entity.m_instance_id, gobject.getId());
+                    // objects close to the camera stream in first
+                    const float stream_priority =
+                        (part_transforms[part_index].getTrans() - m_render_camera->position()).squaredLength();
 
                     // mesh properties
-                    MeshSourceDesc mesh_source    = {game_object_part.m_mesh_desc.m_mesh_file};
-                    bool           is_mesh_loaded = m_render_scene->getMeshAssetIdAllocator().hasElement(mesh_source);
+                    MeshSourceDesc mesh_source = {game_object_part.m_mesh_desc.m_mesh_file};
+                    bool           is_new_mesh = false;
+                    render_entity.m_mesh_asset_id =
+                        m_render_scene->getMeshAssetIdAllocator().allocGuid(mesh_source, is_new_mesh);
 
-                    RenderMeshData mesh_data;
-                    if (!is_mesh_loaded)
+                    if (is_new_mesh && m_asset_streamer)
                     {
-                        mesh_data = m_render_resource->loadMeshData(mesh_source, render_entity.m_bounding_box);
+                        m_asset_streamer->requestMesh(render_entity.m_mesh_asset_id, mesh_source, stream_priority);
                     }
-                    else
+                    else if (is_new_mesh)
                     {
-                        render_entity.m_bounding_box = m_render_resource->getCachedBoudingBox(mesh_source);
+                        RenderMeshData mesh_data =
+                            m_render_resource->loadMeshData(mesh_source, render_entity.m_bounding_box);
+                        m_render_resource->uploadGameObjectRenderResource(m_rhi, render_entity, mesh_data);
                     }
 
-                    render_entity.m_mesh_asset_id = m_render_scene->getMeshAssetIdAllocator().allocGuid(mesh_source);
-                    render_entity.m_enable_vertex_blending =
-                        game_object_part.m_skeleton_animation_result.m_transforms.size() > 1; // take care
-                    render_entity.m_joint_matrices.resize(
-                        game_object_part.m_skeleton_animation_result.m_transforms.size());
-                    for (size_t i = 0; i < game_object_part.m_skeleton_animation_result.m_transforms.size(); ++i)
+                    // until a streamed mesh arrives the entity is culled with the bounds of the placeholder
+                    if (!m_render_resource->tryGetCachedBoundingBox(mesh_source, render_entity.m_bounding_box))
                     {
-                        render_entity.m_joint_matrices[i] =
-                            game_object_part.m_skeleton_animation_result.m_transforms[i].m_matrix;
+                        render_entity.m_bounding_box =
+                            m_render_resource->getCachedBoudingBox(MeshSourceDesc {k_placeholder_mesh_file});
                     }
 
+                    render_entity.m_enable_vertex_blending = gobject.m_joint_matrix_count > 1; // take care
+
                     // material properties
                     MaterialSourceDesc material_source;
                     if (game_object_part.m_material_desc.m_with_texture)
@@ -321,61 +465,58 @@ namespace Piccolo
                     }
                     else
                     {
-                        // TODO: move to default material definition json file
-                        material_source = {
-                            asset_manager->getFullPath("asset/texture/default/albedo.jpg").generic_string(),
-                            asset_manager->getFullPath("asset/texture/default/mr.jpg").generic_string(),
-                            asset_manager->getFullPath("asset/texture/default/normal.jpg").generic_string(),
-                            "",
-                            ""};
+                        material_source = getDefaultMaterialSource(*asset_manager);
                     }
-                    bool is_material_loaded = m_render_scene->getMaterialAssetdAllocator().hasElement(material_source);
-
-                    RenderMaterialData material_data;
-                    if (!is_material_loaded)
-                    {
-                        material_data = m_render_resource->loadMaterialData(material_source);
-                    }
-
+                    bool is_new_material = false;
                     render_entity.m_material_asset_id =
-                        m_render_scene->getMaterialAssetdAllocator().allocGuid(material_source);
+                        m_render_scene->getMaterialAssetdAllocator().allocGuid(material_source, is_new_material);
 
-                    // create game object on the graphics api side
-                    if (!is_mesh_loaded)
+                    if (is_new_material && m_asset_streamer)
                     {
-                        m_render_resource->uploadGameObjectRenderResource(m_rhi, render_entity, mesh_data);
+                        m_asset_streamer->requestMaterial(
+                            render_entity.m_material_asset_id, material_source, stream_priority);
                     }
-
-                    if (!is_material_loaded)
+                    else if (is_new_material)
                     {
+                        RenderMaterialData material_data = m_render_resource->loadMaterialData(material_source);
                         m_render_resource->uploadGameObjectRenderResource(m_rhi, render_entity, material_data);
                     }
 
-                    // add object to render scene if needed
-                    if (!is_entity_in_scene)
-                    {
-                        m_render_scene->m_render_entities.push_back(render_entity);
-                    }
-                    else
-                    {
-                        for (auto& entity : m_render_scene->m_render_entities)
-                        {
-                            if (entity.m_instance_id == render_entity.m_instance_id)
-                            {
-                                entity = render_entity;
-                                break;
-                            }
-                        }
-                    }
+                    // add object to render scene or update it
+                    m_render_scene->addOrUpdateRenderEntity(
+                        render_entity, joint_matrices, gobject.m_joint_matrix_count);
                 }
-                // after finished processing, pop this game object
-                swap_data.m_game_object_resource_desc->pop();
             }
 
             // reset game object swap data to a clean state
             m_swap_context.resetGameObjectResourceSwapData();
         }
 
+        // move game objects already in the scene, only their transforms and joints were sent
+        if (!swap_data.m_moved_game_objects.isEmpty())
+        {
+            const DirtyGameObjectBatch& moved_game_objects = swap_data.m_moved_game_objects;
+            for (const DirtyGameObjectDesc& gobject : moved_game_objects.m_game_object_descs)
+            {
+                const std::vector<uint32_t>* instance_ids = m_render_scene->getGameObjectInstanceIds(gobject.m_go_id);
+                if (instance_ids == nullptr)
+                    continue;
+
+                const Matrix4x4* part_transforms = moved_game_objects.getPartTransforms(gobject);
+                const Matrix4x4* joint_matrices  = moved_game_objects.getJointMatrices(gobject);
+                const size_t     part_count = std::min(instance_ids->size(), static_cast<size_t>(gobject.m_part_count));
+                for (size_t part_index = 0; part_index < part_count; part_index++)
+                {
+                    m_render_scene->updateRenderEntityTransform((*instance_ids)[part_index],
+                                                                part_transforms[part_index],
+                                                                joint_matrices,
+                                                                gobject.m_joint_matrix_count);
+                }
+            }
+
+            m_swap_context.resetGameObjectTransformSwapData();
+        }
+
         // remove deleted objects
         if (swap_data.m_game_object_to_delete.has_value())
         {
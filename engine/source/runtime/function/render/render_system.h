@@ -1,5 +1,6 @@
 #pragma once
 
+#include "runtime/function/render/render_asset_streamer.h"
 #include "runtime/function/render/render_entity.h"
 #include "runtime/function/render/render_guid_allocator.h"
 #include "runtime/function/render/render_swap_context.h"
@@ -8,6 +9,7 @@
 #include <array>
 #include <memory>
 #include <optional>
+#include <vector>
 
 namespace Piccolo
 {
@@ -44,7 +46,7 @@ namespace Piccolo
         void tick(float delta_time);
         void clear();
 
-        void                          swapLogicRenderData();
+        float                         swapLogicRenderData();
         RenderSwapContext&            getSwapContext();
         std::shared_ptr<RenderCamera> getRenderCamera() const;
         std::shared_ptr<RHI>          getRHI() const;
@@ -65,6 +67,9 @@ namespace Piccolo
 
         void clearForLevelReloading();
 
+        // empty stats when the assets are loaded synchronously
+        RenderAssetStreamingStats getAssetStreamingStats() const;
+
     private:
         RENDER_PIPELINE_TYPE m_render_pipeline_type {RENDER_PIPELINE_TYPE::DEFERRED_PIPELINE};
 
@@ -76,6 +81,14 @@ namespace Piccolo
         std::shared_ptr<RenderResourceBase> m_render_resource;
         std::shared_ptr<RenderPipelineBase> m_render_pipeline;
 
+        // null when streaming is disabled in the config
+        std::shared_ptr<RenderAssetStreamer> m_asset_streamer;
+        std::vector<RenderStreamedAsset>     m_streamed_assets;
+        size_t                               m_asset_upload_budget {0};
+
         void processSwapData();
+        void createPlaceholderAssets();
+        void uploadStreamedAssets();
+        void onStreamedAssetFailed(const RenderStreamedAsset& asset);
     };
 } // namespace Piccolo
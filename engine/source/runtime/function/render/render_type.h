@@ -1708,14 +1708,21 @@ namespace Piccolo
             m_size = size;
             m_data = malloc(size);
         }
+        // read only view of memory that the owner keeps alive, e.g. a mapped cooked mesh
+        BufferData(const void* data, size_t size, std::shared_ptr<const void> owner) :
+            m_size(size), m_data(const_cast<void*>(data)), m_owner(std::move(owner))
+        {}
         ~BufferData()
         {
-            if (m_data)
+            if (m_data && !m_owner)
             {
                 free(m_data);
             }
         }
         bool isValid() const { return m_data != nullptr; }
+
+    private:
+        std::shared_ptr<const void> m_owner;
     };
 
     class TextureData
@@ -1805,6 +1812,7 @@ namespace Piccolo
     {
         std::shared_ptr<BufferData> m_vertex_buffer;
         std::shared_ptr<BufferData> m_index_buffer;
+        RHIIndexType                m_index_type {RHI_INDEX_TYPE_UINT16};
     };
 
     struct RenderMeshData
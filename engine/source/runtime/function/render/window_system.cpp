@@ -6,12 +6,25 @@ namespace Piccolo
 {
     WindowSystem::~WindowSystem()
     {
+        if (m_is_headless)
+            return;
+
         glfwDestroyWindow(m_window);
         glfwTerminate();
     }
 
     void WindowSystem::initialize(WindowCreateInfo create_info)
     {
+        if (create_info.is_headless)
+        {
+            m_is_headless = true;
+            m_width       = create_info.width;
+            m_height      = create_info.height;
+            m_framebuffer_width.store(m_width, std::memory_order_relaxed);
+            m_framebuffer_height.store(m_height, std::memory_order_relaxed);
+            return;
+        }
+
         if (!glfwInit())
         {
             LOG_FATAL(__FUNCTION__, "failed to initialize GLFW");
@@ -41,24 +54,52 @@ namespace Piccolo
         glfwSetScrollCallback(m_window, scrollCallback);
         glfwSetDropCallback(m_window, dropCallback);
         glfwSetWindowSizeCallback(m_window, windowSizeCallback);
+        glfwSetFramebufferSizeCallback(m_window, framebufferSizeCallback);
         glfwSetWindowCloseCallback(m_window, windowCloseCallback);
 
+        int framebuffer_width  = 0;
+        int framebuffer_height = 0;
+        glfwGetFramebufferSize(m_window, &framebuffer_width, &framebuffer_height);
+        m_framebuffer_width.store(framebuffer_width, std::memory_order_relaxed);
+        m_framebuffer_height.store(framebuffer_height, std::memory_order_relaxed);
+
         glfwSetInputMode(m_window, GLFW_RAW_MOUSE_MOTION, GLFW_FALSE);
     }
 
-    void WindowSystem::pollEvents() const { glfwPollEvents(); }
+    void WindowSystem::pollEvents() const
+    {
+        if (m_window)
+        {
+            glfwPollEvents();
+        }
+    }
 
-    bool WindowSystem::shouldClose() const { return glfwWindowShouldClose(m_window); }
+    // a headless window is never closed by the user, the engine decides when the run ends
+    bool WindowSystem::shouldClose() const { return m_window ? glfwWindowShouldClose(m_window) : false; }
 
-    void WindowSystem::setTitle(const char* title) { glfwSetWindowTitle(m_window, title); }
+    void WindowSystem::setTitle(const char* title)
+    {
+        if (m_window)
+        {
+            glfwSetWindowTitle(m_window, title);
+        }
+    }
 
     GLFWwindow* WindowSystem::getWindow() const { return m_window; }
 
     std::array<int, 2> WindowSystem::getWindowSize() const { return std::array<int, 2>({m_width, m_height}); }
 
+    std::array<int, 2> WindowSystem::getFramebufferSize() const
+    {
+        return std::array<int, 2>({m_framebuffer_width.load(std::memory_order_relaxed),
+                                   m_framebuffer_height.load(std::memory_order_relaxed)});
+    }
+
     void WindowSystem::setFocusMode(bool mode)
     {
         m_is_focus_mode = mode;
+        if (!m_window)
+            return;
         glfwSetInputMode(m_window, GLFW_CURSOR, m_is_focus_mode ? GLFW_CURSOR_DISABLED : GLFW_CURSOR_NORMAL);
     }
 } // namespace Piccolo
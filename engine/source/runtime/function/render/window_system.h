@@ -4,6 +4,7 @@
 #include <GLFW/glfw3.h>
 
 #include <array>
+#include <atomic>
 #include <functional>
 #include <vector>
 
@@ -15,6 +16,8 @@ namespace Piccolo
         int         height {720};
         const char* title {"Piccolo"};
         bool        is_fullscreen {false};
+        // no glfw window is created, the size is only reported to the render system
+        bool        is_headless {false};
     };
 
     class WindowSystem
@@ -28,6 +31,9 @@ namespace Piccolo
         void               setTitle(const char* title);
         GLFWwindow*        getWindow() const;
         std::array<int, 2> getWindowSize() const;
+        // updated by the event polling of the main thread, the render thread reads it instead of asking glfw
+        std::array<int, 2> getFramebufferSize() const;
+        bool               isHeadless() const { return m_is_headless; }
 
         typedef std::function<void()>                   onResetFunc;
         typedef std::function<void(int, int, int, int)> onKeyFunc;
@@ -55,7 +61,7 @@ namespace Piccolo
 
         bool isMouseButtonDown(int button) const
         {
-            if (button < GLFW_MOUSE_BUTTON_1 || button > GLFW_MOUSE_BUTTON_LAST)
+            if (!m_window || button < GLFW_MOUSE_BUTTON_1 || button > GLFW_MOUSE_BUTTON_LAST)
             {
                 return false;
             }
@@ -139,6 +145,15 @@ namespace Piccolo
                 app->m_height = height;
             }
         }
+        static void framebufferSizeCallback(GLFWwindow* window, int width, int height)
+        {
+            WindowSystem* app = (WindowSystem*)glfwGetWindowUserPointer(window);
+            if (app)
+            {
+                app->m_framebuffer_width.store(width, std::memory_order_relaxed);
+                app->m_framebuffer_height.store(height, std::memory_order_relaxed);
+            }
+        }
         static void windowCloseCallback(GLFWwindow* window) { glfwSetWindowShouldClose(window, true); }
 
         void onReset()
@@ -197,6 +212,10 @@ namespace Piccolo
         int         m_width {0};
         int         m_height {0};
 
+        std::atomic<int> m_framebuffer_width {0};
+        std::atomic<int> m_framebuffer_height {0};
+
+        bool m_is_headless {false};
         bool m_is_focus_mode {false};
 
         std::vector<onResetFunc>       m_onResetFunc;
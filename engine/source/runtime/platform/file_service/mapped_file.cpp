@@ -0,0 +1,118 @@
+#include "runtime/platform/file_service/mapped_file.h"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN 1
+#define NOMINMAX 1
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Piccolo
+{
+    MappedFile::~MappedFile() { close(); }
+
+#if defined(_WIN32)
+    bool MappedFile::open(const std::filesystem::path& file_path)
+    {
+        close();
+
+        HANDLE file_handle = CreateFileW(file_path.c_str(),
+                                         GENERIC_READ,
+                                         FILE_SHARE_READ,
+                                         nullptr,
+                                         OPEN_EXISTING,
+                                         FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+                                         nullptr);
+        if (file_handle == INVALID_HANDLE_VALUE)
+            return false;
+
+        LARGE_INTEGER file_size;
+        if (!GetFileSizeEx(file_handle, &file_size) || file_size.QuadPart == 0)
+        {
+            CloseHandle(file_handle);
+            return false;
+        }
+
+        HANDLE mapping_handle = CreateFileMappingW(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping_handle == nullptr)
+        {
+            CloseHandle(file_handle);
+            return false;
+        }
+
+        void* data = MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0);
+        if (data == nullptr)
+        {
+            CloseHandle(mapping_handle);
+            CloseHandle(file_handle);
+            return false;
+        }
+
+        m_file_handle    = file_handle;
+        m_mapping_handle = mapping_handle;
+        m_data           = static_cast<const uint8_t*>(data);
+        m_size           = static_cast<size_t>(file_size.QuadPart);
+        return true;
+    }
+
+    void MappedFile::close()
+    {
+        if (m_data)
+        {
+            UnmapViewOfFile(m_data);
+        }
+        if (m_mapping_handle)
+        {
+            CloseHandle(m_mapping_handle);
+        }
+        if (m_file_handle)
+        {
+            CloseHandle(m_file_handle);
+        }
+        m_data           = nullptr;
+        m_size           = 0;
+        m_file_handle    = nullptr;
+        m_mapping_handle = nullptr;
+    }
+#else
+    bool MappedFile::open(const std::filesystem::path& file_path)
+    {
+        close();
+
+        const int file_descriptor = ::open(file_path.c_str(), O_RDONLY);
+        if (file_descriptor < 0)
+            return false;
+
+        struct stat file_stat;
+        if (fstat(file_descriptor, &file_stat) != 0 || file_stat.st_size == 0)
+        {
+            ::close(file_descriptor);
+            return false;
+        }
+
+        void* data = mmap(nullptr, static_cast<size_t>(file_stat.st_size), PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+        // the mapping keeps its own reference to the file
+        ::close(file_descriptor);
+        if (data == MAP_FAILED)
+            return false;
+
+        m_data = static_cast<const uint8_t*>(data);
+        m_size = static_cast<size_t>(file_stat.st_size);
+        return true;
+    }
+
+    void MappedFile::close()
+    {
+        if (m_data)
+        {
+            munmap(const_cast<uint8_t*>(m_data), m_size);
+        }
+        m_data = nullptr;
+        m_size = 0;
+    }
+#endif
+} // namespace Piccolo
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+namespace Piccolo
+{
+    /// Read-only memory mapping of a whole file, the mapping lives until close() or destruction
+    class MappedFile
+    {
+    public:
+        MappedFile() = default;
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        bool open(const std::filesystem::path& file_path);
+        void close();
+
+        bool           isOpen() const { return m_data != nullptr; }
+        const uint8_t* getData() const { return m_data; }
+        size_t         getSize() const { return m_size; }
+
+    private:
+        const uint8_t* m_data {nullptr};
+        size_t         m_size {0};
+
+#if defined(_WIN32)
+        void* m_file_handle {nullptr};
+        void* m_mapping_handle {nullptr};
+#endif
+    };
+} // namespace Piccolo
@@ -2,6 +2,8 @@
 
 #include "runtime/core/base/macro.h"
 #include "runtime/core/meta/serializer/serializer.h"
+#include "runtime/core/meta/serializer/stream_serializer.h"
+#include "runtime/platform/file_service/mapped_file.h"
 
 #include <filesystem>
 #include <fstream>
@@ -19,29 +21,24 @@ namespace Piccolo
         template<typename AssetType>
         bool loadAsset(const std::string& asset_url, AssetType& out_asset) const
         {
-            // read json file to string
+            // map the json file and read it straight into the runtime res object
             std::filesystem::path asset_path = getFullPath(asset_url);
-            std::ifstream asset_json_file(asset_path);
-            if (!asset_json_file)
+            MappedFile            asset_json_file;
+            if (!asset_json_file.open(asset_path))
             {
                 LOG_ERROR("open file: {} failed!", asset_path.generic_string());
                 return false;
             }
 
-            std::stringstream buffer;
-            buffer << asset_json_file.rdbuf();
-            std::string asset_json_text(buffer.str());
-
-            // parse to json object and read to runtime res object
-            std::string error;
-            auto&&      asset_json = Json::parse(asset_json_text, error);
-            if (!error.empty())
+            JsonReader reader(reinterpret_cast<const char*>(asset_json_file.getData()), asset_json_file.getSize());
+            if (!StreamSerializer::read(reader, out_asset) || !reader.finish())
             {
-                LOG_ERROR("parse json file {} failed!", asset_url);
+                LOG_ERROR("parse json file {} failed: {} at offset {}",
+                          asset_url,
+                          reader.getError(),
+                          reader.getErrorOffset());
                 return false;
             }
-
-            Serializer::read(asset_json, out_asset);
             return true;
         }
 
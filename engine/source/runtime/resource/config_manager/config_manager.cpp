@@ -2,6 +2,7 @@
 
 #include "runtime/engine.h"
 
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
 #include <string>
@@ -56,6 +57,62 @@ namespace Piccolo
                 {
                     m_global_particle_res_url = value;
                 }
+                else if (name == "JobWorkerCount")
+                {
+                    m_job_worker_count = std::stoi(value);
+                }
+                else if (name == "AnimationKeyTolerance")
+                {
+                    m_animation_key_tolerance = std::stof(value);
+                }
+                else if (name == "SaveCookedAnimation")
+                {
+                    m_save_cooked_animation = value == "1" || value == "true";
+                }
+                else if (name == "RenderThread")
+                {
+                    m_enable_render_thread = value == "1" || value == "true";
+                }
+                else if (name == "RenderPipelineDepth")
+                {
+                    m_render_pipeline_depth = static_cast<uint32_t>(std::max(std::stoi(value), 1));
+                }
+                else if (name == "NullRHI")
+                {
+                    m_enable_null_rhi = value == "1" || value == "true";
+                }
+                else if (name == "HeadlessFrameCount")
+                {
+                    m_headless_frame_count = static_cast<uint32_t>(std::max(std::stoi(value), 0));
+                }
+                else if (name == "AssetStreaming")
+                {
+                    m_enable_asset_streaming = value == "1" || value == "true";
+                }
+                else if (name == "AssetDecodeThreadCount")
+                {
+                    m_asset_decode_thread_count = static_cast<uint32_t>(std::max(std::stoi(value), 1));
+                }
+                else if (name == "AssetUploadBudgetKB")
+                {
+                    m_asset_upload_budget = static_cast<size_t>(std::max(std::stoi(value), 1)) << 10;
+                }
+                else if (name == "SaveCookedMesh")
+                {
+                    m_save_cooked_mesh = value == "1" || value == "true";
+                }
+                else if (name == "PhysicsUpdateFrequency")
+                {
+                    m_physics_update_frequency = std::max(std::stof(value), 1.f);
+                }
+                else if (name == "PhysicsMaxSubsteps")
+                {
+                    m_physics_max_substeps = static_cast<uint32_t>(std::max(std::stoi(value), 1));
+                }
+                else if (name == "PhysicsInterpolation")
+                {
+                    m_enable_physics_interpolation = value == "1" || value == "true";
+                }
 #ifdef ENABLE_PHYSICS_DEBUG_RENDERER
                 else if (name == "JoltAssetFolder")
                 {
@@ -84,6 +141,34 @@ namespace Piccolo
 
     const std::string& ConfigManager::getGlobalParticleResUrl() const { return m_global_particle_res_url; }
 
+    int ConfigManager::getJobWorkerCount() const { return m_job_worker_count; }
+
+    float ConfigManager::getAnimationKeyTolerance() const { return m_animation_key_tolerance; }
+
+    bool ConfigManager::shouldSaveCookedAnimation() const { return m_save_cooked_animation; }
+
+    bool ConfigManager::isRenderThreadEnabled() const { return m_enable_render_thread; }
+
+    uint32_t ConfigManager::getRenderPipelineDepth() const { return m_render_pipeline_depth; }
+
+    bool ConfigManager::isNullRHIEnabled() const { return m_enable_null_rhi; }
+
+    uint32_t ConfigManager::getHeadlessFrameCount() const { return m_headless_frame_count; }
+
+    bool ConfigManager::isAssetStreamingEnabled() const { return m_enable_asset_streaming; }
+
+    uint32_t ConfigManager::getAssetDecodeThreadCount() const { return m_asset_decode_thread_count; }
+
+    size_t ConfigManager::getAssetUploadBudget() const { return m_asset_upload_budget; }
+
+    bool ConfigManager::shouldSaveCookedMesh() const { return m_save_cooked_mesh; }
+
+    float ConfigManager::getPhysicsUpdateFrequency() const { return m_physics_update_frequency; }
+
+    uint32_t ConfigManager::getPhysicsMaxSubsteps() const { return m_physics_max_substeps; }
+
+    bool ConfigManager::isPhysicsInterpolationEnabled() const { return m_enable_physics_interpolation; }
+
 #ifdef ENABLE_PHYSICS_DEBUG_RENDERER
     const std::filesystem::path& ConfigManager::getJoltPhysicsAssetFolder() const { return m_jolt_physics_asset_folder; }
 #endif
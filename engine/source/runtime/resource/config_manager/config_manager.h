@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <filesystem>
 
 namespace Piccolo
@@ -26,6 +27,40 @@ namespace Piccolo
         const std::string& getGlobalRenderingResUrl() const;
         const std::string& getGlobalParticleResUrl() const;
 
+        // negative means one worker per hardware thread except the main thread
+        int getJobWorkerCount() const;
+
+        // max error per key component when animation tracks are reduced to a constant while cooking
+        float getAnimationKeyTolerance() const;
+        // write cooked animation clips next to the json clips so the next run maps them directly
+        bool shouldSaveCookedAnimation() const;
+
+        // run the renderer on its own thread so that logic of the next frame overlaps rendering, runtime only
+        bool isRenderThreadEnabled() const;
+        // frames the logic side may run ahead of the render side
+        uint32_t getRenderPipelineDepth() const;
+
+        // render through the null rhi without a window, the engine runs headless with a fixed frame time
+        bool isNullRHIEnabled() const;
+        // frames a headless run ticks before it quits, zero runs until the process is stopped
+        uint32_t getHeadlessFrameCount() const;
+
+        // load meshes and textures on the streaming threads, objects are drawn with placeholders meanwhile
+        bool isAssetStreamingEnabled() const;
+        uint32_t getAssetDecodeThreadCount() const;
+        // bytes of streamed assets the render thread uploads per frame
+        size_t getAssetUploadBudget() const;
+        // write cooked meshes next to the obj and json meshes so the next run maps them directly, on by default
+        // so that a mesh is only cooked once per source or cooker change, SaveCookedMesh=0 keeps the assets read only
+        bool shouldSaveCookedMesh() const;
+
+        // fixed physics steps per second, independent of the frame rate
+        float getPhysicsUpdateFrequency() const;
+        // steps a single frame may run to catch up, the time beyond them is dropped
+        uint32_t getPhysicsMaxSubsteps() const;
+        // transforms of simulated bodies are blended between the last two steps instead of snapping to the last one
+        bool isPhysicsInterpolationEnabled() const;
+
     private:
         std::filesystem::path m_root_folder;
         std::filesystem::path m_asset_folder;
@@ -41,5 +76,25 @@ namespace Piccolo
         std::string m_default_world_url;
         std::string m_global_rendering_res_url;
         std::string m_global_particle_res_url;
+
+        int m_job_worker_count {-1};
+
+        float m_animation_key_tolerance {0.0001f};
+        bool  m_save_cooked_animation {false};
+
+        bool     m_enable_render_thread {false};
+        uint32_t m_render_pipeline_depth {2};
+
+        bool     m_enable_null_rhi {false};
+        uint32_t m_headless_frame_count {0};
+
+        bool     m_enable_asset_streaming {true};
+        uint32_t m_asset_decode_thread_count {2};
+        size_t   m_asset_upload_budget {16 << 20};
+        bool     m_save_cooked_mesh {true};
+
+        float    m_physics_update_frequency {60.f};
+        uint32_t m_physics_max_substeps {4};
+        bool     m_enable_physics_interpolation {true};
     };
 } // namespace Piccolo
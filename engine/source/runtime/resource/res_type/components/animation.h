@@ -28,6 +28,20 @@ namespace Piccolo
         std::vector<AnimationResultElement> node;
     };
 
+    REFLECTION_TYPE(AnimationLodLevel)
+    CLASS(AnimationLodLevel, Fields)
+    {
+        REFLECTION_BODY(AnimationLodLevel);
+
+    public:
+        // camera distance from which the level is used
+        float min_distance = 0.f;
+        // clips are sampled every update_interval frames, the frames in between interpolate the last two poses
+        int update_interval = 1;
+        // keep the lod bones of the skeleton in their initial pose
+        bool skip_lod_bones = false;
+    };
+
     REFLECTION_TYPE(AnimationComponentRes)
     CLASS(AnimationComponentRes, Fields)
     {
@@ -38,6 +52,8 @@ namespace Piccolo
         BlendState  blend_state;
         // animation to skeleton map
         float       frame_position; // 0-1
+        // sorted by min_distance, no level means a full update every frame
+        std::vector<AnimationLodLevel> lod_levels;
 
         META(Disable)
         AnimationResult animation_result;
@@ -31,6 +31,13 @@ namespace Piccolo
         PhysicsControllerConfig() {}
         ~PhysicsControllerConfig() {}
         Capsule m_capsule_shape;
+
+        // collide and slide passes of a move, each one slides along the surface the previous one ran into
+        int m_max_slide_iterations {4};
+        // obstacles up to this height are stepped onto while walking
+        float m_step_height {0.3f};
+        // walking characters follow the ground down slopes and steps up to this distance
+        float m_ground_snap_distance {0.2f};
     };
 
     REFLECTION_TYPE(MotorComponentRes)
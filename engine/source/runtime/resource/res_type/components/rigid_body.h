@@ -16,6 +16,17 @@ namespace Piccolo
         invalid
     };
 
+    // values of RigidBodyComponentRes::m_actor_type
+    enum class RigidBodyActorType : int
+    {
+        // moved by the simulation, the object transform follows the body
+        dynamic_actor,
+        // never moves except when the object is placed somewhere else
+        static_actor,
+        // moved by the object transform, pushes dynamic bodies but is not pushed back
+        kinematic_actor
+    };
+
     REFLECTION_TYPE(RigidBodyShape)
     CLASS(RigidBodyShape, WhiteListFields)
     {
@@ -44,7 +55,16 @@ namespace Piccolo
 
     public:
         std::vector<RigidBodyShape> m_shapes;
-        float                       m_inverse_mass;
-        int                         m_actor_type;
+        // zero computes the mass from the volume of the shapes, only used by dynamic bodies
+        float m_inverse_mass {0.f};
+        // RigidBodyActorType
+        int m_actor_type {static_cast<int>(RigidBodyActorType::static_actor)};
+
+        float   m_linear_damping {0.05f};
+        float   m_angular_damping {0.05f};
+        Vector3 m_linear_velocity {Vector3::ZERO};
+        Vector3 m_angular_velocity {Vector3::ZERO};
+
+        RigidBodyActorType getActorType() const { return static_cast<RigidBodyActorType>(m_actor_type); }
     };
 } // namespace Piccolo
\ No newline at end of file
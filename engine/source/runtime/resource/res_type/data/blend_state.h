@@ -42,6 +42,8 @@ namespace Piccolo
         std::vector<float>       blend_weight;
         std::vector<std::string> blend_mask_file_path;
         std::vector<float>       blend_ratio;
+        // non zero for clips added on top of the blended pose instead of being blended with the other clips
+        std::vector<int>         blend_is_additive;
     };
 
 } // namespace Piccolo
\ No newline at end of file
@@ -31,6 +31,7 @@ namespace Piccolo
         int                  root_index;
         bool in_topological_order = false; // TODO: if not in topological order, we need to topology sort in skeleton
                                            // build process
+        std::vector<std::string> lod_bones; // names of the bones only animated at full detail, e.g. fingers
     };
 
 } // namespace Piccolo
\ No newline at end of file
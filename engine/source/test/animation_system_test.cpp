@@ -0,0 +1,124 @@
+#include "test/test_framework.h"
+
+#include "runtime/function/animation/animation_system.h"
+#include "runtime/function/animation/skeleton.h"
+
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <string>
+
+using namespace Piccolo;
+
+namespace
+{
+    // only the allocations of the thread running a test are counted, and only while it asks for it
+    thread_local bool     t_is_counting_allocations {false};
+    thread_local uint32_t t_allocation_count {0};
+
+    class AllocationCountScope
+    {
+    public:
+        AllocationCountScope()
+        {
+            t_allocation_count        = 0;
+            t_is_counting_allocations = true;
+        }
+        ~AllocationCountScope() { t_is_counting_allocations = false; }
+
+        uint32_t getAllocationCount() const { return t_allocation_count; }
+    };
+
+    BlendState makeBlendState(const std::string& path_prefix)
+    {
+        // longer than any small string buffer, so a copy of a path would allocate
+        const std::string long_prefix = path_prefix + "/asset/objects/character/player/components/animation/data/";
+
+        BlendState blend_state;
+        blend_state.clip_count               = 2;
+        blend_state.blend_clip_file_path     = {long_prefix + "idle.animation.json",
+                                                long_prefix + "walk.animation.json"};
+        blend_state.blend_anim_skel_map_path = {long_prefix + "idle.animation_skeleton_map.json",
+                                                long_prefix + "walk.animation_skeleton_map.json"};
+        blend_state.blend_weight             = {1.f, 1.f};
+        blend_state.blend_ratio              = {0.5f, 0.5f};
+        blend_state.blend_is_additive        = {0, 0};
+        return blend_state;
+    }
+} // namespace
+
+void* operator new(std::size_t size)
+{
+    if (t_is_counting_allocations)
+    {
+        ++t_allocation_count;
+    }
+    if (void* ptr = std::malloc(size == 0 ? 1 : size))
+    {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+PICCOLO_TEST(blendStateSourceHashIgnoresTheBlendRatios)
+{
+    const BlendState blend_state = makeBlendState("");
+    const size_t     source_hash = BlendStateCache::computeSourceHash(blend_state);
+
+    auto changes_source_hash = [&blend_state, source_hash](const std::function<void(BlendState&)>& change) {
+        BlendState changed_state = blend_state;
+        change(changed_state);
+        return BlendStateCache::computeSourceHash(changed_state) != source_hash;
+    };
+
+    PICCOLO_CHECK(!changes_source_hash([](BlendState& state) { state.blend_ratio = {0.1f, 0.9f}; }));
+    PICCOLO_CHECK(changes_source_hash([](BlendState& state) { state.blend_ratio.push_back(0.f); }));
+    PICCOLO_CHECK(changes_source_hash([](BlendState& state) { state.blend_weight[0] = 0.5f; }));
+    PICCOLO_CHECK(changes_source_hash([](BlendState& state) { state.blend_is_additive[1] = 1; }));
+    PICCOLO_CHECK(changes_source_hash(
+        [](BlendState& state) { state.blend_clip_file_path[1] = state.blend_clip_file_path[0]; }));
+
+    // a path moved from one list to the next is a different source
+    PICCOLO_CHECK(changes_source_hash([](BlendState& state) {
+        state.blend_anim_skel_map_path.insert(state.blend_anim_skel_map_path.begin(),
+                                              state.blend_clip_file_path.back());
+        state.blend_clip_file_path.pop_back();
+    }));
+
+    AllocationCountScope allocation_count_scope;
+    BlendStateCache::computeSourceHash(blend_state);
+    PICCOLO_CHECK(allocation_count_scope.getAllocationCount() == 0);
+}
+
+PICCOLO_TEST(blendStateCacheUpdateDoesNotAllocateOnceBuilt)
+{
+    // no files are loaded, the clips of the state are left out of the cache
+    BlendState blend_state;
+    blend_state.clip_count        = 2;
+    blend_state.blend_weight      = {1.f, 1.f};
+    blend_state.blend_ratio       = {0.5f, 0.5f};
+    blend_state.blend_is_additive = {0, 0};
+
+    BlendStateCache cache;
+    PICCOLO_CHECK(!cache.isBuiltFrom(blend_state));
+
+    AnimationManager::updateBlendStateCache(blend_state, cache);
+    PICCOLO_CHECK(cache.isBuiltFrom(blend_state));
+
+    AllocationCountScope allocation_count_scope;
+    for (uint32_t frame_index = 0; frame_index < 100; ++frame_index)
+    {
+        blend_state.blend_ratio[0] = frame_index / 100.f;
+        blend_state.blend_ratio[1] = 1.f - blend_state.blend_ratio[0];
+        AnimationManager::updateBlendStateCache(blend_state, cache);
+    }
+    PICCOLO_CHECK(allocation_count_scope.getAllocationCount() == 0);
+
+    // the ratios are still taken over every update
+    PICCOLO_CHECK(cache.isBuiltFrom(blend_state));
+    PICCOLO_CHECK(cache.m_blend_ratios.size() == 2 && cache.m_blend_ratios[0] == blend_state.blend_ratio[0]);
+}
@@ -0,0 +1,182 @@
+#include "test/test_framework.h"
+
+#include "runtime/core/job/job_system.h"
+#include "runtime/function/framework/level/level_tick_scheduler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+using namespace Piccolo;
+
+namespace
+{
+    constexpr uint32_t k_worker_count = 3;
+
+    size_t getPhasePosition(const std::vector<ComponentTickPhase>& phase_order, ComponentTickPhase phase)
+    {
+        return std::find(phase_order.begin(), phase_order.end(), phase) - phase_order.begin();
+    }
+} // namespace
+
+PICCOLO_TEST(jobSystemWaitsForEveryJobOfACounter)
+{
+    JobSystem job_system;
+    job_system.initialize(k_worker_count);
+
+    std::atomic<uint32_t> executed_count {0};
+    JobCounter            counter;
+    for (uint32_t job_index = 0; job_index < 1000; ++job_index)
+    {
+        job_system.run([&executed_count]() { executed_count.fetch_add(1, std::memory_order_relaxed); }, counter);
+    }
+    job_system.wait(counter);
+
+    PICCOLO_CHECK(counter.isDone());
+    PICCOLO_CHECK(executed_count.load() == 1000);
+}
+
+PICCOLO_TEST(jobSystemRunsJobsInlineWithoutWorkers)
+{
+    JobSystem job_system;
+    job_system.initialize(0);
+
+    uint32_t   executed_count = 0;
+    JobCounter counter;
+    job_system.run([&executed_count]() { executed_count++; }, counter);
+
+    // nothing is queued, the job is done when run returns
+    PICCOLO_CHECK(counter.isDone());
+    PICCOLO_CHECK(executed_count == 1);
+}
+
+PICCOLO_TEST(jobSystemOrdersDependentStages)
+{
+    JobSystem job_system;
+    job_system.initialize(k_worker_count);
+
+    // the second stage reads what the first stage wrote, it is only submitted once the first counter is done
+    constexpr uint32_t    k_value_count = 256;
+    std::vector<uint32_t> first_stage(k_value_count, 0);
+    std::vector<uint32_t> second_stage(k_value_count, 0);
+
+    JobCounter first_counter;
+    for (uint32_t value_index = 0; value_index < k_value_count; ++value_index)
+    {
+        job_system.run([&first_stage, value_index]() { first_stage[value_index] = value_index + 1; }, first_counter);
+    }
+    job_system.wait(first_counter);
+
+    JobCounter second_counter;
+    for (uint32_t value_index = 0; value_index < k_value_count; ++value_index)
+    {
+        job_system.run([&, value_index]() { second_stage[value_index] = first_stage[value_index] * 2; },
+                       second_counter);
+    }
+    job_system.wait(second_counter);
+
+    for (uint32_t value_index = 0; value_index < k_value_count; ++value_index)
+    {
+        PICCOLO_CHECK(second_stage[value_index] == (value_index + 1) * 2);
+    }
+}
+
+PICCOLO_TEST(jobSystemWaitsOnNestedCountersInsideJobs)
+{
+    JobSystem job_system;
+    job_system.initialize(k_worker_count);
+
+    // every outer job waits for its own inner jobs, the waiting workers have to keep executing jobs or this
+    // deadlocks as soon as every worker waits
+    constexpr uint32_t    k_outer_count = 16;
+    constexpr uint32_t    k_inner_count = 32;
+    std::atomic<uint32_t> inner_executed_count {0};
+    std::atomic<uint32_t> complete_outer_count {0};
+
+    JobCounter outer_counter;
+    for (uint32_t outer_index = 0; outer_index < k_outer_count; ++outer_index)
+    {
+        job_system.run(
+            [&]() {
+                std::atomic<uint32_t> own_inner_count {0};
+                JobCounter            inner_counter;
+                for (uint32_t inner_index = 0; inner_index < k_inner_count; ++inner_index)
+                {
+                    job_system.run(
+                        [&]() {
+                            own_inner_count.fetch_add(1, std::memory_order_relaxed);
+                            inner_executed_count.fetch_add(1, std::memory_order_relaxed);
+                        },
+                        inner_counter);
+                }
+                job_system.wait(inner_counter);
+
+                if (own_inner_count.load() == k_inner_count)
+                {
+                    complete_outer_count.fetch_add(1, std::memory_order_relaxed);
+                }
+            },
+            outer_counter);
+    }
+    job_system.wait(outer_counter);
+
+    PICCOLO_CHECK(inner_executed_count.load() == k_outer_count * k_inner_count);
+    PICCOLO_CHECK(complete_outer_count.load() == k_outer_count);
+}
+
+PICCOLO_TEST(jobSystemParallelForVisitsEveryIndexOnce)
+{
+    JobSystem job_system;
+    job_system.initialize(k_worker_count);
+
+    for (uint32_t count : {0u, 1u, 15u, 10007u})
+    {
+        std::unique_ptr<std::atomic<uint32_t>[]> visit_counts(new std::atomic<uint32_t>[count + 1]);
+        for (uint32_t index = 0; index <= count; ++index)
+        {
+            visit_counts[index] = 0;
+        }
+
+        job_system.parallelFor(count, 16, [&visit_counts](uint32_t begin, uint32_t end) {
+            for (uint32_t index = begin; index < end; ++index)
+            {
+                visit_counts[index].fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+
+        bool is_visited_once = true;
+        for (uint32_t index = 0; index < count; ++index)
+        {
+            is_visited_once = is_visited_once && visit_counts[index].load() == 1;
+        }
+        PICCOLO_CHECK(is_visited_once);
+        PICCOLO_CHECK(visit_counts[count].load() == 0);
+    }
+}
+
+PICCOLO_TEST(levelTickSchedulerOrdersPhasesByDependency)
+{
+    LevelTickScheduler scheduler;
+
+    const std::vector<ComponentTickPhase>& default_order = scheduler.getPhaseOrder();
+    PICCOLO_CHECK(default_order.size() == k_component_tick_phase_count);
+    PICCOLO_CHECK(getPhasePosition(default_order, ComponentTickPhase::pre_physics) <
+                  getPhasePosition(default_order, ComponentTickPhase::physics));
+    PICCOLO_CHECK(getPhasePosition(default_order, ComponentTickPhase::physics) <
+                  getPhasePosition(default_order, ComponentTickPhase::animation));
+    PICCOLO_CHECK(getPhasePosition(default_order, ComponentTickPhase::post_physics) <
+                  getPhasePosition(default_order, ComponentTickPhase::render_extract));
+    PICCOLO_CHECK(getPhasePosition(default_order, ComponentTickPhase::animation) <
+                  getPhasePosition(default_order, ComponentTickPhase::render_extract));
+
+    // declared after post_physics, a new dependency has to move animation in front of it
+    scheduler.addPhaseDependency(ComponentTickPhase::animation, ComponentTickPhase::post_physics);
+    const std::vector<ComponentTickPhase>& order = scheduler.getPhaseOrder();
+    PICCOLO_CHECK(getPhasePosition(order, ComponentTickPhase::physics) <
+                  getPhasePosition(order, ComponentTickPhase::animation));
+    PICCOLO_CHECK(getPhasePosition(order, ComponentTickPhase::animation) <
+                  getPhasePosition(order, ComponentTickPhase::post_physics));
+    PICCOLO_CHECK(getPhasePosition(order, ComponentTickPhase::post_physics) <
+                  getPhasePosition(order, ComponentTickPhase::render_extract));
+}
@@ -0,0 +1,169 @@
+#include "test/test_framework.h"
+
+#include "runtime/core/job/job_system.h"
+#include "runtime/function/physics/jolt/job_system_adapter.h"
+#include "runtime/function/physics/physics_scene.h"
+#include "runtime/resource/res_type/components/rigid_body.h"
+
+#include "Jolt/Jolt.h"
+#include "Jolt/RegisterTypes.h"
+
+#include "Jolt/Core/Factory.h"
+#include "Jolt/Core/TempAllocator.h"
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+using namespace Piccolo;
+
+namespace
+{
+    constexpr uint32_t k_worker_count = 3;
+    constexpr float    k_step_time    = 1.f / 60.f;
+
+    // what the physics manager sets up for its scenes
+    class PhysicsTestContext
+    {
+    public:
+        PhysicsTestContext()
+        {
+            m_config.m_interpolation_mode = PhysicsInterpolationMode::none;
+
+            JPH::Factory::sInstance = new JPH::Factory();
+            JPH::RegisterTypes();
+
+            m_job_system.initialize(k_worker_count);
+            m_jolt_job_system =
+                new JoltJobSystemAdapter(m_job_system, m_config.m_max_job_count, m_config.m_max_barrier_count);
+            m_temp_allocator = new JPH::TempAllocatorImpl(m_config.m_temp_allocator_size);
+        }
+
+        ~PhysicsTestContext()
+        {
+            delete m_temp_allocator;
+            delete m_jolt_job_system;
+            m_job_system.clear();
+
+            delete JPH::Factory::sInstance;
+            JPH::Factory::sInstance = nullptr;
+        }
+
+        std::unique_ptr<PhysicsScene> createScene() const
+        {
+            return std::make_unique<PhysicsScene>(m_config, m_config.m_gravity, m_jolt_job_system, m_temp_allocator);
+        }
+
+        PhysicsConfig m_config;
+
+    private:
+        JobSystem           m_job_system;
+        JPH::JobSystem*     m_jolt_job_system {nullptr};
+        JPH::TempAllocator* m_temp_allocator {nullptr};
+    };
+
+    void setBoxShape(RigidBodyComponentRes& rigidbody_res, const Vector3& half_extents, RigidBodyActorType actor_type)
+    {
+        // reserved so the shape is never copied, a copy would need the reflection registry
+        rigidbody_res.m_shapes.reserve(1);
+
+        RigidBodyShape& shape = rigidbody_res.m_shapes.emplace_back();
+        shape.m_type          = RigidBodyShapeType::box;
+        shape.m_geometry      = PICCOLO_REFLECTION_NEW(Box);
+
+        static_cast<Box*>(shape.m_geometry.getPtr())->m_half_extents = half_extents;
+
+        rigidbody_res.m_actor_type = static_cast<int>(actor_type);
+    }
+
+    Transform makeTransform(const Vector3& position)
+    {
+        Transform transform;
+        transform.m_position = position;
+        return transform;
+    }
+} // namespace
+
+PICCOLO_TEST(physicsSceneDropsADynamicBoxUnderGravity)
+{
+    PhysicsTestContext            context;
+    std::unique_ptr<PhysicsScene> scene = context.createScene();
+
+    RigidBodyComponentRes box_res;
+    setBoxShape(box_res, Vector3(0.5f, 0.5f, 0.5f), RigidBodyActorType::dynamic_actor);
+    box_res.m_linear_damping = 0.f;
+    const uint32_t box_id    = scene->createRigidBody(makeTransform(Vector3(0.f, 0.f, 100.f)), box_res);
+
+    RigidBodyComponentRes static_res;
+    setBoxShape(static_res, Vector3(0.5f, 0.5f, 0.5f), RigidBodyActorType::static_actor);
+    const uint32_t static_id = scene->createRigidBody(makeTransform(Vector3(10.f, 0.f, 0.f)), static_res);
+
+    PICCOLO_CHECK(box_id != s_invalid_rigidbody_id);
+    PICCOLO_CHECK(static_id != s_invalid_rigidbody_id);
+
+    // one second in frame sized ticks
+    for (uint32_t frame_index = 0; frame_index < 60; ++frame_index)
+    {
+        scene->tick(k_step_time);
+    }
+
+    Vector3    position;
+    Quaternion rotation;
+    PICCOLO_CHECK(scene->getSimulatedTransform(box_id, position, rotation));
+    PICCOLO_CHECK(std::fabs(position.x) < 1e-3f && std::fabs(position.y) < 1e-3f);
+
+    // a free fall of one second drops the box by g / 2, the fixed steps integrate it a bit differently
+    const float expected_z = 100.f + 0.5f * context.m_config.m_gravity.z;
+    PICCOLO_CHECK(std::fabs(position.z - expected_z) < 0.2f);
+
+    // static bodies are not moved by the simulation
+    PICCOLO_CHECK(!scene->getSimulatedTransform(static_id, position, rotation));
+}
+
+PICCOLO_TEST(physicsSceneRestsADynamicBoxOnStaticGround)
+{
+    PhysicsTestContext            context;
+    std::unique_ptr<PhysicsScene> scene = context.createScene();
+
+    // the ground top face is at z = 0
+    RigidBodyComponentRes ground_res;
+    setBoxShape(ground_res, Vector3(20.f, 20.f, 0.5f), RigidBodyActorType::static_actor);
+    scene->createRigidBody(makeTransform(Vector3(0.f, 0.f, -0.5f)), ground_res);
+
+    RigidBodyComponentRes box_res;
+    setBoxShape(box_res, Vector3(0.5f, 0.5f, 0.5f), RigidBodyActorType::dynamic_actor);
+    const uint32_t box_id = scene->createRigidBody(makeTransform(Vector3(0.f, 0.f, 3.f)), box_res);
+
+    for (uint32_t frame_index = 0; frame_index < 180; ++frame_index)
+    {
+        scene->tick(k_step_time);
+    }
+
+    Vector3    position;
+    Quaternion rotation;
+    PICCOLO_CHECK(scene->getSimulatedTransform(box_id, position, rotation));
+    PICCOLO_CHECK(std::fabs(position.z - 0.5f) < 0.05f);
+}
+
+PICCOLO_TEST(physicsSceneMovesAKinematicBoxToItsTarget)
+{
+    PhysicsTestContext            context;
+    std::unique_ptr<PhysicsScene> scene = context.createScene();
+
+    RigidBodyComponentRes kinematic_res;
+    setBoxShape(kinematic_res, Vector3(0.5f, 0.5f, 0.5f), RigidBodyActorType::kinematic_actor);
+    const uint32_t kinematic_id = scene->createRigidBody(makeTransform(Vector3::ZERO), kinematic_res);
+    scene->tick(k_step_time);
+
+    scene->updateRigidBodyGlobalTransform(kinematic_id, makeTransform(Vector3(5.f, 0.f, 0.f)));
+    scene->tick(k_step_time);
+
+    // the scene queries find the body at the target and no longer at the start
+    std::vector<PhysicsHitInfo> hits;
+    PICCOLO_CHECK(scene->raycast(Vector3(5.f, 0.f, 10.f), Vector3(0.f, 0.f, -1.f), 20.f, hits));
+    PICCOLO_CHECK(!hits.empty() && hits.front().body_id == kinematic_id);
+    PICCOLO_CHECK(!hits.empty() && std::fabs(hits.front().hit_position.z - 0.5f) < 1e-3f);
+
+    hits.clear();
+    PICCOLO_CHECK(!scene->raycast(Vector3(0.f, 0.f, 10.f), Vector3(0.f, 0.f, -1.f), 20.f, hits));
+}
@@ -0,0 +1,95 @@
+#include "test/test_framework.h"
+
+#include "runtime/function/render/render_helper.h"
+
+#include <random>
+#include <vector>
+
+using namespace Piccolo;
+
+namespace
+{
+    // covers empty batches, batches smaller than one sse group and tails that are not a multiple of four
+    constexpr size_t k_box_counts[] = {0, 1, 3, 4, 5, 31, 32, 33, 63, 1000, 1027};
+
+    Vector4 makeRandomPlane(std::mt19937& random_engine)
+    {
+        std::uniform_real_distribution<float> normal_distribution(-1.0f, 1.0f);
+        std::uniform_real_distribution<float> distance_distribution(-20.0f, 20.0f);
+
+        Vector3 normal(normal_distribution(random_engine),
+                       normal_distribution(random_engine),
+                       normal_distribution(random_engine));
+        normal.normalise();
+        return Vector4(normal, distance_distribution(random_engine));
+    }
+
+    ClusterFrustum makeRandomFrustum(std::mt19937& random_engine)
+    {
+        ClusterFrustum f;
+        f.m_plane_right  = makeRandomPlane(random_engine);
+        f.m_plane_left   = makeRandomPlane(random_engine);
+        f.m_plane_top    = makeRandomPlane(random_engine);
+        f.m_plane_bottom = makeRandomPlane(random_engine);
+        f.m_plane_near   = makeRandomPlane(random_engine);
+        f.m_plane_far    = makeRandomPlane(random_engine);
+        return f;
+    }
+
+    BoundingBox makeRandomBox(std::mt19937& random_engine)
+    {
+        std::uniform_real_distribution<float> center_distribution(-30.0f, 30.0f);
+        std::uniform_real_distribution<float> extent_distribution(0.0f, 8.0f);
+
+        Vector3 center(center_distribution(random_engine),
+                       center_distribution(random_engine),
+                       center_distribution(random_engine));
+        Vector3 extent(extent_distribution(random_engine),
+                       extent_distribution(random_engine),
+                       extent_distribution(random_engine));
+        return BoundingBox(center - extent, center + extent);
+    }
+} // namespace
+
+PICCOLO_TEST(tiledFrustumIntersectBoxesMatchesTheScalarTest)
+{
+    std::mt19937 random_engine(20221017);
+
+    size_t visible_count = 0;
+    size_t culled_count  = 0;
+    for (uint32_t frustum_index = 0; frustum_index < 64; ++frustum_index)
+    {
+        const ClusterFrustum f = makeRandomFrustum(random_engine);
+        for (size_t box_count : k_box_counts)
+        {
+            std::vector<BoundingBox> boxes;
+            BoundingBoxBatch         box_batch;
+            for (size_t box_index = 0; box_index < box_count; ++box_index)
+            {
+                boxes.push_back(makeRandomBox(random_engine));
+                box_batch.add(boxes.back());
+            }
+
+            std::vector<uint32_t> visible_bits;
+            TiledFrustumIntersectBoxes(f, box_batch, visible_bits);
+
+            PICCOLO_CHECK(visible_bits.size() == (box_count + 31) / 32);
+            for (size_t box_index = 0; box_index < box_count; ++box_index)
+            {
+                const bool is_visible = (visible_bits[box_index / 32] >> (box_index % 32)) & 1u;
+                PICCOLO_CHECK(is_visible == TiledFrustumIntersectBox(f, boxes[box_index]));
+                is_visible ? ++visible_count : ++culled_count;
+            }
+
+            // bits past the last box stay clear
+            if (box_count % 32 != 0)
+            {
+                PICCOLO_CHECK((visible_bits.back() >> (box_count % 32)) == 0);
+            }
+        }
+    }
+
+    // the random scene has to exercise both outcomes for the comparison to mean anything
+    PICCOLO_CHECK(visible_count > 0);
+    PICCOLO_CHECK(culled_count > 0);
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace Piccolo
+{
+    namespace Test
+    {
+        using TestFunction = void (*)();
+
+        struct TestCase
+        {
+            const char*  m_name;
+            TestFunction m_function;
+        };
+
+        std::vector<TestCase>& getTestCases();
+
+        void     reportFailure(const char* file, int line, const char* expression);
+        uint32_t getFailureCount();
+
+        struct TestRegistrar
+        {
+            TestRegistrar(const char* name, TestFunction function) { getTestCases().push_back({name, function}); }
+        };
+    } // namespace Test
+} // namespace Piccolo
+
+/// Defines a test case that PiccoloTest runs, the name has to be unique within the executable
+#define PICCOLO_TEST(name) \
+    static void name(); \
+    static Piccolo::Test::TestRegistrar name##_registrar(#name, name); \
+    static void name()
+
+/// Records a failure of the running test and continues
+#define PICCOLO_CHECK(expression) \
+    do \
+    { \
+        if (!(expression)) \
+        { \
+            Piccolo::Test::reportFailure(__FILE__, __LINE__, #expression); \
+        } \
+    } while (false)
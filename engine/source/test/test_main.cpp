@@ -0,0 +1,55 @@
+#include "test/test_framework.h"
+
+#include <cstdio>
+#include <cstring>
+
+namespace Piccolo
+{
+    namespace Test
+    {
+        namespace
+        {
+            uint32_t g_failure_count = 0;
+        } // namespace
+
+        std::vector<TestCase>& getTestCases()
+        {
+            static std::vector<TestCase> test_cases;
+            return test_cases;
+        }
+
+        void reportFailure(const char* file, int line, const char* expression)
+        {
+            std::printf("    %s:%d: check failed: %s\n", file, line, expression);
+            g_failure_count++;
+        }
+
+        uint32_t getFailureCount() { return g_failure_count; }
+    } // namespace Test
+} // namespace Piccolo
+
+// runs every test, or only the tests whose name contains the first argument
+int main(int argc, char** argv)
+{
+    using namespace Piccolo::Test;
+
+    const char* filter       = argc > 1 ? argv[1] : nullptr;
+    uint32_t    run_count    = 0;
+    uint32_t    failed_count = 0;
+    for (const TestCase& test_case : getTestCases())
+    {
+        if (filter && std::strstr(test_case.m_name, filter) == nullptr)
+            continue;
+
+        const uint32_t failure_count = getFailureCount();
+        test_case.m_function();
+        const bool is_passed = getFailureCount() == failure_count;
+
+        std::printf("[%s] %s\n", is_passed ? "  ok" : "fail", test_case.m_name);
+        run_count++;
+        failed_count += is_passed ? 0 : 1;
+    }
+
+    std::printf("%u tests, %u failed\n", run_count, failed_count);
+    return failed_count == 0 ? 0 : 1;
+}